@@ -17,4 +17,23 @@ else()
     message(STATUS "Float implementation for to_numeric: std::sto[f|d|ld]")
     set(EDUCELAB_NEED_TO_NUMERIC_FP TRUE)
     add_compile_definitions(EDUCELAB_NEED_TO_NUMERIC_FP)
-endif()
\ No newline at end of file
+endif()
+# Check for float versions of std::to_chars
+set(code [[
+    #include <charconv>
+
+    int main() {
+        char buf[32];
+        float val{5.F};
+        std::to_chars(buf, buf + 32, val);
+        return 0;
+    }
+]])
+check_cxx_source_compiles("${code}" CXX_CHARCONV_FP_TO_CHARS)
+if(CXX_CHARCONV_FP_TO_CHARS)
+    message(STATUS "Float implementation for append_numeric: std::to_chars")
+else()
+    message(STATUS "Float implementation for append_numeric: std::snprintf")
+    set(EDUCELAB_NEED_TO_CHARS_FP TRUE)
+    add_compile_definitions(EDUCELAB_NEED_TO_CHARS_FP)
+endif()
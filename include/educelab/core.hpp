@@ -3,18 +3,46 @@
 #include "educelab/core/Version.hpp"
 
 #include "educelab/core/io/ImageIO.hpp"
+#include "educelab/core/io/MeshIO.hpp"
+#include "educelab/core/io/MeshStream.hpp"
+#include "educelab/core/io/PointCloudIO.hpp"
 
 #include "educelab/core/types/Color.hpp"
+#include "educelab/core/types/ColorArray.hpp"
 #include "educelab/core/types/Image.hpp"
 #include "educelab/core/types/Mat.hpp"
 #include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/types/PointCloud.hpp"
 #include "educelab/core/types/Signals.hpp"
 #include "educelab/core/types/Uuid.hpp"
 #include "educelab/core/types/Vec.hpp"
 
 #include "educelab/core/utils/Caching.hpp"
+#include "educelab/core/utils/Colormap.hpp"
+#include "educelab/core/utils/Compression.hpp"
 #include "educelab/core/utils/Filesystem.hpp"
+#include "educelab/core/utils/Hashing.hpp"
 #include "educelab/core/utils/Iteration.hpp"
 #include "educelab/core/utils/LinearAlgebra.hpp"
 #include "educelab/core/utils/Math.hpp"
-#include "educelab/core/utils/String.hpp"
\ No newline at end of file
+#include "educelab/core/utils/MemoryMap.hpp"
+#include "educelab/core/utils/MemoryUsage.hpp"
+#include "educelab/core/utils/MeshAdjacency.hpp"
+#include "educelab/core/utils/MeshCacheOptimization.hpp"
+#include "educelab/core/utils/MeshComponents.hpp"
+#include "educelab/core/utils/MeshDecimation.hpp"
+#include "educelab/core/utils/MeshIntersection.hpp"
+#include "educelab/core/utils/MeshMerge.hpp"
+#include "educelab/core/utils/MeshNormals.hpp"
+#include "educelab/core/utils/MeshPartitioning.hpp"
+#include "educelab/core/utils/MeshRasterization.hpp"
+#include "educelab/core/utils/MeshReordering.hpp"
+#include "educelab/core/utils/MeshSmoothing.hpp"
+#include "educelab/core/utils/MeshStatistics.hpp"
+#include "educelab/core/utils/MeshSubdivision.hpp"
+#include "educelab/core/utils/MeshWelding.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+#include "educelab/core/utils/PointCloudProcessing.hpp"
+#include "educelab/core/utils/Sorting.hpp"
+#include "educelab/core/utils/String.hpp"
+#include "educelab/core/utils/TextureBaking.hpp"
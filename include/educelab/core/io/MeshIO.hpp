@@ -0,0 +1,2185 @@
+#pragma once
+
+/** @file */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "educelab/core/types/Color.hpp"
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/utils/Compression.hpp"
+#include "educelab/core/utils/Filesystem.hpp"
+#include "educelab/core/utils/MemoryMap.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+#include "educelab/core/utils/String.hpp"
+
+namespace educelab
+{
+
+/** @brief Options for write_mesh() */
+struct MeshWriteOptions {
+    /**
+     * @brief Quantize vertex positions to 16-bit integers over the mesh
+     * bounding box. Native format only.
+     */
+    bool quantizePositions{false};
+    /**
+     * @brief Delta-encode and LZ-compress face indices. Native format only.
+     */
+    bool compressIndices{false};
+};
+
+namespace detail
+{
+/** Marker for OBJ face corners without a texture or normal reference */
+constexpr std::int64_t OBJ_NO_INDEX{std::numeric_limits<std::int64_t>::min()};
+
+/** Minimum number of bytes parsed by a single OBJ parsing task */
+constexpr std::size_t OBJ_MIN_CHUNK_BYTES{1 << 16};
+
+/** Number of records (e.g. lines) formatted by a single writing task */
+constexpr std::size_t RECORDS_PER_BLOCK{1 << 14};
+
+/**
+ * Elements parsed from a contiguous block of OBJ lines. Face corners are
+ * stored as 0-based indices. Corners which used negative (relative) indices
+ * are resolved against the chunk-local element count and recorded in the
+ * `rel*` lists so they can be offset once the counts of all preceding chunks
+ * are known.
+ */
+template <typename T>
+struct ObjChunk {
+    /** Vertex positions (xyz) */
+    std::vector<T> v;
+    /** Vertex colors (rgb). Empty if no vertex in the chunk has a color. */
+    std::vector<float> vc;
+    /** Vertex normals (xyz) */
+    std::vector<T> vn;
+    /** Texture coordinates (uv) */
+    std::vector<T> vt;
+    /** Number of vertices per face */
+    std::vector<std::uint32_t> faceSizes;
+    /** Face corner vertex indices */
+    std::vector<std::int64_t> fv;
+    /** Face corner texture coordinate indices */
+    std::vector<std::int64_t> ft;
+    /** Face corner normal indices */
+    std::vector<std::int64_t> fn;
+    /** Corners with relative vertex indices */
+    std::vector<std::size_t> relV;
+    /** Corners with relative texture coordinate indices */
+    std::vector<std::size_t> relT;
+    /** Corners with relative normal indices */
+    std::vector<std::size_t> relN;
+    /** Whether any corner references a normal */
+    bool hasNormalRefs{false};
+    /** Whether any corner references a texture coordinate */
+    bool hasTextureRefs{false};
+
+    /** Number of vertices */
+    [[nodiscard]] auto numV() const -> std::size_t { return v.size() / 3; }
+    /** Number of texture coordinates */
+    [[nodiscard]] auto numVt() const -> std::size_t { return vt.size() / 2; }
+    /** Number of normals */
+    [[nodiscard]] auto numVn() const -> std::size_t { return vn.size() / 3; }
+};
+
+/** Whether a character is OBJ inline whitespace */
+inline auto obj_is_space(char c) -> bool
+{
+    return c == ' ' or c == '\t' or c == '\r';
+}
+
+/** Advance past inline whitespace */
+inline auto obj_skip_space(const char* p, const char* end) -> const char*
+{
+    while (p < end and obj_is_space(*p)) {
+        p++;
+    }
+    return p;
+}
+
+/** Throw a parsing error which includes the offending line */
+[[noreturn]] inline void obj_parse_error(
+    const std::string& msg, const char* lineBegin, const char* lineEnd)
+{
+    throw std::runtime_error(
+        "Invalid OBJ " + msg + ": " + std::string(lineBegin, lineEnd));
+}
+
+/** Parse a number from p, advancing p past it */
+template <typename T>
+auto obj_parse_number(const char*& p, const char* end) -> T
+{
+    if (p < end and *p == '+') {
+        p++;
+    }
+    std::size_t pos{0};
+    auto val = to_numeric<T>(std::string_view(p, end - p), &pos);
+    p += pos;
+    return val;
+}
+
+/** Resolve a 1-based or negative OBJ index to a 0-based, chunk-local index */
+inline auto obj_resolve_index(
+    std::int64_t idx,
+    std::size_t localCount,
+    std::vector<std::size_t>& rel,
+    std::size_t corner) -> std::int64_t
+{
+    if (idx > 0) {
+        return idx - 1;
+    }
+    rel.emplace_back(corner);
+    return static_cast<std::int64_t>(localCount) + idx;
+}
+
+/** Parse the OBJ lines in [begin, end) */
+template <typename T>
+auto obj_parse_chunk(const char* begin, const char* end) -> ObjChunk<T>
+{
+    // Integer meshes still need to accept decimal coordinates
+    using ParseT = std::conditional_t<std::is_floating_point_v<T>, T, double>;
+
+    ObjChunk<T> c;
+    const char* line = begin;
+    while (line < end) {
+        const auto* lineEnd = static_cast<const char*>(
+            std::memchr(line, '\n', static_cast<std::size_t>(end - line)));
+        if (lineEnd == nullptr) {
+            lineEnd = end;
+        }
+        const auto* p = obj_skip_space(line, lineEnd);
+
+        // Element keyword
+        const auto* kw = p;
+        while (p < lineEnd and not obj_is_space(*p)) {
+            p++;
+        }
+        const std::string_view key(kw, p - kw);
+
+        try {
+            // Vertex position with optional color
+            if (key == "v") {
+                std::array<ParseT, 6> vals{};
+                std::size_t n{0};
+                for (p = obj_skip_space(p, lineEnd); p < lineEnd and n < 6;
+                     p = obj_skip_space(p, lineEnd)) {
+                    vals[n++] = obj_parse_number<ParseT>(p, lineEnd);
+                }
+                if (n < 3 or n == 5 or p < lineEnd) {
+                    obj_parse_error("vertex", line, lineEnd);
+                }
+                auto idx = c.numV();
+                for (std::size_t d{0}; d < 3; d++) {
+                    c.v.emplace_back(static_cast<T>(vals[d]));
+                }
+                // x y z r g b. x y z w has 4 values and no color.
+                if (n == 6) {
+                    c.vc.resize(
+                        3 * idx, std::numeric_limits<float>::quiet_NaN());
+                    for (std::size_t d{3}; d < 6; d++) {
+                        c.vc.emplace_back(static_cast<float>(vals[d]));
+                    }
+                } else if (not c.vc.empty()) {
+                    c.vc.resize(
+                        3 * (idx + 1), std::numeric_limits<float>::quiet_NaN());
+                }
+            }
+
+            // Vertex normal
+            else if (key == "vn") {
+                for (std::size_t d{0}; d < 3; d++) {
+                    p = obj_skip_space(p, lineEnd);
+                    c.vn.emplace_back(
+                        static_cast<T>(obj_parse_number<ParseT>(p, lineEnd)));
+                }
+                if (obj_skip_space(p, lineEnd) < lineEnd) {
+                    obj_parse_error("vertex normal", line, lineEnd);
+                }
+            }
+
+            // Texture coordinate: u [v [w]]. w is ignored.
+            else if (key == "vt") {
+                std::array<ParseT, 3> vals{};
+                std::size_t n{0};
+                for (p = obj_skip_space(p, lineEnd); p < lineEnd and n < 3;
+                     p = obj_skip_space(p, lineEnd)) {
+                    vals[n++] = obj_parse_number<ParseT>(p, lineEnd);
+                }
+                if (n < 1 or p < lineEnd) {
+                    obj_parse_error("texture coordinate", line, lineEnd);
+                }
+                c.vt.emplace_back(static_cast<T>(vals[0]));
+                c.vt.emplace_back(static_cast<T>(vals[1]));
+            }
+
+            // Face: v, v/vt, v//vn, or v/vt/vn corners
+            else if (key == "f") {
+                // 0 is not a valid OBJ index, and the smallest int64 would be
+                // mistaken for a missing reference
+                auto parseIndex = [&]() {
+                    auto idx = obj_parse_number<std::int64_t>(p, lineEnd);
+                    if (idx == 0 or idx == OBJ_NO_INDEX) {
+                        obj_parse_error("face index", line, lineEnd);
+                    }
+                    return idx;
+                };
+                std::uint32_t size{0};
+                for (p = obj_skip_space(p, lineEnd); p < lineEnd;
+                     p = obj_skip_space(p, lineEnd)) {
+                    auto corner = c.fv.size();
+                    auto v = parseIndex();
+                    auto vt = OBJ_NO_INDEX;
+                    auto vn = OBJ_NO_INDEX;
+                    if (p < lineEnd and *p == '/') {
+                        p++;
+                        if (p < lineEnd and *p != '/') {
+                            vt = parseIndex();
+                        }
+                        if (p < lineEnd and *p == '/') {
+                            p++;
+                            vn = parseIndex();
+                        }
+                    }
+                    if (p < lineEnd and not obj_is_space(*p)) {
+                        obj_parse_error("face", line, lineEnd);
+                    }
+
+                    c.fv.emplace_back(
+                        obj_resolve_index(v, c.numV(), c.relV, corner));
+                    c.ft.emplace_back(
+                        vt == OBJ_NO_INDEX
+                            ? OBJ_NO_INDEX
+                            : obj_resolve_index(vt, c.numVt(), c.relT, corner));
+                    c.fn.emplace_back(
+                        vn == OBJ_NO_INDEX
+                            ? OBJ_NO_INDEX
+                            : obj_resolve_index(vn, c.numVn(), c.relN, corner));
+                    c.hasNormalRefs |= vn != OBJ_NO_INDEX;
+                    c.hasTextureRefs |= vt != OBJ_NO_INDEX;
+                    size++;
+                }
+                if (size < 3) {
+                    obj_parse_error("face", line, lineEnd);
+                }
+                c.faceSizes.emplace_back(size);
+            }
+
+            // Comments, groups, materials, etc. are ignored
+        } catch (const std::invalid_argument&) {
+            obj_parse_error("number", line, lineEnd);
+        } catch (const std::out_of_range&) {
+            obj_parse_error("number", line, lineEnd);
+        }
+
+        line = lineEnd + 1;
+    }
+    return c;
+}
+
+/** Offset chunk-local indices and check them against the total counts */
+inline void obj_offset_indices(
+    std::vector<std::int64_t>& idxs,
+    const std::vector<std::size_t>& rel,
+    std::size_t offset,
+    std::size_t total,
+    const char* name)
+{
+    for (const auto& corner : rel) {
+        idxs[corner] += static_cast<std::int64_t>(offset);
+    }
+    for (const auto& idx : idxs) {
+        if (idx != OBJ_NO_INDEX and
+            (idx < 0 or static_cast<std::size_t>(idx) >= total)) {
+            throw std::runtime_error(
+                std::string("Invalid OBJ: ") + name + " index out of range");
+        }
+    }
+}
+
+/**
+ * @brief Read an OBJ file
+ *
+ * The file is memory-mapped and split at line boundaries into chunks which are
+ * parsed in parallel, then merged into the output mesh. Vertex positions
+ * (including the common `v x y z r g b` color extension), vertex normals, and
+ * polygonal faces are loaded. Negative (relative) indices are supported.
+ * Normals referenced by face corners are assigned to the referenced vertex.
+ * Texture coordinates are loaded into the mesh's UV list, and the UV indices
+ * of faces whose corners all reference one are stored as face UVs.
+ */
+template <class MeshType>
+auto obj_read(const std::filesystem::path& path) -> MeshType
+{
+    static_assert(MeshType::dims == 3, "OBJ only supports 3D meshes");
+    using T = typename MeshType::value_type;
+    using Vertex = typename MeshType::Vertex;
+    using Face = typename MeshType::Face;
+    using Index = typename Face::value_type;
+    using UV = typename MeshType::UV;
+
+    const MemoryMap file(path);
+    const auto* data = reinterpret_cast<const char*>(file.data());
+    const auto* dataEnd = data + file.size();
+
+    // Split into chunks ending at line boundaries
+    auto numChunks = std::max<std::size_t>(
+        1, std::min(num_threads() * 4, file.size() / OBJ_MIN_CHUNK_BYTES));
+    std::vector<const char*> bounds{data};
+    for (std::size_t i{1}; i < numChunks; i++) {
+        const auto* p =
+            std::max(data + i * file.size() / numChunks, bounds.back());
+        const auto* nl = static_cast<const char*>(
+            std::memchr(p, '\n', static_cast<std::size_t>(dataEnd - p)));
+        bounds.emplace_back(nl == nullptr ? dataEnd : nl + 1);
+    }
+    bounds.emplace_back(dataEnd);
+    numChunks = bounds.size() - 1;
+
+    // Parse
+    std::vector<ObjChunk<T>> chunks(numChunks);
+    parallel_for(
+        0, numChunks,
+        [&](auto i) {
+            chunks[i] = obj_parse_chunk<T>(bounds[i], bounds[i + 1]);
+        },
+        1);
+
+    // Global offsets for each chunk
+    struct Offsets {
+        std::size_t v{0}, vt{0}, vn{0}, f{0};
+    };
+    std::vector<Offsets> offsets(numChunks + 1);
+    for (std::size_t i{0}; i < numChunks; i++) {
+        offsets[i + 1].v = offsets[i].v + chunks[i].numV();
+        offsets[i + 1].vt = offsets[i].vt + chunks[i].numVt();
+        offsets[i + 1].vn = offsets[i].vn + chunks[i].numVn();
+        offsets[i + 1].f = offsets[i].f + chunks[i].faceSizes.size();
+    }
+    const auto& totals = offsets.back();
+    MeshType::checkCapacity(totals.v);
+    MeshType::checkCapacity(totals.vt);
+
+    // Resolve relative indices and validate
+    parallel_for(
+        0, numChunks,
+        [&](auto i) {
+            auto& c = chunks[i];
+            obj_offset_indices(c.fv, c.relV, offsets[i].v, totals.v, "vertex");
+            obj_offset_indices(
+                c.ft, c.relT, offsets[i].vt, totals.vt, "texture");
+            obj_offset_indices(
+                c.fn, c.relN, offsets[i].vn, totals.vn, "normal");
+        },
+        1);
+
+    // Copy into the mesh
+    MeshType mesh;
+    auto& vertices = mesh.vertices();
+    auto& faces = mesh.faces();
+    vertices.resize(totals.v);
+    faces.resize(totals.f);
+    std::vector<T> normals(3 * totals.vn);
+    auto& uvs = mesh.uvs();
+    auto& faceUVs = mesh.faceUVs();
+    uvs.resize(totals.vt);
+    if (std::any_of(chunks.begin(), chunks.end(), [](const auto& c) {
+            return c.hasTextureRefs;
+        })) {
+        faceUVs.resize(totals.f);
+    }
+    parallel_for(
+        0, numChunks,
+        [&](auto i) {
+            const auto& c = chunks[i];
+            for (std::size_t vi{0}; vi < c.numV(); vi++) {
+                Vertex& vert = vertices[offsets[i].v + vi];
+                for (std::size_t d{0}; d < 3; d++) {
+                    vert[d] = c.v[3 * vi + d];
+                }
+                if constexpr (traits::has_color_v<Vertex>) {
+                    if (not c.vc.empty() and not std::isnan(c.vc[3 * vi])) {
+                        vert.color = Color::F32C3{
+                            c.vc[3 * vi], c.vc[3 * vi + 1], c.vc[3 * vi + 2]};
+                    }
+                }
+            }
+            std::copy(
+                c.vn.begin(), c.vn.end(), normals.begin() + 3 * offsets[i].vn);
+            for (std::size_t ti{0}; ti < c.numVt(); ti++) {
+                uvs[offsets[i].vt + ti] = UV{c.vt[2 * ti], c.vt[2 * ti + 1]};
+            }
+
+            std::size_t corner{0};
+            for (std::size_t fi{0}; fi < c.faceSizes.size(); fi++) {
+                Face& face = faces[offsets[i].f + fi];
+                face.resize(c.faceSizes[fi]);
+                auto first = corner;
+                for (auto& idx : face) {
+                    idx = static_cast<Index>(c.fv[corner++]);
+                }
+
+                // Face UVs only if every corner has one
+                if (not c.hasTextureRefs or
+                    std::any_of(
+                        c.ft.begin() + first, c.ft.begin() + corner,
+                        [](auto t) { return t == OBJ_NO_INDEX; })) {
+                    continue;
+                }
+                Face& faceUV = faceUVs[offsets[i].f + fi];
+                faceUV.resize(face.size());
+                for (std::size_t k{0}; k < face.size(); k++) {
+                    faceUV[k] = static_cast<Index>(c.ft[first + k]);
+                }
+            }
+        },
+        1);
+
+    // Assign normals in file order so that the last reference wins
+    if constexpr (traits::has_normal_v<Vertex>) {
+        for (const auto& c : chunks) {
+            if (not c.hasNormalRefs) {
+                continue;
+            }
+            for (std::size_t corner{0}; corner < c.fv.size(); corner++) {
+                auto n = c.fn[corner];
+                if (n == OBJ_NO_INDEX) {
+                    continue;
+                }
+                const auto* nv = &normals[3 * n];
+                vertices[c.fv[corner]].normal =
+                    Vec<T, 3>{nv[0], nv[1], nv[2]};
+            }
+        }
+    }
+
+    return mesh;
+}
+
+/**
+ * Convert a vertex color to the color type `T` stored by a writer
+ *
+ * @throws std::runtime_error If the vertex does not have a color
+ */
+template <typename T>
+auto vertex_color(const Color& c) -> T
+{
+    if (not c.has_value()) {
+        throw std::runtime_error("Vertex is missing a color");
+    }
+    return c.value<T>();
+}
+
+/**
+ * Format `n` records with `func(i, buffer)` in parallel blocks and write them
+ * to a stream in order. Bounds memory use to a few blocks per thread.
+ */
+template <typename Func>
+void write_records(std::ostream& os, std::size_t n, Func&& func)
+{
+    auto threads = num_threads();
+    std::vector<std::string> buffers(threads);
+    for (std::size_t start{0}; start < n;
+         start += threads * RECORDS_PER_BLOCK) {
+        parallel_for(
+            0, threads,
+            [&](auto t) {
+                auto& buf = buffers[t];
+                buf.clear();
+                auto b = std::min(n, start + t * RECORDS_PER_BLOCK);
+                auto e = std::min(n, b + RECORDS_PER_BLOCK);
+                for (auto i = b; i < e; i++) {
+                    func(i, buf);
+                }
+            },
+            1);
+        for (const auto& buf : buffers) {
+            os.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        }
+    }
+}
+
+/**
+ * @brief Write an OBJ file
+ *
+ * Vertex positions and faces are always written. Vertex colors are written
+ * (as `v x y z r g b`) when every vertex has a color, and vertex normals are
+ * written when every vertex has a normal. Colors of other types are
+ * converted to F32C3. Texture coordinates are written when the mesh has any,
+ * and are referenced by the corners of faces with face UVs. Numbers are
+ * formatted with `std::to_chars` in parallel blocks.
+ */
+template <class MeshType>
+void obj_write(const std::filesystem::path& path, const MeshType& mesh)
+{
+    static_assert(MeshType::dims == 3, "OBJ only supports 3D meshes");
+    using Vertex = typename MeshType::Vertex;
+    const auto& vertices = mesh.vertices();
+    const auto& faces = mesh.faces();
+
+    bool writeColors{false};
+    bool writeNormals{false};
+    if constexpr (traits::has_color_v<Vertex>) {
+        writeColors =
+            not vertices.empty() and
+            std::all_of(vertices.begin(), vertices.end(), [](auto& v) {
+                return v.color.has_value();
+            });
+    }
+    if constexpr (traits::has_normal_v<Vertex>) {
+        writeNormals =
+            not vertices.empty() and
+            std::all_of(vertices.begin(), vertices.end(), [](auto& v) {
+                return v.normal.has_value();
+            });
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    if (not file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + path.string());
+    }
+
+    // Vertices
+    write_records(file, vertices.size(), [&](auto i, std::string& buf) {
+        const auto& v = vertices[i];
+        buf += 'v';
+        for (const auto& c : v) {
+            buf += ' ';
+            append_numeric(buf, c);
+        }
+        if constexpr (traits::has_color_v<Vertex>) {
+            if (writeColors) {
+                for (const auto& c : vertex_color<Color::F32C3>(v.color)) {
+                    buf += ' ';
+                    append_numeric(buf, c);
+                }
+            }
+        }
+        buf += '\n';
+    });
+
+    // Normals
+    if constexpr (traits::has_normal_v<Vertex>) {
+        if (writeNormals) {
+            write_records(file, vertices.size(), [&](auto i, auto& buf) {
+                buf += "vn";
+                for (const auto& c : vertices[i].normal.value()) {
+                    buf += ' ';
+                    append_numeric(buf, c);
+                }
+                buf += '\n';
+            });
+        }
+    }
+
+    // Texture coordinates
+    const auto& uvs = mesh.uvs();
+    write_records(file, uvs.size(), [&](auto i, std::string& buf) {
+        buf += "vt";
+        for (const auto& c : uvs[i]) {
+            buf += ' ';
+            append_numeric(buf, c);
+        }
+        buf += '\n';
+    });
+
+    // Faces
+    write_records(file, faces.size(), [&](auto i, std::string& buf) {
+        const auto& face = faces[i];
+        const auto& faceUV = mesh.faceUV(i);
+        const auto hasUV = not faceUV.empty() and faceUV.size() == face.size();
+        buf += 'f';
+        for (std::size_t k{0}; k < face.size(); k++) {
+            buf += ' ';
+            append_numeric(buf, face[k] + 1);
+            if (hasUV or writeNormals) {
+                buf += '/';
+            }
+            if (hasUV) {
+                append_numeric(buf, faceUV[k] + 1);
+            }
+            if (writeNormals) {
+                buf += '/';
+                append_numeric(buf, face[k] + 1);
+            }
+        }
+        buf += '\n';
+    });
+
+    file.close();
+    if (file.fail()) {
+        throw std::runtime_error("Failed to write file: " + path.string());
+    }
+}
+
+/** Native mesh file signature */
+constexpr std::array<char, 8> NATIVE_MAGIC{'E', 'L', 'M', 'E', 'S', 'H', 0, 0};
+
+/** Native mesh format version */
+constexpr std::uint32_t NATIVE_VERSION{1};
+
+/** Alignment of native mesh blocks in bytes */
+constexpr std::size_t NATIVE_ALIGNMENT{64};
+
+/** Number of face indices in each independently compressed segment */
+constexpr std::size_t NATIVE_SEGMENT_SIZE{1 << 20};
+
+/**
+ * Upper bound on the expansion ratio of lz_compress(). Bounds the number of
+ * compressed face indices before they are allocated.
+ */
+constexpr std::uint64_t NATIVE_MAX_LZ_RATIO{256};
+
+/** Native mesh block types */
+enum class NativeBlockType : std::uint32_t {
+    /** Vertex positions */
+    Positions = 1,
+    /** Vertex normals */
+    Normals,
+    /** Vertex colors (F32C3) */
+    Colors,
+    /** Number of vertices in each face. Omitted for triangle meshes. */
+    FaceSizes,
+    /** Face vertex indices */
+    Indices
+};
+
+/** Native mesh block encodings */
+enum class NativeEncoding : std::uint32_t {
+    /** Packed, little-endian array */
+    Raw = 0,
+    /** Per-axis minimum and step (double), then 16-bit values */
+    Quantized16,
+    /** Segment table, then LZ-compressed, delta-encoded varint segments */
+    DeltaLZ
+};
+
+/** Native mesh file header */
+struct NativeHeader {
+    /** File signature */
+    std::array<char, 8> magic{NATIVE_MAGIC};
+    /** Format version */
+    std::uint32_t version{NATIVE_VERSION};
+    /** Number of entries in the block table */
+    std::uint32_t numBlocks{0};
+    /** Number of vertices */
+    std::uint64_t numVertices{0};
+    /** Number of faces */
+    std::uint64_t numFaces{0};
+    /** Number of position dimensions */
+    std::uint32_t dims{0};
+    /** Bytes per raw position/normal scalar (4 or 8) */
+    std::uint32_t scalarSize{0};
+    /** Bytes per raw face index (4 or 8) */
+    std::uint32_t indexSize{0};
+    /** Reserved */
+    std::uint32_t reserved{0};
+};
+static_assert(sizeof(NativeHeader) == 48, "Unexpected header padding");
+
+/** Native mesh block table entry */
+struct NativeBlockEntry {
+    /** Block type */
+    NativeBlockType type{};
+    /** Block encoding */
+    NativeEncoding encoding{};
+    /** Offset from the beginning of the file in bytes */
+    std::uint64_t offset{0};
+    /** Size of the block in bytes */
+    std::uint64_t size{0};
+};
+static_assert(sizeof(NativeBlockEntry) == 24, "Unexpected entry padding");
+
+/** A native mesh block staged for writing */
+struct NativeBlock {
+    /** Block type */
+    NativeBlockType type{};
+    /** Block encoding */
+    NativeEncoding encoding{};
+    /** Encoded block */
+    std::vector<std::byte> data;
+};
+
+/** Append the bytes of a trivially copyable value */
+template <typename T>
+void native_append(std::vector<std::byte>& buf, const T& val)
+{
+    const auto* p = reinterpret_cast<const std::byte*>(&val);
+    buf.insert(buf.end(), p, p + sizeof(T));
+}
+
+/** Read a trivially copyable value from a possibly unaligned address */
+template <typename T>
+auto native_load(const std::byte* p) -> T
+{
+    T val;
+    std::memcpy(&val, p, sizeof(T));
+    return val;
+}
+
+/** Whether the host stores values little-endian */
+inline auto host_is_little_endian() -> bool
+{
+    const std::uint16_t one{1};
+    return native_load<std::uint8_t>(
+               reinterpret_cast<const std::byte*>(&one)) == 1;
+}
+
+/** Read the i-th scalar of a float or double array as T */
+template <typename T>
+auto native_load_scalar(
+    const std::byte* p, std::size_t scalarSize, std::size_t i) -> T
+{
+    if (scalarSize == sizeof(float)) {
+        return static_cast<T>(native_load<float>(p + i * sizeof(float)));
+    }
+    return static_cast<T>(native_load<double>(p + i * sizeof(double)));
+}
+
+/** Throw a native format error */
+[[noreturn]] inline void native_error(const std::string& msg)
+{
+    throw std::runtime_error("Invalid native mesh file: " + msg);
+}
+
+/**
+ * Throw if the host is not little-endian. Native blocks are copied to and
+ * from memory without byte swapping.
+ */
+inline void native_check_host()
+{
+    if (not host_is_little_endian()) {
+        throw std::runtime_error(
+            "Native mesh format requires a little-endian host");
+    }
+}
+
+/** Compress a flat index buffer as delta-encoded LZ segments */
+template <typename Index>
+auto native_encode_indices(const std::vector<Index>& idxs)
+    -> std::vector<std::byte>
+{
+    auto numSegments = (idxs.size() + NATIVE_SEGMENT_SIZE - 1) /
+                       NATIVE_SEGMENT_SIZE;
+    std::vector<std::vector<std::byte>> segments(numSegments);
+    parallel_for(
+        0, numSegments,
+        [&](auto s) {
+            auto b = s * NATIVE_SEGMENT_SIZE;
+            auto n = std::min(NATIVE_SEGMENT_SIZE, idxs.size() - b);
+            std::vector<std::byte> deltas;
+            deltas.reserve(2 * n);
+            delta_encode(idxs.data() + b, n, deltas);
+            segments[s] = lz_compress(deltas.data(), deltas.size());
+            // Prefix with the decoded size so it can be decompressed in place
+            std::vector<std::byte> prefix;
+            native_append(prefix, static_cast<std::uint64_t>(deltas.size()));
+            segments[s].insert(
+                segments[s].begin(), prefix.begin(), prefix.end());
+        },
+        1);
+
+    // Segment table: count, then (offset, size) relative to the block start
+    std::vector<std::byte> buf;
+    native_append(buf, static_cast<std::uint64_t>(numSegments));
+    std::uint64_t offset{8 + 16 * numSegments};
+    for (const auto& s : segments) {
+        native_append(buf, offset);
+        native_append(buf, static_cast<std::uint64_t>(s.size()));
+        offset += s.size();
+    }
+    for (const auto& s : segments) {
+        buf.insert(buf.end(), s.begin(), s.end());
+    }
+    return buf;
+}
+
+/** Decode delta-encoded LZ segments into a flat index buffer */
+template <typename Index>
+void native_decode_indices(
+    const std::byte* data, std::size_t size, std::vector<Index>& idxs)
+{
+    if (size < 8) {
+        native_error("truncated index block");
+    }
+    auto numSegments = native_load<std::uint64_t>(data);
+    auto expected =
+        (idxs.size() + NATIVE_SEGMENT_SIZE - 1) / NATIVE_SEGMENT_SIZE;
+    if (numSegments != expected or size < 8 + 16 * numSegments) {
+        native_error("bad index segment table");
+    }
+    parallel_for(
+        0, numSegments,
+        [&](auto s) {
+            auto offset = native_load<std::uint64_t>(data + 8 + 16 * s);
+            auto segSize = native_load<std::uint64_t>(data + 16 + 16 * s);
+            if (segSize < 8 or offset > size or segSize > size - offset) {
+                native_error("bad index segment bounds");
+            }
+            const auto* seg = data + offset;
+            auto rawSize = native_load<std::uint64_t>(seg);
+            // Every varint is at least one byte and at most ten
+            auto b = s * NATIVE_SEGMENT_SIZE;
+            auto n = std::min(NATIVE_SEGMENT_SIZE, idxs.size() - b);
+            if (rawSize < n or rawSize > 10 * n) {
+                native_error("bad index segment size");
+            }
+            std::vector<std::byte> deltas(rawSize);
+            lz_decompress(seg + 8, segSize - 8, deltas.data(), deltas.size());
+            delta_decode(deltas.data(), deltas.size(), idxs.data() + b, n);
+        },
+        1);
+}
+
+/** Native mesh block table, indexed by block type */
+using NativeBlockTable = std::array<std::optional<NativeBlockEntry>, 6>;
+
+/** Validate a native mesh header */
+inline void native_check_header(const NativeHeader& header, std::size_t dims)
+{
+    if (header.magic != NATIVE_MAGIC) {
+        native_error("bad signature");
+    }
+    if (header.version != NATIVE_VERSION) {
+        native_error("unsupported version " + std::to_string(header.version));
+    }
+    if (header.dims != dims) {
+        native_error("dimension mismatch");
+    }
+    if ((header.scalarSize != 4 and header.scalarSize != 8) or
+        (header.indexSize != 4 and header.indexSize != 8)) {
+        native_error("bad scalar or index size");
+    }
+}
+
+/** Size of a native mesh block table in bytes */
+inline auto native_table_size(const NativeHeader& header) -> std::uint64_t
+{
+    return std::uint64_t{header.numBlocks} * sizeof(NativeBlockEntry);
+}
+
+/** Parse a native mesh block table and check its blocks' bounds */
+inline auto native_parse_table(
+    const std::byte* table, const NativeHeader& header, std::uint64_t fileSize)
+    -> NativeBlockTable
+{
+    NativeBlockTable blocks;
+    for (std::size_t b{0}; b < header.numBlocks; b++) {
+        auto entry =
+            native_load<NativeBlockEntry>(table + b * sizeof(NativeBlockEntry));
+        if (entry.offset > fileSize or entry.size > fileSize - entry.offset) {
+            native_error("block out of bounds");
+        }
+        auto type = static_cast<std::size_t>(entry.type);
+        // Skip unknown block types for forward compatibility
+        if (type < blocks.size()) {
+            blocks[type] = entry;
+        }
+    }
+    return blocks;
+}
+
+/**
+ * Multiply sizes read from a native mesh file. Results are limited to 2^63 so
+ * that small offsets can be added without overflow.
+ */
+inline auto native_mul(std::uint64_t a, std::uint64_t b) -> std::uint64_t
+{
+    constexpr auto limit = std::numeric_limits<std::uint64_t>::max() >> 1;
+    if (b != 0 and a > limit / b) {
+        native_error("size overflow");
+    }
+    return a * b;
+}
+
+/** Throw if a block doesn't have the expected size */
+inline void native_check_size(const NativeBlockEntry& e, std::uint64_t expected)
+{
+    if (e.size != expected) {
+        native_error("unexpected block size");
+    }
+}
+
+/**
+ * @brief Write a native binary mesh file
+ *
+ * The file consists of a fixed-size header, a block table, and a sequence of
+ * attribute blocks, each aligned to 64 bytes. Raw blocks are packed arrays
+ * which can be used in place after memory-mapping the file. Positions may
+ * optionally be quantized to 16 bits over the mesh bounding box, and face
+ * indices may optionally be delta-encoded and LZ-compressed in independent
+ * segments. Values are stored little-endian, so the format is only
+ * supported on little-endian hosts.
+ *
+ * @throws std::runtime_error If the host is not little-endian
+ * @throws std::invalid_argument If a face has fewer than 3 vertices
+ */
+template <class MeshType>
+void native_write(
+    const std::filesystem::path& path,
+    const MeshType& mesh,
+    const MeshWriteOptions& opts)
+{
+    using T = typename MeshType::value_type;
+    using Vertex = typename MeshType::Vertex;
+    static_assert(
+        std::is_floating_point_v<T>,
+        "Native mesh format requires a floating-point mesh");
+    constexpr auto Dims = MeshType::dims;
+    native_check_host();
+    const auto& vertices = mesh.vertices();
+    const auto& faces = mesh.faces();
+    const auto nv = vertices.size();
+    const auto nf = faces.size();
+
+    NativeHeader header;
+    header.numVertices = nv;
+    header.numFaces = nf;
+    header.dims = Dims;
+    header.scalarSize = sizeof(T);
+    header.indexSize = nv <= std::numeric_limits<std::uint32_t>::max()
+                           ? sizeof(std::uint32_t)
+                           : sizeof(std::uint64_t);
+    std::vector<NativeBlock> blocks;
+    // Block references must stay valid while the blocks are encoded
+    blocks.reserve(5);
+
+    // Positions
+    auto& pos = blocks.emplace_back();
+    pos.type = NativeBlockType::Positions;
+    if (opts.quantizePositions and nv > 0) {
+        pos.encoding = NativeEncoding::Quantized16;
+        std::array<double, Dims> lo;
+        std::array<double, Dims> step;
+        lo.fill(std::numeric_limits<double>::max());
+        step.fill(std::numeric_limits<double>::lowest());
+        for (const auto& v : vertices) {
+            for (std::size_t d{0}; d < Dims; d++) {
+                lo[d] = std::min(lo[d], static_cast<double>(v[d]));
+                step[d] = std::max(step[d], static_cast<double>(v[d]));
+            }
+        }
+        constexpr double maxQ{std::numeric_limits<std::uint16_t>::max()};
+        for (std::size_t d{0}; d < Dims; d++) {
+            step[d] = (step[d] - lo[d]) / maxQ;
+            native_append(pos.data, lo[d]);
+        }
+        for (std::size_t d{0}; d < Dims; d++) {
+            native_append(pos.data, step[d]);
+        }
+        auto prefix = pos.data.size();
+        pos.data.resize(prefix + nv * Dims * sizeof(std::uint16_t));
+        auto* out = pos.data.data() + prefix;
+        parallel_for(0, nv, [&](auto i) {
+            for (std::size_t d{0}; d < Dims; d++) {
+                double q{0};
+                if (step[d] > 0) {
+                    q = std::round((vertices[i][d] - lo[d]) / step[d]);
+                }
+                auto val = static_cast<std::uint16_t>(std::clamp(q, 0., maxQ));
+                auto o = (i * Dims + d) * sizeof(std::uint16_t);
+                std::memcpy(out + o, &val, sizeof(val));
+            }
+        });
+    } else {
+        pos.encoding = NativeEncoding::Raw;
+        pos.data.resize(nv * Dims * sizeof(T));
+        parallel_for(0, nv, [&](auto i) {
+            std::memcpy(
+                pos.data.data() + i * Dims * sizeof(T), vertices[i].data(),
+                Dims * sizeof(T));
+        });
+    }
+
+    // Normals, if every vertex has one
+    if constexpr (traits::has_normal_v<Vertex>) {
+        if (nv > 0 and std::all_of(
+                           vertices.begin(), vertices.end(),
+                           [](auto& v) { return v.normal.has_value(); })) {
+            auto& nrm = blocks.emplace_back();
+            nrm.type = NativeBlockType::Normals;
+            nrm.data.resize(nv * Dims * sizeof(T));
+            parallel_for(0, nv, [&](auto i) {
+                std::memcpy(
+                    nrm.data.data() + i * Dims * sizeof(T),
+                    vertices[i].normal->data(), Dims * sizeof(T));
+            });
+        }
+    }
+
+    // Colors as F32C3, if every vertex has a color
+    if constexpr (traits::has_color_v<Vertex>) {
+        if (nv > 0 and
+            std::all_of(vertices.begin(), vertices.end(), [](auto& v) {
+                return v.color.has_value();
+            })) {
+            auto& clr = blocks.emplace_back();
+            clr.type = NativeBlockType::Colors;
+            clr.data.resize(nv * 3 * sizeof(float));
+            parallel_for(0, nv, [&](auto i) {
+                auto c = vertex_color<Color::F32C3>(vertices[i].color);
+                std::memcpy(
+                    clr.data.data() + i * 3 * sizeof(float), c.data(),
+                    3 * sizeof(float));
+            });
+        }
+    }
+
+    // Face sizes, unless this is a triangle mesh
+    std::vector<std::size_t> corners(nf + 1, 0);
+    bool triangles{true};
+    for (std::size_t f{0}; f < nf; f++) {
+        if (faces[f].size() < 3) {
+            throw std::invalid_argument(
+                "Native mesh faces require at least 3 vertices");
+        }
+        triangles = triangles and faces[f].size() == 3;
+        corners[f + 1] = corners[f] + faces[f].size();
+    }
+    if (not triangles) {
+        auto& sizes = blocks.emplace_back();
+        sizes.type = NativeBlockType::FaceSizes;
+        for (const auto& f : faces) {
+            native_append(sizes.data, static_cast<std::uint32_t>(f.size()));
+        }
+    }
+
+    // Face indices
+    auto& idx = blocks.emplace_back();
+    idx.type = NativeBlockType::Indices;
+    auto encodeIndices = [&](auto tag) {
+        using Index = decltype(tag);
+        std::vector<Index> flat(corners.back());
+        parallel_for(0, nf, [&](auto f) {
+            std::copy(
+                faces[f].begin(), faces[f].end(), flat.begin() + corners[f]);
+        });
+        if (opts.compressIndices) {
+            idx.encoding = NativeEncoding::DeltaLZ;
+            idx.data = native_encode_indices(flat);
+        } else {
+            idx.encoding = NativeEncoding::Raw;
+            idx.data.resize(flat.size() * sizeof(Index));
+            std::memcpy(idx.data.data(), flat.data(), idx.data.size());
+        }
+    };
+    if (header.indexSize == sizeof(std::uint32_t)) {
+        encodeIndices(std::uint32_t{});
+    } else {
+        encodeIndices(std::uint64_t{});
+    }
+
+    // Block table
+    auto align = [](std::uint64_t v) {
+        return (v + NATIVE_ALIGNMENT - 1) / NATIVE_ALIGNMENT * NATIVE_ALIGNMENT;
+    };
+    header.numBlocks = static_cast<std::uint32_t>(blocks.size());
+    std::vector<NativeBlockEntry> table;
+    auto offset =
+        align(sizeof(NativeHeader) + blocks.size() * sizeof(NativeBlockEntry));
+    for (const auto& b : blocks) {
+        table.push_back({b.type, b.encoding, offset, b.data.size()});
+        offset = align(offset + b.data.size());
+    }
+
+    // Write
+    std::ofstream file(path, std::ios::binary);
+    if (not file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + path.string());
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(
+        reinterpret_cast<const char*>(table.data()),
+        static_cast<std::streamsize>(table.size() * sizeof(NativeBlockEntry)));
+    const std::array<char, NATIVE_ALIGNMENT> padding{};
+    for (std::size_t b{0}; b < blocks.size(); b++) {
+        auto pad = table[b].offset - static_cast<std::uint64_t>(file.tellp());
+        file.write(padding.data(), static_cast<std::streamsize>(pad));
+        file.write(
+            reinterpret_cast<const char*>(blocks[b].data.data()),
+            static_cast<std::streamsize>(blocks[b].data.size()));
+    }
+    file.close();
+    if (file.fail()) {
+        throw std::runtime_error("Failed to write file: " + path.string());
+    }
+}
+
+/**
+ * @brief Read a native binary mesh file
+ *
+ * The file is memory-mapped and raw blocks are copied directly into the
+ * mesh's vertex and face storage in parallel. Positions and normals stored
+ * with a different floating-point precision than the mesh are converted.
+ *
+ * @see native_write
+ * @throws std::runtime_error If the file is invalid or the host is not
+ * little-endian
+ */
+template <class MeshType>
+auto native_read(const std::filesystem::path& path) -> MeshType
+{
+    using T = typename MeshType::value_type;
+    using Vertex = typename MeshType::Vertex;
+    using Index = typename MeshType::Face::value_type;
+    constexpr auto Dims = MeshType::dims;
+    native_check_host();
+
+    const MemoryMap file(path);
+    const auto* data = file.data();
+
+    // Header
+    if (file.size() < sizeof(NativeHeader)) {
+        native_error("truncated header");
+    }
+    auto header = native_load<NativeHeader>(data);
+    native_check_header(header, Dims);
+    const auto nv = static_cast<std::size_t>(header.numVertices);
+    const auto nf = static_cast<std::size_t>(header.numFaces);
+    MeshType::checkCapacity(nv);
+
+    // Block table
+    auto tableEnd = sizeof(NativeHeader) + native_table_size(header);
+    if (file.size() < tableEnd) {
+        native_error("truncated block table");
+    }
+    auto blocks =
+        native_parse_table(data + sizeof(NativeHeader), header, file.size());
+    auto block = [&](NativeBlockType t) -> const auto&
+    {
+        return blocks[static_cast<std::size_t>(t)];
+    };
+
+    // Check the vertex and face counts against the blocks which store them
+    // before allocating
+    const auto& pos = block(NativeBlockType::Positions);
+    if (not pos) {
+        native_error("missing positions");
+    }
+    if (pos->encoding == NativeEncoding::Raw) {
+        native_check_size(*pos, native_mul(nv, Dims * header.scalarSize));
+    } else if (pos->encoding == NativeEncoding::Quantized16) {
+        native_check_size(
+            *pos, 2 * Dims * sizeof(double) + native_mul(nv, Dims * 2));
+    } else {
+        native_error("bad position encoding");
+    }
+    const auto& sizes = block(NativeBlockType::FaceSizes);
+    if (sizes) {
+        native_check_size(*sizes, native_mul(nf, sizeof(std::uint32_t)));
+    }
+    const auto& idx = block(NativeBlockType::Indices);
+    if (not idx and nf > 0) {
+        native_error("missing face indices");
+    }
+    std::uint64_t maxCorners{0};
+    if (idx and idx->encoding == NativeEncoding::Raw) {
+        maxCorners = idx->size / header.indexSize;
+    } else if (idx and idx->encoding == NativeEncoding::DeltaLZ) {
+        maxCorners = native_mul(idx->size, NATIVE_MAX_LZ_RATIO);
+    } else if (idx) {
+        native_error("bad index encoding");
+    }
+    if (native_mul(nf, 3) > maxCorners) {
+        native_error("too many faces");
+    }
+
+    MeshType mesh;
+    auto& vertices = mesh.vertices();
+    auto& faces = mesh.faces();
+    vertices.resize(nv);
+    faces.resize(nf);
+
+    // Positions
+    const auto* posData = data + pos->offset;
+    if (pos->encoding == NativeEncoding::Raw) {
+        parallel_for(0, nv, [&](auto i) {
+            if (header.scalarSize == sizeof(T)) {
+                std::memcpy(
+                    vertices[i].data(), posData + i * Dims * sizeof(T),
+                    Dims * sizeof(T));
+                return;
+            }
+            for (std::size_t d{0}; d < Dims; d++) {
+                vertices[i][d] = native_load_scalar<T>(
+                    posData, header.scalarSize, i * Dims + d);
+            }
+        });
+    } else {
+        std::array<double, Dims> lo;
+        std::array<double, Dims> step;
+        for (std::size_t d{0}; d < Dims; d++) {
+            lo[d] = native_load<double>(posData + d * sizeof(double));
+            step[d] =
+                native_load<double>(posData + (Dims + d) * sizeof(double));
+        }
+        const auto* q = posData + 2 * Dims * sizeof(double);
+        parallel_for(0, nv, [&](auto i) {
+            for (std::size_t d{0}; d < Dims; d++) {
+                auto val = native_load<std::uint16_t>(q + 2 * (i * Dims + d));
+                vertices[i][d] = static_cast<T>(lo[d] + val * step[d]);
+            }
+        });
+    }
+
+    // Normals
+    if constexpr (traits::has_normal_v<Vertex>) {
+        if (const auto& nrm = block(NativeBlockType::Normals); nrm) {
+            native_check_size(
+                *nrm, native_mul(nv, Dims * header.scalarSize));
+            const auto* nrmData = data + nrm->offset;
+            parallel_for(0, nv, [&](auto i) {
+                Vec<T, Dims> n;
+                for (std::size_t d{0}; d < Dims; d++) {
+                    n[d] = native_load_scalar<T>(
+                        nrmData, header.scalarSize, i * Dims + d);
+                }
+                vertices[i].normal = n;
+            });
+        }
+    }
+
+    // Colors
+    if constexpr (traits::has_color_v<Vertex>) {
+        if (const auto& clr = block(NativeBlockType::Colors); clr) {
+            native_check_size(*clr, native_mul(nv, 3 * sizeof(float)));
+            const auto* clrData = data + clr->offset;
+            parallel_for(0, nv, [&](auto i) {
+                Color::F32C3 c;
+                std::memcpy(
+                    c.data(), clrData + i * 3 * sizeof(float),
+                    3 * sizeof(float));
+                vertices[i].color = c;
+            });
+        }
+    }
+
+    // Face sizes
+    std::vector<std::size_t> corners(nf + 1, 0);
+    if (sizes) {
+        const auto* sizeData = data + sizes->offset;
+        for (std::size_t f{0}; f < nf; f++) {
+            auto s = native_load<std::uint32_t>(sizeData + 4 * f);
+            if (s < 3) {
+                native_error("bad face size");
+            }
+            corners[f + 1] = corners[f] + s;
+            if (corners[f + 1] > maxCorners) {
+                native_error("too many face indices");
+            }
+        }
+    } else {
+        for (std::size_t f{0}; f < nf; f++) {
+            corners[f + 1] = corners[f] + 3;
+        }
+    }
+
+    // Face indices
+    auto decodeIndices = [&](auto tag) {
+        using FileIndex = decltype(tag);
+        const auto* idxData = data + idx->offset;
+        const bool raw = idx->encoding == NativeEncoding::Raw;
+        std::vector<FileIndex> flat;
+        if (raw) {
+            native_check_size(*idx, corners.back() * sizeof(FileIndex));
+        } else {
+            flat.resize(corners.back());
+            native_decode_indices(idxData, idx->size, flat);
+        }
+        parallel_for(0, nf, [&](auto f) {
+            auto& face = faces[f];
+            face.resize(corners[f + 1] - corners[f]);
+            for (std::size_t c{0}; c < face.size(); c++) {
+                auto corner = corners[f] + c;
+                auto v = raw ? native_load<FileIndex>(
+                                   idxData + corner * sizeof(FileIndex))
+                             : flat[corner];
+                if (v >= nv) {
+                    native_error("face index out of range");
+                }
+                face[c] = static_cast<Index>(v);
+            }
+        });
+    };
+    if (nf > 0) {
+        if (header.indexSize == sizeof(std::uint32_t)) {
+            decodeIndices(std::uint32_t{});
+        } else {
+            decodeIndices(std::uint64_t{});
+        }
+    }
+
+    return mesh;
+}
+
+/** Number of bytes buffered by PlyReader */
+constexpr std::size_t PLY_BUFFER_SIZE{1 << 20};
+
+/** PLY body encodings */
+enum class PlyFormat { Ascii, BinaryLittleEndian, BinaryBigEndian };
+
+/** PLY scalar types */
+enum class PlyType {
+    Int8,
+    UInt8,
+    Int16,
+    UInt16,
+    Int32,
+    UInt32,
+    Float32,
+    Float64
+};
+
+/** Size of each PlyType in bytes */
+constexpr std::array<std::size_t, 8> PLY_TYPE_SIZES{1, 1, 2, 2, 4, 4, 4, 8};
+
+/** PLY element property */
+struct PlyProperty {
+    /** Property name */
+    std::string name;
+    /** Value type */
+    PlyType type{PlyType::Float32};
+    /** Whether this is a list property */
+    bool isList{false};
+    /** List length type */
+    PlyType countType{PlyType::UInt8};
+};
+
+/** PLY element declaration */
+struct PlyElement {
+    /** Element name */
+    std::string name;
+    /** Number of instances */
+    std::uint64_t count{0};
+    /** Properties in file order */
+    std::vector<PlyProperty> properties;
+
+    /** Index of the named property */
+    [[nodiscard]] auto find(std::string_view n) const
+        -> std::optional<std::size_t>
+    {
+        for (std::size_t i{0}; i < properties.size(); i++) {
+            if (properties[i].name == n) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /** Binary size of one instance in bytes, or 0 if it contains lists */
+    [[nodiscard]] auto stride() const -> std::size_t
+    {
+        std::size_t s{0};
+        for (const auto& p : properties) {
+            if (p.isList) {
+                return 0;
+            }
+            s += PLY_TYPE_SIZES[static_cast<std::size_t>(p.type)];
+        }
+        return s;
+    }
+};
+
+/** PLY file header */
+struct PlyHeader {
+    /** Body encoding */
+    PlyFormat format{PlyFormat::Ascii};
+    /** Elements in file order */
+    std::vector<PlyElement> elements;
+    /** Offset of the body from the beginning of the file in bytes */
+    std::uint64_t dataOffset{0};
+
+    /** Index of the named element */
+    [[nodiscard]] auto find(std::string_view n) const
+        -> std::optional<std::size_t>
+    {
+        for (std::size_t i{0}; i < elements.size(); i++) {
+            if (elements[i].name == n) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+};
+
+/** Throw a PLY format error */
+[[noreturn]] inline void ply_error(const std::string& msg)
+{
+    throw std::runtime_error("Invalid PLY file: " + msg);
+}
+
+/** Parse a PLY type name */
+inline auto ply_parse_type(std::string_view name) -> PlyType
+{
+    using P = std::pair<std::string_view, PlyType>;
+    constexpr std::array<P, 16> names{
+        {{"char", PlyType::Int8},
+         {"int8", PlyType::Int8},
+         {"uchar", PlyType::UInt8},
+         {"uint8", PlyType::UInt8},
+         {"short", PlyType::Int16},
+         {"int16", PlyType::Int16},
+         {"ushort", PlyType::UInt16},
+         {"uint16", PlyType::UInt16},
+         {"int", PlyType::Int32},
+         {"int32", PlyType::Int32},
+         {"uint", PlyType::UInt32},
+         {"uint32", PlyType::UInt32},
+         {"float", PlyType::Float32},
+         {"float32", PlyType::Float32},
+         {"double", PlyType::Float64},
+         {"float64", PlyType::Float64}}};
+    for (const auto& [n, t] : names) {
+        if (n == name) {
+            return t;
+        }
+    }
+    ply_error("unknown type " + std::string(name));
+}
+
+/**
+ * Parse a PLY header. On return, the stream is positioned at the beginning of
+ * the body.
+ */
+inline auto ply_read_header(std::istream& is) -> PlyHeader
+{
+    std::string line;
+    if (not std::getline(is, line) or trim(line) != "ply") {
+        ply_error("bad signature");
+    }
+    PlyHeader header;
+    bool hasFormat{false};
+    while (std::getline(is, line)) {
+        auto tokens = split(line, ' ', '\t', '\r');
+        if (tokens.empty() or tokens[0] == "comment" or
+            tokens[0] == "obj_info") {
+            continue;
+        }
+        const auto& key = tokens[0];
+        if (key == "end_header") {
+            if (not hasFormat) {
+                ply_error("missing format");
+            }
+            header.dataOffset = static_cast<std::uint64_t>(is.tellg());
+            return header;
+        }
+        if (key == "format" and tokens.size() == 3) {
+            if (tokens[1] == "ascii") {
+                header.format = PlyFormat::Ascii;
+            } else if (tokens[1] == "binary_little_endian") {
+                header.format = PlyFormat::BinaryLittleEndian;
+            } else if (tokens[1] == "binary_big_endian") {
+                header.format = PlyFormat::BinaryBigEndian;
+            } else {
+                ply_error("unknown format " + std::string(tokens[1]));
+            }
+            hasFormat = true;
+        } else if (key == "element" and tokens.size() == 3) {
+            auto& e = header.elements.emplace_back();
+            e.name = tokens[1];
+            e.count = to_numeric<std::uint64_t>(tokens[2]);
+        } else if (key == "property" and not header.elements.empty()) {
+            PlyProperty p;
+            if (tokens.size() == 5 and tokens[1] == "list") {
+                p.isList = true;
+                p.countType = ply_parse_type(tokens[2]);
+                p.type = ply_parse_type(tokens[3]);
+                p.name = tokens[4];
+            } else if (tokens.size() == 3) {
+                p.type = ply_parse_type(tokens[1]);
+                p.name = tokens[2];
+            } else {
+                ply_error("bad header line: " + line);
+            }
+            header.elements.back().properties.emplace_back(std::move(p));
+        } else {
+            ply_error("bad header line: " + line);
+        }
+    }
+    ply_error("missing end_header");
+}
+
+/**
+ * Read the header of a PLY file. Element counts are checked against the size
+ * of the body so that they can be used to allocate storage: Every property
+ * of every element instance takes at least one byte.
+ */
+inline auto ply_read_header(const std::filesystem::path& path) -> PlyHeader
+{
+    std::ifstream file(path, std::ios::binary);
+    if (not file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + path.string());
+    }
+    auto header = ply_read_header(file);
+    auto remaining = std::filesystem::file_size(path) - header.dataOffset;
+    for (const auto& e : header.elements) {
+        auto minSize = std::max<std::uint64_t>(e.properties.size(), 1);
+        if (e.count > remaining / minSize) {
+            ply_error("element count exceeds file size");
+        }
+        remaining -= e.count * minSize;
+    }
+    return header;
+}
+
+/**
+ * Buffered sequential reader for the body of a PLY file. Values of any type
+ * and encoding are returned as double, which represents every PLY type
+ * exactly.
+ */
+class PlyReader
+{
+public:
+    /** Open a file and seek to the beginning of its body */
+    PlyReader(const std::filesystem::path& path, const PlyHeader& header)
+        : file_(path, std::ios::binary),
+          format_{header.format},
+          swap_{
+              format_ != PlyFormat::Ascii and
+              (format_ == PlyFormat::BinaryBigEndian) ==
+                  host_is_little_endian()}
+    {
+        if (not file_.is_open()) {
+            throw std::runtime_error("Cannot open file: " + path.string());
+        }
+        file_.seekg(static_cast<std::streamoff>(header.dataOffset));
+    }
+
+    /** Read one value */
+    auto read(PlyType type) -> double
+    {
+        if (format_ == PlyFormat::Ascii) {
+            auto tok = token();
+            try {
+                return to_numeric<double>(tok);
+            } catch (const std::exception&) {
+                ply_error("bad value " + std::string(tok));
+            }
+        }
+        const auto size = PLY_TYPE_SIZES[static_cast<std::size_t>(type)];
+        std::array<char, 8> b;
+        std::memcpy(b.data(), next(size), size);
+        if (swap_) {
+            std::reverse(b.begin(), b.begin() + size);
+        }
+        switch (type) {
+            case PlyType::Int8:
+                return native_load<std::int8_t>(bytes(b));
+            case PlyType::UInt8:
+                return native_load<std::uint8_t>(bytes(b));
+            case PlyType::Int16:
+                return native_load<std::int16_t>(bytes(b));
+            case PlyType::UInt16:
+                return native_load<std::uint16_t>(bytes(b));
+            case PlyType::Int32:
+                return native_load<std::int32_t>(bytes(b));
+            case PlyType::UInt32:
+                return native_load<std::uint32_t>(bytes(b));
+            case PlyType::Float32:
+                return native_load<float>(bytes(b));
+            case PlyType::Float64:
+                return native_load<double>(bytes(b));
+        }
+        return 0;
+    }
+
+    /** Read the length of a list property */
+    auto readCount(const PlyProperty& p) -> std::size_t
+    {
+        auto n = read(p.countType);
+        if (not(n >= 0) or n != std::floor(n)) {
+            ply_error("bad list length");
+        }
+        return static_cast<std::size_t>(n);
+    }
+
+    /** Skip one property value */
+    void skip(const PlyProperty& p)
+    {
+        auto n = p.isList ? readCount(p) : 1;
+        for (std::size_t i{0}; i < n; i++) {
+            if (format_ == PlyFormat::Ascii) {
+                token();
+            } else {
+                next(PLY_TYPE_SIZES[static_cast<std::size_t>(p.type)]);
+            }
+        }
+    }
+
+    /** Skip `n` instances of an element */
+    void skip(const PlyElement& e, std::uint64_t n)
+    {
+        auto stride = e.stride();
+        if (format_ == PlyFormat::Ascii or stride == 0) {
+            for (std::uint64_t i{0}; i < n; i++) {
+                for (const auto& p : e.properties) {
+                    skip(p);
+                }
+            }
+            return;
+        }
+        // Fixed-size binary elements are skipped with a seek
+        auto bytes = n * stride;
+        if (bytes <= end_ - pos_) {
+            pos_ += static_cast<std::size_t>(bytes);
+            return;
+        }
+        file_.seekg(
+            static_cast<std::streamoff>(bytes - (end_ - pos_)), std::ios::cur);
+        pos_ = end_ = 0;
+    }
+
+private:
+    /** View a value buffer as bytes */
+    static auto bytes(const std::array<char, 8>& b) -> const std::byte*
+    {
+        return reinterpret_cast<const std::byte*>(b.data());
+    }
+
+    /** Refill the buffer, keeping unread bytes. Returns false at EOF. */
+    auto fill() -> bool
+    {
+        if (buf_.empty()) {
+            buf_.resize(PLY_BUFFER_SIZE);
+        }
+        std::memmove(buf_.data(), buf_.data() + pos_, end_ - pos_);
+        end_ -= pos_;
+        pos_ = 0;
+        file_.read(
+            buf_.data() + end_,
+            static_cast<std::streamsize>(PLY_BUFFER_SIZE - end_));
+        auto n = static_cast<std::size_t>(file_.gcount());
+        end_ += n;
+        return n > 0;
+    }
+
+    /** Consume `n` bytes */
+    auto next(std::size_t n) -> const char*
+    {
+        while (end_ - pos_ < n) {
+            if (not fill()) {
+                ply_error("unexpected end of file");
+            }
+        }
+        const auto* p = buf_.data() + pos_;
+        pos_ += n;
+        return p;
+    }
+
+    /** Consume the next whitespace-delimited token */
+    auto token() -> std::string_view
+    {
+        auto isSpace = [](char c) {
+            return c == ' ' or c == '\t' or c == '\r' or c == '\n';
+        };
+        while (true) {
+            while (pos_ < end_ and isSpace(buf_[pos_])) {
+                pos_++;
+            }
+            if (pos_ < end_ or not fill()) {
+                break;
+            }
+        }
+        std::size_t len{0};
+        while (true) {
+            while (pos_ + len < end_ and not isSpace(buf_[pos_ + len])) {
+                len++;
+            }
+            if (pos_ + len < end_ or not fill()) {
+                break;
+            }
+        }
+        if (len == 0) {
+            ply_error("unexpected end of file");
+        }
+        std::string_view tok(buf_.data() + pos_, len);
+        pos_ += len;
+        return tok;
+    }
+
+    /** Input file */
+    std::ifstream file_;
+    /** Body encoding */
+    PlyFormat format_;
+    /** Whether the body's byte order differs from the host's */
+    bool swap_;
+    /** Read buffer */
+    std::vector<char> buf_;
+    /** Position of the next unread byte in the buffer */
+    std::size_t pos_{0};
+    /** End of the valid bytes in the buffer */
+    std::size_t end_{0};
+};
+
+/** Mapping from PLY vertex properties to vertex attributes */
+struct PlyVertexLayout {
+    /** Marker for properties which aren't loaded */
+    static constexpr std::size_t NONE{std::numeric_limits<std::size_t>::max()};
+    /**
+     * Attribute of each property: `d` for position `d`, `3 + d` for normal
+     * `d`, `6 + c` for color channel `c`, or NONE
+     */
+    std::vector<std::size_t> roles;
+    /** Whether the element has a complete normal */
+    bool hasNormals{false};
+    /** Whether the element has a complete RGB color */
+    bool hasColors{false};
+    /** Type of the color properties */
+    PlyType colorType{PlyType::UInt8};
+};
+
+/** Determine the layout of a PLY vertex element */
+template <std::size_t Dims>
+auto ply_vertex_layout(const PlyElement& e) -> PlyVertexLayout
+{
+    static_assert(Dims >= 2 and Dims <= 3, "PLY only supports 2D and 3D");
+    constexpr std::array<std::array<std::string_view, 3>, 3> names{
+        {{"x", "y", "z"}, {"nx", "ny", "nz"}, {"red", "green", "blue"}}};
+    constexpr std::array<std::size_t, 3> required{Dims, Dims, 3};
+    PlyVertexLayout layout;
+    layout.roles.assign(e.properties.size(), PlyVertexLayout::NONE);
+    std::array<bool, 3> complete{true, true, true};
+    for (std::size_t a{0}; a < 3; a++) {
+        for (std::size_t c{0}; c < required[a]; c++) {
+            auto p = e.find(names[a][c]);
+            if (not p or e.properties[*p].isList) {
+                complete[a] = false;
+                continue;
+            }
+            layout.roles[*p] = 3 * a + c;
+            if (a == 2) {
+                layout.colorType = e.properties[*p].type;
+            }
+        }
+    }
+    if (not complete[0]) {
+        ply_error("missing vertex positions");
+    }
+    layout.hasNormals = complete[1];
+    layout.hasColors = complete[2];
+    return layout;
+}
+
+/**
+ * Read the properties of one vertex, indexed by their PlyVertexLayout role.
+ * Unused properties are skipped.
+ */
+inline auto ply_read_vertex_values(
+    PlyReader& reader, const PlyElement& e, const PlyVertexLayout& layout)
+    -> std::array<double, 9>
+{
+    std::array<double, 9> vals{};
+    for (std::size_t i{0}; i < e.properties.size(); i++) {
+        const auto& p = e.properties[i];
+        if (layout.roles[i] == PlyVertexLayout::NONE) {
+            reader.skip(p);
+        } else {
+            vals[layout.roles[i]] = reader.read(p.type);
+        }
+    }
+    return vals;
+}
+
+/** Read one vertex */
+template <class Vertex, std::size_t Dims>
+void ply_read_vertex(
+    PlyReader& reader,
+    const PlyElement& e,
+    const PlyVertexLayout& layout,
+    Vertex& vertex)
+{
+    using T = std::decay_t<decltype(vertex[0])>;
+    auto vals = ply_read_vertex_values(reader, e, layout);
+    for (std::size_t d{0}; d < Dims; d++) {
+        vertex[d] = static_cast<T>(vals[d]);
+    }
+    if constexpr (traits::has_normal_v<Vertex>) {
+        if (layout.hasNormals) {
+            Vec<T, Dims> n;
+            for (std::size_t d{0}; d < Dims; d++) {
+                n[d] = static_cast<T>(vals[3 + d]);
+            }
+            vertex.normal = n;
+        }
+    }
+    if constexpr (traits::has_color_v<Vertex>) {
+        if (layout.hasColors) {
+            auto setColor = [&](auto c) {
+                using C = typename decltype(c)::value_type;
+                for (std::size_t i{0}; i < 3; i++) {
+                    c[i] = static_cast<C>(vals[6 + i]);
+                }
+                vertex.color = c;
+            };
+            if (layout.colorType == PlyType::Float32 or
+                layout.colorType == PlyType::Float64) {
+                setColor(Color::F32C3{});
+            } else if (layout.colorType == PlyType::UInt16) {
+                setColor(Color::U16C3{});
+            } else {
+                setColor(Color::U8C3{});
+            }
+        }
+    }
+}
+
+/** Find the vertex index list of a PLY face element */
+inline auto ply_face_indices(const PlyElement& e) -> std::size_t
+{
+    auto p = e.find("vertex_indices");
+    if (not p) {
+        p = e.find("vertex_index");
+    }
+    if (not p or not e.properties[*p].isList) {
+        ply_error("missing face vertex indices");
+    }
+    return *p;
+}
+
+/** Read one face, checking its indices against the number of vertices */
+template <class Face>
+void ply_read_face(
+    PlyReader& reader,
+    const PlyElement& e,
+    std::size_t indicesProp,
+    std::uint64_t numVertices,
+    Face& face)
+{
+    using Index = typename Face::value_type;
+    for (std::size_t i{0}; i < e.properties.size(); i++) {
+        const auto& p = e.properties[i];
+        if (i != indicesProp) {
+            reader.skip(p);
+            continue;
+        }
+        face.resize(reader.readCount(p));
+        for (auto& idx : face) {
+            auto v = reader.read(p.type);
+            if (not(v >= 0) or v >= static_cast<double>(numVertices)) {
+                ply_error("face index out of range");
+            }
+            idx = static_cast<Index>(v);
+        }
+    }
+}
+
+/** PLY type name of a floating-point type */
+template <typename T>
+constexpr auto ply_type_name() -> std::string_view
+{
+    static_assert(std::is_floating_point_v<T>, "Unsupported PLY type");
+    return sizeof(T) == sizeof(float) ? "float" : "double";
+}
+
+/**
+ * Write a binary little-endian PLY header. If `width` is non-zero, the
+ * element counts are padded with spaces to `width` characters so that the
+ * header can be rewritten in place once the final counts are known.
+ */
+template <typename T, std::size_t Dims>
+void ply_write_header(
+    std::ostream& os,
+    std::uint64_t numVertices,
+    std::uint64_t numFaces,
+    bool normals,
+    bool colors,
+    std::size_t width = 0)
+{
+    static_assert(Dims >= 2 and Dims <= 3, "PLY only supports 2D and 3D");
+    constexpr std::array<std::string_view, 3> axes{"x", "y", "z"};
+    auto count = [&](std::uint64_t n) {
+        auto s = std::to_string(n);
+        if (s.size() < width) {
+            s.append(width - s.size(), ' ');
+        }
+        return s;
+    };
+    std::string h{"ply\nformat binary_little_endian 1.0\n"};
+    h += "element vertex " + count(numVertices) + "\n";
+    for (std::size_t d{0}; d < Dims; d++) {
+        h += "property ";
+        h += ply_type_name<T>();
+        h += " ";
+        h += axes[d];
+        h += "\n";
+    }
+    if (normals) {
+        for (std::size_t d{0}; d < Dims; d++) {
+            h += "property ";
+            h += ply_type_name<T>();
+            h += " n";
+            h += axes[d];
+            h += "\n";
+        }
+    }
+    if (colors) {
+        h += "property uchar red\nproperty uchar green\nproperty uchar blue\n";
+    }
+    h += "element face " + count(numFaces) + "\n";
+    h += "property list uchar uint vertex_indices\nend_header\n";
+    os.write(h.data(), static_cast<std::streamsize>(h.size()));
+}
+
+/** Append a binary value in little-endian byte order */
+template <typename V>
+void ply_append_value(std::string& buf, const V& val)
+{
+    const auto* p = reinterpret_cast<const char*>(&val);
+    const auto offset = buf.size();
+    buf.append(p, sizeof(val));
+    if (not host_is_little_endian()) {
+        std::reverse(buf.begin() + offset, buf.end());
+    }
+}
+
+/** Append one binary vertex record */
+template <class Vertex>
+void ply_append_vertex(
+    std::string& buf, const Vertex& v, bool normals, bool colors)
+{
+    auto append = [&](const auto& val) { ply_append_value(buf, val); };
+    for (const auto& c : v) {
+        append(c);
+    }
+    if constexpr (traits::has_normal_v<Vertex>) {
+        if (normals) {
+            if (not v.normal) {
+                throw std::runtime_error("Vertex is missing a normal");
+            }
+            for (const auto& c : *v.normal) {
+                append(c);
+            }
+        }
+    }
+    if constexpr (traits::has_color_v<Vertex>) {
+        if (colors) {
+            for (const auto& c : vertex_color<Color::U8C3>(v.color)) {
+                append(c);
+            }
+        }
+    }
+}
+
+/** Append one binary face record */
+template <class Face>
+void ply_append_face(std::string& buf, const Face& face)
+{
+    if (face.size() > std::numeric_limits<std::uint8_t>::max()) {
+        throw std::overflow_error("PLY faces are limited to 255 vertices");
+    }
+    buf += static_cast<char>(face.size());
+    for (const auto& idx : face) {
+        if (idx > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::overflow_error("PLY vertex index exceeds 32 bits");
+        }
+        ply_append_value(buf, static_cast<std::uint32_t>(idx));
+    }
+}
+
+/**
+ * @brief Read a PLY file
+ *
+ * ASCII and binary (either byte order) files are supported. Vertex positions,
+ * normals (`nx`, `ny`, `nz`), and RGB colors are loaded, along with faces
+ * from the `vertex_indices` list property. Unrecognized elements and
+ * properties are skipped. Integer colors are stored as U8C3 (or U16C3 for
+ * 16-bit properties) and floating-point colors as F32C3.
+ */
+template <class MeshType>
+auto ply_read(const std::filesystem::path& path) -> MeshType
+{
+    using Vertex = typename MeshType::Vertex;
+    constexpr auto Dims = MeshType::dims;
+    auto header = ply_read_header(path);
+    auto vIdx = header.find("vertex");
+    if (not vIdx) {
+        ply_error("missing vertex element");
+    }
+    const auto& vElem = header.elements[*vIdx];
+    auto layout = ply_vertex_layout<Dims>(vElem);
+    MeshType::checkCapacity(vElem.count);
+
+    MeshType mesh;
+    PlyReader reader(path, header);
+    for (const auto& e : header.elements) {
+        if (&e == &vElem) {
+            auto& vertices = mesh.vertices();
+            vertices.resize(static_cast<std::size_t>(e.count));
+            for (auto& v : vertices) {
+                ply_read_vertex<Vertex, Dims>(reader, e, layout, v);
+            }
+        } else if (e.name == "face") {
+            auto prop = ply_face_indices(e);
+            auto& faces = mesh.faces();
+            faces.resize(static_cast<std::size_t>(e.count));
+            for (auto& f : faces) {
+                ply_read_face(reader, e, prop, vElem.count, f);
+            }
+        } else {
+            reader.skip(e, e.count);
+        }
+    }
+    return mesh;
+}
+
+/**
+ * @brief Write a binary little-endian PLY file
+ *
+ * Vertex normals are written when every vertex has a normal. Vertex colors
+ * are converted to 8-bit RGB and written when every vertex has a color.
+ * Records are formatted in parallel blocks.
+ *
+ * @throws std::overflow_error If the mesh has more than 2^32 vertices or a
+ * face has more than 255 vertices
+ */
+template <class MeshType>
+void ply_write(const std::filesystem::path& path, const MeshType& mesh)
+{
+    using T = typename MeshType::value_type;
+    using Vertex = typename MeshType::Vertex;
+    const auto& vertices = mesh.vertices();
+    const auto& faces = mesh.faces();
+    if (vertices.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::overflow_error("Too many vertices for PLY");
+    }
+
+    bool colors{false};
+    bool normals{false};
+    if constexpr (traits::has_color_v<Vertex>) {
+        colors = not vertices.empty() and
+                 std::all_of(vertices.begin(), vertices.end(), [](auto& v) {
+                     return v.color.has_value();
+                 });
+    }
+    if constexpr (traits::has_normal_v<Vertex>) {
+        normals = not vertices.empty() and
+                  std::all_of(vertices.begin(), vertices.end(), [](auto& v) {
+                      return v.normal.has_value();
+                  });
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    if (not file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + path.string());
+    }
+    ply_write_header<T, MeshType::dims>(
+        file, vertices.size(), faces.size(), normals, colors);
+    write_records(file, vertices.size(), [&](auto i, std::string& buf) {
+        ply_append_vertex(buf, vertices[i], normals, colors);
+    });
+    write_records(file, faces.size(), [&](auto i, std::string& buf) {
+        ply_append_face(buf, faces[i]);
+    });
+    file.close();
+    if (file.fail()) {
+        throw std::runtime_error("Failed to write file: " + path.string());
+    }
+}
+}  // namespace detail
+
+/**
+ * @brief Read a Mesh from disk
+ *
+ * The file format is determined by the file extension. Supported formats:
+ *   - OBJ (`.obj`)
+ *   - PLY (`.ply`)
+ *   - Native binary mesh (`.elmesh`)
+ *
+ * ```{.cpp}
+ * auto mesh = read_mesh<Mesh3f>("scan.obj");
+ * ```
+ *
+ * @throws std::invalid_argument If the file format is not supported or does
+ * not support the mesh's dimensions
+ * @throws std::runtime_error If the file cannot be read or parsed
+ * @throws std::overflow_error If the file has more vertices than can be
+ * indexed by the mesh's index type
+ */
+template <class MeshType>
+auto read_mesh(const std::filesystem::path& path) -> MeshType
+{
+    constexpr auto Dims = MeshType::dims;
+    if (is_file_type(path, "obj")) {
+        if constexpr (Dims == 3) {
+            return detail::obj_read<MeshType>(path);
+        } else {
+            throw std::invalid_argument("OBJ only supports 3D meshes");
+        }
+    }
+    if (is_file_type(path, "ply")) {
+        if constexpr (Dims == 2 or Dims == 3) {
+            return detail::ply_read<MeshType>(path);
+        } else {
+            throw std::invalid_argument("PLY only supports 2D and 3D meshes");
+        }
+    }
+    if (is_file_type(path, "elmesh")) {
+        return detail::native_read<MeshType>(path);
+    }
+    auto ext = path.extension().string();
+    throw std::invalid_argument("Unsupported file type: " + ext);
+}
+
+/**
+ * @brief Write a Mesh to disk
+ *
+ * The file format is determined by the file extension. Supported formats:
+ *   - OBJ (`.obj`)
+ *   - PLY (`.ply`, binary little-endian)
+ *   - Native binary mesh (`.elmesh`)
+ *
+ * The native format is intended as a fast-loading cache for processed meshes.
+ * Its attribute blocks are aligned so that they can be used directly from a
+ * memory-mapped file. See MeshWriteOptions for its optional encodings.
+ *
+ * ```{.cpp}
+ * MeshWriteOptions opts;
+ * opts.compressIndices = true;
+ * write_mesh("cache.elmesh", mesh, opts);
+ * ```
+ *
+ * @throws std::invalid_argument If the file format is not supported or does
+ * not support the mesh's dimensions
+ * @throws std::runtime_error If the file cannot be written
+ */
+template <class MeshType>
+void write_mesh(
+    const std::filesystem::path& path,
+    const MeshType& mesh,
+    const MeshWriteOptions& opts = {})
+{
+    constexpr auto Dims = MeshType::dims;
+    if (is_file_type(path, "obj")) {
+        if constexpr (Dims == 3) {
+            detail::obj_write(path, mesh);
+        } else {
+            throw std::invalid_argument("OBJ only supports 3D meshes");
+        }
+    } else if (is_file_type(path, "ply")) {
+        if constexpr (Dims == 2 or Dims == 3) {
+            detail::ply_write(path, mesh);
+        } else {
+            throw std::invalid_argument("PLY only supports 2D and 3D meshes");
+        }
+    } else if (is_file_type(path, "elmesh")) {
+        detail::native_write(path, mesh, opts);
+    } else {
+        auto ext = path.extension().string();
+        throw std::invalid_argument("Unsupported file type: " + ext);
+    }
+}
+
+}  // namespace educelab
@@ -0,0 +1,1369 @@
+#pragma once
+
+/** @file */
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "educelab/core/io/MeshIO.hpp"
+#include "educelab/core/types/Color.hpp"
+#include "educelab/core/types/Mat.hpp"
+#include "educelab/core/types/Vec.hpp"
+#include "educelab/core/utils/Compression.hpp"
+#include "educelab/core/utils/Filesystem.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+
+namespace educelab
+{
+
+/** @brief Vertex attributes carried by a mesh stream */
+struct MeshStreamAttributes {
+    /** Vertex normals */
+    bool normals{false};
+    /** Vertex colors */
+    bool colors{false};
+};
+
+/** @brief Options for the streaming mesh operations */
+struct MeshStreamOptions {
+    /** Maximum number of vertices or faces held in memory at once */
+    std::size_t chunkSize{1 << 16};
+    /**
+     * Output file options. Quantized positions are not supported when
+     * streaming.
+     */
+    MeshWriteOptions write;
+};
+
+namespace detail
+{
+/** Width of the padded element counts in a streamed PLY header */
+constexpr std::size_t PLY_COUNT_WIDTH{20};
+
+/** End of a native block table with an entry for every block type */
+constexpr std::uint64_t NATIVE_STREAM_TABLE_END{
+    sizeof(NativeHeader) + 5 * sizeof(NativeBlockEntry)};
+
+/** Offset of the first block of a streamed native file */
+constexpr std::uint64_t NATIVE_STREAM_DATA_OFFSET{
+    (NATIVE_STREAM_TABLE_END + NATIVE_ALIGNMENT - 1) / NATIVE_ALIGNMENT *
+    NATIVE_ALIGNMENT};
+
+/** Number of bytes copied at once when merging spill files */
+constexpr std::size_t STREAM_COPY_SIZE{1 << 20};
+
+/** Chunked reader for PLY files */
+template <class MeshType>
+class PlyStreamReader
+{
+public:
+    using Vertex = typename MeshType::Vertex;
+    using Face = typename MeshType::Face;
+
+    explicit PlyStreamReader(const std::filesystem::path& path)
+        : path_{path}, header_{ply_read_header(path)}
+    {
+        auto v = header_.find("vertex");
+        if (not v) {
+            ply_error("missing vertex element");
+        }
+        vElem_ = *v;
+        layout_ = ply_vertex_layout<MeshType::dims>(header_.elements[vElem_]);
+        MeshType::checkCapacity(numVertices());
+        fElem_ = header_.find("face");
+        if (fElem_) {
+            indices_ = ply_face_indices(header_.elements[*fElem_]);
+        }
+    }
+
+    [[nodiscard]] auto numVertices() const -> std::uint64_t
+    {
+        return header_.elements[vElem_].count;
+    }
+
+    [[nodiscard]] auto numFaces() const -> std::uint64_t
+    {
+        return fElem_ ? header_.elements[*fElem_].count : 0;
+    }
+
+    [[nodiscard]] auto attributes() const -> MeshStreamAttributes
+    {
+        return {layout_.hasNormals, layout_.hasColors};
+    }
+
+    void readVertices(std::vector<Vertex>& chunk, std::size_t n)
+    {
+        n = std::min<std::uint64_t>(n, numVertices() - nextVertex_);
+        chunk.assign(n, Vertex{});
+        if (n == 0) {
+            return;
+        }
+        if (not vReader_) {
+            vReader_.emplace(open(vElem_));
+        }
+        const auto& e = header_.elements[vElem_];
+        for (auto& v : chunk) {
+            ply_read_vertex<Vertex, MeshType::dims>(*vReader_, e, layout_, v);
+        }
+        nextVertex_ += n;
+    }
+
+    void readFaces(std::vector<Face>& chunk, std::size_t n)
+    {
+        n = std::min<std::uint64_t>(n, numFaces() - nextFace_);
+        chunk.resize(n);
+        if (n == 0) {
+            return;
+        }
+        if (not fReader_) {
+            fReader_.emplace(open(*fElem_));
+        }
+        const auto& e = header_.elements[*fElem_];
+        for (auto& f : chunk) {
+            ply_read_face(*fReader_, e, indices_, numVertices(), f);
+        }
+        nextFace_ += n;
+    }
+
+private:
+    /** Open a reader positioned at the first instance of an element */
+    auto open(std::size_t elem) const -> PlyReader
+    {
+        PlyReader reader(path_, header_);
+        for (std::size_t e{0}; e < elem; e++) {
+            reader.skip(header_.elements[e], header_.elements[e].count);
+        }
+        return reader;
+    }
+
+    std::filesystem::path path_;
+    PlyHeader header_;
+    PlyVertexLayout layout_;
+    std::size_t vElem_{0};
+    std::optional<std::size_t> fElem_;
+    std::size_t indices_{0};
+    // Vertices and faces are read with independent readers so that they can
+    // be consumed in either order
+    std::optional<PlyReader> vReader_;
+    std::optional<PlyReader> fReader_;
+    std::uint64_t nextVertex_{0};
+    std::uint64_t nextFace_{0};
+};
+
+/** Chunked reader for native mesh files */
+template <class MeshType>
+class NativeStreamReader
+{
+public:
+    using T = typename MeshType::value_type;
+    using Vertex = typename MeshType::Vertex;
+    using Face = typename MeshType::Face;
+    using Index = typename Face::value_type;
+    static constexpr auto Dims = MeshType::dims;
+
+    explicit NativeStreamReader(const std::filesystem::path& path)
+        : file_(path, std::ios::binary)
+    {
+        native_check_host();
+        if (not file_.is_open()) {
+            throw std::runtime_error("Cannot open file: " + path.string());
+        }
+        const auto fileSize = std::filesystem::file_size(path);
+
+        // Header and block table
+        readAt(0, sizeof(NativeHeader));
+        header_ = native_load<NativeHeader>(buf_.data());
+        native_check_header(header_, Dims);
+        readAt(sizeof(NativeHeader), native_table_size(header_));
+        blocks_ = native_parse_table(buf_.data(), header_, fileSize);
+        const auto nv = header_.numVertices;
+        const auto nf = header_.numFaces;
+        const auto ss = header_.scalarSize;
+        MeshType::checkCapacity(nv);
+
+        // Vertex blocks
+        const auto& pos = block(NativeBlockType::Positions);
+        if (not pos) {
+            native_error("missing positions");
+        }
+        if (pos->encoding == NativeEncoding::Raw) {
+            native_check_size(*pos, native_mul(nv, Dims * ss));
+        } else if (pos->encoding == NativeEncoding::Quantized16) {
+            native_check_size(
+                *pos, 2 * Dims * sizeof(double) + native_mul(nv, Dims * 2));
+            readAt(pos->offset, 2 * Dims * sizeof(double));
+            for (std::size_t d{0}; d < Dims; d++) {
+                lo_[d] = native_load<double>(buf_.data() + d * sizeof(double));
+                step_[d] = native_load<double>(
+                    buf_.data() + (Dims + d) * sizeof(double));
+            }
+        } else {
+            native_error("bad position encoding");
+        }
+        if (const auto& nrm = block(NativeBlockType::Normals); nrm) {
+            native_check_size(*nrm, native_mul(nv, Dims * ss));
+        }
+        if (const auto& clr = block(NativeBlockType::Colors); clr) {
+            native_check_size(*clr, native_mul(nv, 3 * sizeof(float)));
+        }
+
+        // Face sizes. The total number of corners is needed to check the
+        // index block, so the sizes are scanned once in bounded chunks.
+        numCorners_ = native_mul(nf, 3);
+        if (const auto& sizes = block(NativeBlockType::FaceSizes); sizes) {
+            native_check_size(*sizes, native_mul(nf, sizeof(std::uint32_t)));
+            numCorners_ = 0;
+            const auto maxCorners = native_mul(fileSize, NATIVE_MAX_LZ_RATIO);
+            std::vector<std::uint32_t> s;
+            for (std::uint64_t f{0}; f < nf; f += STREAM_COPY_SIZE / 4) {
+                auto n = std::min<std::uint64_t>(STREAM_COPY_SIZE / 4, nf - f);
+                readSizes(f, static_cast<std::size_t>(n), s);
+                for (auto v : s) {
+                    numCorners_ += v;
+                    if (numCorners_ > maxCorners) {
+                        native_error("too many face indices");
+                    }
+                }
+            }
+        }
+
+        // Face indices
+        const auto& idx = block(NativeBlockType::Indices);
+        if (not idx and nf > 0) {
+            native_error("missing face indices");
+        }
+        if (idx and idx->encoding == NativeEncoding::Raw) {
+            native_check_size(
+                *idx, native_mul(numCorners_, header_.indexSize));
+        } else if (idx and idx->encoding == NativeEncoding::DeltaLZ) {
+            if (idx->size < 8) {
+                native_error("truncated index block");
+            }
+            readAt(idx->offset, 8);
+            auto numSegments = native_load<std::uint64_t>(buf_.data());
+            auto expected =
+                (numCorners_ + NATIVE_SEGMENT_SIZE - 1) / NATIVE_SEGMENT_SIZE;
+            if (numSegments != expected or
+                idx->size < 8 + native_mul(numSegments, 16)) {
+                native_error("bad index segment table");
+            }
+            readAt(idx->offset + 8, 16 * numSegments);
+            segments_.resize(numSegments);
+            for (std::size_t s{0}; s < numSegments; s++) {
+                auto& [offset, size] = segments_[s];
+                offset = native_load<std::uint64_t>(buf_.data() + 16 * s);
+                size = native_load<std::uint64_t>(buf_.data() + 16 * s + 8);
+                if (size < 8 or offset > idx->size or
+                    size > idx->size - offset) {
+                    native_error("bad index segment bounds");
+                }
+            }
+        } else if (idx) {
+            native_error("bad index encoding");
+        }
+    }
+
+    [[nodiscard]] auto numVertices() const -> std::uint64_t
+    {
+        return header_.numVertices;
+    }
+
+    [[nodiscard]] auto numFaces() const -> std::uint64_t
+    {
+        return header_.numFaces;
+    }
+
+    [[nodiscard]] auto attributes() const -> MeshStreamAttributes
+    {
+        return {
+            block(NativeBlockType::Normals).has_value(),
+            block(NativeBlockType::Colors).has_value()};
+    }
+
+    void readVertices(std::vector<Vertex>& chunk, std::size_t n)
+    {
+        const auto b = nextVertex_;
+        n = static_cast<std::size_t>(
+            std::min<std::uint64_t>(n, numVertices() - b));
+        chunk.assign(n, Vertex{});
+        if (n == 0) {
+            return;
+        }
+        const auto ss = header_.scalarSize;
+
+        // Positions
+        const auto& pos = block(NativeBlockType::Positions);
+        if (pos->encoding == NativeEncoding::Raw) {
+            readAt(pos->offset + b * Dims * ss, n * Dims * ss);
+            parallel_for(0, n, [&](auto i) {
+                for (std::size_t d{0}; d < Dims; d++) {
+                    chunk[i][d] =
+                        native_load_scalar<T>(buf_.data(), ss, i * Dims + d);
+                }
+            });
+        } else {
+            auto prefix = 2 * Dims * sizeof(double);
+            readAt(pos->offset + prefix + b * Dims * 2, n * Dims * 2);
+            parallel_for(0, n, [&](auto i) {
+                for (std::size_t d{0}; d < Dims; d++) {
+                    auto q = native_load<std::uint16_t>(
+                        buf_.data() + 2 * (i * Dims + d));
+                    chunk[i][d] = static_cast<T>(lo_[d] + q * step_[d]);
+                }
+            });
+        }
+
+        // Normals
+        if constexpr (traits::has_normal_v<Vertex>) {
+            if (const auto& nrm = block(NativeBlockType::Normals); nrm) {
+                readAt(nrm->offset + b * Dims * ss, n * Dims * ss);
+                parallel_for(0, n, [&](auto i) {
+                    Vec<T, Dims> v;
+                    for (std::size_t d{0}; d < Dims; d++) {
+                        v[d] = native_load_scalar<T>(
+                            buf_.data(), ss, i * Dims + d);
+                    }
+                    chunk[i].normal = v;
+                });
+            }
+        }
+
+        // Colors
+        if constexpr (traits::has_color_v<Vertex>) {
+            if (const auto& clr = block(NativeBlockType::Colors); clr) {
+                constexpr auto size = 3 * sizeof(float);
+                readAt(clr->offset + b * size, n * size);
+                parallel_for(0, n, [&](auto i) {
+                    Color::F32C3 c;
+                    std::memcpy(c.data(), buf_.data() + i * size, size);
+                    chunk[i].color = c;
+                });
+            }
+        }
+        nextVertex_ += n;
+    }
+
+    void readFaces(std::vector<Face>& chunk, std::size_t n)
+    {
+        n = static_cast<std::size_t>(
+            std::min<std::uint64_t>(n, numFaces() - nextFace_));
+        chunk.resize(n);
+        if (n == 0) {
+            return;
+        }
+        readSizes(nextFace_, n, sizes_);
+        std::vector<std::size_t> corners(n + 1, 0);
+        for (std::size_t f{0}; f < n; f++) {
+            corners[f + 1] = corners[f] + sizes_[f];
+        }
+        readIndices(nextCorner_, corners.back(), flat_);
+        const auto nv = numVertices();
+        parallel_for(0, n, [&](auto f) {
+            auto& face = chunk[f];
+            face.resize(sizes_[f]);
+            for (std::size_t c{0}; c < face.size(); c++) {
+                auto v = flat_[corners[f] + c];
+                if (v >= nv) {
+                    native_error("face index out of range");
+                }
+                face[c] = static_cast<Index>(v);
+            }
+        });
+        nextFace_ += n;
+        nextCorner_ += corners.back();
+    }
+
+private:
+    /** Read `n` bytes at `offset` into the scratch buffer */
+    void readAt(std::uint64_t offset, std::uint64_t n)
+    {
+        buf_.resize(static_cast<std::size_t>(n));
+        file_.seekg(static_cast<std::streamoff>(offset));
+        file_.read(
+            reinterpret_cast<char*>(buf_.data()),
+            static_cast<std::streamsize>(n));
+        if (static_cast<std::uint64_t>(file_.gcount()) != n) {
+            native_error("unexpected end of file");
+        }
+    }
+
+    /** Read the sizes of faces [b, b + n) */
+    void readSizes(
+        std::uint64_t b, std::size_t n, std::vector<std::uint32_t>& s)
+    {
+        s.resize(n);
+        const auto& sizes = block(NativeBlockType::FaceSizes);
+        if (not sizes) {
+            std::fill(s.begin(), s.end(), 3);
+            return;
+        }
+        readAt(sizes->offset + 4 * b, 4 * n);
+        for (std::size_t f{0}; f < n; f++) {
+            s[f] = native_load<std::uint32_t>(buf_.data() + 4 * f);
+            if (s[f] < 3) {
+                native_error("bad face size");
+            }
+        }
+    }
+
+    /** Read face corners [b, b + n) */
+    void readIndices(
+        std::uint64_t b, std::size_t n, std::vector<std::uint64_t>& out)
+    {
+        out.resize(n);
+        const auto& idx = block(NativeBlockType::Indices);
+        const auto isz = header_.indexSize;
+        if (idx->encoding == NativeEncoding::Raw) {
+            readAt(idx->offset + b * isz, n * isz);
+            parallel_for(0, n, [&](auto i) {
+                out[i] = isz == sizeof(std::uint32_t)
+                             ? native_load<std::uint32_t>(buf_.data() + 4 * i)
+                             : native_load<std::uint64_t>(buf_.data() + 8 * i);
+            });
+            return;
+        }
+        // Decode one segment at a time
+        for (std::size_t i{0}; i < n;) {
+            auto corner = b + i;
+            auto s = corner / NATIVE_SEGMENT_SIZE;
+            if (s != segment_) {
+                loadSegment(s);
+            }
+            auto begin = corner - s * NATIVE_SEGMENT_SIZE;
+            auto count =
+                std::min<std::uint64_t>(n - i, decoded_.size() - begin);
+            std::copy_n(decoded_.begin() + begin, count, out.begin() + i);
+            i += count;
+        }
+    }
+
+    /** Decompress an index segment */
+    void loadSegment(std::uint64_t s)
+    {
+        const auto& idx = block(NativeBlockType::Indices);
+        const auto& [offset, size] = segments_[s];
+        readAt(idx->offset + offset, size);
+        auto rawSize = native_load<std::uint64_t>(buf_.data());
+        auto b = s * NATIVE_SEGMENT_SIZE;
+        auto n = std::min<std::uint64_t>(NATIVE_SEGMENT_SIZE, numCorners_ - b);
+        // Every varint is at least one byte and at most ten
+        if (rawSize < n or rawSize > 10 * n) {
+            native_error("bad index segment size");
+        }
+        std::vector<std::byte> deltas(rawSize);
+        lz_decompress(buf_.data() + 8, size - 8, deltas.data(), deltas.size());
+        decoded_.resize(n);
+        delta_decode(deltas.data(), deltas.size(), decoded_.data(), n);
+        segment_ = s;
+    }
+
+    [[nodiscard]] auto block(NativeBlockType t) const
+        -> const std::optional<NativeBlockEntry>&
+    {
+        return blocks_[static_cast<std::size_t>(t)];
+    }
+
+    std::ifstream file_;
+    NativeHeader header_;
+    NativeBlockTable blocks_;
+    std::array<double, Dims> lo_{};
+    std::array<double, Dims> step_{};
+    std::uint64_t numCorners_{0};
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> segments_;
+    std::uint64_t segment_{std::numeric_limits<std::uint64_t>::max()};
+    std::vector<std::uint64_t> decoded_;
+    std::vector<std::byte> buf_;
+    std::vector<std::uint32_t> sizes_;
+    std::vector<std::uint64_t> flat_;
+    std::uint64_t nextVertex_{0};
+    std::uint64_t nextFace_{0};
+    std::uint64_t nextCorner_{0};
+};
+
+/** Check that every index of a face chunk is less than `nv` */
+template <class Face>
+void stream_check_faces(const std::vector<Face>& faces, std::uint64_t nv)
+{
+    parallel_for(0, faces.size(), [&](auto f) {
+        for (const auto& v : faces[f]) {
+            if (static_cast<std::uint64_t>(v) >= nv) {
+                throw std::out_of_range("Face references invalid vertex");
+            }
+        }
+    });
+}
+
+/** Chunked writer for binary PLY files */
+template <class MeshType>
+class PlyStreamWriter
+{
+public:
+    using T = typename MeshType::value_type;
+    using Vertex = typename MeshType::Vertex;
+    using Face = typename MeshType::Face;
+
+    PlyStreamWriter(
+        const std::filesystem::path& path, const MeshStreamAttributes& attrs)
+        : path_{path}, file_(path, std::ios::binary), attrs_{attrs}
+    {
+        if (not file_.is_open()) {
+            throw std::runtime_error("Cannot open file: " + path.string());
+        }
+        writeHeader();
+    }
+
+    void writeVertices(const std::vector<Vertex>& vertices)
+    {
+        write_records(file_, vertices.size(), [&](auto i, std::string& buf) {
+            ply_append_vertex(
+                buf, vertices[i], attrs_.normals, attrs_.colors);
+        });
+        numVertices_ += vertices.size();
+    }
+
+    void writeFaces(const std::vector<Face>& faces)
+    {
+        if (numVertices_ > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::overflow_error("Too many vertices for PLY");
+        }
+        write_records(file_, faces.size(), [&](auto i, std::string& buf) {
+            ply_append_face(buf, faces[i]);
+        });
+        numFaces_ += faces.size();
+    }
+
+    void close()
+    {
+        // The padded header has the same size regardless of the counts
+        file_.seekp(0);
+        writeHeader();
+        file_.close();
+        if (file_.fail()) {
+            throw std::runtime_error("Failed to write file: " + path_.string());
+        }
+    }
+
+private:
+    void writeHeader()
+    {
+        ply_write_header<T, MeshType::dims>(
+            file_, numVertices_, numFaces_, attrs_.normals, attrs_.colors,
+            PLY_COUNT_WIDTH);
+    }
+
+    std::filesystem::path path_;
+    std::ofstream file_;
+    MeshStreamAttributes attrs_;
+    std::uint64_t numVertices_{0};
+    std::uint64_t numFaces_{0};
+};
+
+/**
+ * Chunked writer for native mesh files. Positions are written directly to
+ * the output file. Every other block is spilled to a temporary file next to
+ * the output and appended when the writer is closed.
+ */
+template <class MeshType>
+class NativeStreamWriter
+{
+public:
+    using T = typename MeshType::value_type;
+    using Vertex = typename MeshType::Vertex;
+    using Face = typename MeshType::Face;
+    static constexpr auto Dims = MeshType::dims;
+    static_assert(
+        std::is_floating_point_v<T>,
+        "Native mesh format requires a floating-point mesh");
+
+    NativeStreamWriter(
+        const std::filesystem::path& path,
+        const MeshStreamAttributes& attrs,
+        const MeshWriteOptions& opts)
+        : path_{path}, attrs_{attrs}, opts_{opts}
+    {
+        // Validate before opening, which truncates an existing file
+        native_check_host();
+        if (opts.quantizePositions) {
+            throw std::invalid_argument(
+                "Quantized positions are not supported when streaming");
+        }
+        file_.open(path, std::ios::binary);
+        if (not file_.is_open()) {
+            throw std::runtime_error("Cannot open file: " + path.string());
+        }
+        const std::array<char, NATIVE_STREAM_DATA_OFFSET> placeholder{};
+        file_.write(placeholder.data(), placeholder.size());
+        // The destructor doesn't run if the constructor throws, so clean up
+        // the spills which were already created
+        try {
+            for (std::size_t s{0}; s < spills_.size(); s++) {
+                spills_[s].path = path_;
+                spills_[s].path += ".spill" + std::to_string(s);
+                spills_[s].file.open(spills_[s].path, std::ios::binary);
+                if (not spills_[s].file.is_open()) {
+                    throw std::runtime_error(
+                        "Cannot open file: " + spills_[s].path.string());
+                }
+            }
+        } catch (...) {
+            removeSpills();
+            throw;
+        }
+    }
+
+    NativeStreamWriter(const NativeStreamWriter&) = delete;
+    auto operator=(const NativeStreamWriter&) -> NativeStreamWriter& = delete;
+
+    ~NativeStreamWriter() { removeSpills(); }
+
+    void writeVertices(const std::vector<Vertex>& vertices)
+    {
+        const auto n = vertices.size();
+        buf_.resize(n * Dims * sizeof(T));
+        parallel_for(0, n, [&](auto i) {
+            std::memcpy(
+                buf_.data() + i * Dims * sizeof(T), vertices[i].data(),
+                Dims * sizeof(T));
+        });
+        write(file_, buf_);
+
+        if constexpr (traits::has_normal_v<Vertex>) {
+            if (attrs_.normals) {
+                parallel_for(0, n, [&](auto i) {
+                    if (not vertices[i].normal) {
+                        throw std::runtime_error("Vertex is missing a normal");
+                    }
+                    std::memcpy(
+                        buf_.data() + i * Dims * sizeof(T),
+                        vertices[i].normal->data(), Dims * sizeof(T));
+                });
+                write(spill(Spill::Normals), buf_);
+            }
+        }
+
+        if constexpr (traits::has_color_v<Vertex>) {
+            if (attrs_.colors) {
+                constexpr auto size = 3 * sizeof(float);
+                buf_.resize(n * size);
+                parallel_for(0, n, [&](auto i) {
+                    auto c = vertex_color<Color::F32C3>(vertices[i].color);
+                    std::memcpy(buf_.data() + i * size, c.data(), size);
+                });
+                write(spill(Spill::Colors), buf_);
+            }
+        }
+        numVertices_ += n;
+    }
+
+    void writeFaces(const std::vector<Face>& faces)
+    {
+        if (indexSize_ == 0) {
+            indexSize_ =
+                numVertices_ <= std::numeric_limits<std::uint32_t>::max()
+                    ? sizeof(std::uint32_t)
+                    : sizeof(std::uint64_t);
+        }
+        std::vector<std::uint32_t> sizes(faces.size());
+        for (std::size_t f{0}; f < faces.size(); f++) {
+            sizes[f] = static_cast<std::uint32_t>(faces[f].size());
+            triangles_ = triangles_ and sizes[f] == 3;
+        }
+        write(spill(Spill::FaceSizes), sizes);
+
+        if (opts_.compressIndices) {
+            for (const auto& face : faces) {
+                for (const auto& v : face) {
+                    pending_.push_back(v);
+                    if (pending_.size() == NATIVE_SEGMENT_SIZE) {
+                        flushSegment();
+                    }
+                }
+            }
+        } else if (indexSize_ == sizeof(std::uint32_t)) {
+            writeRaw<std::uint32_t>(faces);
+        } else {
+            writeRaw<std::uint64_t>(faces);
+        }
+        numFaces_ += faces.size();
+    }
+
+    void close()
+    {
+        if (indexSize_ == 0) {
+            writeFaces({});
+        }
+        if (not pending_.empty()) {
+            flushSegment();
+        }
+
+        NativeHeader header;
+        header.numVertices = numVertices_;
+        header.numFaces = numFaces_;
+        header.dims = Dims;
+        header.scalarSize = sizeof(T);
+        header.indexSize = indexSize_;
+        std::vector<NativeBlockEntry> table;
+        table.push_back(
+            {NativeBlockType::Positions, NativeEncoding::Raw,
+             NATIVE_STREAM_DATA_OFFSET, numVertices_ * Dims * sizeof(T)});
+
+        // Append the spilled blocks
+        auto append = [&](Spill s, NativeBlockType type, NativeEncoding enc) {
+            auto& spill = spills_[static_cast<std::size_t>(s)];
+            spill.file.close();
+            if (spill.file.fail()) {
+                throw std::runtime_error(
+                    "Failed to write file: " + spill.path.string());
+            }
+            const std::array<char, NATIVE_ALIGNMENT> padding{};
+            auto pos = static_cast<std::uint64_t>(file_.tellp());
+            auto pad = (NATIVE_ALIGNMENT - pos % NATIVE_ALIGNMENT) %
+                       NATIVE_ALIGNMENT;
+            file_.write(padding.data(), static_cast<std::streamsize>(pad));
+            NativeBlockEntry entry{type, enc, pos + pad, 0};
+            if (enc == NativeEncoding::DeltaLZ) {
+                // Segment table with offsets relative to the block start
+                std::vector<std::byte> segTable;
+                native_append(segTable, std::uint64_t{segmentSizes_.size()});
+                std::uint64_t offset{8 + 16 * segmentSizes_.size()};
+                for (auto size : segmentSizes_) {
+                    native_append(segTable, offset);
+                    native_append(segTable, size);
+                    offset += size;
+                }
+                write(file_, segTable);
+                entry.size += segTable.size();
+            }
+            entry.size += copy(spill.path);
+            table.push_back(entry);
+        };
+        if (attrs_.normals) {
+            append(
+                Spill::Normals, NativeBlockType::Normals, NativeEncoding::Raw);
+        }
+        if (attrs_.colors) {
+            append(Spill::Colors, NativeBlockType::Colors, NativeEncoding::Raw);
+        }
+        if (not triangles_) {
+            append(
+                Spill::FaceSizes, NativeBlockType::FaceSizes,
+                NativeEncoding::Raw);
+        }
+        append(
+            Spill::Indices, NativeBlockType::Indices,
+            opts_.compressIndices ? NativeEncoding::DeltaLZ
+                                  : NativeEncoding::Raw);
+
+        // Header and block table
+        header.numBlocks = static_cast<std::uint32_t>(table.size());
+        file_.seekp(0);
+        file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file_.write(
+            reinterpret_cast<const char*>(table.data()),
+            static_cast<std::streamsize>(
+                table.size() * sizeof(NativeBlockEntry)));
+        file_.close();
+        removeSpills();
+        if (file_.fail()) {
+            throw std::runtime_error("Failed to write file: " + path_.string());
+        }
+    }
+
+private:
+    /** Spill files */
+    enum class Spill { Normals, Colors, FaceSizes, Indices };
+
+    struct SpillFile {
+        std::filesystem::path path;
+        std::ofstream file;
+    };
+
+    void removeSpills()
+    {
+        for (auto& s : spills_) {
+            s.file.close();
+            std::error_code ec;
+            std::filesystem::remove(s.path, ec);
+        }
+    }
+
+    auto spill(Spill s) -> std::ofstream&
+    {
+        return spills_[static_cast<std::size_t>(s)].file;
+    }
+
+    template <typename V>
+    static void write(std::ostream& os, const std::vector<V>& buf)
+    {
+        os.write(
+            reinterpret_cast<const char*>(buf.data()),
+            static_cast<std::streamsize>(buf.size() * sizeof(V)));
+    }
+
+    template <typename FileIndex>
+    void writeRaw(const std::vector<Face>& faces)
+    {
+        std::vector<FileIndex> flat;
+        for (const auto& face : faces) {
+            flat.insert(flat.end(), face.begin(), face.end());
+        }
+        write(spill(Spill::Indices), flat);
+    }
+
+    /** Encode the pending indices as one delta-encoded LZ segment */
+    void flushSegment()
+    {
+        std::vector<std::byte> deltas;
+        deltas.reserve(2 * pending_.size());
+        delta_encode(pending_.data(), pending_.size(), deltas);
+        auto compressed = lz_compress(deltas.data(), deltas.size());
+        std::vector<std::byte> prefix;
+        native_append(prefix, static_cast<std::uint64_t>(deltas.size()));
+        write(spill(Spill::Indices), prefix);
+        write(spill(Spill::Indices), compressed);
+        segmentSizes_.push_back(prefix.size() + compressed.size());
+        pending_.clear();
+    }
+
+    /** Append a spill file to the output. Returns the number of bytes. */
+    auto copy(const std::filesystem::path& path) -> std::uint64_t
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::vector<char> chunk(STREAM_COPY_SIZE);
+        std::uint64_t total{0};
+        while (in) {
+            in.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            file_.write(chunk.data(), in.gcount());
+            total += static_cast<std::uint64_t>(in.gcount());
+        }
+        return total;
+    }
+
+    std::filesystem::path path_;
+    std::ofstream file_;
+    MeshStreamAttributes attrs_;
+    MeshWriteOptions opts_;
+    std::array<SpillFile, 4> spills_;
+    std::vector<std::byte> buf_;
+    std::vector<std::uint64_t> pending_;
+    std::vector<std::uint64_t> segmentSizes_;
+    std::uint64_t numVertices_{0};
+    std::uint64_t numFaces_{0};
+    std::uint32_t indexSize_{0};
+    bool triangles_{true};
+};
+}  // namespace detail
+
+/**
+ * @brief Read a mesh file in bounded-memory chunks
+ *
+ * Vertices and faces are read in chunks of at most `chunkSize` elements, so
+ * meshes which are much larger than the available memory can be processed.
+ * Vertices and faces have independent cursors and can be read in either
+ * order. Supported formats:
+ *   - PLY (`.ply`, ASCII or binary)
+ *   - Native binary mesh (`.elmesh`)
+ *
+ * ```{.cpp}
+ * MeshStreamReader<Mesh3f> reader("scan.ply");
+ * std::vector<Mesh3f::Vertex> vertices;
+ * while (reader.readVertices(vertices)) {
+ *     // ...
+ * }
+ * ```
+ *
+ * @throws std::invalid_argument If the file format is not supported
+ * @throws std::runtime_error If the file cannot be read or parsed
+ */
+template <class MeshType>
+class MeshStreamReader
+{
+public:
+    /** Vertex type */
+    using Vertex = typename MeshType::Vertex;
+    /** Face type */
+    using Face = typename MeshType::Face;
+
+    /** @brief Open a mesh file */
+    explicit MeshStreamReader(
+        const std::filesystem::path& path, std::size_t chunkSize = 1 << 16)
+        : impl_{open(path)}, chunkSize_{chunkSize}
+    {
+        if (chunkSize == 0) {
+            throw std::invalid_argument("Chunk size must be > 0");
+        }
+    }
+
+    /** @brief Total number of vertices in the file */
+    [[nodiscard]] auto numVertices() const -> std::uint64_t
+    {
+        return std::visit([](auto& r) { return r.numVertices(); }, *impl_);
+    }
+
+    /** @brief Total number of faces in the file */
+    [[nodiscard]] auto numFaces() const -> std::uint64_t
+    {
+        return std::visit([](auto& r) { return r.numFaces(); }, *impl_);
+    }
+
+    /** @brief Vertex attributes stored in the file */
+    [[nodiscard]] auto attributes() const -> MeshStreamAttributes
+    {
+        return std::visit([](auto& r) { return r.attributes(); }, *impl_);
+    }
+
+    /** @brief Maximum number of elements per chunk */
+    [[nodiscard]] auto chunkSize() const -> std::size_t { return chunkSize_; }
+
+    /**
+     * @brief Read the next chunk of vertices
+     *
+     * @returns false once every vertex has been read
+     */
+    auto readVertices(std::vector<Vertex>& chunk) -> bool
+    {
+        std::visit([&](auto& r) { r.readVertices(chunk, chunkSize_); }, *impl_);
+        return not chunk.empty();
+    }
+
+    /**
+     * @brief Read the next chunk of faces
+     *
+     * @returns false once every face has been read
+     */
+    auto readFaces(std::vector<Face>& chunk) -> bool
+    {
+        std::visit([&](auto& r) { r.readFaces(chunk, chunkSize_); }, *impl_);
+        return not chunk.empty();
+    }
+
+private:
+    using Impl = std::variant<
+        detail::PlyStreamReader<MeshType>,
+        detail::NativeStreamReader<MeshType>>;
+
+    static auto open(const std::filesystem::path& path) -> std::unique_ptr<Impl>
+    {
+        if (is_file_type(path, "ply")) {
+            return std::make_unique<Impl>(
+                std::in_place_index<0>, path);
+        }
+        if (is_file_type(path, "elmesh")) {
+            return std::make_unique<Impl>(
+                std::in_place_index<1>, path);
+        }
+        auto ext = path.extension().string();
+        throw std::invalid_argument("Unsupported file type: " + ext);
+    }
+
+    std::unique_ptr<Impl> impl_;
+    std::size_t chunkSize_;
+};
+
+/**
+ * @brief Write a mesh file in chunks
+ *
+ * All vertices must be written before the first face. Element counts do not
+ * need to be known in advance: The header is completed by close(). The
+ * vertex attributes to write are fixed when the writer is opened, and every
+ * vertex must provide them. Supported formats:
+ *   - PLY (`.ply`, binary little-endian)
+ *   - Native binary mesh (`.elmesh`). Non-position blocks are spilled to
+ *     temporary files next to the output, which are merged by close().
+ *
+ * close() must be called to finalize the file. Files which are not closed
+ * are incomplete.
+ *
+ * @throws std::invalid_argument If the file format is not supported
+ * @throws std::runtime_error If the file cannot be written
+ */
+template <class MeshType>
+class MeshStreamWriter
+{
+public:
+    /** Vertex type */
+    using Vertex = typename MeshType::Vertex;
+    /** Face type */
+    using Face = typename MeshType::Face;
+
+    /** @brief Open a mesh file for writing */
+    explicit MeshStreamWriter(
+        const std::filesystem::path& path,
+        const MeshStreamAttributes& attrs = {},
+        const MeshWriteOptions& opts = {})
+        : impl_{open(path, attrs, opts)}
+    {
+    }
+
+    /** @brief Append vertices */
+    void writeVertices(const std::vector<Vertex>& vertices)
+    {
+        if (facesStarted_) {
+            throw std::runtime_error("Vertices must be written before faces");
+        }
+        std::visit([&](auto& w) { w.writeVertices(vertices); }, *impl_);
+        numVertices_ += vertices.size();
+    }
+
+    /**
+     * @brief Append faces
+     *
+     * @throws std::out_of_range If a face references a vertex which has not
+     * been written
+     */
+    void writeFaces(const std::vector<Face>& faces)
+    {
+        facesStarted_ = true;
+        detail::stream_check_faces(faces, numVertices_);
+        std::visit([&](auto& w) { w.writeFaces(faces); }, *impl_);
+        numFaces_ += faces.size();
+    }
+
+    /** @brief Number of vertices written */
+    [[nodiscard]] auto numVertices() const -> std::uint64_t
+    {
+        return numVertices_;
+    }
+
+    /** @brief Number of faces written */
+    [[nodiscard]] auto numFaces() const -> std::uint64_t { return numFaces_; }
+
+    /** @brief Finalize and close the file */
+    void close()
+    {
+        std::visit([](auto& w) { w.close(); }, *impl_);
+    }
+
+private:
+    using Impl = std::variant<
+        detail::PlyStreamWriter<MeshType>,
+        detail::NativeStreamWriter<MeshType>>;
+
+    static auto open(
+        const std::filesystem::path& path,
+        MeshStreamAttributes attrs,
+        const MeshWriteOptions& opts) -> std::unique_ptr<Impl>
+    {
+        // Attributes which the vertex type doesn't have can't be written
+        attrs.normals = attrs.normals and traits::has_normal_v<Vertex>;
+        attrs.colors = attrs.colors and traits::has_color_v<Vertex>;
+        if (is_file_type(path, "ply")) {
+            return std::make_unique<Impl>(std::in_place_index<0>, path, attrs);
+        }
+        if (is_file_type(path, "elmesh")) {
+            return std::make_unique<Impl>(
+                std::in_place_index<1>, path, attrs, opts);
+        }
+        auto ext = path.extension().string();
+        throw std::invalid_argument("Unsupported file type: " + ext);
+    }
+
+    std::unique_ptr<Impl> impl_;
+    std::uint64_t numVertices_{0};
+    std::uint64_t numFaces_{0};
+    bool facesStarted_{false};
+};
+
+namespace detail
+{
+/**
+ * Stream a mesh from `in` to `out`, applying `vertexFunc(chunk)` to every
+ * vertex chunk and `faceFunc(chunk)` to every face chunk before writing
+ */
+template <class InMesh, class OutMesh, class VertexFunc, class FaceFunc>
+void stream_mesh(
+    MeshStreamReader<InMesh>& reader,
+    MeshStreamWriter<OutMesh>& writer,
+    VertexFunc&& vertexFunc,
+    FaceFunc&& faceFunc)
+{
+    std::vector<typename InMesh::Vertex> vertices;
+    while (reader.readVertices(vertices)) {
+        writer.writeVertices(vertexFunc(vertices));
+    }
+    std::vector<typename InMesh::Face> faces;
+    while (reader.readFaces(faces)) {
+        writer.writeFaces(faceFunc(faces));
+    }
+    writer.close();
+}
+}  // namespace detail
+
+/**
+ * @brief Apply a function to every vertex of a mesh file in bounded memory
+ *
+ * `func(vertex)` is called in parallel on each vertex chunk and may modify
+ * any vertex attribute. Faces are copied unchanged. The input and output may
+ * use different formats, but must not be the same file.
+ */
+template <class MeshType, class Func>
+void stream_transform(
+    const std::filesystem::path& in,
+    const std::filesystem::path& out,
+    Func func,
+    const MeshStreamOptions& opts = {})
+{
+    MeshStreamReader<MeshType> reader(in, opts.chunkSize);
+    MeshStreamWriter<MeshType> writer(out, reader.attributes(), opts.write);
+    detail::stream_mesh(
+        reader, writer,
+        [&](auto& vertices) -> auto& {
+            parallel_for(
+                0, vertices.size(), [&](auto i) { func(vertices[i]); });
+            return vertices;
+        },
+        [](auto& faces) -> auto& { return faces; });
+}
+
+/**
+ * @brief Apply a homogeneous transform to a 3D mesh file in bounded memory
+ *
+ * Positions are transformed by `m` with the perspective divide. Normals are
+ * transformed by the inverse transpose of the upper-left 3x3 block and
+ * renormalized.
+ */
+template <class MeshType, typename M>
+void stream_transform(
+    const std::filesystem::path& in,
+    const std::filesystem::path& out,
+    const Mat<4, 4, M>& m,
+    const MeshStreamOptions& opts = {})
+{
+    static_assert(MeshType::dims == 3, "Matrix transforms require a 3D mesh");
+    using T = typename MeshType::value_type;
+    using V3 = Vec<double, 3>;
+    // The cofactor matrix is the inverse transpose scaled by the determinant
+    std::array<V3, 3> rows;
+    for (std::size_t r{0}; r < 3; r++) {
+        rows[r] = V3{double(m(r, 0)), double(m(r, 1)), double(m(r, 2))};
+    }
+    const std::array<V3, 3> cof{
+        rows[1].cross(rows[2]), rows[2].cross(rows[0]),
+        rows[0].cross(rows[1])};
+    const double sign = rows[0].dot(cof[0]) < 0 ? -1 : 1;
+
+    stream_transform<MeshType>(
+        in, out,
+        [&](auto& v) {
+            std::array<double, 4> p{};
+            for (std::size_t r{0}; r < 4; r++) {
+                p[r] = double(m(r, 3));
+                for (std::size_t c{0}; c < 3; c++) {
+                    p[r] += double(m(r, c)) * double(v[c]);
+                }
+            }
+            auto w = p[3] != 0 ? p[3] : 1.0;
+            for (std::size_t d{0}; d < 3; d++) {
+                v[d] = static_cast<T>(p[d] / w);
+            }
+            using Vertex = std::decay_t<decltype(v)>;
+            if constexpr (traits::has_normal_v<Vertex>) {
+                if (v.normal) {
+                    const auto& n = *v.normal;
+                    V3 nd{double(n[0]), double(n[1]), double(n[2])};
+                    V3 t{cof[0].dot(nd), cof[1].dot(nd), cof[2].dot(nd)};
+                    auto len = t.magnitude();
+                    if (len > 0) {
+                        t *= sign / len;
+                    }
+                    v.normal = Vec<T, 3>{
+                        static_cast<T>(t[0]), static_cast<T>(t[1]),
+                        static_cast<T>(t[2])};
+                }
+            }
+        },
+        opts);
+}
+
+/**
+ * @brief Compute the bounding box of a mesh file in bounded memory
+ *
+ * Only the vertex positions are read.
+ *
+ * @returns The per-axis minimum and maximum vertex position. If the mesh has
+ * no vertices, the minimum is the largest representable value and the maximum
+ * is the lowest.
+ */
+template <class MeshType>
+auto stream_bounds(
+    const std::filesystem::path& path, const MeshStreamOptions& opts = {})
+    -> std::pair<
+        Vec<typename MeshType::value_type, MeshType::dims>,
+        Vec<typename MeshType::value_type, MeshType::dims>>
+{
+    using T = typename MeshType::value_type;
+    constexpr auto Dims = MeshType::dims;
+    using Bounds = std::pair<Vec<T, Dims>, Vec<T, Dims>>;
+    Bounds result;
+    result.first.fill(std::numeric_limits<T>::max());
+    result.second.fill(std::numeric_limits<T>::lowest());
+    auto merge = [](Bounds& b, const auto& v) {
+        for (std::size_t d{0}; d < Dims; d++) {
+            b.first[d] = std::min(b.first[d], v[d]);
+            b.second[d] = std::max(b.second[d], v[d]);
+        }
+    };
+
+    MeshStreamReader<MeshType> reader(path, opts.chunkSize);
+    std::vector<typename MeshType::Vertex> vertices;
+    std::vector<Bounds> partial;
+    while (reader.readVertices(vertices)) {
+        const auto n = vertices.size();
+        partial.assign(std::min(num_threads(), n), result);
+        parallel_for(
+            0, partial.size(),
+            [&](auto b) {
+                auto [begin, end] = block_range(n, partial.size(), b);
+                for (auto i = begin; i < end; i++) {
+                    merge(partial[b], vertices[i]);
+                }
+            },
+            1);
+        for (const auto& p : partial) {
+            merge(result, p.first);
+            merge(result, p.second);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Convert a mesh file in bounded memory
+ *
+ * Converts between file formats (by extension), between scalar precisions
+ * (`InMesh` and `OutMesh` may have different value types), and between
+ * attribute sets. Normals and colors are written when they are present in the
+ * input, requested in `keep`, and supported by `OutMesh`. Colors are
+ * converted to the output format's color type.
+ *
+ * ```{.cpp}
+ * // Drop normals and store as single-precision with compressed indices
+ * MeshStreamOptions opts;
+ * opts.write.compressIndices = true;
+ * stream_convert<Mesh3d, Mesh3f>(
+ *     "scan.ply", "scan.elmesh", {false, true}, opts);
+ * ```
+ */
+template <class InMesh, class OutMesh = InMesh>
+void stream_convert(
+    const std::filesystem::path& in,
+    const std::filesystem::path& out,
+    const MeshStreamAttributes& keep = {true, true},
+    const MeshStreamOptions& opts = {})
+{
+    static_assert(InMesh::dims == OutMesh::dims, "Dimension mismatch");
+    using InVertex = typename InMesh::Vertex;
+    using OutVertex = typename OutMesh::Vertex;
+    using OutT = typename OutMesh::value_type;
+    using OutFace = typename OutMesh::Face;
+    using OutIndex = typename OutFace::value_type;
+    constexpr auto Dims = OutMesh::dims;
+    constexpr bool normals =
+        traits::has_normal_v<InVertex> and traits::has_normal_v<OutVertex>;
+    constexpr bool colors =
+        traits::has_color_v<InVertex> and traits::has_color_v<OutVertex>;
+
+    MeshStreamReader<InMesh> reader(in, opts.chunkSize);
+    OutMesh::checkCapacity(reader.numVertices());
+    auto attrs = reader.attributes();
+    attrs.normals = attrs.normals and keep.normals and normals;
+    attrs.colors = attrs.colors and keep.colors and colors;
+    MeshStreamWriter<OutMesh> writer(out, attrs, opts.write);
+
+    std::vector<OutVertex> outVerts;
+    std::vector<OutFace> outFaces;
+    detail::stream_mesh(
+        reader, writer,
+        [&](const auto& vertices) -> auto& {
+            outVerts.assign(vertices.size(), OutVertex{});
+            parallel_for(0, vertices.size(), [&](auto i) {
+                const auto& src = vertices[i];
+                auto& dst = outVerts[i];
+                for (std::size_t d{0}; d < Dims; d++) {
+                    dst[d] = static_cast<OutT>(src[d]);
+                }
+                if constexpr (normals) {
+                    if (attrs.normals and src.normal) {
+                        Vec<OutT, Dims> n;
+                        for (std::size_t d{0}; d < Dims; d++) {
+                            n[d] = static_cast<OutT>((*src.normal)[d]);
+                        }
+                        dst.normal = n;
+                    }
+                }
+                if constexpr (colors) {
+                    if (attrs.colors) {
+                        dst.color = src.color;
+                    }
+                }
+            });
+            return outVerts;
+        },
+        [&](const auto& faces) -> auto& {
+            outFaces.resize(faces.size());
+            parallel_for(0, faces.size(), [&](auto f) {
+                const auto& src = faces[f];
+                auto& dst = outFaces[f];
+                dst.resize(src.size());
+                for (std::size_t c{0}; c < src.size(); c++) {
+                    dst[c] = static_cast<OutIndex>(src[c]);
+                }
+            });
+            return outFaces;
+        });
+}
+
+/**
+ * @brief Keep only the faces of a mesh file which satisfy a predicate, in
+ * bounded memory
+ *
+ * `pred(face)` is evaluated in parallel on each face chunk. Vertices are
+ * copied unchanged, including vertices which are no longer referenced, so
+ * that face indices stay valid without random access to the input.
+ *
+ * @returns The number of faces kept
+ */
+template <class MeshType, class Predicate>
+auto stream_filter_faces(
+    const std::filesystem::path& in,
+    const std::filesystem::path& out,
+    Predicate&& pred,
+    const MeshStreamOptions& opts = {}) -> std::uint64_t
+{
+    using Face = typename MeshType::Face;
+    MeshStreamReader<MeshType> reader(in, opts.chunkSize);
+    MeshStreamWriter<MeshType> writer(out, reader.attributes(), opts.write);
+    std::vector<char> keep;
+    std::vector<Face> kept;
+    detail::stream_mesh(
+        reader, writer, [](auto& vertices) -> auto& { return vertices; },
+        [&](auto& faces) -> auto& {
+            keep.resize(faces.size());
+            parallel_for(0, faces.size(), [&](auto f) {
+                keep[f] = pred(std::as_const(faces[f])) ? 1 : 0;
+            });
+            kept.clear();
+            for (std::size_t f{0}; f < faces.size(); f++) {
+                if (keep[f] != 0) {
+                    kept.emplace_back(std::move(faces[f]));
+                }
+            }
+            return kept;
+        });
+    return writer.numFaces();
+}
+
+}  // namespace educelab
@@ -0,0 +1,188 @@
+#pragma once
+
+/** @file */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "educelab/core/io/MeshIO.hpp"
+#include "educelab/core/types/PointCloud.hpp"
+#include "educelab/core/utils/Filesystem.hpp"
+
+namespace educelab
+{
+
+namespace detail
+{
+/**
+ * @brief Read the vertex element of a PLY file as a point cloud
+ *
+ * Other elements (e.g. faces) are skipped. Integer colors are scaled to
+ * [0, 1] by the maximum of their type.
+ */
+template <class PointCloudType>
+auto ply_read_points(const std::filesystem::path& path) -> PointCloudType
+{
+    using T = typename PointCloudType::value_type;
+    constexpr auto Dims = PointCloudType::dims;
+    auto header = ply_read_header(path);
+    auto vIdx = header.find("vertex");
+    if (not vIdx) {
+        ply_error("missing vertex element");
+    }
+    const auto& vElem = header.elements[*vIdx];
+    auto layout = ply_vertex_layout<Dims>(vElem);
+    double colorScale{1};
+    if (layout.colorType == PlyType::UInt16) {
+        colorScale = 1. / std::numeric_limits<std::uint16_t>::max();
+    } else if (
+        layout.colorType != PlyType::Float32 and
+        layout.colorType != PlyType::Float64) {
+        colorScale = 1. / std::numeric_limits<std::uint8_t>::max();
+    }
+
+    PointCloudType cloud;
+    PlyReader reader(path, header);
+    for (const auto& e : header.elements) {
+        if (&e != &vElem) {
+            reader.skip(e, e.count);
+            continue;
+        }
+        cloud.resize(static_cast<std::size_t>(e.count));
+        if (layout.hasNormals) {
+            cloud.enableNormals();
+        }
+        if (layout.hasColors) {
+            cloud.enableColors();
+        }
+        for (std::size_t i{0}; i < cloud.size(); i++) {
+            auto vals = ply_read_vertex_values(reader, e, layout);
+            auto& p = cloud.points()[i];
+            for (std::size_t d{0}; d < Dims; d++) {
+                p[d] = static_cast<T>(vals[d]);
+            }
+            if (layout.hasNormals) {
+                auto& n = cloud.normals()[i];
+                for (std::size_t d{0}; d < Dims; d++) {
+                    n[d] = static_cast<T>(vals[3 + d]);
+                }
+            }
+            if (layout.hasColors) {
+                auto& c = cloud.colors()[i];
+                for (std::size_t ch{0}; ch < 3; ch++) {
+                    c[ch] = static_cast<float>(vals[6 + ch] * colorScale);
+                }
+            }
+        }
+    }
+    return cloud;
+}
+
+/**
+ * @brief Write a point cloud as a binary little-endian PLY file
+ *
+ * Colors are written as 8-bit RGB. The file has an empty face element.
+ */
+template <class PointCloudType>
+void ply_write_points(
+    const std::filesystem::path& path, const PointCloudType& cloud)
+{
+    using T = typename PointCloudType::value_type;
+    if (cloud.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::overflow_error("Too many vertices for PLY");
+    }
+    const auto normals = cloud.hasNormals();
+    const auto colors = cloud.hasColors();
+
+    std::ofstream file(path, std::ios::binary);
+    if (not file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + path.string());
+    }
+    ply_write_header<T, PointCloudType::dims>(
+        file, cloud.size(), 0, normals, colors);
+    write_records(file, cloud.size(), [&](auto i, std::string& buf) {
+        auto append = [&](const auto& val) { ply_append_value(buf, val); };
+        for (const auto& c : cloud.points()[i]) {
+            append(c);
+        }
+        if (normals) {
+            for (const auto& c : cloud.normals()[i]) {
+                append(c);
+            }
+        }
+        if (colors) {
+            for (const auto& c : cloud.colors()[i]) {
+                append(static_cast<std::uint8_t>(
+                    std::lround(std::clamp(c, 0.F, 1.F) * 255.F)));
+            }
+        }
+    });
+    file.close();
+    if (file.fail()) {
+        throw std::runtime_error("Failed to write file: " + path.string());
+    }
+}
+}  // namespace detail
+
+/**
+ * @brief Read a PointCloud from disk
+ *
+ * The file format is determined by the file extension. Supported formats:
+ *   - PLY (`.ply`)
+ *
+ * The vertices of the file are loaded as points, along with their normals
+ * and colors if present. Faces are ignored, so meshes can be loaded as
+ * point clouds.
+ *
+ * ```{.cpp}
+ * auto cloud = read_point_cloud<PointCloud3f>("scan.ply");
+ * ```
+ *
+ * @throws std::invalid_argument If the file format is not supported
+ * @throws std::runtime_error If the file cannot be read or parsed
+ */
+template <class PointCloudType>
+auto read_point_cloud(const std::filesystem::path& path) -> PointCloudType
+{
+    constexpr auto Dims = PointCloudType::dims;
+    static_assert(Dims == 2 or Dims == 3, "PLY only supports 2D and 3D");
+    if (is_file_type(path, "ply")) {
+        return detail::ply_read_points<PointCloudType>(path);
+    }
+    auto ext = path.extension().string();
+    throw std::invalid_argument("Unsupported file type: " + ext);
+}
+
+/**
+ * @brief Write a PointCloud to disk
+ *
+ * The file format is determined by the file extension. Supported formats:
+ *   - PLY (`.ply`, binary little-endian)
+ *
+ * Colors are written as 8-bit RGB.
+ *
+ * @throws std::invalid_argument If the file format is not supported
+ * @throws std::runtime_error If the file cannot be written
+ * @throws std::overflow_error If the cloud has more than 2^32 points
+ */
+template <class PointCloudType>
+void write_point_cloud(
+    const std::filesystem::path& path, const PointCloudType& cloud)
+{
+    constexpr auto Dims = PointCloudType::dims;
+    static_assert(Dims == 2 or Dims == 3, "PLY only supports 2D and 3D");
+    if (is_file_type(path, "ply")) {
+        detail::ply_write_points(path, cloud);
+    } else {
+        auto ext = path.extension().string();
+        throw std::invalid_argument("Unsupported file type: " + ext);
+    }
+}
+
+}  // namespace educelab
@@ -2,19 +2,184 @@
 
 /** @file */
 
-#include <regex>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <variant>
 
 #include "educelab/core/types/Vec.hpp"
+#include "educelab/core/utils/MemoryUsage.hpp"
 
 namespace educelab
 {
 
 namespace detail
 {
-/** Regular expression for recognizing hexadecimal color codes */
-const std::regex REGEX_HEX_COLOR{"^#([A-Fa-f0-9]{3}|[A-Fa-f0-9]{6})$"};
+/** Component type and number of channels of a color value type */
+template <typename T>
+struct ColorTraits {
+    /** Component type */
+    using component = T;
+    /** Number of channels */
+    static constexpr std::size_t channels{1};
+};
+
+/** @copydoc ColorTraits */
+template <typename T, std::size_t N>
+struct ColorTraits<Vec<T, N>> {
+    /** Component type */
+    using component = T;
+    /** Number of channels */
+    static constexpr std::size_t channels{N};
+};
+
+/** Maximum value of a color component. Floating-point colors are in [0, 1]. */
+template <typename T>
+constexpr auto color_max() -> T
+{
+    if constexpr (std::is_floating_point_v<T>) {
+        return T{1};
+    } else {
+        return std::numeric_limits<T>::max();
+    }
+}
+
+/**
+ * @brief Convert a color component between depths
+ *
+ * Values are scaled by the ratio of the depths' maximum values and rounded to
+ * the nearest integer. Floating-point values are clamped to [0, 1] before
+ * conversion to an integer depth, and NaN converts to zero. The conversion is
+ * branch-free so that loops over it can be vectorized.
+ */
+template <typename Out, typename In>
+auto convert_component(In v) -> Out
+{
+    if constexpr (std::is_same_v<In, Out>) {
+        return v;
+    } else if constexpr (std::is_floating_point_v<Out>) {
+        return static_cast<Out>(v) / static_cast<Out>(color_max<In>());
+    } else if constexpr (std::is_floating_point_v<In>) {
+        v = v > In{0} ? v : In{0};
+        v = v < In{1} ? v : In{1};
+        return static_cast<Out>(v * color_max<Out>() + In{0.5});
+    } else {
+        constexpr std::uint32_t inMax{color_max<In>()};
+        constexpr std::uint32_t outMax{color_max<Out>()};
+        auto u = static_cast<std::uint32_t>(v);
+        return static_cast<Out>((u * outMax + inMax / 2) / inMax);
+    }
+}
+
+/**
+ * @brief Convert a color value between color value types
+ *
+ * Components are converted with convert_component(). Grayscale values are
+ * replicated to every RGB channel and RGB values are reduced to grayscale by
+ * their luma (ITU-R BT.601 weights). Alpha is dropped when converting to a
+ * type without alpha and is set to opaque when converting from one.
+ */
+template <typename Dst, typename Src>
+auto convert_color(const Src& src) -> Dst
+{
+    using Out = typename ColorTraits<Dst>::component;
+    constexpr auto srcCns = ColorTraits<Src>::channels;
+    constexpr auto dstCns = ColorTraits<Dst>::channels;
+
+    if constexpr (srcCns == 1 and dstCns == 1) {
+        return convert_component<Out>(src);
+    } else if constexpr (dstCns == 1) {
+        auto y = 0.299F * convert_component<float>(src[0]) +
+                 0.587F * convert_component<float>(src[1]) +
+                 0.114F * convert_component<float>(src[2]);
+        return convert_component<Out>(y);
+    } else {
+        Dst dst;
+        if constexpr (srcCns == 1) {
+            auto gray = convert_component<Out>(src);
+            dst[0] = gray;
+            dst[1] = gray;
+            dst[2] = gray;
+        } else {
+            for (std::size_t c{0}; c < 3; c++) {
+                dst[c] = convert_component<Out>(src[c]);
+            }
+        }
+        if constexpr (dstCns == 4 and srcCns == 4) {
+            dst[3] = convert_component<Out>(src[3]);
+        } else if constexpr (dstCns == 4) {
+            dst[3] = color_max<Out>();
+        }
+        return dst;
+    }
+}
+
+/** Value of a hexadecimal digit, or -1 if `c` is not a hexadecimal digit */
+inline auto hex_digit(char c) -> int
+{
+    if (c >= '0' and c <= '9') {
+        return c - '0';
+    }
+    // Setting the 0x20 bit lowercases ASCII letters
+    auto lower = static_cast<char>(c | 0x20);
+    if (lower >= 'a' and lower <= 'f') {
+        return lower - 'a' + 10;
+    }
+    return -1;
+}
+
+/**
+ * @brief Parse a hexadecimal color code (`#0a3` or `#00aa33`) to 8-bit RGB
+ *
+ * Digits may be upper or lowercase. A 3-digit code is expanded by repeating
+ * each digit. Returns false, leaving `rgb` unspecified, if `hex` is not a
+ * valid color code.
+ */
+inline auto parse_hex_color(std::string_view hex, Vec<std::uint8_t, 3>& rgb)
+    -> bool
+{
+    if ((hex.size() != 4 and hex.size() != 7) or hex[0] != '#') {
+        return false;
+    }
+    const auto wide = hex.size() == 7;
+    for (std::size_t c{0}; c < 3; c++) {
+        auto hi = hex_digit(hex[wide ? 1 + 2 * c : 1 + c]);
+        auto lo = wide ? hex_digit(hex[2 + 2 * c]) : hi;
+        if (hi < 0 or lo < 0) {
+            return false;
+        }
+        rgb[c] = static_cast<std::uint8_t>(hi * 16 + lo);
+    }
+    return true;
+}
+
+/**
+ * @brief Write 8-bit RGB as a 6-digit, lowercase hexadecimal color code
+ *
+ * Writes exactly 7 characters to `out` and no null terminator.
+ */
+inline void format_hex_color(const Vec<std::uint8_t, 3>& rgb, char* out)
+{
+    constexpr std::string_view digits{"0123456789abcdef"};
+    out[0] = '#';
+    for (std::size_t c{0}; c < 3; c++) {
+        out[1 + 2 * c] = digits[rgb[c] >> 4];
+        out[2 + 2 * c] = digits[rgb[c] & 0xF];
+    }
+}
+
+/** Convert 8-bit RGB to a 6-digit, lowercase hexadecimal color code */
+inline auto rgb_to_hex(const Vec<std::uint8_t, 3>& rgb) -> std::string
+{
+    std::string hex(7, '#');
+    format_hex_color(rgb, hex.data());
+    return hex;
+}
 }  // namespace detail
 
 /**
@@ -33,6 +198,10 @@ const std::regex REGEX_HEX_COLOR{"^#([A-Fa-f0-9]{3}|[A-Fa-f0-9]{6})$"};
  * c = Color::U8C3{255, 0, 0};
  * std::cout << c.type_name() << "\n";           // "U8C3"
  * std::cout << c.value<Color::U8C3>() << "\n";  // "[255, 0, 0]"
+ *
+ * // Values are converted to other types on request
+ * std::cout << c.value<Color::F32C4>() << "\n";  // "[1, 0, 0, 1]"
+ * std::cout << c.value<Color::HexCode>() << "\n";  // "#ff0000"
  * ```
  */
 class Color
@@ -61,7 +230,9 @@ public:
         /** 32-bit float RGBA color */
         F32C4,
         /**
-         * Hexadecimal RGB color string of 3 or 6 digits (`#0a3` or `#00aa33`)
+         * Hexadecimal RGB color string of 6 digits (`#00aa33`). Hex strings
+         * assigned to a Color are stored as U8C3, so this type is only
+         * produced by convert().
          */
         HexCode
     };
@@ -96,16 +267,15 @@ public:
     {
     }
 
-    /** @brief Construct from hexadecimal string */
-    explicit Color(std::string_view str)
-    {
-        if (not std::regex_match(
-                str.begin(), str.end(), detail::REGEX_HEX_COLOR)) {
-            throw std::invalid_argument(
-                "String not a hex color code: " + std::string(str));
-        }
-        val_ = std::string(str);
-    }
+    /**
+     * @brief Construct from hexadecimal string
+     *
+     * The string is parsed and stored as a U8C3 value.
+     *
+     * @throws std::invalid_argument If `str` is not a 3 or 6 digit
+     * hexadecimal color code
+     */
+    explicit Color(std::string_view str) { operator=(str); }
 
     /** @brief Construct from hexadecimal CString */
     explicit Color(const char* str) : Color(std::string_view(str)) {}
@@ -121,15 +291,22 @@ public:
         return *this;
     }
 
-    /** @brief Assign a hexadecimal string value */
+    /**
+     * @brief Assign a hexadecimal string value
+     *
+     * The string is parsed and stored as a U8C3 value.
+     *
+     * @throws std::invalid_argument If `str` is not a 3 or 6 digit
+     * hexadecimal color code
+     */
     auto operator=(std::string_view str) -> Color&
     {
-        if (not std::regex_match(
-                str.begin(), str.end(), detail::REGEX_HEX_COLOR)) {
+        U8C3 rgb;
+        if (not detail::parse_hex_color(str, rgb)) {
             throw std::invalid_argument(
                 "String not a hex color code: " + std::string(str));
         }
-        val_ = std::string(str);
+        val_ = rgb;
         return *this;
     }
 
@@ -194,6 +371,15 @@ public:
     /**
      * @brief Get the stored color value in the format of the requested color
      * type
+     *
+     * Values are converted between types by scaling each channel by the
+     * maximum value of its depth (floating-point colors are in [0, 1]).
+     * Grayscale values are replicated to the RGB channels, RGB values are
+     * converted to grayscale by their luma, and missing alpha is opaque.
+     * HexCode values convert through U8C3, and conversions to HexCode always
+     * produce 6-digit, lowercase codes.
+     *
+     * @throws std::bad_variant_access If the Color has no value
      */
     template <typename T>
     [[nodiscard]] auto value() const -> T
@@ -203,13 +389,48 @@ public:
             return std::get<T>(val_);
         }
 
-        // TODO: Do convert to requested type
-        throw std::bad_variant_access();
+        return std::visit(
+            [](const auto& v) -> T {
+                using V = std::decay_t<decltype(v)>;
+                if constexpr (std::is_same_v<V, std::monostate>) {
+                    throw std::bad_variant_access();
+                } else if constexpr (std::is_same_v<T, V>) {
+                    return v;
+                } else if constexpr (std::is_same_v<V, HexCode>) {
+                    U8C3 rgb;
+                    detail::parse_hex_color(v, rgb);
+                    return detail::convert_color<T>(rgb);
+                } else if constexpr (std::is_same_v<T, HexCode>) {
+                    return detail::rgb_to_hex(
+                        detail::convert_color<U8C3>(v));
+                } else {
+                    return detail::convert_color<T>(v);
+                }
+            },
+            val_);
     }
 
+    /**
+     * @brief Get a copy of this color converted to the given color type
+     *
+     * Converting to Type::None returns an empty Color.
+     *
+     * @see value()
+     */
+    [[nodiscard]] auto convert(Type type) const -> Color;
+
     /** @brief Clear the stored value */
     auto clear() -> void { val_ = std::monostate{}; }
 
+    /**
+     * @brief Get the number of bytes used by this color, including the heap
+     * memory of a stored HexCode
+     */
+    [[nodiscard]] auto memoryUsage() const -> std::size_t
+    {
+        return sizeof(Color) + detail::heap_usage(val_);
+    }
+
 private:
     /** Container type for storing all color values */
     using Container = std::variant<
@@ -227,4 +448,101 @@ private:
     /** Color value */
     Container val_{};
 };
+
+namespace detail
+{
+/** Color::Type of a color value type */
+template <typename T>
+constexpr auto color_type() -> Color::Type
+{
+    if constexpr (std::is_same_v<T, Color::U8C1>) {
+        return Color::Type::U8C1;
+    } else if constexpr (std::is_same_v<T, Color::U8C3>) {
+        return Color::Type::U8C3;
+    } else if constexpr (std::is_same_v<T, Color::U8C4>) {
+        return Color::Type::U8C4;
+    } else if constexpr (std::is_same_v<T, Color::U16C1>) {
+        return Color::Type::U16C1;
+    } else if constexpr (std::is_same_v<T, Color::U16C3>) {
+        return Color::Type::U16C3;
+    } else if constexpr (std::is_same_v<T, Color::U16C4>) {
+        return Color::Type::U16C4;
+    } else if constexpr (std::is_same_v<T, Color::F32C1>) {
+        return Color::Type::F32C1;
+    } else if constexpr (std::is_same_v<T, Color::F32C3>) {
+        return Color::Type::F32C3;
+    } else if constexpr (std::is_same_v<T, Color::F32C4>) {
+        return Color::Type::F32C4;
+    } else if constexpr (std::is_same_v<T, Color::HexCode>) {
+        return Color::Type::HexCode;
+    } else {
+        return Color::Type::None;
+    }
+}
+
+/**
+ * @brief Call `f(tag)` with the std::in_place_type_t tag of the color value
+ * type for `type`
+ *
+ * Type::None passes the tag of std::monostate.
+ */
+template <typename Func>
+auto visit_color_type(Color::Type type, Func&& f)
+{
+    switch (type) {
+        case Color::Type::U8C1:
+            return f(std::in_place_type<Color::U8C1>);
+        case Color::Type::U8C3:
+            return f(std::in_place_type<Color::U8C3>);
+        case Color::Type::U8C4:
+            return f(std::in_place_type<Color::U8C4>);
+        case Color::Type::U16C1:
+            return f(std::in_place_type<Color::U16C1>);
+        case Color::Type::U16C3:
+            return f(std::in_place_type<Color::U16C3>);
+        case Color::Type::U16C4:
+            return f(std::in_place_type<Color::U16C4>);
+        case Color::Type::F32C1:
+            return f(std::in_place_type<Color::F32C1>);
+        case Color::Type::F32C3:
+            return f(std::in_place_type<Color::F32C3>);
+        case Color::Type::F32C4:
+            return f(std::in_place_type<Color::F32C4>);
+        case Color::Type::HexCode:
+            return f(std::in_place_type<Color::HexCode>);
+        case Color::Type::None:
+            break;
+    }
+    return f(std::in_place_type<std::monostate>);
+}
+
+/** Value type of a std::in_place_type_t tag */
+template <typename Tag>
+struct in_place_value;
+
+/** @copydoc in_place_value */
+template <typename T>
+struct in_place_value<std::in_place_type_t<T>> {
+    /** Tagged type */
+    using type = T;
+};
+
+/** @copydoc in_place_value */
+template <typename Tag>
+using in_place_value_t = typename in_place_value<std::decay_t<Tag>>::type;
+}  // namespace detail
+
+inline auto Color::convert(Type type) const -> Color
+{
+    return detail::visit_color_type(type, [this](auto tag) -> Color {
+        using T = detail::in_place_value_t<decltype(tag)>;
+        if constexpr (std::is_same_v<T, std::monostate>) {
+            return Color{};
+        } else {
+            Color c;
+            c.val_ = value<T>();
+            return c;
+        }
+    });
+}
 }  // namespace educelab
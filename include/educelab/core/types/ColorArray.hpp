@@ -0,0 +1,275 @@
+#pragma once
+
+/** @file */
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "educelab/core/types/Color.hpp"
+#include "educelab/core/utils/MemoryUsage.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+
+namespace educelab
+{
+
+/**
+ * @brief Convert an array of colors to another color value type
+ *
+ * Each color is converted as by Color::value(). Colors are converted in
+ * parallel blocks, and each block is a simple loop over the branch-free
+ * channel conversions so that the compiler can vectorize it.
+ *
+ * ```{.cpp}
+ * std::vector<Color::U8C3> rgb(n);
+ * auto rgba = convert_colors<Color::F32C4>(rgb);
+ * ```
+ */
+template <typename Dst, typename Src>
+auto convert_colors(const std::vector<Src>& src) -> std::vector<Dst>
+{
+    static_assert(
+        not std::is_same_v<Src, Color::HexCode> and
+            not std::is_same_v<Dst, Color::HexCode>,
+        "HexCode arrays are not supported");
+    std::vector<Dst> dst(src.size());
+    const auto* in = src.data();
+    auto* out = dst.data();
+    parallel_for_blocks(
+        0, src.size(),
+        [in, out](auto b, auto e) {
+            for (auto i = b; i < e; i++) {
+                out[i] = detail::convert_color<Dst>(in[i]);
+            }
+        },
+        16384);
+    return dst;
+}
+
+/**
+ * @brief Packed array of colors which share a single color type
+ *
+ * A Color can hold any color type, so it is the size of its largest value
+ * type and has to check its type on every access. ColorArray stores a single
+ * typed array instead: a U8C3 array uses 3 bytes per color and the values can
+ * be passed directly to file writers and image buffers. Use it for
+ * per-element colors, such as per-vertex or per-point colors.
+ *
+ * Colors can be accessed individually as Color objects, which are converted
+ * to and from the array's type, or in bulk through values(). convert()
+ * converts the whole array to another type.
+ *
+ * ```{.cpp}
+ * ColorArray colors(Color::Type::U8C3, mesh.size());
+ * colors.set(0, Color("#ff0000"));
+ * for (auto& c : colors.values<Color::U8C3>()) {
+ *     c[1] = 255;
+ * }
+ * auto floats = colors.convert(Color::Type::F32C4);
+ * ```
+ *
+ * HexCode arrays are not supported.
+ */
+class ColorArray
+{
+public:
+    /** @brief Default constructor. The array has Type::None and no colors. */
+    ColorArray() = default;
+
+    /**
+     * @brief Construct an array of `size` colors of the given type
+     *
+     * Colors are zero-initialized.
+     *
+     * @throws std::invalid_argument If `type` is Type::None or Type::HexCode
+     */
+    explicit ColorArray(Color::Type type, std::size_t size = 0)
+    {
+        detail::visit_color_type(type, [&](auto tag) {
+            using T = detail::in_place_value_t<decltype(tag)>;
+            if constexpr (
+                std::is_same_v<T, std::monostate> or
+                std::is_same_v<T, Color::HexCode>) {
+                throw std::invalid_argument("Unsupported color array type");
+            } else {
+                vals_.emplace<std::vector<T>>(size);
+            }
+        });
+    }
+
+    /** @brief Construct from a list of color values */
+    template <typename T>
+    explicit ColorArray(std::vector<T> values)
+        : vals_{std::in_place_type<std::vector<T>>, std::move(values)}
+    {
+    }
+
+    /** @brief Get the color type of the array */
+    [[nodiscard]] auto type() const -> Color::Type
+    {
+        return static_cast<Color::Type>(vals_.index());
+    }
+
+    /** @brief Number of colors in the array */
+    [[nodiscard]] auto size() const -> std::size_t
+    {
+        return std::visit([](const auto& v) { return size_of(v); }, vals_);
+    }
+
+    /** @brief Whether the array has no colors */
+    [[nodiscard]] auto empty() const -> bool { return size() == 0; }
+
+    /**
+     * @brief Get the color at an index
+     *
+     * @throws std::out_of_range If `idx` is out of range
+     */
+    [[nodiscard]] auto get(std::size_t idx) const -> Color
+    {
+        return std::visit(
+            [idx](const auto& v) -> Color {
+                if constexpr (std::is_same_v<
+                                  std::decay_t<decltype(v)>,
+                                  std::monostate>) {
+                    throw std::out_of_range("Color index out of range");
+                } else {
+                    return Color(v.at(idx));
+                }
+            },
+            vals_);
+    }
+
+    /**
+     * @brief Set the color at an index
+     *
+     * The color is converted to the array's type.
+     *
+     * @throws std::out_of_range If `idx` is out of range
+     * @throws std::bad_variant_access If `color` has no value
+     */
+    void set(std::size_t idx, const Color& color)
+    {
+        std::visit(
+            [idx, &color](auto& v) {
+                using V = std::decay_t<decltype(v)>;
+                if constexpr (std::is_same_v<V, std::monostate>) {
+                    throw std::out_of_range("Color index out of range");
+                } else {
+                    using T = typename V::value_type;
+                    v.at(idx) = color.value<T>();
+                }
+            },
+            vals_);
+    }
+
+    /**
+     * @brief Get the color values
+     *
+     * Provides direct access to the underlying storage for bulk operations.
+     *
+     * @throws std::bad_variant_access If `T` is not the array's value type
+     */
+    template <typename T>
+    [[nodiscard]] auto values() const -> const std::vector<T>&
+    {
+        return std::get<std::vector<T>>(vals_);
+    }
+
+    /** @copydoc values() const */
+    template <typename T>
+    [[nodiscard]] auto values() -> std::vector<T>&
+    {
+        return std::get<std::vector<T>>(vals_);
+    }
+
+    /**
+     * @brief Resize the array to `n` colors
+     *
+     * New colors are zero-initialized. Does nothing for Type::None arrays.
+     */
+    void resize(std::size_t n)
+    {
+        std::visit([n](auto& v) { resize_of(v, n); }, vals_);
+    }
+
+    /** @brief Remove all colors. The array keeps its type. */
+    void clear() { resize(0); }
+
+    /**
+     * @brief Get a copy of this array converted to the given color type
+     *
+     * @see convert_colors()
+     * @throws std::invalid_argument If `type` is Type::None or Type::HexCode
+     */
+    [[nodiscard]] auto convert(Color::Type type) const -> ColorArray
+    {
+        if (type == this->type()) {
+            return *this;
+        }
+        ColorArray result(type);
+        std::visit(
+            [](const auto& src, auto& dst) {
+                using S = std::decay_t<decltype(src)>;
+                using D = std::decay_t<decltype(dst)>;
+                if constexpr (
+                    not std::is_same_v<S, std::monostate> and
+                    not std::is_same_v<D, std::monostate>) {
+                    dst = convert_colors<typename D::value_type>(src);
+                }
+            },
+            vals_, result.vals_);
+        return result;
+    }
+
+    /** @brief Get the number of bytes used by this array */
+    [[nodiscard]] auto memoryUsage() const -> std::size_t
+    {
+        return sizeof(ColorArray) + detail::heap_usage(vals_);
+    }
+
+private:
+    /** Size of a value list */
+    template <typename T>
+    static auto size_of(const std::vector<T>& v) -> std::size_t
+    {
+        return v.size();
+    }
+
+    /** Size of an empty array */
+    static auto size_of(const std::monostate& /*unused*/) -> std::size_t
+    {
+        return 0;
+    }
+
+    /** Resize a value list */
+    template <typename T>
+    static void resize_of(std::vector<T>& v, std::size_t n)
+    {
+        v.resize(n);
+    }
+
+    /** Resize an empty array */
+    static void resize_of(std::monostate& /*unused*/, std::size_t /*unused*/)
+    {
+    }
+
+    /** Container type for storing the typed value lists */
+    using Container = std::variant<
+        std::monostate,
+        std::vector<Color::U8C1>,
+        std::vector<Color::U8C3>,
+        std::vector<Color::U8C4>,
+        std::vector<Color::U16C1>,
+        std::vector<Color::U16C3>,
+        std::vector<Color::U16C4>,
+        std::vector<Color::F32C1>,
+        std::vector<Color::F32C3>,
+        std::vector<Color::F32C4>>;
+    /** Color values */
+    Container vals_{};
+};
+
+}  // namespace educelab
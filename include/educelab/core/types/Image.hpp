@@ -5,6 +5,8 @@
 #include <cstdint>
 #include <vector>
 
+#include "educelab/core/utils/MemoryUsage.hpp"
+
 namespace educelab
 {
 
@@ -13,7 +15,8 @@ enum class Depth {
     None, /** Unset or unspecified */
     U8,   /** Unsigned 8-bit integer */
     U16,  /** Unsigned 16-bit integer */
-    F32   /** 32-bit float */
+    F32,  /** 32-bit float */
+    U32   /** Unsigned 32-bit integer labels. Cannot be converted. */
 };
 
 /** @brief Class for storing image data */
@@ -55,6 +58,12 @@ public:
     /** @brief Get the size of the image in bytes */
     [[nodiscard]] auto size() const -> std::size_t;
 
+    /**
+     * @brief Get the number of bytes used by this image, including its pixel
+     * storage
+     */
+    [[nodiscard]] auto memoryUsage() const -> std::size_t;
+
     /** @copydoc empty() */
     explicit operator bool() const noexcept;
 
@@ -2,13 +2,20 @@
 
 /** @file */
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <memory>
 #include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include <variant>
 #include <vector>
 
 #include "educelab/core/types/Color.hpp"
 #include "educelab/core/types/Vec.hpp"
+#include "educelab/core/utils/MemoryUsage.hpp"
 
 namespace educelab
 {
@@ -32,6 +39,36 @@ struct DefaultVertexTraits {
     /** @brief Vertex color */
     Color color;
 };
+
+/** @brief Detect whether a vertex type provides a `normal` trait */
+template <class V, class = void>
+struct has_normal : std::false_type {
+};
+
+/** @copydoc has_normal */
+template <class V>
+struct has_normal<V, std::void_t<decltype(std::declval<V>().normal)>>
+    : std::true_type {
+};
+
+/** @copydoc has_normal */
+template <class V>
+constexpr bool has_normal_v = has_normal<V>::value;
+
+/** @brief Detect whether a vertex type provides a `color` trait */
+template <class V, class = void>
+struct has_color : std::false_type {
+};
+
+/** @copydoc has_color */
+template <class V>
+struct has_color<V, std::void_t<decltype(std::declval<V>().color)>>
+    : std::true_type {
+};
+
+/** @copydoc has_color */
+template <class V>
+constexpr bool has_color_v = has_color<V>::value;
 }  // namespace traits
 
 /**
@@ -40,17 +77,35 @@ struct DefaultVertexTraits {
  * @tparam T Numeric type to use for coordinate system
  * @tparam Dims Number of dimensions in the coordinate system
  * @tparam VertexTraits Additional vertex traits
+ * @tparam IndexType Unsigned integer type used to store vertex and texture
+ * coordinate indices. Defaults to 32-bit indices, which halves the size of
+ * the face list compared to 64-bit indices. Use `std::uint64_t` for meshes
+ * with more than 2^32 - 1 vertices.
  */
 template <
     typename T,
     std::size_t Dims,
     typename VertexTraits = traits::DefaultVertexTraits<T, Dims>,
+    typename IndexType = std::uint32_t,
     std::enable_if_t<std::is_arithmetic<T>::value, bool> = true>
 class Mesh
 {
+    static_assert(
+        std::is_integral_v<IndexType> and std::is_unsigned_v<IndexType>,
+        "IndexType must be an unsigned integer type");
+
 public:
     /** Pointer type */
     using Pointer = std::shared_ptr<Mesh>;
+    /** Coordinate numeric type */
+    using value_type = T;
+    /** Number of dimensions in the coordinate system */
+    static constexpr std::size_t dims{Dims};
+    /** Vertex and texture coordinate index type */
+    using index_type = IndexType;
+    /** Largest index representable by index_type */
+    static constexpr std::size_t max_index{
+        std::numeric_limits<IndexType>::max()};
 
     /** @brief %Vertex type */
     struct Vertex : public Vec<T, Dims>, public VertexTraits {
@@ -70,6 +125,22 @@ public:
         /** Inherit assignment operators */
         using Vec<T, Dims>::operator=;
 
+        /**
+         * @brief Get the number of bytes used by this vertex, including the
+         * heap memory of its traits
+         */
+        [[nodiscard]] auto memoryUsage() const -> std::size_t
+        {
+            if constexpr (traits::has_memory_usage_v<VertexTraits>) {
+                return sizeof(Vertex) - sizeof(VertexTraits) +
+                       static_cast<const VertexTraits&>(*this).memoryUsage();
+            } else if constexpr (traits::has_color_v<VertexTraits>) {
+                return sizeof(Vertex) + detail::heap_usage(this->color);
+            } else {
+                return sizeof(Vertex);
+            }
+        }
+
         /** @brief Addition operator */
         template <class Vector>
         friend auto operator+(Vertex lhs, const Vector& rhs) -> Vertex
@@ -104,25 +175,96 @@ public:
     };
 
     /** @brief Face type */
-    using Face = std::vector<std::size_t>;
+    using Face = std::vector<index_type>;
+
+    /** @brief Texture coordinate type */
+    using UV = Vec<T, 2>;
 
     /** @brief Default constructor */
     Mesh() = default;
 
+    /**
+     * @brief Convert from a mesh with a different index type
+     *
+     * @throws std::overflow_error If `other` has more vertices or texture
+     * coordinates than can be indexed by index_type
+     */
+    template <typename OtherIndex>
+    explicit Mesh(const Mesh<T, Dims, VertexTraits, OtherIndex>& other)
+        : vertices_(other.numVertices()), uvs_{other.uvs()}
+    {
+        checkCapacity(vertices_.size());
+        checkCapacity(uvs_.size());
+        // Each index type has its own Vertex type with the same bases
+        for (std::size_t v{0}; v < vertices_.size(); v++) {
+            const auto& src = other.vertex(v);
+            static_cast<Vec<T, Dims>&>(vertices_[v]) = src;
+            static_cast<VertexTraits&>(vertices_[v]) = src;
+        }
+        auto convert = [](const auto& src) {
+            std::vector<Face> dst(src.size());
+            for (std::size_t f{0}; f < src.size(); f++) {
+                dst[f].reserve(src[f].size());
+                for (const auto& v : src[f]) {
+                    dst[f].push_back(toIndex(v));
+                }
+            }
+            return dst;
+        };
+        faces_ = convert(other.faces());
+        faceUVs_ = convert(other.faceUVs());
+    }
+
     /** Construct a new mesh */
     [[nodiscard]] static auto New() -> Pointer
     {
         return std::make_shared<Mesh>();
     }
 
+    /**
+     * @brief Convert a value to index_type
+     *
+     * @throws std::overflow_error If `idx` is negative or larger than
+     * max_index
+     */
+    template <typename I>
+    static auto toIndex(I idx) -> index_type
+    {
+        static_assert(std::is_integral_v<I>, "Index must be an integer");
+        if constexpr (std::is_signed_v<I>) {
+            if (idx < 0) {
+                throw std::overflow_error("Negative mesh index");
+            }
+        }
+        if (static_cast<std::make_unsigned_t<I>>(idx) > max_index) {
+            throw std::overflow_error("Index exceeds mesh index type");
+        }
+        return static_cast<index_type>(idx);
+    }
+
+    /**
+     * @brief Check that `count` elements can be indexed by index_type
+     *
+     * @throws std::overflow_error If `count - 1` is larger than max_index
+     */
+    static void checkCapacity(std::size_t count)
+    {
+        if (count > 0 and count - 1 > max_index) {
+            throw std::overflow_error("Element count exceeds mesh index type");
+        }
+    }
+
     /**
      * @brief Insert a vertex
      *
      * Returns the index of the vertex in the mesh.
+     *
+     * @throws std::overflow_error If the index of the new vertex cannot be
+     * represented by index_type
      */
-    auto insertVertex(const Vertex& v) -> std::size_t
+    auto insertVertex(const Vertex& v) -> index_type
     {
-        auto idx = vertices_.size();
+        auto idx = toIndex(vertices_.size());
         vertices_.push_back(v);
         return idx;
     }
@@ -132,12 +274,15 @@ public:
      *
      * The number of arguments provided must match Dims. Returns the index of
      * the vertex in the mesh.
+     *
+     * @throws std::overflow_error If the index of the new vertex cannot be
+     * represented by index_type
      */
     template <typename... Args>
-    auto insertVertex(Args... args) -> std::size_t
+    auto insertVertex(Args... args) -> index_type
     {
         static_assert(sizeof...(args) == Dims, "Incorrect number of arguments");
-        auto idx = vertices_.size();
+        auto idx = toIndex(vertices_.size());
         vertices_.emplace_back(args...);
         return idx;
     }
@@ -170,13 +315,17 @@ public:
      * @brief Insert a face with vertex index values
      *
      * Returns the index of the face in the mesh.
+     *
+     * @throws std::overflow_error If an index cannot be represented by
+     * index_type
      */
     template <typename... Indices>
     auto insertFace(Indices... indices) -> std::size_t
     {
         static_assert(sizeof...(indices) >= 3, "Face must have >= 3 vertices");
+        Face f{toIndex(indices)...};
         auto idx = faces_.size();
-        faces_.emplace_back(indices...);
+        faces_.emplace_back(std::move(f));
         return idx;
     }
 
@@ -189,11 +338,191 @@ public:
     /** @brief Get a face by index */
     [[nodiscard]] auto face(std::size_t idx) -> Face& { return faces_.at(idx); }
 
+    /**
+     * @brief Insert a face with per-corner texture coordinates
+     *
+     * `uvs` holds an index into the UV list for each corner of `f`. Returns
+     * the index of the face in the mesh.
+     *
+     * @throws std::invalid_argument If `f` and `uvs` have different sizes
+     */
+    auto insertFace(const Face& f, const Face& uvs) -> std::size_t
+    {
+        if (f.size() != uvs.size()) {
+            throw std::invalid_argument("Face and face UVs differ in size");
+        }
+        auto idx = faces_.size();
+        faces_.emplace_back(f);
+        faceUVs_.resize(idx);
+        faceUVs_.emplace_back(uvs);
+        return idx;
+    }
+
+    /**
+     * @brief Insert a texture coordinate
+     *
+     * Returns the index of the texture coordinate in the mesh.
+     *
+     * @throws std::overflow_error If the index of the new texture coordinate
+     * cannot be represented by index_type
+     */
+    auto insertUV(const UV& uv) -> index_type
+    {
+        auto idx = toIndex(uvs_.size());
+        uvs_.push_back(uv);
+        return idx;
+    }
+
+    /** @copydoc insertUV(const UV&) */
+    auto insertUV(T u, T v) -> index_type { return insertUV(UV{u, v}); }
+
+    /** @brief Get a texture coordinate by index */
+    [[nodiscard]] auto uv(std::size_t idx) const -> const UV&
+    {
+        return uvs_.at(idx);
+    }
+
+    /** @brief Get a texture coordinate by index */
+    [[nodiscard]] auto uv(std::size_t idx) -> UV& { return uvs_.at(idx); }
+
+    /**
+     * @brief Get the texture coordinate indices of a face's corners
+     *
+     * Returns an empty list if the face has no texture coordinates.
+     */
+    [[nodiscard]] auto faceUV(std::size_t idx) const -> const Face&
+    {
+        static const Face none;
+        if (idx >= faces_.size()) {
+            throw std::out_of_range("Face index out of range");
+        }
+        return idx < faceUVs_.size() ? faceUVs_[idx] : none;
+    }
+
+    /**
+     * @brief Assign one texture coordinate to each vertex
+     *
+     * Replaces the UV list with `uvs` and sets the texture coordinate
+     * indices of every face to its vertex indices.
+     *
+     * @throws std::invalid_argument If `uvs` doesn't have one entry per
+     * vertex
+     */
+    void setVertexUVs(std::vector<UV> uvs)
+    {
+        if (uvs.size() != vertices_.size()) {
+            throw std::invalid_argument(
+                "Vertex UVs and vertices differ in size");
+        }
+        uvs_ = std::move(uvs);
+        faceUVs_ = faces_;
+    }
+
+    /**
+     * @brief Get the vertex list
+     *
+     * Provides direct access to the underlying vertex storage for bulk
+     * operations. Modifying the size of this list may invalidate face indices.
+     */
+    [[nodiscard]] auto vertices() const -> const std::vector<Vertex>&
+    {
+        return vertices_;
+    }
+
+    /** @copydoc vertices() const */
+    [[nodiscard]] auto vertices() -> std::vector<Vertex>& { return vertices_; }
+
+    /**
+     * @brief Get the face list
+     *
+     * Provides direct access to the underlying face storage for bulk
+     * operations.
+     */
+    [[nodiscard]] auto faces() const -> const std::vector<Face>&
+    {
+        return faces_;
+    }
+
+    /** @copydoc faces() const */
+    [[nodiscard]] auto faces() -> std::vector<Face>& { return faces_; }
+
+    /**
+     * @brief Get the texture coordinate list
+     *
+     * Provides direct access to the underlying UV storage for bulk
+     * operations.
+     */
+    [[nodiscard]] auto uvs() const -> const std::vector<UV>& { return uvs_; }
+
+    /** @copydoc uvs() const */
+    [[nodiscard]] auto uvs() -> std::vector<UV>& { return uvs_; }
+
+    /**
+     * @brief Get the per-corner texture coordinate indices of all faces
+     *
+     * Entry `i` holds one UV index for each corner of face `i`, or is empty
+     * if face `i` has no texture coordinates. The list may be shorter than
+     * the face list, in which case the remaining faces have no texture
+     * coordinates.
+     */
+    [[nodiscard]] auto faceUVs() const -> const std::vector<Face>&
+    {
+        return faceUVs_;
+    }
+
+    /** @copydoc faceUVs() const */
+    [[nodiscard]] auto faceUVs() -> std::vector<Face>& { return faceUVs_; }
+
+    /** @brief Number of vertices in the mesh */
+    [[nodiscard]] auto numVertices() const -> std::size_t
+    {
+        return vertices_.size();
+    }
+
+    /** @brief Number of faces in the mesh */
+    [[nodiscard]] auto numFaces() const -> std::size_t { return faces_.size(); }
+
+    /** @brief Number of texture coordinates in the mesh */
+    [[nodiscard]] auto numUVs() const -> std::size_t { return uvs_.size(); }
+
+    /** @brief Whether the mesh has texture coordinates */
+    [[nodiscard]] auto hasUVs() const -> bool { return not uvs_.empty(); }
+
+    /** @brief Whether the mesh has no vertices */
+    [[nodiscard]] auto empty() const -> bool { return vertices_.empty(); }
+
+    /**
+     * @brief Get the number of bytes used by this mesh
+     *
+     * Includes the vertex, face, and texture coordinate lists, the index list
+     * of every face, and the heap memory of vertex traits (e.g. colors).
+     * Unused list capacity is included.
+     */
+    [[nodiscard]] auto memoryUsage() const -> std::size_t
+    {
+        return sizeof(Mesh) + detail::heap_usage(vertices_) +
+               detail::heap_usage(faces_) + detail::heap_usage(uvs_) +
+               detail::heap_usage(faceUVs_);
+    }
+
+    /** @brief Remove all vertices, faces, and texture coordinates */
+    void clear()
+    {
+        vertices_.clear();
+        faces_.clear();
+        uvs_.clear();
+        faceUVs_.clear();
+    }
+
 private:
     /** Vertices */
     std::vector<Vertex> vertices_;
     /** Faces */
     std::vector<Face> faces_;
+    /** Texture coordinates */
+    std::vector<UV> uvs_;
+    /** Texture coordinate indices of each face corner */
+    std::vector<Face> faceUVs_;
 };
 
 /** @brief 3D 32-bit floating-point mesh */
@@ -201,4 +530,74 @@ using Mesh3f = Mesh<float, 3>;
 /** @brief 3D 64-bit floating-point mesh */
 using Mesh3d = Mesh<double, 3>;
 
+/**
+ * @brief Mesh with 64-bit vertex indices
+ *
+ * For meshes with more vertices than can be indexed by the default 32-bit
+ * index type.
+ */
+template <typename T, std::size_t Dims>
+using LargeMesh =
+    Mesh<T, Dims, traits::DefaultVertexTraits<T, Dims>, std::uint64_t>;
+
+namespace detail
+{
+/**
+ * Reorder the face UVs of a mesh to follow a face permutation or removal.
+ * `order[i]` is the old index of new face `i`. Call before or after
+ * reordering the faces themselves.
+ */
+template <class MeshType, class Order>
+void permute_face_uvs(MeshType& mesh, const Order& order)
+{
+    auto& faceUVs = mesh.faceUVs();
+    if (faceUVs.empty()) {
+        return;
+    }
+    std::vector<typename MeshType::Face> result(order.size());
+    for (std::size_t i{0}; i < order.size(); i++) {
+        auto f = static_cast<std::size_t>(order[i]);
+        if (f < faceUVs.size()) {
+            result[i] = std::move(faceUVs[f]);
+        }
+    }
+    faceUVs = std::move(result);
+}
+
+/**
+ * Copy the texture coordinates used by `dst` from `src`. The face UVs of
+ * `dst` must hold UV indices of `src`. Only the referenced UVs are copied, in
+ * source order, and the face UVs are re-indexed to them.
+ *
+ * @throws std::out_of_range If a face UV references an invalid UV of `src`
+ */
+template <class MeshType>
+void copy_used_uvs(MeshType& dst, const MeshType& src)
+{
+    using Index = typename MeshType::Face::value_type;
+    std::vector<std::size_t> used;
+    for (const auto& face : dst.faceUVs()) {
+        used.insert(used.end(), face.begin(), face.end());
+    }
+    if (used.empty()) {
+        return;
+    }
+    std::sort(used.begin(), used.end());
+    used.erase(std::unique(used.begin(), used.end()), used.end());
+    auto& uvs = dst.uvs();
+    uvs.clear();
+    uvs.reserve(used.size());
+    for (const auto& t : used) {
+        uvs.push_back(src.uv(t));
+    }
+    for (auto& face : dst.faceUVs()) {
+        for (auto& t : face) {
+            auto it = std::lower_bound(
+                used.begin(), used.end(), static_cast<std::size_t>(t));
+            t = static_cast<Index>(it - used.begin());
+        }
+    }
+}
+}  // namespace detail
+
 }  // namespace educelab
\ No newline at end of file
@@ -0,0 +1,340 @@
+#pragma once
+
+/** @file */
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "educelab/core/types/Color.hpp"
+#include "educelab/core/types/Vec.hpp"
+#include "educelab/core/utils/MemoryUsage.hpp"
+
+namespace educelab
+{
+
+/**
+ * @brief Point cloud with per-point normals and colors
+ *
+ * Attributes are stored as separate arrays (structure of arrays), so bulk
+ * operations on positions don't touch the normals and colors, and points
+ * carry no per-point overhead for attributes which the cloud doesn't have.
+ * Normals and colors are enabled per cloud. Once enabled, the attribute
+ * arrays have one entry per point and grow with the cloud, including when
+ * the attribute is enabled before any points are inserted.
+ *
+ * ```{.cpp}
+ * PointCloud3f cloud;
+ * cloud.insertPoint(0, 0, 0);
+ * cloud.enableNormals();
+ * cloud.normal(0) = {0, 0, 1};
+ * ```
+ *
+ * @tparam T Numeric type to use for coordinate system
+ * @tparam Dims Number of dimensions in the coordinate system
+ */
+template <
+    typename T,
+    std::size_t Dims,
+    std::enable_if_t<std::is_arithmetic<T>::value, bool> = true>
+class PointCloud
+{
+public:
+    /** Pointer type */
+    using Pointer = std::shared_ptr<PointCloud>;
+    /** Coordinate numeric type */
+    using value_type = T;
+    /** Number of dimensions in the coordinate system */
+    static constexpr std::size_t dims{Dims};
+    /** @brief Point position type */
+    using Point = Vec<T, Dims>;
+    /** @brief Point normal type */
+    using Normal = Vec<T, Dims>;
+    /** @brief Point color type. Channels are in the range [0, 1]. */
+    using PointColor = Color::F32C3;
+
+    /** @brief Default constructor */
+    PointCloud() = default;
+
+    /** @brief Construct from a list of positions */
+    explicit PointCloud(std::vector<Point> points) : points_{std::move(points)}
+    {
+    }
+
+    /** Construct a new point cloud */
+    [[nodiscard]] static auto New() -> Pointer
+    {
+        return std::make_shared<PointCloud>();
+    }
+
+    /**
+     * @brief Insert a point
+     *
+     * If the cloud has normals or colors, the new point's attributes are
+     * zero-initialized. Returns the index of the point.
+     */
+    auto insertPoint(const Point& p) -> std::size_t
+    {
+        auto idx = points_.size();
+        if (normalsEnabled_) {
+            normals_.emplace_back();
+        }
+        if (colorsEnabled_) {
+            colors_.emplace_back();
+        }
+        points_.push_back(p);
+        return idx;
+    }
+
+    /**
+     * @brief Insert a point with element values
+     *
+     * The number of arguments provided must match Dims. Returns the index of
+     * the point.
+     */
+    template <typename... Args>
+    auto insertPoint(Args... args) -> std::size_t
+    {
+        static_assert(sizeof...(args) == Dims, "Incorrect number of arguments");
+        return insertPoint(Point{static_cast<T>(args)...});
+    }
+
+    /** @brief Get a point position by index */
+    [[nodiscard]] auto point(std::size_t idx) const -> const Point&
+    {
+        return points_.at(idx);
+    }
+
+    /** @brief Get a point position by index */
+    [[nodiscard]] auto point(std::size_t idx) -> Point&
+    {
+        return points_.at(idx);
+    }
+
+    /**
+     * @brief Get a point normal by index
+     *
+     * @throws std::out_of_range If the cloud has no normals or `idx` is out
+     * of range
+     */
+    [[nodiscard]] auto normal(std::size_t idx) const -> const Normal&
+    {
+        return normals_.at(idx);
+    }
+
+    /** @copydoc normal(std::size_t) const */
+    [[nodiscard]] auto normal(std::size_t idx) -> Normal&
+    {
+        return normals_.at(idx);
+    }
+
+    /**
+     * @brief Get a point color by index
+     *
+     * @throws std::out_of_range If the cloud has no colors or `idx` is out
+     * of range
+     */
+    [[nodiscard]] auto color(std::size_t idx) const -> const PointColor&
+    {
+        return colors_.at(idx);
+    }
+
+    /** @copydoc color(std::size_t) const */
+    [[nodiscard]] auto color(std::size_t idx) -> PointColor&
+    {
+        return colors_.at(idx);
+    }
+
+    /**
+     * @brief Get the position list
+     *
+     * Provides direct access to the underlying storage for bulk operations.
+     * Use resize() to change the number of points.
+     */
+    [[nodiscard]] auto points() const -> const std::vector<Point>&
+    {
+        return points_;
+    }
+
+    /** @copydoc points() const */
+    [[nodiscard]] auto points() -> std::vector<Point>& { return points_; }
+
+    /**
+     * @brief Get the normal list
+     *
+     * Empty if the cloud has no normals.
+     */
+    [[nodiscard]] auto normals() const -> const std::vector<Normal>&
+    {
+        return normals_;
+    }
+
+    /** @copydoc normals() const */
+    [[nodiscard]] auto normals() -> std::vector<Normal>& { return normals_; }
+
+    /**
+     * @brief Get the color list
+     *
+     * Empty if the cloud has no colors.
+     */
+    [[nodiscard]] auto colors() const -> const std::vector<PointColor>&
+    {
+        return colors_;
+    }
+
+    /** @copydoc colors() const */
+    [[nodiscard]] auto colors() -> std::vector<PointColor>& { return colors_; }
+
+    /** @brief Whether the points have normals */
+    [[nodiscard]] auto hasNormals() const -> bool { return normalsEnabled_; }
+
+    /** @brief Whether the points have colors */
+    [[nodiscard]] auto hasColors() const -> bool { return colorsEnabled_; }
+
+    /**
+     * @brief Add a normal to every point
+     *
+     * New normals are zero-initialized. Existing normals are kept. Points
+     * inserted later also get a normal.
+     */
+    void enableNormals()
+    {
+        normalsEnabled_ = true;
+        normals_.resize(points_.size());
+    }
+
+    /**
+     * @brief Add a color to every point
+     *
+     * New colors are zero-initialized. Existing colors are kept. Points
+     * inserted later also get a color.
+     */
+    void enableColors()
+    {
+        colorsEnabled_ = true;
+        colors_.resize(points_.size());
+    }
+
+    /** @brief Remove the point normals */
+    void clearNormals()
+    {
+        normalsEnabled_ = false;
+        normals_.clear();
+        normals_.shrink_to_fit();
+    }
+
+    /** @brief Remove the point colors */
+    void clearColors()
+    {
+        colorsEnabled_ = false;
+        colors_.clear();
+        colors_.shrink_to_fit();
+    }
+
+    /**
+     * @brief Resize the cloud to `n` points
+     *
+     * Resizes every enabled attribute with the positions.
+     */
+    void resize(std::size_t n)
+    {
+        points_.resize(n);
+        if (normalsEnabled_) {
+            normals_.resize(n);
+        }
+        if (colorsEnabled_) {
+            colors_.resize(n);
+        }
+    }
+
+    /** @brief Reserve storage for `n` points and their attributes */
+    void reserve(std::size_t n)
+    {
+        points_.reserve(n);
+        if (normalsEnabled_) {
+            normals_.reserve(n);
+        }
+        if (colorsEnabled_) {
+            colors_.reserve(n);
+        }
+    }
+
+    /**
+     * @brief Keep only the points with the given indices
+     *
+     * Points are reordered to match `indices`, which may be in any order.
+     *
+     * @throws std::out_of_range If an index is out of range
+     */
+    void select(const std::vector<std::size_t>& indices)
+    {
+        for (const auto& i : indices) {
+            if (i >= points_.size()) {
+                throw std::out_of_range("Point index out of range");
+            }
+        }
+        auto gather = [&](auto& src) {
+            std::remove_reference_t<decltype(src)> dst;
+            dst.reserve(indices.size());
+            for (const auto& i : indices) {
+                dst.push_back(src[i]);
+            }
+            src = std::move(dst);
+        };
+        if (normalsEnabled_) {
+            gather(normals_);
+        }
+        if (colorsEnabled_) {
+            gather(colors_);
+        }
+        gather(points_);
+    }
+
+    /** @brief Number of points in the cloud */
+    [[nodiscard]] auto size() const -> std::size_t { return points_.size(); }
+
+    /** @brief Whether the cloud has no points */
+    [[nodiscard]] auto empty() const -> bool { return points_.empty(); }
+
+    /**
+     * @brief Get the number of bytes used by this cloud, including unused
+     * attribute capacity
+     */
+    [[nodiscard]] auto memoryUsage() const -> std::size_t
+    {
+        return sizeof(PointCloud) + detail::heap_usage(points_) +
+               detail::heap_usage(normals_) + detail::heap_usage(colors_);
+    }
+
+    /** @brief Remove all points and attributes */
+    void clear()
+    {
+        points_.clear();
+        normals_.clear();
+        colors_.clear();
+        normalsEnabled_ = false;
+        colorsEnabled_ = false;
+    }
+
+private:
+    /** Positions */
+    std::vector<Point> points_;
+    /** Normals, if any */
+    std::vector<Normal> normals_;
+    /** Colors, if any */
+    std::vector<PointColor> colors_;
+    /** Whether points have normals */
+    bool normalsEnabled_{false};
+    /** Whether points have colors */
+    bool colorsEnabled_{false};
+};
+
+/** @brief 3D 32-bit floating-point point cloud */
+using PointCloud3f = PointCloud<float, 3>;
+/** @brief 3D 64-bit floating-point point cloud */
+using PointCloud3d = PointCloud<double, 3>;
+
+}  // namespace educelab
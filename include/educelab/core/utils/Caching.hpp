@@ -8,11 +8,14 @@
 #include <cstddef>
 #include <list>
 #include <mutex>
+#include <optional>
 #include <random>
 #include <shared_mutex>
 #include <unordered_map>
 #include <vector>
 
+#include "educelab/core/utils/MemoryUsage.hpp"
+
 namespace educelab
 {
 
@@ -192,6 +195,20 @@ public:
         entryMap_.clear();
     }
 
+    /**
+     * Approximate number of bytes used by the policy. List and map nodes are
+     * counted as their entries plus two pointers.
+     */
+    [[nodiscard]] auto memoryUsage() const -> std::size_t
+    {
+        constexpr auto links = 2 * sizeof(void*);
+        return sizeof(LRUPolicy) +
+               entryList_.size() * (sizeof(EntryRecord) + links) +
+               entryMap_.size() *
+                   (sizeof(typename EntryMap::value_type) + links) +
+               entryMap_.bucket_count() * sizeof(void*);
+    }
+
 private:
     /** Policy entry record */
     using EntryRecord = std::pair<KeyT, SizeT>;
@@ -249,10 +266,11 @@ private:
  * container provides no facilities for tracking the underlying type stored in
  * a `std::any` object. If you do not know the type of the stored object at time
  * of retrieval, refer to the `std::any` documentation. Second,
- * insert(const T2&) uses the `sizeof` operator to calculate the storage used by
- * the inserted object. For objects which allocate memory on the heap
- * (e.g. `std::vector`), this value will be incorrect. You must manually
- * provide the effective size of the object using insert(value_type, size_type).
+ * insert(const T2&) uses memory_usage() to calculate the storage used by the
+ * inserted object. This includes the heap memory of library types (Image,
+ * Mesh, etc.) and standard containers, but other types which allocate memory
+ * must either specialize MemoryUsage or have their effective size provided
+ * manually using insert(value_type, size_type).
  *
  * The cache's thread-safety properties are determined by the templated
  * synchronization policy, `SyncPolicy`. This class defines the cache's mutex
@@ -328,13 +346,13 @@ public:
     }
 
     /**
-     * @brief Cache an object with an automatically determined size
+     * @brief Cache an object with its size determined by memory_usage()
      * @return Key for accessing cached object
      */
     template <typename T2>
     auto insert(const T2& value) -> key_type
     {
-        return insert(value, sizeof(value));
+        return insert(value, static_cast<size_type>(memory_usage(value)));
     }
 
     /** @brief Return whether the object referenced by key is in the cache */
@@ -474,6 +492,24 @@ public:
         return cache_.empty();
     }
 
+    /**
+     * @brief Get the approximate number of bytes used by the cache
+     *
+     * This is size() plus the cache's own bookkeeping: the cache object, its
+     * entry map, and its eviction policy. Map nodes are counted as their
+     * entries plus two pointers.
+     */
+    [[nodiscard]] auto memoryUsage() const -> std::size_t
+    {
+        const typename sync_policy::trivial_lock lock(mutex_);
+        constexpr auto links = 2 * sizeof(void*);
+        auto policy = MemoryUsage<eviction_policy>::bytes(policy_);
+        return sizeof(ObjectCache) + static_cast<std::size_t>(size_) +
+               cache_.size() * (sizeof(typename Map::value_type) + links) +
+               cache_.bucket_count() * sizeof(void*) + policy -
+               sizeof(eviction_policy);
+    }
+
 private:
     /** Private clear() implementation */
     auto clear_() -> size_type
@@ -514,8 +550,10 @@ private:
     /** Eviction policy type */
     using eviction_policy = EvictionPolicy;
 
+    /** Entry map type */
+    using Map = std::unordered_map<key_type, CacheEntry>;
     /** Data cache */
-    std::unordered_map<key_type, CacheEntry> cache_;
+    Map cache_;
     /** Eviction policy instance */
     mutable eviction_policy policy_;
     /** Cache mutex */
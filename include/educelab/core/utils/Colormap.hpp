@@ -0,0 +1,297 @@
+#pragma once
+
+/** @file */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "educelab/core/types/Color.hpp"
+#include "educelab/core/types/Image.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+
+namespace educelab
+{
+
+/** @brief Built-in colormaps */
+enum class Colormap {
+    /** Linear grayscale from black to white */
+    Gray,
+    /** Perceptually uniform blue-green-yellow (matplotlib) */
+    Viridis,
+    /** Perceptually uniform black-purple-orange-white (matplotlib) */
+    Magma,
+    /** Perceptually uniform black-purple-orange-yellow (matplotlib) */
+    Inferno,
+    /** Perceptually uniform blue-purple-orange-yellow (matplotlib) */
+    Plasma,
+    /** Improved rainbow colormap (Google) */
+    Turbo
+};
+
+/** @brief Options for apply_colormap() */
+struct ColormapOptions {
+    /**
+     * Number of lookup table entries used for the built-in colormaps. Larger
+     * tables give smoother gradients for high dynamic range images.
+     */
+    std::size_t lutSize{256};
+    /**
+     * Write U8C4 output. Pixels which are NaN or infinite are transparent
+     * and every other pixel is opaque.
+     */
+    bool alpha{false};
+};
+
+namespace detail
+{
+/**
+ * Polynomial fit of a colormap. Channel `c` at `t` is
+ * `sum_i coeffs[c][i] * t^i`. The matplotlib colormaps use published
+ * degree-6 least-squares fits and Turbo uses Google's degree-5 fit. Both are
+ * within a few 8-bit steps of the original colormaps.
+ */
+using ColormapPolynomial = std::array<std::array<double, 7>, 3>;
+
+/** Polynomial coefficients of a built-in colormap */
+inline auto colormap_polynomial(Colormap cmap) -> ColormapPolynomial
+{
+    switch (cmap) {
+        case Colormap::Gray:
+            return {{{0, 1}, {0, 1}, {0, 1}}};
+        case Colormap::Viridis:
+            return {{
+                {0.2777273272234177, 0.1050930431085774, -0.3308618287255563,
+                 -4.634230498983486, 6.228269936347081, 4.776384997670288,
+                 -5.435455855934631},
+                {0.005407344544966578, 1.404613529898575, 0.214847559468213,
+                 -5.799100973351585, 14.17993336680509, -13.74514537774601,
+                 4.645852612178535},
+                {0.3340998053353061, 1.384590162594685, 0.09509516302823659,
+                 -19.33244095627987, 56.69055260068105, -65.35303263337234,
+                 26.3124352495832},
+            }};
+        case Colormap::Magma:
+            return {{
+                {-0.002136485053939582, 0.2516605407371642, 8.353717279216625,
+                 -27.66873308576866, 52.17613981234068, -50.76852536473588,
+                 18.65570506591883},
+                {-0.000749655052795221, 0.6775232436837668, -3.577719514958484,
+                 14.26473078096533, -27.94360607168351, 29.04658282127291,
+                 -11.48977351997711},
+                {-0.005386127855323933, 2.494026599312351, 0.3144679030132573,
+                 -13.64921318813922, 12.94416944238394, 4.23415299384598,
+                 -5.601961508734096},
+            }};
+        case Colormap::Inferno:
+            return {{
+                {0.0002189403691192265, 0.1065134194856116, 11.60249308247187,
+                 -41.70399613139459, 77.162935699427, -71.31942824499214,
+                 25.13112622477341},
+                {0.001651004631001012, 0.5639564367884091, -3.972853965665698,
+                 17.43639888205313, -33.40235894210092, 32.62606426397723,
+                 -12.24266895238567},
+                {-0.01948089843709184, 3.932712388889277, -15.9423941062914,
+                 44.35414519872813, -81.80730925738993, 73.20951985803202,
+                 -23.07032500287172},
+            }};
+        case Colormap::Plasma:
+            return {{
+                {0.05873234392399702, 2.176514634195958, -2.689460476458034,
+                 6.130348345893603, -11.10743619062271, 10.02306557647065,
+                 -3.658713842777788},
+                {0.02333670892565664, 0.2383834171260182, -7.455851135738909,
+                 42.3461881477227, -82.66631109428045, 71.41361770095349,
+                 -22.93153465461149},
+                {0.5433401826748754, 0.7539604599784036, 3.110799939717086,
+                 -28.51885465332158, 60.13984767418263, -54.07218655560067,
+                 18.19190778539828},
+            }};
+        case Colormap::Turbo:
+            return {{
+                {0.13572138, 4.61539260, -42.66032258, 132.13108234,
+                 -152.94239396, 59.28637943, 0},
+                {0.09140261, 2.19418839, 4.84296658, -14.18503333, 4.27729857,
+                 2.82956604, 0},
+                {0.10667330, 12.64194608, -60.58204836, 110.36276771,
+                 -89.90310912, 27.34824973, 0},
+            }};
+    }
+    throw std::invalid_argument("Unknown colormap");
+}
+
+/**
+ * @brief Map the pixels of a single-channel image through a lookup table
+ *
+ * Normalization, lookup, and output are fused into one pass over the pixels
+ * in parallel blocks of rows.
+ */
+template <typename T>
+void apply_lut(
+    const Image& image,
+    Image& out,
+    const std::vector<Color::U8C3>& lut,
+    float min,
+    float max,
+    bool alpha)
+{
+    const auto* in = reinterpret_cast<const T*>(image.data());
+    auto* dst = reinterpret_cast<std::uint8_t*>(out.data());
+    const auto cns = out.channels();
+    // Normalize in double: max - min and pixel - min can overflow a float
+    // even when both are finite
+    const auto last = static_cast<double>(lut.size() - 1);
+    const auto lo = static_cast<double>(min);
+    const auto scale = last / (static_cast<double>(max) - lo);
+    const auto width = image.width();
+    parallel_for_blocks(
+        0, image.height(),
+        [&](auto b, auto e) {
+            for (auto i = b * width; i < e * width; i++) {
+                // NaN fails both comparisons and maps to the first entry
+                auto t = (static_cast<double>(in[i]) - lo) * scale;
+                t = t > 0. ? t : 0.;
+                t = t < last ? t : last;
+                const auto& c = lut[static_cast<std::size_t>(t + 0.5)];
+                auto* px = dst + i * cns;
+                px[0] = c[0];
+                px[1] = c[1];
+                px[2] = c[2];
+                if (alpha) {
+                    auto valid = std::isfinite(static_cast<float>(in[i]));
+                    px[3] = valid ? 255 : 0;
+                }
+            }
+        },
+        std::max<std::size_t>(1, 16384 / std::max<std::size_t>(width, 1)));
+}
+}  // namespace detail
+
+/**
+ * @brief Evaluate a built-in colormap at `t` in [0, 1]
+ *
+ * Values outside of [0, 1] are clamped. Channels are in [0, 1].
+ */
+inline auto colormap_color(Colormap cmap, double t) -> Color::F32C3
+{
+    const auto poly = detail::colormap_polynomial(cmap);
+    t = t > 0 ? t : 0;
+    t = t < 1 ? t : 1;
+    Color::F32C3 color;
+    for (std::size_t c{0}; c < 3; c++) {
+        // Horner's method
+        double v{0};
+        for (auto it = poly[c].rbegin(); it != poly[c].rend(); ++it) {
+            v = v * t + *it;
+        }
+        color[c] = static_cast<float>(std::clamp(v, 0., 1.));
+    }
+    return color;
+}
+
+/**
+ * @brief Build a lookup table for a built-in colormap
+ *
+ * Entry `i` is the colormap evaluated at `i / (size - 1)`.
+ *
+ * @throws std::invalid_argument If `size` is less than 2
+ */
+inline auto colormap_lut(Colormap cmap, std::size_t size = 256)
+    -> std::vector<Color::U8C3>
+{
+    if (size < 2) {
+        throw std::invalid_argument("Colormap LUT needs at least 2 entries");
+    }
+    std::vector<Color::U8C3> lut(size);
+    const auto last = static_cast<double>(size - 1);
+    for (std::size_t i{0}; i < size; i++) {
+        lut[i] = detail::convert_color<Color::U8C3>(
+            colormap_color(cmap, static_cast<double>(i) / last));
+    }
+    return lut;
+}
+
+/**
+ * @brief Color a single-channel image with a lookup table
+ *
+ * Pixel values are normalized from [min, max] to the range of the table and
+ * rounded to the nearest entry. Values outside of [min, max] are clamped and
+ * NaN maps to the first entry. `min` and `max` are in the units of the
+ * image's pixels (e.g. [0, 65535] for the full range of a U16 image). The
+ * result is a U8 image with 3 channels, or 4 if `opts.alpha` is set.
+ *
+ * ```{.cpp}
+ * auto lut = colormap_lut(Colormap::Viridis, 4096);
+ * auto rgb = apply_colormap(depth, lut, near, far);
+ * ```
+ *
+ * @throws std::invalid_argument If the image is empty, has more than one
+ * channel, or is not U8, U16, or F32; if `max <= min` or either is not
+ * finite; or if the table has fewer than 2 entries
+ */
+inline auto apply_colormap(
+    const Image& image,
+    const std::vector<Color::U8C3>& lut,
+    float min,
+    float max,
+    const ColormapOptions& opts = {}) -> Image
+{
+    if (image.empty() or image.channels() != 1) {
+        throw std::invalid_argument("Colormap requires a single-channel image");
+    }
+    if (not(max > min)) {
+        throw std::invalid_argument("Colormap range is empty");
+    }
+    if (not std::isfinite(min) or not std::isfinite(max)) {
+        throw std::invalid_argument("Colormap range must be finite");
+    }
+    if (lut.size() < 2) {
+        throw std::invalid_argument("Colormap LUT needs at least 2 entries");
+    }
+
+    Image out(image.height(), image.width(), opts.alpha ? 4 : 3, Depth::U8);
+    switch (image.type()) {
+        case Depth::U8:
+            detail::apply_lut<std::uint8_t>(
+                image, out, lut, min, max, opts.alpha);
+            break;
+        case Depth::U16:
+            detail::apply_lut<std::uint16_t>(
+                image, out, lut, min, max, opts.alpha);
+            break;
+        case Depth::F32:
+            detail::apply_lut<float>(image, out, lut, min, max, opts.alpha);
+            break;
+        default:
+            throw std::invalid_argument("Unsupported colormap image depth");
+    }
+    return out;
+}
+
+/**
+ * @brief Color a single-channel image with a built-in colormap
+ *
+ * The colormap is sampled into a lookup table with `opts.lutSize` entries.
+ *
+ * ```{.cpp}
+ * auto rgb = apply_colormap(density, Colormap::Magma, 0, 1);
+ * ```
+ *
+ * @see apply_colormap(const Image&, const std::vector<Color::U8C3>&, float,
+ * float, const ColormapOptions&)
+ */
+inline auto apply_colormap(
+    const Image& image,
+    Colormap cmap,
+    float min,
+    float max,
+    const ColormapOptions& opts = {}) -> Image
+{
+    return apply_colormap(
+        image, colormap_lut(cmap, opts.lutSize), min, max, opts);
+}
+
+}  // namespace educelab
@@ -0,0 +1,98 @@
+#pragma once
+
+/** @file */
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace educelab
+{
+
+/**
+ * @brief Compress a buffer with a fast LZ77 byte codec
+ *
+ * The encoded stream is a sequence of LZ4-style tokens (literal run, 16-bit
+ * back-reference offset, match length). It favors encoding and decoding speed
+ * over compression ratio. Compressed data does not store the uncompressed
+ * size, which must be tracked by the caller. Large buffers should be split
+ * into independent segments (< 4 GiB each), which also allows them to be
+ * compressed and decompressed in parallel.
+ */
+auto lz_compress(const std::byte* data, std::size_t size)
+    -> std::vector<std::byte>;
+
+/**
+ * @brief Decompress a buffer produced by lz_compress()
+ *
+ * @throws std::runtime_error If the input is malformed or does not decode to
+ * exactly `outSize` bytes
+ */
+void lz_decompress(
+    const std::byte* data,
+    std::size_t size,
+    std::byte* out,
+    std::size_t outSize);
+
+/**
+ * @brief Delta-encode a sequence of integers as variable-length bytes
+ *
+ * Each value is stored as its zigzag-encoded difference from the previous
+ * value using LEB128 varints. Sequences of nearby values, such as the vertex
+ * indices of spatially coherent faces, encode to 1-2 bytes per value and
+ * compress well with lz_compress(). Encoded bytes are appended to `out`.
+ */
+template <typename T>
+void delta_encode(const T* data, std::size_t n, std::vector<std::byte>& out)
+{
+    static_assert(std::is_integral_v<T>, "Integral type required");
+    std::int64_t prev{0};
+    for (std::size_t i{0}; i < n; i++) {
+        auto val = static_cast<std::int64_t>(data[i]);
+        auto delta = static_cast<std::uint64_t>(val - prev);
+        prev = val;
+        // Zigzag: Small negative deltas become small unsigned values
+        auto zz = (delta << 1) ^ static_cast<std::uint64_t>(
+                                     static_cast<std::int64_t>(delta) >> 63);
+        while (zz >= 0x80) {
+            out.emplace_back(static_cast<std::byte>(zz | 0x80));
+            zz >>= 7;
+        }
+        out.emplace_back(static_cast<std::byte>(zz));
+    }
+}
+
+/**
+ * @brief Decode `n` integers produced by delta_encode()
+ *
+ * @throws std::runtime_error If the input is truncated or malformed
+ */
+template <typename T>
+void delta_decode(
+    const std::byte* data, std::size_t size, T* out, std::size_t n)
+{
+    static_assert(std::is_integral_v<T>, "Integral type required");
+    const auto* end = data + size;
+    std::int64_t prev{0};
+    for (std::size_t i{0}; i < n; i++) {
+        std::uint64_t zz{0};
+        unsigned shift{0};
+        std::uint64_t byte{0x80};
+        while ((byte & 0x80) != 0) {
+            if (data == end or shift > 63) {
+                throw std::runtime_error("Malformed delta-encoded data");
+            }
+            byte = static_cast<std::uint64_t>(*data++);
+            zz |= (byte & 0x7F) << shift;
+            shift += 7;
+        }
+        auto delta = static_cast<std::int64_t>(zz >> 1) ^
+                     -static_cast<std::int64_t>(zz & 1);
+        prev += delta;
+        out[i] = static_cast<T>(prev);
+    }
+}
+
+}  // namespace educelab
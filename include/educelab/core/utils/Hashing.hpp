@@ -0,0 +1,55 @@
+#pragma once
+
+/** @file */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace educelab
+{
+
+namespace detail
+{
+/** Mix a 64-bit value (splitmix64 finalizer) */
+inline auto mix64(std::uint64_t x) -> std::uint64_t
+{
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+/** Hash integer grid coordinates */
+template <std::size_t Dims>
+auto hash_cell(const std::array<std::int64_t, Dims>& cell) -> std::uint64_t
+{
+    std::uint64_t h{0x9E3779B97F4A7C15ULL};
+    for (const auto& c : cell) {
+        h = mix64(h ^ static_cast<std::uint64_t>(c));
+    }
+    return h;
+}
+
+/** Largest magnitude of a grid_coord() result */
+constexpr double GRID_COORD_LIMIT{0x1p62};
+
+/**
+ * Integer grid coordinate of `v` for cells of edge length `size`. The result
+ * is clamped to [-2^62, 2^62], so it and its neighbors never overflow.
+ * Clamping is monotonic, so values within `size` of each other still map to
+ * the same or adjacent coordinates. `v` must not be NaN.
+ */
+inline auto grid_coord(double v, double size) -> std::int64_t
+{
+    auto c = std::clamp(std::floor(v / size), -GRID_COORD_LIMIT,
+                        GRID_COORD_LIMIT);
+    return static_cast<std::int64_t>(c);
+}
+}  // namespace detail
+
+}  // namespace educelab
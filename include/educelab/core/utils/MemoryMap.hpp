@@ -0,0 +1,75 @@
+#pragma once
+
+/** @file */
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+namespace educelab
+{
+
+/**
+ * @brief Read-only memory-mapped file
+ *
+ * Maps the entire contents of a file into the address space of the process.
+ * On POSIX systems, this uses `mmap` so that file pages are loaded on demand
+ * by the OS. On other platforms, the file is read into an internal buffer.
+ *
+ * ```{.cpp}
+ * MemoryMap file("mesh.obj");
+ * std::string_view text = file.view();
+ * ```
+ *
+ * @throws std::runtime_error If the file cannot be opened or mapped
+ */
+class MemoryMap
+{
+public:
+    /** @brief Default constructor. Maps nothing. */
+    MemoryMap() = default;
+
+    /** @brief Map a file */
+    explicit MemoryMap(const std::filesystem::path& path);
+
+    /** @brief Unmaps the file */
+    ~MemoryMap();
+
+    /** @brief Deleted copy constructor */
+    MemoryMap(const MemoryMap&) = delete;
+    /** @brief Deleted copy assignment operator */
+    auto operator=(const MemoryMap&) -> MemoryMap& = delete;
+
+    /** @brief Move constructor */
+    MemoryMap(MemoryMap&& other) noexcept;
+    /** @brief Move assignment operator */
+    auto operator=(MemoryMap&& other) noexcept -> MemoryMap&;
+
+    /** @brief Pointer to the first byte of the mapped file */
+    [[nodiscard]] auto data() const noexcept -> const std::byte*;
+
+    /** @brief Size of the mapped file in bytes */
+    [[nodiscard]] auto size() const noexcept -> std::size_t;
+
+    /** @brief Whether nothing is mapped */
+    [[nodiscard]] auto empty() const noexcept -> bool;
+
+    /** @brief View the mapped file as characters */
+    [[nodiscard]] auto view() const noexcept -> std::string_view;
+
+    /** @brief Unmap the file */
+    void reset();
+
+private:
+    /** Mapped data */
+    const std::byte* data_{nullptr};
+    /** Mapped size */
+    std::size_t size_{0};
+    /** Whether data_ is owned by the OS mapping */
+    bool mapped_{false};
+    /** Fallback storage for platforms without mmap */
+    std::vector<std::byte> buffer_;
+};
+
+}  // namespace educelab
@@ -0,0 +1,241 @@
+#pragma once
+
+/** @file */
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace educelab
+{
+
+namespace traits
+{
+/** @brief Detect whether a type provides a `memoryUsage()` member function */
+template <class T, class = void>
+struct has_memory_usage : std::false_type {
+};
+
+/** @copydoc has_memory_usage */
+template <class T>
+struct has_memory_usage<
+    T,
+    std::void_t<decltype(std::declval<const T&>().memoryUsage())>>
+    : std::true_type {
+};
+
+/** @copydoc has_memory_usage */
+template <class T>
+constexpr bool has_memory_usage_v = has_memory_usage<T>::value;
+}  // namespace traits
+
+/**
+ * @brief Customization point for memory_usage()
+ *
+ * `bytes(v)` returns the number of bytes used by `v`, including the heap
+ * memory it owns. `flat` is true if `bytes()` is always `sizeof(T)`, which
+ * lets containers skip visiting their elements.
+ *
+ * The primary template calls `v.memoryUsage()` if `T` provides it and
+ * otherwise returns `sizeof(T)`. Specialize it for types which own heap
+ * memory but can't be given a member function:
+ *
+ * ```{.cpp}
+ * template <>
+ * struct MemoryUsage<Buffer> {
+ *     static constexpr bool flat{false};
+ *     static auto bytes(const Buffer& b) -> std::size_t
+ *     {
+ *         return sizeof(Buffer) + b.capacity();
+ *     }
+ * };
+ * ```
+ */
+template <typename T, typename = void>
+struct MemoryUsage {
+    /** Whether the type owns no heap memory */
+    static constexpr bool flat{not traits::has_memory_usage_v<T>};
+
+    /** Number of bytes used by `v` */
+    static auto bytes(const T& v) -> std::size_t
+    {
+        if constexpr (traits::has_memory_usage_v<T>) {
+            return v.memoryUsage();
+        } else {
+            return sizeof(T);
+        }
+    }
+};
+
+/**
+ * @brief Get the number of bytes used by an object, including the heap
+ * memory it owns
+ *
+ * Library types which own heap memory (Image, Mesh, Color, etc.) are
+ * supported along with the standard containers and smart pointers. Container
+ * sizes include their unused capacity. Memory owned by the allocator itself
+ * (e.g. block headers) is not counted. Other types are measured with
+ * `sizeof` unless MemoryUsage is specialized for them.
+ *
+ * ```{.cpp}
+ * auto mesh = read_mesh<Mesh3f>("scan.obj");
+ * std::cout << "Mesh: " << memory_usage(mesh) << " bytes\n";
+ * std::cout << "Faces: " << memory_usage(mesh.faces()) << " bytes\n";
+ * ```
+ */
+template <typename T>
+auto memory_usage(const T& v) -> std::size_t
+{
+    return MemoryUsage<T>::bytes(v);
+}
+
+namespace detail
+{
+/** Bytes of heap memory owned by an object */
+template <typename T>
+auto heap_usage(const T& v) -> std::size_t
+{
+    return memory_usage(v) - sizeof(T);
+}
+}  // namespace detail
+
+/** @brief MemoryUsage for std::vector */
+template <typename T, typename Alloc>
+struct MemoryUsage<std::vector<T, Alloc>> {
+    /** Vectors always own heap memory */
+    static constexpr bool flat{false};
+
+    /** Size of the vector, its capacity, and its elements' heap memory */
+    static auto bytes(const std::vector<T, Alloc>& v) -> std::size_t
+    {
+        auto total = sizeof(v) + v.capacity() * sizeof(T);
+        if constexpr (not MemoryUsage<T>::flat) {
+            for (const auto& e : v) {
+                total += detail::heap_usage(e);
+            }
+        }
+        return total;
+    }
+};
+
+/** @brief MemoryUsage for std::basic_string */
+template <typename CharT, typename Traits, typename Alloc>
+struct MemoryUsage<std::basic_string<CharT, Traits, Alloc>> {
+    /** Long strings own heap memory */
+    static constexpr bool flat{false};
+
+    /** Size of the string and its heap buffer, if not stored inline */
+    static auto bytes(const std::basic_string<CharT, Traits, Alloc>& s)
+        -> std::size_t
+    {
+        // Short strings are stored inside the object
+        const auto* begin = reinterpret_cast<const std::byte*>(&s);
+        const auto* data = reinterpret_cast<const std::byte*>(s.data());
+        if (not std::less<>{}(data, begin) and
+            std::less<>{}(data, begin + sizeof(s))) {
+            return sizeof(s);
+        }
+        return sizeof(s) + (s.capacity() + 1) * sizeof(CharT);
+    }
+};
+
+/** @brief MemoryUsage for std::optional */
+template <typename T>
+struct MemoryUsage<std::optional<T>> {
+    /** Flat if the value type is flat */
+    static constexpr bool flat{MemoryUsage<T>::flat};
+
+    /** Size of the optional and its value's heap memory */
+    static auto bytes(const std::optional<T>& v) -> std::size_t
+    {
+        return sizeof(v) + (v ? detail::heap_usage(*v) : 0);
+    }
+};
+
+/** @brief MemoryUsage for std::variant */
+template <typename... Ts>
+struct MemoryUsage<std::variant<Ts...>> {
+    /** Flat if every alternative is flat */
+    static constexpr bool flat{(MemoryUsage<Ts>::flat and ...)};
+
+    /** Size of the variant and its active alternative's heap memory */
+    static auto bytes(const std::variant<Ts...>& v) -> std::size_t
+    {
+        auto heap = [](const auto& a) { return detail::heap_usage(a); };
+        return sizeof(v) + std::visit(heap, v);
+    }
+};
+
+/** @brief MemoryUsage for std::pair */
+template <typename T1, typename T2>
+struct MemoryUsage<std::pair<T1, T2>> {
+    /** Flat if both members are flat */
+    static constexpr bool flat{
+        MemoryUsage<T1>::flat and MemoryUsage<T2>::flat};
+
+    /** Size of the pair and its members' heap memory */
+    static auto bytes(const std::pair<T1, T2>& p) -> std::size_t
+    {
+        return sizeof(p) + detail::heap_usage(p.first) +
+               detail::heap_usage(p.second);
+    }
+};
+
+/** @brief MemoryUsage for std::array */
+template <typename T, std::size_t N>
+struct MemoryUsage<std::array<T, N>> {
+    /** Flat if the element type is flat */
+    static constexpr bool flat{MemoryUsage<T>::flat};
+
+    /** Size of the array and its elements' heap memory */
+    static auto bytes(const std::array<T, N>& a) -> std::size_t
+    {
+        auto total = sizeof(a);
+        if constexpr (not MemoryUsage<T>::flat) {
+            for (const auto& e : a) {
+                total += detail::heap_usage(e);
+            }
+        }
+        return total;
+    }
+};
+
+/**
+ * @brief MemoryUsage for std::shared_ptr
+ *
+ * The pointee is counted in full, even if it is shared with other pointers.
+ * The control block is not counted.
+ */
+template <typename T>
+struct MemoryUsage<std::shared_ptr<T>> {
+    /** Shared pointers own heap memory */
+    static constexpr bool flat{false};
+
+    /** Size of the pointer and its pointee */
+    static auto bytes(const std::shared_ptr<T>& p) -> std::size_t
+    {
+        return sizeof(p) + (p ? memory_usage(*p) : 0);
+    }
+};
+
+/** @brief MemoryUsage for std::unique_ptr */
+template <typename T, typename Deleter>
+struct MemoryUsage<std::unique_ptr<T, Deleter>> {
+    /** Unique pointers own heap memory */
+    static constexpr bool flat{false};
+
+    /** Size of the pointer and its pointee */
+    static auto bytes(const std::unique_ptr<T, Deleter>& p) -> std::size_t
+    {
+        return sizeof(p) + (p ? memory_usage(*p) : 0);
+    }
+};
+
+}  // namespace educelab
@@ -0,0 +1,542 @@
+#pragma once
+
+/** @file */
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "educelab/core/utils/Parallel.hpp"
+#include "educelab/core/utils/Sorting.hpp"
+
+namespace educelab
+{
+
+namespace detail
+{
+/**
+ * Vertex-to-face adjacency in compressed sparse row (CSR) layout. The faces
+ * incident to vertex `v` are `faces[offsets[v]]` to `faces[offsets[v + 1]]`.
+ */
+template <typename Index>
+struct VertexFaceCSR {
+    /** Offsets into faces for each vertex */
+    std::vector<Index> offsets;
+    /** Incident faces, grouped by vertex */
+    std::vector<Index> faces;
+};
+
+/** Build CSR row offsets from a sorted list of row keys */
+template <typename Index>
+auto csr_offsets(const std::vector<Index>& sortedKeys, std::size_t rows)
+    -> std::vector<Index>
+{
+    std::vector<Index> offsets(rows + 1);
+    const auto n = sortedKeys.size();
+    parallel_for(0, n + 1, [&](auto i) {
+        const auto* k = sortedKeys.data();
+        auto lo = i == 0 ? 0 : static_cast<std::size_t>(k[i - 1]) + 1;
+        auto hi = i == n ? rows : static_cast<std::size_t>(k[i]);
+        for (auto r = lo; r <= hi and r <= rows; r++) {
+            offsets[r] = static_cast<Index>(i);
+        }
+    });
+    return offsets;
+}
+
+/**
+ * Offset of each face's first corner. The last element is the corner count.
+ * Also validates the face indices.
+ *
+ * @throws std::out_of_range If a face references an invalid vertex
+ */
+template <class MeshType>
+auto face_corner_offsets(const MeshType& mesh) -> std::vector<std::size_t>
+{
+    const auto& faces = mesh.faces();
+    const auto nv = mesh.numVertices();
+    std::vector<std::size_t> corners(faces.size() + 1, 0);
+    for (std::size_t f{0}; f < faces.size(); f++) {
+        for (const auto& v : faces[f]) {
+            if (static_cast<std::size_t>(v) >= nv) {
+                throw std::out_of_range("Face references invalid vertex");
+            }
+        }
+        corners[f + 1] = corners[f] + faces[f].size();
+    }
+    return corners;
+}
+
+/**
+ * Build a vertex-to-face CSR by radix sorting (vertex, face) pairs for every
+ * face corner. Within each vertex, faces are in ascending order. `corners`
+ * must come from face_corner_offsets(), which validates the face indices.
+ */
+template <typename Index, class MeshType>
+auto build_vertex_face_csr(
+    const MeshType& mesh, const std::vector<std::size_t>& corners)
+    -> VertexFaceCSR<Index>
+{
+    const auto& faces = mesh.faces();
+    std::vector<Index> keys(corners.back());
+    VertexFaceCSR<Index> csr;
+    csr.faces.resize(corners.back());
+    parallel_for(0, faces.size(), [&](auto f) {
+        auto c = corners[f];
+        for (const auto& v : faces[f]) {
+            keys[c] = static_cast<Index>(v);
+            csr.faces[c++] = static_cast<Index>(f);
+        }
+    });
+    radix_sort_pairs(keys, csr.faces);
+    csr.offsets = csr_offsets(keys, mesh.numVertices());
+    return csr;
+}
+
+/**
+ * Build a vertex-to-face CSR for every face corner
+ *
+ * @throws std::out_of_range If a face references an invalid vertex
+ */
+template <typename Index, class MeshType>
+auto build_vertex_face_csr(const MeshType& mesh) -> VertexFaceCSR<Index>
+{
+    return build_vertex_face_csr<Index>(mesh, face_corner_offsets(mesh));
+}
+}  // namespace detail
+
+/**
+ * @brief Topological adjacency for a Mesh
+ *
+ * Mesh stores only vertex and face arrays. MeshAdjacency builds the
+ * relationships between vertices, edges, and faces in compressed sparse row
+ * (CSR) form so that one-ring, boundary, and manifold queries are constant
+ * time lookups. Arbitrary polygonal and non-manifold meshes are supported.
+ *
+ * Every face corner `c` of face `f` defines a half-edge from `f[c]` to
+ * `f[c + 1]`. Half-edges are numbered in face order, so the half-edges of face
+ * `f` are contiguous. Undirected edges are found by radix sorting the
+ * half-edges on their (min vertex, max vertex) keys, so construction is
+ * parallel and does not use hashing.
+ *
+ * Adjacency is a snapshot: it must be rebuilt if the mesh topology changes.
+ *
+ * ```{.cpp}
+ * MeshAdjacency adj(mesh);
+ * for (auto n : adj.vertexNeighbors(0)) {
+ *     std::cout << n << "\n";
+ * }
+ * auto boundary = adj.boundaryEdges();
+ * ```
+ *
+ * @tparam Index Unsigned integer type used to store indices. 32-bit indices
+ * halve the memory footprint relative to `std::size_t`.
+ */
+template <typename Index = std::uint32_t>
+class MeshAdjacency
+{
+    static_assert(std::is_unsigned_v<Index>, "Unsigned index type required");
+
+public:
+    /** @brief Index type */
+    using index_type = Index;
+
+    /** @brief Read-only view of a contiguous list of indices */
+    class IndexRange
+    {
+    public:
+        /** @brief Construct from a pointer range */
+        IndexRange(const Index* first, const Index* last)
+            : first_{first}, last_{last}
+        {
+        }
+        /** @brief Iterator to the first index */
+        [[nodiscard]] auto begin() const -> const Index* { return first_; }
+        /** @brief Iterator past the last index */
+        [[nodiscard]] auto end() const -> const Index* { return last_; }
+        /** @brief Number of indices */
+        [[nodiscard]] auto size() const -> std::size_t
+        {
+            return static_cast<std::size_t>(last_ - first_);
+        }
+        /** @brief Whether the range is empty */
+        [[nodiscard]] auto empty() const -> bool { return first_ == last_; }
+        /** @brief Get an index by position */
+        auto operator[](std::size_t i) const -> Index { return first_[i]; }
+
+    private:
+        const Index* first_;
+        const Index* last_;
+    };
+
+    /** @brief Edge as a (min vertex, max vertex) pair */
+    using Edge = std::array<Index, 2>;
+
+    /** @brief Default constructor */
+    MeshAdjacency() = default;
+
+    /**
+     * @brief Build the adjacency for a mesh
+     *
+     * @throws std::overflow_error If the mesh has more vertices or face
+     * corners than can be represented by `Index`
+     */
+    template <class MeshType>
+    explicit MeshAdjacency(const MeshType& mesh)
+    {
+        build_(mesh);
+    }
+
+    /** @brief Number of vertices */
+    [[nodiscard]] auto numVertices() const -> std::size_t
+    {
+        return vfOffsets_.empty() ? 0 : vfOffsets_.size() - 1;
+    }
+
+    /** @brief Number of faces */
+    [[nodiscard]] auto numFaces() const -> std::size_t
+    {
+        return fOffsets_.empty() ? 0 : fOffsets_.size() - 1;
+    }
+
+    /** @brief Number of unique, undirected edges */
+    [[nodiscard]] auto numEdges() const -> std::size_t { return edges_.size(); }
+
+    /** @brief Number of half-edges (face corners) */
+    [[nodiscard]] auto numHalfEdges() const -> std::size_t
+    {
+        return heEdge_.size();
+    }
+
+    /** @brief Get the vertices of an edge, in ascending order */
+    [[nodiscard]] auto edge(std::size_t e) const -> const Edge&
+    {
+        return edges_.at(e);
+    }
+
+    /**
+     * @brief Faces incident to a vertex, in ascending order
+     *
+     * Each face is listed once, even if it repeats the vertex.
+     */
+    [[nodiscard]] auto vertexFaces(std::size_t v) const -> IndexRange
+    {
+        return row_(vfOffsets_, vfFaces_, v);
+    }
+
+    /**
+     * @brief Vertices which share an edge with a vertex, in ascending order
+     *
+     * A vertex is never its own neighbor, even if a face repeats it.
+     */
+    [[nodiscard]] auto vertexNeighbors(std::size_t v) const -> IndexRange
+    {
+        return row_(veOffsets_, vvNeighbors_, v);
+    }
+
+    /**
+     * @brief Edges incident to a vertex
+     *
+     * Ordered to match vertexNeighbors(): The i-th edge connects `v` to the
+     * i-th neighbor. Self-edges are not included.
+     */
+    [[nodiscard]] auto vertexEdges(std::size_t v) const -> IndexRange
+    {
+        return row_(veOffsets_, veEdges_, v);
+    }
+
+    /** @brief Faces incident to an edge */
+    [[nodiscard]] auto edgeFaces(std::size_t e) const -> IndexRange
+    {
+        return row_(efOffsets_, efFaces_, e);
+    }
+
+    /**
+     * @brief Edges of a face
+     *
+     * The i-th edge connects face corners `i` and `i + 1`.
+     */
+    [[nodiscard]] auto faceEdges(std::size_t f) const -> IndexRange
+    {
+        return row_(fOffsets_, heEdge_, f);
+    }
+
+    /**
+     * @brief Faces which share an edge with a face
+     *
+     * Each neighbor is listed once, in ascending order.
+     */
+    [[nodiscard]] auto faceNeighbors(std::size_t f) const -> std::vector<Index>
+    {
+        std::vector<Index> result;
+        for (auto e : faceEdges(f)) {
+            for (auto n : edgeFaces(e)) {
+                if (n != f) {
+                    result.push_back(n);
+                }
+            }
+        }
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+        return result;
+    }
+
+    /** @brief Whether an edge is incident to exactly one face */
+    [[nodiscard]] auto isBoundaryEdge(std::size_t e) const -> bool
+    {
+        return edgeFaces(e).size() == 1;
+    }
+
+    /** @brief Whether an edge is incident to more than two faces */
+    [[nodiscard]] auto isNonManifoldEdge(std::size_t e) const -> bool
+    {
+        return edgeFaces(e).size() > 2;
+    }
+
+    /** @brief Whether a vertex is incident to a boundary edge */
+    [[nodiscard]] auto isBoundaryVertex(std::size_t v) const -> bool
+    {
+        const auto edges = vertexEdges(v);
+        return std::any_of(edges.begin(), edges.end(), [this](auto e) {
+            return isBoundaryEdge(e);
+        });
+    }
+
+    /**
+     * @brief Whether a vertex is non-manifold
+     *
+     * A vertex is non-manifold if it is incident to a non-manifold edge or if
+     * its incident faces do not form a single edge-connected fan (e.g. two
+     * cones which touch at their tips). Isolated vertices are manifold.
+     */
+    [[nodiscard]] auto isNonManifoldVertex(std::size_t v) const -> bool
+    {
+        const auto faces = vertexFaces(v);
+        if (faces.size() < 2) {
+            return false;
+        }
+
+        // Union-find over the fan's faces, linked by shared edges
+        std::vector<std::size_t> parent(faces.size());
+        std::iota(parent.begin(), parent.end(), 0);
+        auto find = [&parent](std::size_t i) {
+            while (parent[i] != i) {
+                i = parent[i] = parent[parent[i]];
+            }
+            return i;
+        };
+        auto local = [&faces](Index f) {
+            return static_cast<std::size_t>(
+                std::lower_bound(faces.begin(), faces.end(), f) -
+                faces.begin());
+        };
+        auto components = faces.size();
+        for (auto e : vertexEdges(v)) {
+            const auto ef = edgeFaces(e);
+            if (ef.size() > 2) {
+                return true;
+            }
+            if (ef.size() == 2) {
+                auto a = find(local(ef[0]));
+                auto b = find(local(ef[1]));
+                if (a != b) {
+                    parent[a] = b;
+                    components--;
+                }
+            }
+        }
+        return components > 1;
+    }
+
+    /** @brief List all boundary edges */
+    [[nodiscard]] auto boundaryEdges() const -> std::vector<Index>
+    {
+        return filter_(
+            numEdges(), [this](auto e) { return isBoundaryEdge(e); });
+    }
+
+    /** @brief List all non-manifold edges */
+    [[nodiscard]] auto nonManifoldEdges() const -> std::vector<Index>
+    {
+        return filter_(
+            numEdges(), [this](auto e) { return isNonManifoldEdge(e); });
+    }
+
+    /** @brief List all non-manifold vertices */
+    [[nodiscard]] auto nonManifoldVertices() const -> std::vector<Index>
+    {
+        return filter_(
+            numVertices(), [this](auto v) { return isNonManifoldVertex(v); });
+    }
+
+    /** @brief Whether every edge and vertex is manifold */
+    [[nodiscard]] auto isManifold() const -> bool
+    {
+        return nonManifoldEdges().empty() and nonManifoldVertices().empty();
+    }
+
+private:
+    /** Face corner offsets (half-edges of face f) */
+    std::vector<Index> fOffsets_;
+    /** Vertex-to-face CSR */
+    std::vector<Index> vfOffsets_;
+    std::vector<Index> vfFaces_;
+    /** Unique edges */
+    std::vector<Edge> edges_;
+    /** Edge of each half-edge */
+    std::vector<Index> heEdge_;
+    /** Edge-to-face CSR */
+    std::vector<Index> efOffsets_;
+    std::vector<Index> efFaces_;
+    /** Vertex-to-edge/vertex CSR */
+    std::vector<Index> veOffsets_;
+    std::vector<Index> veEdges_;
+    std::vector<Index> vvNeighbors_;
+
+    /** Get a CSR row */
+    static auto row_(
+        const std::vector<Index>& offsets,
+        const std::vector<Index>& values,
+        std::size_t r) -> IndexRange
+    {
+        if (r + 1 >= offsets.size()) {
+            throw std::out_of_range("Adjacency index out of range");
+        }
+        const auto* data = values.data();
+        return {data + offsets[r], data + offsets[r + 1]};
+    }
+
+    /** Collect the indices in [0, n) which satisfy a predicate */
+    template <class Pred>
+    static auto filter_(std::size_t n, Pred pred) -> std::vector<Index>
+    {
+        std::vector<char> flags(n);
+        parallel_for(0, n, [&](auto i) { flags[i] = pred(i) ? 1 : 0; });
+        std::vector<Index> result;
+        for (std::size_t i{0}; i < n; i++) {
+            if (flags[i] != 0) {
+                result.push_back(static_cast<Index>(i));
+            }
+        }
+        return result;
+    }
+
+    template <class MeshType>
+    void build_(const MeshType& mesh)
+    {
+        const auto& faces = mesh.faces();
+        const auto nv = mesh.numVertices();
+        const auto nf = faces.size();
+        auto corners = detail::face_corner_offsets(mesh);
+        const auto nh = corners.back();
+        constexpr auto maxIdx = std::numeric_limits<Index>::max();
+        if (nv >= maxIdx or nf >= maxIdx or nh >= maxIdx) {
+            throw std::overflow_error(
+                "Mesh is too large for the adjacency index type");
+        }
+
+        // Half-edge keys. Face indices were validated by face_corner_offsets.
+        std::vector<Index> hiKeys(nh);
+        std::vector<Index> loKeys(nh);
+        std::vector<Index> heFace(nh);
+        parallel_for(0, nf, [&](auto f) {
+            const auto& face = faces[f];
+            for (std::size_t c{0}; c < face.size(); c++) {
+                auto a = static_cast<std::size_t>(face[c]);
+                auto b = static_cast<std::size_t>(face[(c + 1) % face.size()]);
+                auto h = corners[f] + c;
+                loKeys[h] = static_cast<Index>(std::min(a, b));
+                hiKeys[h] = static_cast<Index>(std::max(a, b));
+                heFace[h] = static_cast<Index>(f);
+            }
+        });
+
+        // Vertex-to-face. The CSR has one entry per corner, so a face which
+        // repeats a vertex is listed more than once in that vertex's row.
+        // Rows are ascending, so the repeats are adjacent and are compacted
+        // in place.
+        fOffsets_.assign(corners.begin(), corners.end());
+        auto vf = detail::build_vertex_face_csr<Index>(mesh, corners);
+        vfOffsets_ = std::move(vf.offsets);
+        vfFaces_ = std::move(vf.faces);
+        std::size_t out{0};
+        for (std::size_t v{0}; v < nv; v++) {
+            auto begin = static_cast<std::size_t>(vfOffsets_[v]);
+            auto end = static_cast<std::size_t>(vfOffsets_[v + 1]);
+            vfOffsets_[v] = static_cast<Index>(out);
+            for (auto i = begin; i < end; i++) {
+                if (i == begin or vfFaces_[i] != vfFaces_[i - 1]) {
+                    vfFaces_[out++] = vfFaces_[i];
+                }
+            }
+        }
+        vfOffsets_[nv] = static_cast<Index>(out);
+        vfFaces_.resize(out);
+
+        // Sort half-edges by (lo, hi): LSD order sorts on hi, then on lo
+        std::vector<Index> order(nh);
+        std::iota(order.begin(), order.end(), Index{0});
+        auto keys = hiKeys;
+        radix_sort_pairs(keys, order);
+        parallel_for(0, nh, [&](auto i) { keys[i] = loKeys[order[i]]; });
+        radix_sort_pairs(keys, order);
+
+        // Unique edges and edge-to-face CSR. The sort is stable, so the faces
+        // in each row are ascending and repeats (a face which uses the same
+        // edge twice) are adjacent.
+        heEdge_.resize(nh);
+        edges_.clear();
+        efOffsets_.clear();
+        efFaces_.clear();
+        for (std::size_t i{0}; i < nh; i++) {
+            auto h = order[i];
+            Edge e{loKeys[h], hiKeys[h]};
+            if (edges_.empty() or edges_.back() != e) {
+                edges_.push_back(e);
+                efOffsets_.push_back(static_cast<Index>(efFaces_.size()));
+                efFaces_.push_back(heFace[h]);
+            } else if (efFaces_.back() != heFace[h]) {
+                efFaces_.push_back(heFace[h]);
+            }
+            heEdge_[h] = static_cast<Index>(edges_.size() - 1);
+        }
+        efOffsets_.push_back(static_cast<Index>(efFaces_.size()));
+        const auto ne = edges_.size();
+
+        // Vertex-to-edge: Listing (hi -> lo) before (lo -> hi) makes each
+        // row's neighbors ascending after a stable sort on the source vertex.
+        // Self-edges from repeated face vertices are skipped.
+        std::vector<Index> links;
+        links.reserve(ne);
+        for (std::size_t e{0}; e < ne; e++) {
+            if (edges_[e][0] != edges_[e][1]) {
+                links.push_back(static_cast<Index>(e));
+            }
+        }
+        const auto nl = links.size();
+        std::vector<Index> src(2 * nl);
+        veEdges_.resize(2 * nl);
+        parallel_for(0, nl, [&](auto i) {
+            const auto& e = edges_[links[i]];
+            src[i] = e[1];
+            src[nl + i] = e[0];
+            veEdges_[i] = links[i];
+            veEdges_[nl + i] = links[i];
+        });
+        radix_sort_pairs(src, veEdges_);
+        veOffsets_ = detail::csr_offsets(src, nv);
+        vvNeighbors_.resize(2 * nl);
+        parallel_for(0, 2 * nl, [&](auto i) {
+            const auto& e = edges_[veEdges_[i]];
+            vvNeighbors_[i] = e[0] == src[i] ? e[1] : e[0];
+        });
+    }
+};
+
+}  // namespace educelab
@@ -0,0 +1,280 @@
+#pragma once
+
+/** @file */
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+#include "educelab/core/utils/Sorting.hpp"
+
+namespace educelab
+{
+
+/**
+ * @brief Lock-free concurrent union-find (disjoint set) structure
+ *
+ * unite() and find() may be called concurrently from any number of threads.
+ * Roots are always linked to the smaller root with compare-and-swap, so the
+ * final representative of every set is its smallest element, regardless of
+ * the order of operations. find() performs path halving with relaxed
+ * compare-and-swap writes, which only ever shorten paths and never change
+ * the set an element belongs to.
+ */
+class ConcurrentUnionFind
+{
+public:
+    /** @brief Element index type */
+    using Index = std::uint32_t;
+
+    /** @brief Construct with `n` singleton sets */
+    explicit ConcurrentUnionFind(std::size_t n) : parent_(n)
+    {
+        if (n > std::numeric_limits<Index>::max()) {
+            throw std::overflow_error("Too many elements for union-find");
+        }
+        parallel_for(0, n, [&](auto i) {
+            parent_[i].store(static_cast<Index>(i), std::memory_order_relaxed);
+        });
+    }
+
+    /** @brief Number of elements */
+    [[nodiscard]] auto size() const -> std::size_t { return parent_.size(); }
+
+    /** @brief Find the representative of the set containing `x` */
+    auto find(Index x) -> Index
+    {
+        while (true) {
+            auto p = parent_[x].load(std::memory_order_relaxed);
+            if (p == x) {
+                return x;
+            }
+            auto gp = parent_[p].load(std::memory_order_relaxed);
+            if (gp == p) {
+                return p;
+            }
+            // Path halving
+            parent_[x].compare_exchange_weak(
+                p, gp, std::memory_order_relaxed, std::memory_order_relaxed);
+            x = gp;
+        }
+    }
+
+    /** @brief Merge the sets containing `a` and `b` */
+    void unite(Index a, Index b)
+    {
+        while (true) {
+            a = find(a);
+            b = find(b);
+            if (a == b) {
+                return;
+            }
+            // Link the larger root under the smaller one
+            if (a < b) {
+                std::swap(a, b);
+            }
+            auto expected = a;
+            if (parent_[a].compare_exchange_strong(
+                    expected, b, std::memory_order_acq_rel,
+                    std::memory_order_relaxed)) {
+                return;
+            }
+            // a stopped being a root. Retry with its new root.
+        }
+    }
+
+private:
+    std::vector<std::atomic<Index>> parent_;
+};
+
+/** @brief Result of connected_components() */
+struct MeshComponents {
+    /** Number of components */
+    std::size_t numComponents{0};
+    /** Component of each vertex */
+    std::vector<std::uint32_t> vertexLabels;
+    /** Component of each face */
+    std::vector<std::uint32_t> faceLabels;
+    /** Number of vertices in each component */
+    std::vector<std::size_t> vertexCounts;
+    /** Number of faces in each component */
+    std::vector<std::size_t> faceCounts;
+};
+
+/**
+ * @brief Label the connected components of a mesh
+ *
+ * Two vertices are connected if they share a face. Faces are labeled with
+ * the component of their vertices. Vertices which aren't referenced by any
+ * face are their own components. Components are numbered in order of their
+ * smallest vertex index, so labels are deterministic.
+ *
+ * Faces are merged into a lock-free union-find in parallel. The labels are
+ * then resolved in parallel.
+ *
+ * @throws std::out_of_range If a face references an invalid vertex
+ * @throws std::overflow_error If the mesh has more than 2^32 - 1 vertices
+ */
+template <class MeshType>
+auto connected_components(const MeshType& mesh) -> MeshComponents
+{
+    using Index = ConcurrentUnionFind::Index;
+    const auto nv = mesh.numVertices();
+    const auto& faces = mesh.faces();
+    const auto nf = faces.size();
+
+    ConcurrentUnionFind uf(nv);
+    parallel_for(0, nf, [&](auto f) {
+        const auto& face = faces[f];
+        for (const auto& v : face) {
+            if (static_cast<std::size_t>(v) >= nv) {
+                throw std::out_of_range("Face references invalid vertex");
+            }
+        }
+        for (std::size_t i{1}; i < face.size(); i++) {
+            uf.unite(static_cast<Index>(face[0]), static_cast<Index>(face[i]));
+        }
+    });
+
+    // Roots are the smallest vertex of each component, so ranking the roots
+    // in vertex order gives deterministic labels
+    MeshComponents result;
+    result.vertexLabels.resize(nv);
+    parallel_for(0, nv, [&](auto v) {
+        result.vertexLabels[v] = uf.find(static_cast<Index>(v));
+    });
+    std::vector<Index> rank(nv);
+    Index next{0};
+    for (std::size_t v{0}; v < nv; v++) {
+        if (result.vertexLabels[v] == v) {
+            rank[v] = next++;
+        }
+    }
+    result.numComponents = next;
+    parallel_for(0, nv, [&](auto v) {
+        result.vertexLabels[v] = rank[result.vertexLabels[v]];
+    });
+
+    result.faceLabels.resize(nf);
+    parallel_for(0, nf, [&](auto f) {
+        const auto& face = faces[f];
+        result.faceLabels[f] = face.empty()
+                                   ? std::numeric_limits<Index>::max()
+                                   : result.vertexLabels[face[0]];
+    });
+
+    result.vertexCounts.assign(next, 0);
+    result.faceCounts.assign(next, 0);
+    for (const auto& l : result.vertexLabels) {
+        result.vertexCounts[l]++;
+    }
+    for (const auto& l : result.faceLabels) {
+        if (l < next) {
+            result.faceCounts[l]++;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Split a mesh into one mesh per connected component
+ *
+ * Components with fewer than `minFaces` faces are discarded, which removes
+ * small islands. By default, only unreferenced vertices are discarded. The
+ * output meshes are in component order (see connected_components()), and
+ * vertices and faces keep their relative order within each component.
+ * Each output mesh gets a copy of the UVs used by its faces.
+ *
+ * Vertices and faces are grouped by component with a parallel radix sort,
+ * then copied into preallocated output meshes in parallel, so the input is
+ * traversed only once after labeling.
+ *
+ * @throws std::out_of_range If a face references an invalid vertex or UV
+ */
+template <class MeshType>
+auto split_components(const MeshType& mesh, std::size_t minFaces = 1)
+    -> std::vector<MeshType>
+{
+    using Index = typename MeshType::Face::value_type;
+    auto comps = connected_components(mesh);
+    const auto nc = comps.numComponents;
+    const auto nv = mesh.numVertices();
+    const auto nf = mesh.numFaces();
+
+    // Output mesh of each component, or NONE if it's discarded
+    constexpr auto NONE = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> output(nc, NONE);
+    const auto& faceUVs = mesh.faceUVs();
+    std::vector<MeshType> meshes;
+    for (std::size_t c{0}; c < nc; c++) {
+        if (comps.faceCounts[c] >= minFaces) {
+            output[c] = meshes.size();
+            auto& m = meshes.emplace_back();
+            m.vertices().resize(comps.vertexCounts[c]);
+            m.faces().resize(comps.faceCounts[c]);
+            if (not faceUVs.empty()) {
+                m.faceUVs().resize(comps.faceCounts[c]);
+            }
+        }
+    }
+
+    // Group by label with a stable sort. The position of an element within
+    // its group is its index in the output mesh.
+    std::vector<std::size_t> vertOffsets(nc + 1, 0);
+    std::vector<std::size_t> faceOffsets(nc + 1, 0);
+    for (std::size_t c{0}; c < nc; c++) {
+        vertOffsets[c + 1] = vertOffsets[c] + comps.vertexCounts[c];
+        faceOffsets[c + 1] = faceOffsets[c] + comps.faceCounts[c];
+    }
+    auto vertKeys = comps.vertexLabels;
+    std::vector<std::size_t> vertOrder(nv);
+    std::iota(vertOrder.begin(), vertOrder.end(), 0);
+    radix_sort_pairs(vertKeys, vertOrder);
+    auto faceKeys = comps.faceLabels;
+    std::vector<std::size_t> faceOrder(nf);
+    std::iota(faceOrder.begin(), faceOrder.end(), 0);
+    radix_sort_pairs(faceKeys, faceOrder);
+
+    // Copy vertices
+    std::vector<std::size_t> local(nv);
+    parallel_for(0, nv, [&](auto i) {
+        auto v = vertOrder[i];
+        auto c = vertKeys[i];
+        local[v] = i - vertOffsets[c];
+        if (output[c] != NONE) {
+            meshes[output[c]].vertices()[local[v]] = mesh.vertex(v);
+        }
+    });
+
+    // Copy faces with remapped indices
+    parallel_for(0, nf, [&](auto i) {
+        auto c = faceKeys[i];
+        if (c >= nc or output[c] == NONE) {
+            return;
+        }
+        auto f = faceOrder[i];
+        auto& m = meshes[output[c]];
+        auto& dst = m.faces()[i - faceOffsets[c]];
+        dst = mesh.face(f);
+        for (auto& v : dst) {
+            v = static_cast<Index>(local[v]);
+        }
+        if (f < faceUVs.size()) {
+            m.faceUVs()[i - faceOffsets[c]] = faceUVs[f];
+        }
+    });
+
+    // Copy the UVs used by each output mesh
+    parallel_for(
+        0, meshes.size(),
+        [&](auto m) { detail::copy_used_uvs(meshes[m], mesh); }, 1);
+    return meshes;
+}
+
+}  // namespace educelab
@@ -0,0 +1,796 @@
+#pragma once
+
+/** @file */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/types/Vec.hpp"
+#include "educelab/core/utils/MeshAdjacency.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+#include "educelab/core/utils/Sorting.hpp"
+
+namespace educelab
+{
+
+/** @brief Options for decimate() and decimate_parallel() */
+struct DecimateOptions {
+    /** Stop once the mesh has at most this many faces */
+    std::size_t targetFaces{0};
+    /**
+     * Stop once the cheapest edge collapse has an error greater than this
+     * value. The error is the area-weighted mean squared distance from the
+     * new vertex to the planes of the original faces merged into it, so it is
+     * in squared mesh units and largely independent of the tessellation. Pass
+     * `tol * tol` to keep vertices within about `tol` of the surface.
+     */
+    double maxError{std::numeric_limits<double>::infinity()};
+    /** Penalize collapses which move boundary edges */
+    bool preserveBoundary{true};
+};
+
+namespace detail
+{
+/** Symmetric 4x4 error quadric stored as its upper triangle */
+struct Quadric {
+    /** a2, ab, ac, ad, b2, bc, bd, c2, cd, d2 */
+    std::array<double, 10> q{};
+    /** Summed area of the face planes, used to normalize the error */
+    double area{0};
+
+    /** Quadric for the plane n.p + d = 0, scaled by weight */
+    static auto Plane(const Vec<double, 3>& n, double d, double w) -> Quadric
+    {
+        Quadric r;
+        r.q = {w * n[0] * n[0], w * n[0] * n[1], w * n[0] * n[2],
+               w * n[0] * d,    w * n[1] * n[1], w * n[1] * n[2],
+               w * n[1] * d,    w * n[2] * n[2], w * n[2] * d,
+               w * d * d};
+        return r;
+    }
+
+    auto operator+=(const Quadric& o) -> Quadric&
+    {
+        for (std::size_t i{0}; i < q.size(); i++) {
+            q[i] += o.q[i];
+        }
+        area += o.area;
+        return *this;
+    }
+
+    friend auto operator+(Quadric a, const Quadric& b) -> Quadric
+    {
+        a += b;
+        return a;
+    }
+
+    /** Evaluate the squared error at p */
+    [[nodiscard]] auto error(const Vec<double, 3>& p) const -> double
+    {
+        const auto& [a2, ab, ac, ad, b2, bc, bd, c2, cd, d2] = q;
+        auto x = p[0];
+        auto y = p[1];
+        auto z = p[2];
+        return a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x +
+               b2 * y * y + 2 * bc * y * z + 2 * bd * y + c2 * z * z +
+               2 * cd * z + d2;
+    }
+
+    /**
+     * Evaluate the error at p divided by the face area, i.e. the
+     * area-weighted mean squared distance to the face planes
+     */
+    [[nodiscard]] auto normalizedError(const Vec<double, 3>& p) const -> double
+    {
+        auto e = error(p);
+        return area > 0 ? e / area : e;
+    }
+
+    /** Position which minimizes the error. Returns false if singular. */
+    auto optimize(Vec<double, 3>& p) const -> bool
+    {
+        const auto& [a2, ab, ac, ad, b2, bc, bd, c2, cd, d2] = q;
+        // Cramer's rule on A p = -b
+        auto det = a2 * (b2 * c2 - bc * bc) - ab * (ab * c2 - bc * ac) +
+                   ac * (ab * bc - b2 * ac);
+        auto scale = std::abs(a2 * b2 * c2) + std::abs(ab * ab * c2) +
+                     std::abs(ac * ac * b2) + std::abs(bc * bc * a2);
+        if (not(std::abs(det) > 1e-10 * scale) or scale == 0) {
+            return false;
+        }
+        auto x = -ad * (b2 * c2 - bc * bc) + ab * (bd * c2 - bc * cd) -
+                 ac * (bd * bc - b2 * cd);
+        auto y = a2 * (-bd * c2 + cd * bc) + ad * (ab * c2 - bc * ac) +
+                 ac * (-ab * cd + bd * ac);
+        auto z = a2 * (-b2 * cd + bc * bd) - ab * (-ab * cd + bd * ac) -
+                 ad * (ab * bc - b2 * ac);
+        p = Vec<double, 3>{x / det, y / det, z / det};
+        return std::isfinite(p[0]) and std::isfinite(p[1]) and
+               std::isfinite(p[2]);
+    }
+};
+
+/**
+ * Garland-Heckbert edge collapse decimation of a triangle mesh.
+ *
+ * Faces are stored as flat index triples. Each vertex keeps a singly linked
+ * list of its face corners (corner `c` is slot `c % 3` of face `c / 3`),
+ * which can be spliced in O(1) when one vertex collapses into another. Edge
+ * collapses are ordered with a binary heap with lazy invalidation: each
+ * entry records the versions of its endpoints and is skipped if either has
+ * changed since it was pushed.
+ *
+ * run() only collapses edges between unlocked vertices. If every face
+ * incident to an unlocked vertex has only vertices from the same region,
+ * runs over disjoint regions do not share any mutable state and can execute
+ * concurrently.
+ */
+class QuadricDecimator
+{
+public:
+    using Index = std::uint32_t;
+    using Vec3 = Vec<double, 3>;
+    static constexpr Index NONE{std::numeric_limits<Index>::max()};
+
+    template <class MeshType>
+    QuadricDecimator(const MeshType& mesh, bool preserveBoundary)
+    {
+        const auto nv = mesh.numVertices();
+        const auto nf = mesh.numFaces();
+        if (nv >= NONE or 3 * nf >= NONE) {
+            throw std::overflow_error("Mesh is too large to decimate");
+        }
+        pos_.resize(nv);
+        parallel_for(0, nv, [&](auto v) {
+            const auto& p = mesh.vertex(v);
+            pos_[v] = Vec3{double(p[0]), double(p[1]), double(p[2])};
+        });
+        faces_.resize(nf);
+        for (std::size_t f{0}; f < nf; f++) {
+            const auto& face = mesh.face(f);
+            if (face.size() != 3) {
+                throw std::invalid_argument("Decimation requires triangles");
+            }
+            for (std::size_t c{0}; c < 3; c++) {
+                if (face[c] >= nv) {
+                    throw std::out_of_range("Face references invalid vertex");
+                }
+                faces_[f][c] = static_cast<Index>(face[c]);
+            }
+        }
+        faceAlive_.assign(nf, 1);
+        vertAlive_.assign(nv, 1);
+        locked_.assign(nv, 0);
+        boundary_.assign(nv, 0);
+        version_.assign(nv, 0);
+        liveFaces_ = nf;
+        buildCornerLists_();
+        buildQuadrics_(mesh, preserveBoundary);
+    }
+
+    [[nodiscard]] auto numVertices() const -> std::size_t
+    {
+        return pos_.size();
+    }
+    [[nodiscard]] auto liveFaces() const -> std::size_t { return liveFaces_; }
+    [[nodiscard]] auto position(Index v) const -> const Vec3&
+    {
+        return pos_[v];
+    }
+    [[nodiscard]] auto face(Index f) const -> const std::array<Index, 3>&
+    {
+        return faces_[f];
+    }
+    [[nodiscard]] auto faceAlive(Index f) const -> bool
+    {
+        return faceAlive_[f] != 0;
+    }
+    [[nodiscard]] auto numFaces() const -> std::size_t { return faces_.size(); }
+
+    /** Lock or unlock a vertex */
+    void setLocked(Index v, bool locked) { locked_[v] = locked ? 1 : 0; }
+
+    /**
+     * Collapse edges between the given vertices until `removeFaces` faces
+     * have been removed or no collapse has an error <= maxError. Returns the
+     * number of faces removed. Does not update liveFaces().
+     */
+    auto run(
+        const std::vector<Index>& verts, std::size_t removeFaces, double maxErr)
+        -> std::size_t
+    {
+        if (removeFaces == 0) {
+            return 0;
+        }
+        Heap heap;
+        std::vector<Index> nbrs;
+        for (auto v : verts) {
+            if (locked_[v] != 0 or vertAlive_[v] == 0) {
+                continue;
+            }
+            neighbors_(v, nbrs);
+            for (auto w : nbrs) {
+                if (v < w and locked_[w] == 0) {
+                    push_(heap, v, w);
+                }
+            }
+        }
+
+        std::size_t removed{0};
+        std::vector<Index> nbrsU;
+        std::vector<Index> nbrsV;
+        while (removed < removeFaces and not heap.empty()) {
+            auto e = heap.top();
+            heap.pop();
+            if (e.cost > maxErr) {
+                break;
+            }
+            if (vertAlive_[e.u] == 0 or vertAlive_[e.v] == 0 or
+                version_[e.u] != e.verU or version_[e.v] != e.verV) {
+                continue;
+            }
+            auto target = target_(e.u, e.v).first;
+            if (not canCollapse_(e.u, e.v, target, nbrsU, nbrsV)) {
+                continue;
+            }
+            removed += collapse_(e.u, e.v, target);
+
+            // Requeue the edges around the merged vertex
+            neighbors_(e.v, nbrs);
+            for (auto w : nbrs) {
+                if (locked_[w] == 0) {
+                    push_(heap, e.v, w);
+                }
+            }
+        }
+        return removed;
+    }
+
+    /** Update the live face count after one or more run() calls */
+    void recount()
+    {
+        std::size_t n{0};
+        for (const auto& a : faceAlive_) {
+            n += a;
+        }
+        liveFaces_ = n;
+    }
+
+private:
+    struct Collapse {
+        float cost;
+        Index u;
+        Index v;
+        Index verU;
+        Index verV;
+
+        auto operator<(const Collapse& o) const -> bool
+        {
+            return cost > o.cost;
+        }
+    };
+    using Heap = std::priority_queue<Collapse>;
+
+    std::vector<Vec3> pos_;
+    std::vector<std::array<Index, 3>> faces_;
+    std::vector<char> faceAlive_;
+    std::vector<char> vertAlive_;
+    std::vector<char> locked_;
+    std::vector<char> boundary_;
+    std::vector<Index> version_;
+    std::vector<Quadric> quadrics_;
+    /** Per-vertex corner lists */
+    std::vector<Index> head_;
+    std::vector<Index> tail_;
+    std::vector<Index> next_;
+    std::size_t liveFaces_{0};
+
+    void buildCornerLists_()
+    {
+        const auto nv = pos_.size();
+        head_.assign(nv, NONE);
+        tail_.assign(nv, NONE);
+        next_.assign(3 * faces_.size(), NONE);
+        for (std::size_t c{0}; c < next_.size(); c++) {
+            auto v = faces_[c / 3][c % 3];
+            if (head_[v] == NONE) {
+                head_[v] = static_cast<Index>(c);
+            } else {
+                next_[tail_[v]] = static_cast<Index>(c);
+            }
+            tail_[v] = static_cast<Index>(c);
+        }
+    }
+
+    template <class MeshType>
+    void buildQuadrics_(const MeshType& mesh, bool preserveBoundary)
+    {
+        const auto nv = pos_.size();
+        const auto nf = faces_.size();
+
+        // Area-weighted face plane quadrics
+        std::vector<Quadric> faceQ(nf);
+        std::vector<Vec3> faceN(nf);
+        parallel_for(0, nf, [&](auto f) {
+            const auto& [a, b, c] = faces_[f];
+            auto n = (pos_[b] - pos_[a]).cross(pos_[c] - pos_[a]);
+            auto len = n.magnitude();
+            if (len > 0) {
+                n /= len;
+                faceQ[f] = Quadric::Plane(n, -n.dot(pos_[a]), len / 2);
+                faceQ[f].area = len / 2;
+            }
+            faceN[f] = n;
+        });
+
+        // Boundary edges: Flag vertices and add constraint planes
+        // perpendicular to the face through the edge. These don't add to the
+        // quadric's area, so they only act as a penalty.
+        MeshAdjacency<Index> adj(mesh);
+        std::vector<Quadric> edgeQ(adj.numEdges());
+        parallel_for(0, adj.numEdges(), [&](auto e) {
+            if (not adj.isBoundaryEdge(e)) {
+                return;
+            }
+            const auto& [a, b] = adj.edge(e);
+            auto f = adj.edgeFaces(e)[0];
+            auto dir = pos_[b] - pos_[a];
+            auto len2 = dir.magnitude2();
+            auto n = dir.cross(faceN[f]);
+            auto len = n.magnitude();
+            if (len > 0) {
+                n /= len;
+                constexpr double BOUNDARY_WEIGHT{1000};
+                edgeQ[e] = Quadric::Plane(
+                    n, -n.dot(pos_[a]), BOUNDARY_WEIGHT * len2);
+            }
+        });
+
+        // Gather per vertex
+        quadrics_.resize(nv);
+        parallel_for(0, nv, [&](auto v) {
+            Quadric q;
+            for (auto f : adj.vertexFaces(v)) {
+                q += faceQ[f];
+            }
+            for (auto e : adj.vertexEdges(v)) {
+                if (adj.isBoundaryEdge(e)) {
+                    boundary_[v] = 1;
+                    if (preserveBoundary) {
+                        q += edgeQ[e];
+                    }
+                }
+            }
+            quadrics_[v] = q;
+        });
+    }
+
+    /** Alive vertices which share an alive face with v. Compacts v's list. */
+    void neighbors_(Index v, std::vector<Index>& out)
+    {
+        out.clear();
+        Index prev{NONE};
+        for (auto c = head_[v]; c != NONE; c = next_[c]) {
+            auto f = c / 3;
+            if (faceAlive_[f] == 0) {
+                // Unlink the dead corner
+                if (prev == NONE) {
+                    head_[v] = next_[c];
+                } else {
+                    next_[prev] = next_[c];
+                }
+                if (tail_[v] == c) {
+                    tail_[v] = prev;
+                }
+                continue;
+            }
+            for (auto w : faces_[f]) {
+                if (w != v) {
+                    out.push_back(w);
+                }
+            }
+            prev = c;
+        }
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+
+    /** Optimal position and normalized error for collapsing edge (u, v) */
+    auto target_(Index u, Index v) const -> std::pair<Vec3, double>
+    {
+        auto q = quadrics_[u] + quadrics_[v];
+        Vec3 target;
+        if (not q.optimize(target)) {
+            // Fall back to the best of the endpoints and midpoint
+            target = (pos_[u] + pos_[v]) / 2.0;
+            auto best = q.error(target);
+            for (const auto* p : {&pos_[u], &pos_[v]}) {
+                auto err = q.error(*p);
+                if (err < best) {
+                    best = err;
+                    target = *p;
+                }
+            }
+        }
+        return {target, std::max(q.normalizedError(target), 0.0)};
+    }
+
+    void push_(Heap& heap, Index u, Index v)
+    {
+        // Targets are recomputed when popped, which keeps entries small
+        auto cost = static_cast<float>(target_(u, v).second);
+        heap.push({cost, u, v, version_[u], version_[v]});
+    }
+
+    /** Whether face f would flip or degenerate if `from` moves to `to` */
+    auto flips_(Index f, Index from, const Vec3& to) const -> bool
+    {
+        const auto& face = faces_[f];
+        std::size_t k{0};
+        while (face[k] != from) {
+            k++;
+        }
+        const auto& a = pos_[face[(k + 1) % 3]];
+        const auto& b = pos_[face[(k + 2) % 3]];
+        const auto& p = pos_[from];
+        auto oldN = (a - p).cross(b - p);
+        auto newN = (a - to).cross(b - to);
+        auto oldLen2 = oldN.magnitude2();
+        auto newLen2 = newN.magnitude2();
+        if (oldLen2 <= 0) {
+            return false;
+        }
+        return newLen2 <= 0 or
+               oldN.dot(newN) <= 0.05 * std::sqrt(oldLen2 * newLen2);
+    }
+
+    auto contains_(Index f, Index v) const -> bool
+    {
+        const auto& face = faces_[f];
+        return face[0] == v or face[1] == v or face[2] == v;
+    }
+
+    auto canCollapse_(
+        Index u,
+        Index v,
+        const Vec3& target,
+        std::vector<Index>& nbrsU,
+        std::vector<Index>& nbrsV) -> bool
+    {
+        // Link condition: Shared neighbors must be the opposite vertices of
+        // the shared faces, otherwise the collapse creates non-manifold edges
+        neighbors_(u, nbrsU);
+        neighbors_(v, nbrsV);
+        std::size_t common{0};
+        for (auto i = nbrsU.begin(), j = nbrsV.begin();
+             i != nbrsU.end() and j != nbrsV.end();) {
+            if (*i < *j) {
+                i++;
+            } else if (*j < *i) {
+                j++;
+            } else {
+                common++;
+                i++;
+                j++;
+            }
+        }
+        std::size_t shared{0};
+        for (auto c = head_[u]; c != NONE; c = next_[c]) {
+            auto f = c / 3;
+            if (faceAlive_[f] != 0 and contains_(f, v)) {
+                shared++;
+            }
+        }
+        if (shared == 0 or common != shared) {
+            return false;
+        }
+        // Don't pinch the mesh by joining two boundaries through its interior
+        if (boundary_[u] != 0 and boundary_[v] != 0 and shared != 1) {
+            return false;
+        }
+
+        // Reject collapses which flip the remaining faces
+        for (auto [from, other] : {std::pair{u, v}, std::pair{v, u}}) {
+            for (auto c = head_[from]; c != NONE; c = next_[c]) {
+                auto f = c / 3;
+                if (faceAlive_[f] != 0 and not contains_(f, other) and
+                    flips_(f, from, target)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /** Collapse u into v. Returns the number of faces removed. */
+    auto collapse_(Index u, Index v, const Vec3& target) -> std::size_t
+    {
+        std::size_t removed{0};
+        for (auto c = head_[u]; c != NONE; c = next_[c]) {
+            auto f = c / 3;
+            if (faceAlive_[f] == 0) {
+                continue;
+            }
+            if (contains_(f, v)) {
+                faceAlive_[f] = 0;
+                removed++;
+            } else {
+                faces_[f][c % 3] = v;
+            }
+        }
+
+        // Splice u's corners onto v's list
+        if (head_[u] != NONE) {
+            if (head_[v] == NONE) {
+                head_[v] = head_[u];
+            } else {
+                next_[tail_[v]] = head_[u];
+            }
+            tail_[v] = tail_[u];
+        }
+        head_[u] = tail_[u] = NONE;
+
+        pos_[v] = target;
+        quadrics_[v] += quadrics_[u];
+        boundary_[v] = boundary_[v] | boundary_[u];
+        vertAlive_[u] = 0;
+        version_[u]++;
+        version_[v]++;
+        return removed;
+    }
+};
+
+/** Write the decimated result back to a mesh, dropping unused vertices */
+template <class MeshType>
+void decimate_write_back(MeshType& mesh, const QuadricDecimator& dec)
+{
+    using T = typename MeshType::value_type;
+    using Index = typename MeshType::Face::value_type;
+    constexpr auto NONE = QuadricDecimator::NONE;
+
+    std::vector<std::uint32_t> remap(dec.numVertices(), NONE);
+    std::vector<typename MeshType::Face> faces;
+    std::vector<std::uint32_t> kept;
+    faces.reserve(dec.liveFaces());
+    kept.reserve(dec.liveFaces());
+    std::uint32_t nextIdx{0};
+    for (std::uint32_t f{0}; f < dec.numFaces(); f++) {
+        if (not dec.faceAlive(f)) {
+            continue;
+        }
+        kept.push_back(f);
+        typename MeshType::Face face(3);
+        for (std::size_t c{0}; c < 3; c++) {
+            auto& r = remap[dec.face(f)[c]];
+            if (r == NONE) {
+                r = nextIdx++;
+            }
+            face[c] = static_cast<Index>(r);
+        }
+        faces.emplace_back(std::move(face));
+    }
+
+    std::vector<typename MeshType::Vertex> verts(nextIdx);
+    auto& old = mesh.vertices();
+    parallel_for(0, remap.size(), [&](auto v) {
+        if (remap[v] == NONE) {
+            return;
+        }
+        auto& out = verts[remap[v]];
+        out = std::move(old[v]);
+        const auto& p = dec.position(static_cast<std::uint32_t>(v));
+        out[0] = static_cast<T>(p[0]);
+        out[1] = static_cast<T>(p[1]);
+        out[2] = static_cast<T>(p[2]);
+    });
+    mesh.vertices() = std::move(verts);
+    mesh.faces() = std::move(faces);
+    permute_face_uvs(mesh, kept);
+}
+
+/** Faces to remove to reach the target */
+inline auto decimate_budget(std::size_t live, std::size_t target)
+    -> std::size_t
+{
+    return live > target ? live - target : 0;
+}
+}  // namespace detail
+
+/**
+ * @brief Simplify a triangle mesh with quadric error edge collapses
+ *
+ * Implements Garland and Heckbert's quadric error metric simplification.
+ * Edges are collapsed in order of increasing error until the mesh has at
+ * most `opts.targetFaces` faces or the cheapest collapse exceeds
+ * `opts.maxError`. Collapses which would flip a face or create non-manifold
+ * edges are skipped, so the target may not be reached exactly.
+ *
+ * Vertices keep the traits of the vertex they were merged into. Vertex
+ * normals are not updated. Unreferenced vertices are removed. Surviving
+ * faces keep their face UVs, which are not adjusted for the moved vertices.
+ *
+ * ```{.cpp}
+ * DecimateOptions opts;
+ * opts.targetFaces = mesh.numFaces() / 10;
+ * decimate(mesh, opts);
+ * ```
+ *
+ * @throws std::invalid_argument If the mesh contains non-triangular faces
+ */
+template <class MeshType>
+void decimate(MeshType& mesh, const DecimateOptions& opts)
+{
+    static_assert(MeshType::dims == 3, "Decimation requires a 3D mesh");
+    detail::QuadricDecimator dec(mesh, opts.preserveBoundary);
+    std::vector<std::uint32_t> verts(dec.numVertices());
+    std::iota(verts.begin(), verts.end(), 0);
+    dec.run(
+        verts, detail::decimate_budget(dec.liveFaces(), opts.targetFaces),
+        opts.maxError);
+    dec.recount();
+    detail::decimate_write_back(mesh, dec);
+}
+
+/**
+ * @brief Simplify a triangle mesh in parallel, spatially partitioned passes
+ *
+ * Produces results comparable to decimate() on large meshes using all
+ * available threads. Vertices are partitioned into a grid of spatial
+ * clusters, and each cluster is decimated independently and concurrently
+ * with the vertices on its border locked. A second pass repeats this on a
+ * grid offset by half a cluster, which unlocks the first pass's seams.
+ * Because every cluster operates on a small, spatially coherent region,
+ * the working set of each thread stays cache-resident. Finally, a serial
+ * pass over the reduced mesh reaches the exact target.
+ *
+ * Each cluster pass targets the same reduction ratio as the whole mesh.
+ *
+ * @param mesh Triangle mesh
+ * @param opts Decimation options
+ * @param clusters Approximate number of clusters per pass. If 0, a multiple
+ * of num_threads() is used. At most one cluster per vertex is used.
+ * @throws std::invalid_argument If the mesh contains non-triangular faces
+ */
+template <class MeshType>
+void decimate_parallel(
+    MeshType& mesh, const DecimateOptions& opts, std::size_t clusters = 0)
+{
+    static_assert(MeshType::dims == 3, "Decimation requires a 3D mesh");
+    using Index = detail::QuadricDecimator::Index;
+    detail::QuadricDecimator dec(mesh, opts.preserveBoundary);
+    const auto nv = dec.numVertices();
+    const auto nf = dec.numFaces();
+    if (nf == 0) {
+        detail::decimate_write_back(mesh, dec);
+        return;
+    }
+
+    // Grid resolution. There is no use for more clusters than vertices, and
+    // the cell count must fit in the 32-bit cell keys.
+    if (clusters == 0) {
+        clusters = 8 * num_threads();
+    }
+    clusters = std::min(clusters, nv);
+    constexpr std::size_t MAX_RES{1624};
+    auto res = std::min(
+        MAX_RES, static_cast<std::size_t>(std::max(
+                     1.0, std::round(std::cbrt(double(clusters))))));
+    Vec<double, 3> lo;
+    Vec<double, 3> hi;
+    lo.fill(std::numeric_limits<double>::max());
+    hi.fill(std::numeric_limits<double>::lowest());
+    for (std::size_t v{0}; v < nv; v++) {
+        const auto& p = dec.position(static_cast<Index>(v));
+        for (std::size_t d{0}; d < 3; d++) {
+            lo[d] = std::min(lo[d], p[d]);
+            hi[d] = std::max(hi[d], p[d]);
+        }
+    }
+    Vec<double, 3> cellSize;
+    for (std::size_t d{0}; d < 3; d++) {
+        cellSize[d] = std::max((hi[d] - lo[d]) / double(res), 1e-30);
+    }
+
+    std::vector<std::uint32_t> cluster(nv);
+    for (const auto offset : {0.0, 0.5}) {
+        auto live = dec.liveFaces();
+        auto remove = detail::decimate_budget(live, opts.targetFaces);
+        if (remove == 0) {
+            break;
+        }
+        const auto ratio = double(remove) / double(live);
+        const auto cellsPerAxis = res + 1;
+
+        // Assign vertices to cells and group them with a radix sort
+        std::vector<std::uint32_t> keys(nv);
+        std::vector<Index> order(nv);
+        parallel_for(0, nv, [&](auto v) {
+            const auto& p = dec.position(static_cast<Index>(v));
+            std::size_t key{0};
+            for (std::size_t d{3}; d-- > 0;) {
+                auto c = static_cast<std::size_t>(std::clamp(
+                    (p[d] - lo[d]) / cellSize[d] + offset, 0.0,
+                    double(res)));
+                key = key * cellsPerAxis + std::min(c, res);
+            }
+            keys[v] = cluster[v] = static_cast<std::uint32_t>(key);
+            order[v] = static_cast<Index>(v);
+        });
+        radix_sort_pairs(keys, order);
+
+        // Lock vertices of faces which span clusters. Count each cluster's
+        // interior faces.
+        std::vector<char> locked(nv, 0);
+        std::vector<char> interior(nf, 0);
+        for (std::size_t f{0}; f < nf; f++) {
+            if (not dec.faceAlive(static_cast<Index>(f))) {
+                continue;
+            }
+            const auto& face = dec.face(static_cast<Index>(f));
+            auto c = cluster[face[0]];
+            if (cluster[face[1]] == c and cluster[face[2]] == c) {
+                interior[f] = 1;
+            } else {
+                for (auto v : face) {
+                    locked[v] = 1;
+                }
+            }
+        }
+        for (std::size_t v{0}; v < nv; v++) {
+            dec.setLocked(static_cast<Index>(v), locked[v] != 0);
+        }
+
+        // Cluster ranges in the sorted order. Replace each vertex's cell key
+        // with its range, which only spans the occupied cells.
+        std::vector<std::size_t> starts;
+        for (std::size_t i{0}; i < nv; i++) {
+            if (i == 0 or keys[i] != keys[i - 1]) {
+                starts.push_back(i);
+            }
+            cluster[order[i]] = static_cast<std::uint32_t>(starts.size() - 1);
+        }
+        starts.push_back(nv);
+        std::vector<std::size_t> interiorFaces(starts.size() - 1, 0);
+        for (std::size_t f{0}; f < nf; f++) {
+            if (interior[f] != 0) {
+                interiorFaces[cluster[dec.face(static_cast<Index>(f))[0]]]++;
+            }
+        }
+
+        // Decimate clusters concurrently
+        parallel_for(
+            0, starts.size() - 1,
+            [&](auto i) {
+                std::vector<Index> verts(
+                    order.begin() + starts[i], order.begin() + starts[i + 1]);
+                auto budget = static_cast<std::size_t>(
+                    ratio * double(interiorFaces[i]));
+                dec.run(verts, budget, opts.maxError);
+            },
+            1);
+        dec.recount();
+    }
+
+    // Serial pass over everything which is left
+    std::vector<Index> verts(nv);
+    std::iota(verts.begin(), verts.end(), Index{0});
+    for (std::size_t v{0}; v < nv; v++) {
+        dec.setLocked(static_cast<Index>(v), false);
+    }
+    dec.run(
+        verts, detail::decimate_budget(dec.liveFaces(), opts.targetFaces),
+        opts.maxError);
+    dec.recount();
+    detail::decimate_write_back(mesh, dec);
+}
+
+}  // namespace educelab
@@ -0,0 +1,595 @@
+#pragma once
+
+/** @file */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "educelab/core/types/Vec.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+
+namespace educelab
+{
+
+/** @brief A ray with a parametric extent */
+template <typename T>
+struct Ray {
+    /** Origin */
+    Vec<T, 3> origin;
+    /** Direction. Does not need to be normalized. */
+    Vec<T, 3> direction;
+    /** Smallest accepted hit distance */
+    T tMin{0};
+    /** Largest accepted hit distance */
+    T tMax{std::numeric_limits<T>::infinity()};
+};
+
+/** @brief Result of a ray-mesh intersection query */
+template <typename T>
+struct RayHit {
+    /** Face index of rays which didn't hit anything */
+    static constexpr std::size_t NONE{std::numeric_limits<std::size_t>::max()};
+
+    /** Index of the intersected face, or NONE */
+    std::size_t face{NONE};
+    /**
+     * Vertices of the intersected triangle. For faces with more than 3
+     * vertices, this is the triangle of the face's fan triangulation which
+     * was hit.
+     */
+    std::array<std::size_t, 3> vertices{};
+    /**
+     * Hit distance along the ray, in multiples of the ray direction:
+     * `origin + distance * direction` is the hit point
+     */
+    T distance{std::numeric_limits<T>::infinity()};
+    /** Barycentric weight of each of the triangle vertices */
+    Vec<T, 3> barycentric;
+
+    /** @brief Whether the ray hit the mesh */
+    explicit operator bool() const { return face != NONE; }
+};
+
+namespace detail
+{
+/** Maximum depth of a BVH. Deeper splits fall back to median splits. */
+constexpr std::size_t BVH_SAH_DEPTH{64};
+/** Size of the BVH traversal stack */
+constexpr std::size_t BVH_STACK_SIZE{128};
+/** Number of bins used to evaluate the surface area heuristic */
+constexpr std::size_t BVH_BINS{16};
+
+/**
+ * Per-ray constants of the watertight ray-triangle test (Woop, Benthin, and
+ * Wald, "Watertight Ray/Triangle Intersection", JCGT 2013)
+ */
+template <typename T>
+struct WatertightRay {
+    std::size_t kx, ky, kz;
+    T sx, sy, sz;
+
+    explicit WatertightRay(const Vec<T, 3>& dir)
+    {
+        kz = 0;
+        for (std::size_t d{1}; d < 3; d++) {
+            if (std::abs(dir[d]) > std::abs(dir[kz])) {
+                kz = d;
+            }
+        }
+        kx = (kz + 1) % 3;
+        ky = (kx + 1) % 3;
+        // Preserve the winding of the triangle
+        if (dir[kz] < 0) {
+            std::swap(kx, ky);
+        }
+        sx = dir[kx] / dir[kz];
+        sy = dir[ky] / dir[kz];
+        sz = T(1) / dir[kz];
+    }
+};
+
+/**
+ * Watertight ray-triangle intersection. Rays through shared edges and
+ * vertices always hit at least one of the adjacent triangles. On a hit in
+ * (tMin, tMax), returns true and sets the distance and barycentric weights.
+ */
+template <typename T>
+auto intersect_triangle(
+    const std::array<T, 9>& tri,
+    const Vec<T, 3>& origin,
+    const WatertightRay<T>& r,
+    T tMin,
+    T tMax,
+    T& t,
+    Vec<T, 3>& bary) -> bool
+{
+    // Translate and shear the vertices into ray space
+    std::array<T, 3> x;
+    std::array<T, 3> y;
+    std::array<T, 3> z;
+    for (std::size_t i{0}; i < 3; i++) {
+        auto px = tri[3 * i + r.kx] - origin[r.kx];
+        auto py = tri[3 * i + r.ky] - origin[r.ky];
+        z[i] = tri[3 * i + r.kz] - origin[r.kz];
+        x[i] = px - r.sx * z[i];
+        y[i] = py - r.sy * z[i];
+    }
+
+    // Scaled barycentric coordinates
+    auto u = x[2] * y[1] - y[2] * x[1];
+    auto v = x[0] * y[2] - y[0] * x[2];
+    auto w = x[1] * y[0] - y[1] * x[0];
+    // Edge test in double precision when float is inconclusive
+    if constexpr (std::is_same_v<T, float>) {
+        if (u == 0 or v == 0 or w == 0) {
+            u = float(double(x[2]) * y[1] - double(y[2]) * x[1]);
+            v = float(double(x[0]) * y[2] - double(y[0]) * x[2]);
+            w = float(double(x[1]) * y[0] - double(y[1]) * x[0]);
+        }
+    }
+    if ((u < 0 or v < 0 or w < 0) and (u > 0 or v > 0 or w > 0)) {
+        return false;
+    }
+    auto det = u + v + w;
+    if (det == 0) {
+        return false;
+    }
+
+    // Distance
+    auto tScaled = r.sz * (u * z[0] + v * z[1] + w * z[2]);
+    auto dist = tScaled / det;
+    if (not(dist > tMin and dist < tMax)) {
+        return false;
+    }
+    t = dist;
+    bary = Vec<T, 3>{u / det, v / det, w / det};
+    return true;
+}
+}  // namespace detail
+
+/**
+ * @brief Bounding volume hierarchy for ray queries against a mesh
+ *
+ * Faces are fan-triangulated and organized in a binary BVH, built with the
+ * binned surface area heuristic. Triangle positions are copied into the
+ * hierarchy in leaf order, so the tree can be reused for any number of
+ * queries and does not reference the source mesh. Ray-triangle tests use the
+ * watertight algorithm of Woop et al., so rays never slip through shared
+ * edges or vertices. Batched queries are traversed in parallel.
+ *
+ * ```{.cpp}
+ * MeshBVH bvh(mesh);
+ * auto hits = bvh.intersect(rays);
+ * for (const auto& hit : hits) {
+ *     if (hit) {
+ *         std::cout << hit.face << " " << hit.distance << "\n";
+ *     }
+ * }
+ * ```
+ */
+template <class MeshType>
+class MeshBVH
+{
+    static_assert(MeshType::dims == 3, "Mesh must be 3D");
+
+public:
+    /** Position element type */
+    using value_type = typename MeshType::value_type;
+    /** Ray type */
+    using RayType = Ray<value_type>;
+    /** Hit type */
+    using HitType = RayHit<value_type>;
+
+    /**
+     * @brief Build the hierarchy for a mesh
+     *
+     * @param mesh Source mesh
+     * @param leafSize Maximum number of triangles per leaf
+     * @throws std::invalid_argument If `leafSize` is 0
+     * @throws std::out_of_range If a face references an invalid vertex
+     */
+    explicit MeshBVH(const MeshType& mesh, std::size_t leafSize = 4)
+    {
+        if (leafSize == 0) {
+            throw std::invalid_argument("BVH leaf size must be > 0");
+        }
+        build_(mesh, leafSize);
+    }
+
+    /** @brief Number of triangles */
+    [[nodiscard]] auto numTriangles() const -> std::size_t
+    {
+        return tris_.size();
+    }
+
+    /** @brief Number of nodes */
+    [[nodiscard]] auto numNodes() const -> std::size_t
+    {
+        return nodes_.size();
+    }
+
+    /** @brief Find the closest intersection of a ray with the mesh */
+    [[nodiscard]] auto intersect(const RayType& ray) const -> HitType
+    {
+        HitType hit;
+        traverse_(ray, [&](auto tri, auto t, const auto& bary) {
+            hit.face = faces_[tri];
+            hit.vertices = verts_[tri];
+            hit.distance = t;
+            hit.barycentric = bary;
+            return t;
+        });
+        return hit;
+    }
+
+    /** @brief Find the closest intersection of every ray */
+    [[nodiscard]] auto intersect(const std::vector<RayType>& rays) const
+        -> std::vector<HitType>
+    {
+        std::vector<HitType> hits(rays.size());
+        parallel_for(
+            0, rays.size(), [&](auto i) { hits[i] = intersect(rays[i]); },
+            64);
+        return hits;
+    }
+
+    /**
+     * @brief Whether the ray hits any face
+     *
+     * Stops at the first hit, so this is faster than intersect() for
+     * visibility queries.
+     */
+    [[nodiscard]] auto occluded(const RayType& ray) const -> bool
+    {
+        bool hit{false};
+        traverse_(ray, [&](auto, auto, const auto&) {
+            hit = true;
+            return ray.tMin;
+        });
+        return hit;
+    }
+
+private:
+    using T = value_type;
+
+    /** BVH node */
+    struct Node {
+        std::array<T, 3> lo;
+        std::array<T, 3> hi;
+        /** Leaf: first triangle. Interior: left child (right is +1). */
+        std::uint32_t index{0};
+        /** Number of triangles. 0 for interior nodes. */
+        std::uint32_t count{0};
+    };
+
+    /** Nodes. The root is the first node. */
+    std::vector<Node> nodes_;
+    /** Triangle positions in leaf order */
+    std::vector<std::array<T, 9>> tris_;
+    /** Source face of each triangle */
+    std::vector<std::size_t> faces_;
+    /** Source vertices of each triangle */
+    std::vector<std::array<std::size_t, 3>> verts_;
+
+    void build_(const MeshType& mesh, std::size_t leafSize)
+    {
+        const auto& faces = mesh.faces();
+        const auto nv = mesh.numVertices();
+
+        // Fan triangulation
+        std::vector<std::size_t> offsets(faces.size() + 1, 0);
+        for (std::size_t f{0}; f < faces.size(); f++) {
+            auto n = faces[f].size();
+            offsets[f + 1] = offsets[f] + (n >= 3 ? n - 2 : 0);
+        }
+        const auto nt = offsets.back();
+        if (nt > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::overflow_error("Too many triangles for BVH");
+        }
+        std::vector<std::size_t> srcFace(nt);
+        std::vector<std::array<std::size_t, 3>> srcVerts(nt);
+        std::vector<std::array<T, 6>> boxes(nt);
+        std::vector<std::array<T, 3>> centroids(nt);
+        parallel_for(0, faces.size(), [&](auto f) {
+            const auto& face = faces[f];
+            for (const auto& v : face) {
+                if (static_cast<std::size_t>(v) >= nv) {
+                    throw std::out_of_range("Face references invalid vertex");
+                }
+            }
+            for (auto t = offsets[f]; t < offsets[f + 1]; t++) {
+                auto i = t - offsets[f];
+                srcFace[t] = f;
+                srcVerts[t] = {face[0], face[i + 1], face[i + 2]};
+                auto& box = boxes[t];
+                for (std::size_t d{0}; d < 3; d++) {
+                    box[d] = std::numeric_limits<T>::max();
+                    box[3 + d] = std::numeric_limits<T>::lowest();
+                    for (const auto& v : srcVerts[t]) {
+                        box[d] = std::min(box[d], mesh.vertex(v)[d]);
+                        box[3 + d] = std::max(box[3 + d], mesh.vertex(v)[d]);
+                    }
+                    centroids[t][d] = (box[d] + box[3 + d]) / 2;
+                }
+            }
+        });
+
+        // Build the tree over a permutation of the triangles
+        std::vector<std::uint32_t> prims(nt);
+        std::iota(prims.begin(), prims.end(), 0);
+        nodes_.reserve(2 * nt / std::max<std::size_t>(leafSize, 1) + 1);
+        nodes_.emplace_back();
+        struct Task {
+            std::size_t node, begin, end, depth;
+        };
+        std::vector<Task> tasks{{0, 0, nt, 0}};
+        while (not tasks.empty()) {
+            auto [node, begin, end, depth] = tasks.back();
+            tasks.pop_back();
+
+            // Bounds of the triangles and of their centroids
+            std::array<T, 3> lo;
+            std::array<T, 3> hi;
+            std::array<T, 3> cLo;
+            std::array<T, 3> cHi;
+            lo.fill(std::numeric_limits<T>::max());
+            cLo.fill(std::numeric_limits<T>::max());
+            hi.fill(std::numeric_limits<T>::lowest());
+            cHi.fill(std::numeric_limits<T>::lowest());
+            for (auto i = begin; i < end; i++) {
+                const auto& box = boxes[prims[i]];
+                const auto& c = centroids[prims[i]];
+                for (std::size_t d{0}; d < 3; d++) {
+                    lo[d] = std::min(lo[d], box[d]);
+                    hi[d] = std::max(hi[d], box[3 + d]);
+                    cLo[d] = std::min(cLo[d], c[d]);
+                    cHi[d] = std::max(cHi[d], c[d]);
+                }
+            }
+            nodes_[node].lo = lo;
+            nodes_[node].hi = hi;
+
+            // Split along the longest centroid axis
+            std::size_t axis{0};
+            for (std::size_t d{1}; d < 3; d++) {
+                if (cHi[d] - cLo[d] > cHi[axis] - cLo[axis]) {
+                    axis = d;
+                }
+            }
+            auto extent = cHi[axis] - cLo[axis];
+            const auto count = end - begin;
+            if (count <= leafSize or not(extent > 0)) {
+                nodes_[node].index = static_cast<std::uint32_t>(begin);
+                nodes_[node].count = static_cast<std::uint32_t>(count);
+                continue;
+            }
+
+            auto mid = begin;
+            if (depth < detail::BVH_SAH_DEPTH) {
+                mid = sah_split_(
+                    prims, boxes, centroids, begin, end, axis, cLo[axis],
+                    extent);
+            }
+            if (mid == begin or mid == end) {
+                mid = begin + count / 2;
+                std::nth_element(
+                    prims.begin() + begin, prims.begin() + mid,
+                    prims.begin() + end, [&](auto a, auto b) {
+                        return centroids[a][axis] < centroids[b][axis];
+                    });
+            }
+
+            auto left = nodes_.size();
+            nodes_.emplace_back();
+            nodes_.emplace_back();
+            nodes_[node].index = static_cast<std::uint32_t>(left);
+            tasks.push_back({left + 1, mid, end, depth + 1});
+            tasks.push_back({left, begin, mid, depth + 1});
+        }
+
+        // Store the triangles in leaf order
+        tris_.resize(nt);
+        faces_.resize(nt);
+        verts_.resize(nt);
+        parallel_for(0, nt, [&](auto i) {
+            auto t = prims[i];
+            faces_[i] = srcFace[t];
+            verts_[i] = srcVerts[t];
+            for (std::size_t k{0}; k < 3; k++) {
+                const auto& p = mesh.vertex(srcVerts[t][k]);
+                for (std::size_t d{0}; d < 3; d++) {
+                    tris_[i][3 * k + d] = p[d];
+                }
+            }
+        });
+    }
+
+    /** Partition by the lowest-cost binned SAH plane. Returns the split. */
+    static auto sah_split_(
+        std::vector<std::uint32_t>& prims,
+        const std::vector<std::array<T, 6>>& boxes,
+        const std::vector<std::array<T, 3>>& centroids,
+        std::size_t begin,
+        std::size_t end,
+        std::size_t axis,
+        T cLo,
+        T extent) -> std::size_t
+    {
+        constexpr auto B = detail::BVH_BINS;
+        using Box = std::array<T, 6>;
+        auto empty = [] {
+            Box b;
+            for (std::size_t d{0}; d < 3; d++) {
+                b[d] = std::numeric_limits<T>::max();
+                b[3 + d] = std::numeric_limits<T>::lowest();
+            }
+            return b;
+        };
+        auto grow = [](Box& a, const Box& b) {
+            for (std::size_t d{0}; d < 3; d++) {
+                a[d] = std::min(a[d], b[d]);
+                a[3 + d] = std::max(a[3 + d], b[3 + d]);
+            }
+        };
+        auto area = [](const Box& b) {
+            auto dx = double(b[3]) - b[0];
+            auto dy = double(b[4]) - b[1];
+            auto dz = double(b[5]) - b[2];
+            return dx * dy + dy * dz + dz * dx;
+        };
+        auto binOf = [&](auto p) {
+            auto bin = std::size_t((centroids[p][axis] - cLo) / extent * B);
+            return std::min(bin, B - 1);
+        };
+
+        std::array<Box, B> binBoxes;
+        binBoxes.fill(empty());
+        std::array<std::size_t, B> binCounts{};
+        for (auto i = begin; i < end; i++) {
+            auto bin = binOf(prims[i]);
+            grow(binBoxes[bin], boxes[prims[i]]);
+            binCounts[bin]++;
+        }
+
+        // Sweep from the right, then from the left
+        std::array<double, B> rightCost{};
+        auto box = empty();
+        std::size_t n{0};
+        for (auto b = B - 1; b > 0; b--) {
+            grow(box, binBoxes[b]);
+            n += binCounts[b];
+            rightCost[b] = n > 0 ? area(box) * double(n) : 0;
+        }
+        box = empty();
+        n = 0;
+        auto bestCost = std::numeric_limits<double>::max();
+        std::size_t bestBin{0};
+        for (std::size_t b{0}; b + 1 < B; b++) {
+            grow(box, binBoxes[b]);
+            n += binCounts[b];
+            auto cost = (n > 0 ? area(box) * double(n) : 0) + rightCost[b + 1];
+            if (n > 0 and n < end - begin and cost < bestCost) {
+                bestCost = cost;
+                bestBin = b + 1;
+            }
+        }
+        if (bestBin == 0) {
+            return begin;
+        }
+        auto it = std::partition(
+            prims.begin() + begin, prims.begin() + end,
+            [&](auto p) { return binOf(p) < bestBin; });
+        return static_cast<std::size_t>(it - prims.begin());
+    }
+
+    /**
+     * Visit the triangles hit by a ray. `onHit(tri, t, bary)` returns the new
+     * maximum distance. Hits are always beyond `ray.tMin`, so returning
+     * `ray.tMin` stops the traversal, even if `ray.tMin` is negative.
+     */
+    template <typename OnHit>
+    void traverse_(const RayType& ray, OnHit onHit) const
+    {
+        if (nodes_.empty() or tris_.empty()) {
+            return;
+        }
+        const auto& o = ray.origin;
+        const detail::WatertightRay<T> wr(ray.direction);
+        std::array<T, 3> inv;
+        for (std::size_t d{0}; d < 3; d++) {
+            inv[d] = T(1) / ray.direction[d];
+        }
+        // Conservative slab test (Ize, "Robust BVH Ray Traversal", 2013)
+        constexpr auto eps = std::numeric_limits<T>::epsilon();
+        constexpr auto slack = 4 * eps;
+        auto tMax = ray.tMax;
+        auto boxHit = [&](const Node& n, T& tNear) {
+            tNear = ray.tMin;
+            auto tFar = tMax;
+            for (std::size_t d{0}; d < 3; d++) {
+                auto t0 = (n.lo[d] - o[d]) * inv[d];
+                auto t1 = (n.hi[d] - o[d]) * inv[d];
+                if (t0 > t1) {
+                    std::swap(t0, t1);
+                }
+                // Widen the far distance by its magnitude so that boxes
+                // behind the origin are also conservative. Scaling instead of
+                // adding |t1| * slack keeps infinite distances infinite.
+                // Comparisons ignore NaNs from 0 * inf.
+                t1 *= t1 < 0 ? T(1) - slack : T(1) + slack;
+                tNear = t0 > tNear ? t0 : tNear;
+                tFar = t1 < tFar ? t1 : tFar;
+            }
+            return tNear <= tFar;
+        };
+
+        std::array<std::uint32_t, detail::BVH_STACK_SIZE> stack;
+        std::size_t top{0};
+        T tNear;
+        if (not boxHit(nodes_[0], tNear)) {
+            return;
+        }
+        stack[top++] = 0;
+        T t;
+        Vec<T, 3> bary;
+        while (top > 0) {
+            const auto& node = nodes_[stack[--top]];
+            if (node.count > 0) {
+                for (auto i = node.index; i < node.index + node.count; i++) {
+                    if (detail::intersect_triangle(
+                            tris_[i], o, wr, ray.tMin, tMax, t, bary)) {
+                        tMax = onHit(i, t, bary);
+                        if (not(tMax > ray.tMin)) {
+                            return;
+                        }
+                    }
+                }
+                continue;
+            }
+            // Visit the nearer child first
+            T tLeft;
+            T tRight;
+            auto left = node.index;
+            auto hitLeft = boxHit(nodes_[left], tLeft);
+            auto hitRight = boxHit(nodes_[left + 1], tRight);
+            if (hitLeft and hitRight) {
+                if (tLeft <= tRight) {
+                    stack[top++] = left + 1;
+                    stack[top++] = left;
+                } else {
+                    stack[top++] = left;
+                    stack[top++] = left + 1;
+                }
+            } else if (hitLeft) {
+                stack[top++] = left;
+            } else if (hitRight) {
+                stack[top++] = left + 1;
+            }
+        }
+    }
+};
+
+/**
+ * @brief Intersect a batch of rays with a mesh
+ *
+ * Convenience wrapper which builds a MeshBVH and intersects all rays in
+ * parallel. Build a MeshBVH directly to reuse it across batches.
+ */
+template <class MeshType>
+auto intersect(
+    const MeshType& mesh,
+    const std::vector<Ray<typename MeshType::value_type>>& rays)
+    -> std::vector<RayHit<typename MeshType::value_type>>
+{
+    return MeshBVH<MeshType>(mesh).intersect(rays);
+}
+
+}  // namespace educelab
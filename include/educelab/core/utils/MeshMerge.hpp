@@ -0,0 +1,251 @@
+#pragma once
+
+/** @file */
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+
+namespace educelab
+{
+
+namespace detail
+{
+/** Copy a vertex between mesh types, converting positions and normals */
+template <class DstVertex, class SrcVertex>
+void convert_vertex(DstVertex& dst, const SrcVertex& src)
+{
+    if constexpr (std::is_same_v<DstVertex, SrcVertex>) {
+        dst = src;
+    } else {
+        using T = typename DstVertex::value_type;
+        for (std::size_t d{0}; d < dst.size(); d++) {
+            dst[d] = static_cast<T>(src[d]);
+        }
+        if constexpr (
+            traits::has_normal_v<DstVertex> and
+            traits::has_normal_v<SrcVertex>) {
+            if (src.normal) {
+                auto& n = dst.normal.emplace();
+                for (std::size_t d{0}; d < n.size(); d++) {
+                    n[d] = static_cast<T>((*src.normal)[d]);
+                }
+            } else {
+                dst.normal.reset();
+            }
+        }
+        if constexpr (
+            traits::has_color_v<DstVertex> and traits::has_color_v<SrcVertex>) {
+            dst.color = src.color;
+        }
+    }
+}
+
+/**
+ * Clear all vertex normals unless every vertex has one, so that meshes
+ * assembled from inputs with and without normals have consistent attributes
+ */
+template <class MeshType>
+void unify_normals(MeshType& mesh)
+{
+    if constexpr (traits::has_normal_v<typename MeshType::Vertex>) {
+        auto& verts = mesh.vertices();
+        std::atomic<std::size_t> count{0};
+        parallel_for_blocks(0, verts.size(), [&](auto b, auto e) {
+            std::size_t local{0};
+            for (auto i = b; i < e; i++) {
+                local += verts[i].normal.has_value() ? 1 : 0;
+            }
+            count += local;
+        });
+        if (count > 0 and count < verts.size()) {
+            parallel_for(0, verts.size(), [&](auto i) {
+                verts[i].normal.reset();
+            });
+        }
+    }
+}
+
+/**
+ * Append meshes to `dst`. Sizes are reserved once, then vertices, texture
+ * coordinates, and faces are copied in parallel blocks which may span
+ * several inputs.
+ */
+template <class MeshType, class SrcMesh>
+void append_meshes(MeshType& dst, const std::vector<const SrcMesh*>& srcs)
+{
+    static_assert(MeshType::dims == SrcMesh::dims, "Mesh dims must match");
+    using Index = typename MeshType::Face::value_type;
+    const auto k = srcs.size();
+
+    // Validate first, so dst is unchanged on error
+    bool hasFaceUVs{not dst.faceUVs().empty()};
+    for (const auto* src : srcs) {
+        const auto nv = src->numVertices();
+        const auto nt = src->numUVs();
+        const auto& faces = src->faces();
+        const auto& faceUVs = src->faceUVs();
+        parallel_for(0, faces.size(), [&](auto f) {
+            for (const auto& v : faces[f]) {
+                if (static_cast<std::size_t>(v) >= nv) {
+                    throw std::out_of_range("Face references invalid vertex");
+                }
+            }
+            if (f < faceUVs.size()) {
+                for (const auto& t : faceUVs[f]) {
+                    if (static_cast<std::size_t>(t) >= nt) {
+                        throw std::out_of_range("Face references invalid UV");
+                    }
+                }
+            }
+        });
+        hasFaceUVs |= not faceUVs.empty();
+    }
+
+    // Output offsets of each input
+    std::vector<std::size_t> vOffsets(k + 1);
+    std::vector<std::size_t> fOffsets(k + 1);
+    std::vector<std::size_t> tOffsets(k + 1);
+    vOffsets[0] = dst.numVertices();
+    fOffsets[0] = dst.numFaces();
+    tOffsets[0] = dst.numUVs();
+    for (std::size_t m{0}; m < k; m++) {
+        vOffsets[m + 1] = vOffsets[m] + srcs[m]->numVertices();
+        fOffsets[m + 1] = fOffsets[m] + srcs[m]->numFaces();
+        tOffsets[m + 1] = tOffsets[m] + srcs[m]->numUVs();
+    }
+    MeshType::checkCapacity(vOffsets[k]);
+    MeshType::checkCapacity(tOffsets[k]);
+    auto& verts = dst.vertices();
+    auto& faces = dst.faces();
+    auto& uvs = dst.uvs();
+    auto& faceUVs = dst.faceUVs();
+    verts.resize(vOffsets[k]);
+    faces.resize(fOffsets[k]);
+    uvs.resize(tOffsets[k]);
+    if (hasFaceUVs) {
+        faceUVs.resize(fOffsets[k]);
+    }
+
+    // Input containing output element i
+    auto source = [&](const auto& offsets, std::size_t i) {
+        auto it = std::upper_bound(offsets.begin(), offsets.end(), i);
+        return static_cast<std::size_t>(it - offsets.begin()) - 1;
+    };
+
+    parallel_for_blocks(vOffsets[0], vOffsets[k], [&](auto b, auto e) {
+        auto m = source(vOffsets, b);
+        for (auto i = b; i < e; i++) {
+            while (i >= vOffsets[m + 1]) {
+                m++;
+            }
+            convert_vertex(verts[i], srcs[m]->vertices()[i - vOffsets[m]]);
+        }
+    });
+
+    parallel_for_blocks(tOffsets[0], tOffsets[k], [&](auto b, auto e) {
+        using T = typename MeshType::value_type;
+        auto m = source(tOffsets, b);
+        for (auto i = b; i < e; i++) {
+            while (i >= tOffsets[m + 1]) {
+                m++;
+            }
+            const auto& uv = srcs[m]->uvs()[i - tOffsets[m]];
+            uvs[i] = typename MeshType::UV{
+                static_cast<T>(uv[0]), static_cast<T>(uv[1])};
+        }
+    });
+
+    parallel_for_blocks(
+        fOffsets[0], fOffsets[k],
+        [&](auto b, auto e) {
+            auto m = source(fOffsets, b);
+            for (auto i = b; i < e; i++) {
+                while (i >= fOffsets[m + 1]) {
+                    m++;
+                }
+                const auto& src = srcs[m]->faces()[i - fOffsets[m]];
+                const auto offset = vOffsets[m];
+                auto& face = faces[i];
+                face.resize(src.size());
+                for (std::size_t j{0}; j < src.size(); j++) {
+                    face[j] = static_cast<Index>(src[j] + offset);
+                }
+
+                const auto& srcUV = srcs[m]->faceUV(i - fOffsets[m]);
+                if (not srcUV.empty()) {
+                    auto& faceUV = faceUVs[i];
+                    faceUV.resize(srcUV.size());
+                    for (std::size_t j{0}; j < srcUV.size(); j++) {
+                        faceUV[j] = static_cast<Index>(srcUV[j] + tOffsets[m]);
+                    }
+                }
+            }
+        },
+        256);
+
+    unify_normals(dst);
+}
+}  // namespace detail
+
+/**
+ * @brief Append a mesh to another mesh
+ *
+ * The vertices and faces of `src` are added to the end of `dst`, and the
+ * indices of the appended faces are offset to reference the appended
+ * vertices. Texture coordinates and face UVs are appended and offset the
+ * same way. `src` may have a different numeric or index type than `dst`, in
+ * which case positions, normals, texture coordinates, and indices are
+ * converted. The destination is resized once and the copy runs in parallel.
+ * If only some vertices of the result have normals, all normals are cleared.
+ *
+ * ```{.cpp}
+ * Mesh3f model;
+ * for (const auto& path : fragments) {
+ *     append(model, read_mesh<Mesh3f>(path));
+ * }
+ * ```
+ *
+ * @throws std::out_of_range If a face of `src` references an invalid vertex
+ * or texture coordinate. `dst` is not modified.
+ * @throws std::overflow_error If the result has more vertices or texture
+ * coordinates than can be indexed by the index type of `dst`. `dst` is not
+ * modified.
+ */
+template <class MeshType, class SrcMesh>
+void append(MeshType& dst, const SrcMesh& src)
+{
+    detail::append_meshes(dst, std::vector<const SrcMesh*>{&src});
+}
+
+/**
+ * @brief Merge a list of meshes into a single mesh
+ *
+ * Equivalent to appending every mesh to an empty mesh in order, but the
+ * output is allocated once and all inputs are copied in a single parallel
+ * pass, which balances the work regardless of the size of each input.
+ *
+ * @throws std::out_of_range If a face references an invalid vertex or
+ * texture coordinate
+ * @throws std::overflow_error If the result has more vertices or texture
+ * coordinates than can be indexed by the mesh's index type
+ */
+template <class MeshType>
+auto merge(const std::vector<MeshType>& meshes) -> MeshType
+{
+    std::vector<const MeshType*> srcs;
+    srcs.reserve(meshes.size());
+    for (const auto& m : meshes) {
+        srcs.push_back(&m);
+    }
+    MeshType result;
+    detail::append_meshes(result, srcs);
+    return result;
+}
+
+}  // namespace educelab
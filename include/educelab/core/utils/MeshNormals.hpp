@@ -0,0 +1,201 @@
+#pragma once
+
+/** @file */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/types/Vec.hpp"
+#include "educelab/core/utils/MeshAdjacency.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+
+namespace educelab
+{
+
+/** @brief Face weighting schemes for vertex normal computation */
+enum class NormalWeighting {
+    /** All incident faces contribute equally */
+    Uniform,
+    /** Incident faces are weighted by their area */
+    Area,
+    /** Incident faces are weighted by their interior angle at the vertex */
+    Angle
+};
+
+namespace detail
+{
+/**
+ * Unnormalized polygon normal (Newell's method). Magnitude is 2x the area.
+ * The face indices must already be validated.
+ */
+template <class MeshType>
+auto face_normal_area(const MeshType& mesh, const typename MeshType::Face& f)
+{
+    using T = typename MeshType::value_type;
+    Vec<T, 3> n;
+    const auto& verts = mesh.vertices();
+    for (std::size_t i{0}; i < f.size(); i++) {
+        const auto& a = verts[f[i]];
+        const auto& b = verts[f[(i + 1) % f.size()]];
+        n[0] += (a[1] - b[1]) * (a[2] + b[2]);
+        n[1] += (a[2] - b[2]) * (a[0] + b[0]);
+        n[2] += (a[0] - b[0]) * (a[1] + b[1]);
+    }
+    return n;
+}
+
+/** Interior angle of face `f` at corner `c` */
+template <class MeshType>
+auto corner_angle(
+    const MeshType& mesh, const typename MeshType::Face& f, std::size_t c)
+{
+    using T = typename MeshType::value_type;
+    const auto& verts = mesh.vertices();
+    const auto& v = verts[f[c]];
+    auto e0 = verts[f[(c + f.size() - 1) % f.size()]] - v;
+    auto e1 = verts[f[(c + 1) % f.size()]] - v;
+    auto denom = std::sqrt(e0.magnitude2() * e1.magnitude2());
+    if (denom <= T(0)) {
+        return T(0);
+    }
+    auto cos = std::clamp(e0.dot(e1) / denom, T(-1), T(1));
+    return std::acos(cos);
+}
+
+/** compute_vertex_normals() implementation for a CSR index type */
+template <typename Index, class MeshType>
+void compute_vertex_normals_impl(
+    MeshType& mesh,
+    NormalWeighting weighting,
+    const std::vector<std::size_t>& corners)
+{
+    using T = typename MeshType::value_type;
+    const auto& faces = mesh.faces();
+    auto& verts = mesh.vertices();
+
+    // Face normals (area-scaled)
+    std::vector<Vec<T, 3>> fNormals(faces.size());
+    parallel_for(0, faces.size(), [&](auto f) {
+        fNormals[f] = face_normal_area(mesh, faces[f]);
+    });
+
+    // Gather incident face normals at each vertex
+    auto csr = build_vertex_face_csr<Index>(mesh, corners);
+    parallel_for(0, verts.size(), [&](auto v) {
+        Vec<T, 3> sum;
+        for (auto i = csr.offsets[v]; i < csr.offsets[v + 1]; i++) {
+            auto f = csr.faces[i];
+            const auto& n = fNormals[f];
+            if (weighting == NormalWeighting::Area) {
+                sum += n;
+                continue;
+            }
+            auto mag = n.magnitude();
+            if (mag <= T(0)) {
+                continue;
+            }
+            if (weighting == NormalWeighting::Uniform) {
+                sum += n / mag;
+                continue;
+            }
+            // Angle: Weight by the angle at this vertex's corner
+            const auto& face = faces[f];
+            for (std::size_t c{0}; c < face.size(); c++) {
+                if (face[c] == v) {
+                    sum += n * (corner_angle(mesh, face, c) / mag);
+                    break;
+                }
+            }
+        }
+
+        auto mag = sum.magnitude();
+        if (mag > T(0) and std::isfinite(mag)) {
+            verts[v].normal = sum / mag;
+        } else {
+            verts[v].normal.reset();
+        }
+    });
+}
+}  // namespace detail
+
+/**
+ * @brief Compute the normal of every face in a mesh
+ *
+ * Polygon normals are computed with Newell's method, so non-planar and
+ * non-triangular faces are supported. Degenerate faces have a zero normal.
+ *
+ * @throws std::out_of_range If a face references an invalid vertex
+ */
+template <class MeshType>
+auto compute_face_normals(const MeshType& mesh)
+    -> std::vector<Vec<typename MeshType::value_type, 3>>
+{
+    static_assert(MeshType::dims == 3, "Normals require a 3D mesh");
+    using T = typename MeshType::value_type;
+    const auto& faces = mesh.faces();
+    const auto nv = mesh.numVertices();
+    for (const auto& face : faces) {
+        for (const auto& v : face) {
+            if (static_cast<std::size_t>(v) >= nv) {
+                throw std::out_of_range("Face references invalid vertex");
+            }
+        }
+    }
+
+    std::vector<Vec<T, 3>> normals(faces.size());
+    parallel_for(0, faces.size(), [&](auto f) {
+        auto n = detail::face_normal_area(mesh, faces[f]);
+        auto mag = n.magnitude();
+        normals[f] = mag > T(0) ? n / mag : n;
+    });
+    return normals;
+}
+
+/**
+ * @brief Compute the normal trait of every vertex in a mesh
+ *
+ * Each vertex normal is the normalized, weighted sum of the normals of its
+ * incident faces. Face normals are computed in parallel, then each vertex
+ * gathers from its incident faces through a vertex-to-face adjacency list
+ * built with a parallel radix sort. Because every vertex is written by
+ * exactly one task, no atomics or locks are required.
+ *
+ * Vertices which are not referenced by any face, or whose weighted sum is
+ * zero, have their normal reset.
+ *
+ * ```{.cpp}
+ * auto mesh = read_mesh<Mesh3f>("scan.obj");
+ * compute_vertex_normals(mesh, NormalWeighting::Angle);
+ * ```
+ *
+ * @throws std::out_of_range If a face references an invalid vertex. The
+ * mesh is unchanged.
+ */
+template <class MeshType>
+void compute_vertex_normals(
+    MeshType& mesh, NormalWeighting weighting = NormalWeighting::Area)
+{
+    static_assert(MeshType::dims == 3, "Normals require a 3D mesh");
+    static_assert(
+        traits::has_normal_v<typename MeshType::Vertex>,
+        "Mesh vertex type does not have a normal trait");
+
+    // Validate the faces, then use compact indices whenever the corner count
+    // allows
+    auto corners = detail::face_corner_offsets(mesh);
+    if (corners.back() < std::numeric_limits<std::uint32_t>::max() and
+        mesh.numVertices() < std::numeric_limits<std::uint32_t>::max()) {
+        detail::compute_vertex_normals_impl<std::uint32_t>(
+            mesh, weighting, corners);
+    } else {
+        detail::compute_vertex_normals_impl<std::uint64_t>(
+            mesh, weighting, corners);
+    }
+}
+
+}  // namespace educelab
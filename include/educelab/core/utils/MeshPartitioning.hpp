@@ -0,0 +1,180 @@
+#pragma once
+
+/** @file */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/utils/MeshReordering.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+#include "educelab/core/utils/Sorting.hpp"
+
+namespace educelab
+{
+
+/** @brief A spatially coherent piece of a mesh produced by partition_mesh() */
+template <class MeshType>
+struct MeshChunk {
+    /** Chunk mesh. Faces reference the chunk's local vertices. */
+    MeshType mesh;
+    /** Index in the source mesh of each local vertex */
+    std::vector<std::size_t> vertices;
+    /** Index in the source mesh of each local face */
+    std::vector<std::size_t> faces;
+    /**
+     * Local indices of the vertices which are also used by other chunks, in
+     * ascending order
+     */
+    std::vector<std::size_t> boundary;
+};
+
+/**
+ * @brief Partition a mesh into spatially coherent chunks of faces
+ *
+ * Face centroids are sorted along a space-filling curve, and consecutive runs
+ * of `targetFaces` faces become chunks. Every chunk except the last has
+ * exactly `targetFaces` faces. Each chunk holds a copy of the vertices it
+ * uses (in source order) and faces re-indexed to those local vertices, so
+ * chunks can be processed in parallel or written out independently without
+ * sharing any mesh data. Chunks also copy the UVs used by their faces.
+ * Vertices used by more than one chunk are listed in MeshChunk::boundary,
+ * and MeshChunk::vertices maps local vertices back to the source mesh for
+ * merging results.
+ *
+ * ```{.cpp}
+ * auto chunks = partition_mesh(mesh, 1 << 16);
+ * parallel_for(0, chunks.size(), [&](auto c) {
+ *     compute_vertex_normals(chunks[c].mesh);
+ * }, 1);
+ * ```
+ *
+ * @throws std::invalid_argument If `targetFaces` is 0 or a face centroid is
+ * not finite
+ * @throws std::out_of_range If a face references an invalid vertex or UV
+ */
+template <class MeshType>
+auto partition_mesh(
+    const MeshType& mesh,
+    std::size_t targetFaces,
+    SpaceFillingCurve curve = SpaceFillingCurve::Hilbert)
+    -> std::vector<MeshChunk<MeshType>>
+{
+    constexpr auto Dims = MeshType::dims;
+    using Index = typename MeshType::Face::value_type;
+    if (targetFaces == 0) {
+        throw std::invalid_argument("Target faces per chunk must be > 0");
+    }
+    const auto& verts = mesh.vertices();
+    const auto& faces = mesh.faces();
+    const auto& faceUVs = mesh.faceUVs();
+    const auto nv = verts.size();
+    const auto nf = faces.size();
+
+    // Face centroids
+    std::vector<std::array<double, Dims>> centroids(nf);
+    parallel_for(0, nf, [&](auto f) {
+        auto& c = centroids[f];
+        c.fill(0);
+        for (const auto& v : faces[f]) {
+            if (static_cast<std::size_t>(v) >= nv) {
+                throw std::out_of_range("Face references invalid vertex");
+            }
+            for (std::size_t d{0}; d < Dims; d++) {
+                c[d] += static_cast<double>(verts[v][d]);
+            }
+        }
+        if (not faces[f].empty()) {
+            for (auto& val : c) {
+                val /= double(faces[f].size());
+            }
+        }
+    });
+
+    // Sort faces along the curve
+    auto keys = detail::space_filling_keys<Dims>(
+        nf, [&](auto f) { return centroids[f]; }, curve);
+    std::vector<std::size_t> order(nf);
+    std::iota(order.begin(), order.end(), 0);
+    radix_sort_pairs(keys, order);
+
+    // Build the chunks
+    const auto numChunks = (nf + targetFaces - 1) / targetFaces;
+    std::vector<MeshChunk<MeshType>> chunks(numChunks);
+    std::vector<std::atomic<std::uint32_t>> uses(nv);
+    parallel_for(0, nv, [&](auto v) {
+        uses[v].store(0, std::memory_order_relaxed);
+    });
+    parallel_for(
+        0, numChunks,
+        [&](auto c) {
+            auto& chunk = chunks[c];
+            auto begin = c * targetFaces;
+            auto end = std::min(nf, begin + targetFaces);
+            chunk.faces.assign(order.begin() + begin, order.begin() + end);
+
+            // Local vertices in source order
+            for (const auto& f : chunk.faces) {
+                chunk.vertices.insert(
+                    chunk.vertices.end(), faces[f].begin(), faces[f].end());
+            }
+            std::sort(chunk.vertices.begin(), chunk.vertices.end());
+            chunk.vertices.erase(
+                std::unique(chunk.vertices.begin(), chunk.vertices.end()),
+                chunk.vertices.end());
+            auto& localVerts = chunk.mesh.vertices();
+            localVerts.reserve(chunk.vertices.size());
+            for (const auto& v : chunk.vertices) {
+                localVerts.push_back(verts[v]);
+                uses[v].fetch_add(1, std::memory_order_relaxed);
+            }
+
+            // Re-index faces
+            auto& localFaces = chunk.mesh.faces();
+            localFaces.reserve(chunk.faces.size());
+            for (const auto& f : chunk.faces) {
+                auto& face = localFaces.emplace_back(faces[f]);
+                for (auto& v : face) {
+                    auto it = std::lower_bound(
+                        chunk.vertices.begin(), chunk.vertices.end(),
+                        static_cast<std::size_t>(v));
+                    v = static_cast<Index>(it - chunk.vertices.begin());
+                }
+            }
+
+            // Copy the UVs used by the chunk
+            if (not faceUVs.empty()) {
+                auto& localUVs = chunk.mesh.faceUVs();
+                localUVs.resize(chunk.faces.size());
+                for (std::size_t i{0}; i < chunk.faces.size(); i++) {
+                    if (chunk.faces[i] < faceUVs.size()) {
+                        localUVs[i] = faceUVs[chunk.faces[i]];
+                    }
+                }
+                detail::copy_used_uvs(chunk.mesh, mesh);
+            }
+        },
+        1);
+
+    // Boundary vertices
+    parallel_for(
+        0, numChunks,
+        [&](auto c) {
+            auto& chunk = chunks[c];
+            for (std::size_t i{0}; i < chunk.vertices.size(); i++) {
+                if (uses[chunk.vertices[i]].load(std::memory_order_relaxed) >
+                    1) {
+                    chunk.boundary.push_back(i);
+                }
+            }
+        },
+        1);
+    return chunks;
+}
+
+}  // namespace educelab
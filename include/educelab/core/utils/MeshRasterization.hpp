@@ -0,0 +1,666 @@
+#pragma once
+
+/** @file */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "educelab/core/types/Image.hpp"
+#include "educelab/core/types/Mat.hpp"
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+
+namespace educelab
+{
+
+/** @brief Images produced by rasterize() */
+struct RasterImages {
+    /** Face ID of pixels which are not covered by the mesh */
+    static constexpr std::uint32_t NONE{
+        std::numeric_limits<std::uint32_t>::max()};
+
+    /**
+     * Window-space depth in [0, 1] (1 channel, F32). Pixels which are not
+     * covered by the mesh are set to infinity.
+     */
+    Image depth;
+    /**
+     * Unit surface normal of the visible face (3 channels, F32). Vertex
+     * normals are interpolated if every vertex has one; otherwise, the
+     * geometric normal of each triangle is used. Pixels which are not
+     * covered by the mesh are set to 0.
+     */
+    Image normals;
+    /** Index of the visible face (1 channel, U32), or NONE */
+    Image faceIDs;
+};
+
+/** @brief Options for rasterize() */
+struct RasterOptions {
+    /**
+     * Width and height of the pixel tiles which are rasterized in parallel.
+     * Must be a multiple of 8.
+     */
+    std::size_t tileSize{64};
+    /** Discard triangles which are clockwise in normalized device space */
+    bool cullBackFaces{false};
+};
+
+namespace detail
+{
+/** Sub-pixel precision of rasterized vertex positions */
+constexpr std::int64_t RASTER_SUBPIXELS{256};
+/** Width and height of the blocks used for coverage and depth rejection */
+constexpr std::int64_t RASTER_BLOCK{8};
+/** Largest supported image dimension */
+constexpr std::size_t RASTER_MAX_SIZE{1 << 14};
+
+/** Homogeneous clip-space position */
+using ClipVertex = std::array<double, 4>;
+
+/**
+ * Screen-space triangle setup. Coverage uses fixed-point edge functions with
+ * a top-left fill rule, so triangles which share an edge never both cover,
+ * or both miss, a pixel on that edge.
+ */
+struct RasterTriangle {
+    /** Edge functions at pixel (x, y): `a * x + b * y + c >= 0` if covered */
+    std::array<std::int64_t, 3> a{}, b{}, c{};
+    /** Depth at pixel (x, y): `za * x + zb * y + zc` */
+    float za{0}, zb{0}, zc{0};
+    /** Minimum depth of the triangle */
+    float zMin{0};
+    /** Inclusive pixel bounds. Empty if x0 > x1. */
+    std::int32_t x0{1}, x1{0}, y0{1}, y1{0};
+    /** Source face */
+    std::uint32_t face{0};
+    /** Source triangle (0, corner, corner + 1) of the face's fan */
+    std::uint32_t corner{0};
+};
+
+/**
+ * Signed distance of a clip-space point to the near (0), far (1), and
+ * guard-band (2-5) planes. Inside if >= 0.
+ */
+inline auto raster_plane(const ClipVertex& v, std::size_t p, double guard)
+    -> double
+{
+    switch (p) {
+        case 0:
+            return v[3] + v[2];
+        case 1:
+            return v[3] - v[2];
+        case 2:
+            return guard * v[3] - v[0];
+        case 3:
+            return guard * v[3] + v[0];
+        case 4:
+            return guard * v[3] - v[1];
+        default:
+            return guard * v[3] + v[1];
+    }
+}
+
+/**
+ * Clip a clip-space triangle and call `func(a, b, c)` for each triangle of
+ * the clipped polygon. Triangles outside the view frustum are discarded.
+ * The guard band keeps the fixed-point screen coordinates of the result in
+ * range, so only triangles which cross the near or far plane, or which are
+ * very large, are clipped.
+ */
+template <class Func>
+void raster_clip_triangle(
+    const std::array<ClipVertex, 3>& tri, double guard, Func func)
+{
+    bool inside{true};
+    for (std::size_t p{0}; p < 6; p++) {
+        std::size_t numOutside{0};
+        std::size_t numOutsideGuard{0};
+        for (const auto& v : tri) {
+            numOutside += raster_plane(v, p, 1) < 0 ? 1 : 0;
+            numOutsideGuard += raster_plane(v, p, guard) < 0 ? 1 : 0;
+        }
+        if (numOutside == 3) {
+            return;
+        }
+        inside = inside and numOutsideGuard == 0;
+    }
+    if (inside) {
+        func(tri[0], tri[1], tri[2]);
+        return;
+    }
+
+    // Sutherland-Hodgman. Each plane adds at most one vertex.
+    std::array<ClipVertex, 9> poly{tri[0], tri[1], tri[2]};
+    std::array<ClipVertex, 9> out{};
+    std::size_t n{3};
+    for (std::size_t p{0}; p < 6 and n >= 3; p++) {
+        std::size_t m{0};
+        for (std::size_t i{0}; i < n; i++) {
+            const auto& cur = poly[i];
+            const auto& next = poly[(i + 1) % n];
+            auto dc = raster_plane(cur, p, guard);
+            auto dn = raster_plane(next, p, guard);
+            if (dc >= 0) {
+                out[m++] = cur;
+            }
+            if ((dc >= 0) != (dn >= 0)) {
+                auto t = dc / (dc - dn);
+                for (std::size_t d{0}; d < 4; d++) {
+                    out[m][d] = cur[d] + t * (next[d] - cur[d]);
+                }
+                m++;
+            }
+        }
+        poly = out;
+        n = m;
+    }
+    for (std::size_t i{1}; i + 1 < n; i++) {
+        func(poly[0], poly[i], poly[i + 1]);
+    }
+}
+
+/**
+ * Set up a clipped triangle for rasterization. Leaves `t` empty if the
+ * triangle covers no pixel centers or is culled.
+ */
+inline void raster_setup(
+    RasterTriangle& t,
+    const std::array<const ClipVertex*, 3>& v,
+    std::size_t width,
+    std::size_t height,
+    bool cullBackFaces)
+{
+    constexpr auto sub = RASTER_SUBPIXELS;
+    std::array<std::int64_t, 3> xs{};
+    std::array<std::int64_t, 3> ys{};
+    std::array<double, 3> px{};
+    std::array<double, 3> py{};
+    std::array<double, 3> zs{};
+    for (std::size_t i{0}; i < 3; i++) {
+        const auto& p = *v[i];
+        if (not(p[3] > 0)) {
+            return;
+        }
+        px[i] = (p[0] / p[3] + 1) * 0.5 * static_cast<double>(width);
+        py[i] = (1 - p[1] / p[3]) * 0.5 * static_cast<double>(height);
+        xs[i] = std::llround(px[i] * sub);
+        ys[i] = std::llround(py[i] * sub);
+        zs[i] = std::clamp((p[2] / p[3] + 1) * 0.5, 0., 1.);
+    }
+
+    // Counter-clockwise in NDC is clockwise in y-down pixel space
+    auto area = (xs[1] - xs[0]) * (ys[2] - ys[0]) -
+                (ys[1] - ys[0]) * (xs[2] - xs[0]);
+    if (area == 0 or (cullBackFaces and area > 0)) {
+        return;
+    }
+    if (area < 0) {
+        std::swap(xs[1], xs[2]);
+        std::swap(ys[1], ys[2]);
+        std::swap(px[1], px[2]);
+        std::swap(py[1], py[2]);
+        std::swap(zs[1], zs[2]);
+        area = -area;
+    }
+
+    // Edge functions, evaluated at pixel centers
+    for (std::size_t i{0}; i < 3; i++) {
+        auto j = (i + 1) % 3;
+        auto a = ys[i] - ys[j];
+        auto b = xs[j] - xs[i];
+        auto c = -(a * xs[i] + b * ys[i]);
+        auto topLeft = a > 0 or (a == 0 and b > 0);
+        t.a[i] = a * sub;
+        t.b[i] = b * sub;
+        t.c[i] = c + (a + b) * (sub / 2) - (topLeft ? 0 : 1);
+    }
+
+    // Depth plane through the unsnapped vertices, evaluated at pixel centers
+    auto det = (px[1] - px[0]) * (py[2] - py[0]) -
+               (py[1] - py[0]) * (px[2] - px[0]);
+    if (det == 0) {
+        return;
+    }
+    auto dz1 = zs[1] - zs[0];
+    auto dz2 = zs[2] - zs[0];
+    auto za = (dz1 * (py[2] - py[0]) - dz2 * (py[1] - py[0])) / det;
+    auto zb = (dz2 * (px[1] - px[0]) - dz1 * (px[2] - px[0])) / det;
+    auto zc = zs[0] - za * px[0] - zb * py[0] + 0.5 * (za + zb);
+    t.za = static_cast<float>(za);
+    t.zb = static_cast<float>(zb);
+    t.zc = static_cast<float>(zc);
+    t.zMin = static_cast<float>(*std::min_element(zs.begin(), zs.end()));
+
+    // Pixels whose centers are inside the bounding box
+    auto bound = [](std::int64_t lo, std::int64_t hi, std::size_t size) {
+        auto first = std::ceil((static_cast<double>(lo) - sub / 2) / sub);
+        auto last = std::floor((static_cast<double>(hi) - sub / 2) / sub);
+        return std::array<std::int32_t, 2>{
+            static_cast<std::int32_t>(std::max(first, 0.)),
+            static_cast<std::int32_t>(
+                std::min(last, static_cast<double>(size) - 1))};
+    };
+    auto [x0, x1] = bound(
+        *std::min_element(xs.begin(), xs.end()),
+        *std::max_element(xs.begin(), xs.end()), width);
+    auto [y0, y1] = bound(
+        *std::min_element(ys.begin(), ys.end()),
+        *std::max_element(ys.begin(), ys.end()), height);
+    if (x0 <= x1 and y0 <= y1) {
+        t.x0 = x0;
+        t.x1 = x1;
+        t.y0 = y0;
+        t.y1 = y1;
+    }
+}
+
+/**
+ * Rasterize a triangle into the pixels [x0, x1] x [y0, y1] of one block.
+ * The block is skipped if it is outside an edge or if the triangle is
+ * behind every pixel in the block (`blockMaxZ`). Otherwise, the pixels are
+ * evaluated one row of up to 8 lanes at a time, which compilers vectorize.
+ */
+inline void raster_block(
+    const RasterTriangle& t,
+    std::uint32_t id,
+    std::array<std::int64_t, 4> rect,
+    float& blockMaxZ,
+    float* depth,
+    std::uint32_t* ids,
+    std::size_t width)
+{
+    const auto [x0, x1, y0, y1] = rect;
+
+    // Coverage of the block corners
+    bool full{true};
+    for (std::size_t e{0}; e < 3; e++) {
+        auto e00 = t.a[e] * x0 + t.b[e] * y0 + t.c[e];
+        auto dx = t.a[e] * (x1 - x0);
+        auto dy = t.b[e] * (y1 - y0);
+        auto lo = e00 + std::min<std::int64_t>(dx, 0) +
+                  std::min<std::int64_t>(dy, 0);
+        auto hi = e00 + std::max<std::int64_t>(dx, 0) +
+                  std::max<std::int64_t>(dy, 0);
+        if (hi < 0) {
+            return;
+        }
+        full = full and lo >= 0;
+    }
+
+    // Hierarchical depth rejection
+    auto z00 = t.za * float(x0) + t.zb * float(y0) + t.zc;
+    auto zLo = z00 + std::min(t.za * float(x1 - x0), 0.F) +
+               std::min(t.zb * float(y1 - y0), 0.F);
+    if (std::max(zLo, t.zMin) >= blockMaxZ) {
+        return;
+    }
+
+    const auto n = static_cast<std::size_t>(x1 - x0 + 1);
+    bool written{false};
+    for (auto y = y0; y <= y1; y++) {
+        auto* dRow = depth + static_cast<std::size_t>(y) * width + x0;
+        auto* iRow = ids + static_cast<std::size_t>(y) * width + x0;
+        const auto e0 = t.a[0] * x0 + t.b[0] * y + t.c[0];
+        const auto e1 = t.a[1] * x0 + t.b[1] * y + t.c[1];
+        const auto e2 = t.a[2] * x0 + t.b[2] * y + t.c[2];
+        const auto z0 = t.za * float(x0) + t.zb * float(y) + t.zc;
+        for (std::size_t i{0}; i < n; i++) {
+            const auto k = static_cast<std::int64_t>(i);
+            const bool covered =
+                full | ((e0 + k * t.a[0] >= 0) & (e1 + k * t.a[1] >= 0) &
+                        (e2 + k * t.a[2] >= 0));
+            const auto z = z0 + float(i) * t.za;
+            if (covered & (z < dRow[i])) {
+                dRow[i] = z;
+                iRow[i] = id;
+                written = true;
+            }
+        }
+    }
+    if (written) {
+        blockMaxZ = 0;
+        for (auto y = y0; y <= y1; y++) {
+            const auto* dRow = depth + static_cast<std::size_t>(y) * width;
+            for (auto x = x0; x <= x1; x++) {
+                blockMaxZ = std::max(blockMaxZ, dRow[x]);
+            }
+        }
+    }
+}
+
+/**
+ * Perspective-correct barycentric coordinates of an NDC position in a
+ * triangle, from the clip-space (x, y, w) of its vertices
+ */
+inline auto raster_barycentric(
+    const std::array<const std::array<float, 4>*, 3>& v, double nx, double ny)
+    -> std::array<double, 3>
+{
+    auto col = [&](std::size_t i) {
+        const auto& p = *v[i];
+        return std::array<double, 3>{p[0], p[1], p[3]};
+    };
+    auto cross = [](const auto& a, const auto& b) {
+        return std::array<double, 3>{
+            a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2],
+            a[0] * b[1] - a[1] * b[0]};
+    };
+    const std::array<double, 3> q{nx, ny, 1};
+    auto dot = [&q](const auto& a) {
+        return q[0] * a[0] + q[1] * a[1] + q[2] * a[2];
+    };
+    const auto c0 = col(0);
+    const auto c1 = col(1);
+    const auto c2 = col(2);
+    std::array<double, 3> l{
+        dot(cross(c1, c2)), dot(cross(c2, c0)), dot(cross(c0, c1))};
+    auto sum = l[0] + l[1] + l[2];
+    if (sum == 0) {
+        return {1. / 3, 1. / 3, 1. / 3};
+    }
+    for (auto& x : l) {
+        x /= sum;
+    }
+    return l;
+}
+}  // namespace detail
+
+/**
+ * @brief Render the depth, normals, and face IDs of a mesh
+ *
+ * Rasterizes the mesh on the CPU. `camera` maps homogeneous world
+ * coordinates to OpenGL-style clip space (e.g. a projection matrix times a
+ * view matrix). Normalized device coordinates map to pixels so that
+ * (-1, 1) is the top-left corner of the image, and NDC depth in [-1, 1] maps
+ * to window depth in [0, 1]. Faces with more than 3 vertices are
+ * fan-triangulated. Triangles are clipped against the near and far planes.
+ * Pixels are covered when their center is inside a triangle.
+ *
+ * Rendering runs in parallel stages. First, vertices are transformed and
+ * triangles are clipped and set up. Triangles are then binned into square
+ * tiles, and the tiles are rasterized concurrently. Each tile is traversed
+ * in 8x8 blocks. A block is rejected if it is outside a triangle edge, or if
+ * the triangle is behind every pixel in the block, which is tested against
+ * the block's maximum depth. Surviving blocks are evaluated row by row with
+ * integer edge functions. Normals and face IDs are resolved once per pixel
+ * after the depth test. Within a tile, triangles are processed in face
+ * order and ties in depth keep the earlier face, so the result does not
+ * depend on the number of threads.
+ *
+ * ```{.cpp}
+ * auto images = rasterize(mesh, projection * view, 2160, 3840);
+ * auto depth = apply_colormap(images.depth, Colormap::Viridis, 0, 1);
+ * write_image("depth.ppm", depth);
+ * ```
+ *
+ * @throws std::invalid_argument If a dimension is 0 or larger than 16384,
+ * or if the tile size is not a positive multiple of 8
+ * @throws std::out_of_range If a face references an invalid vertex
+ * @throws std::overflow_error If the mesh has too many faces or triangles
+ * for 32-bit face IDs
+ */
+template <class MeshType, typename T>
+auto rasterize(
+    const MeshType& mesh,
+    const Mat<4, 4, T>& camera,
+    std::size_t height,
+    std::size_t width,
+    const RasterOptions& opts = {}) -> RasterImages
+{
+    static_assert(MeshType::dims == 3, "Only 3D meshes can be rasterized");
+    using detail::RASTER_BLOCK;
+    if (height == 0 or width == 0 or height > detail::RASTER_MAX_SIZE or
+        width > detail::RASTER_MAX_SIZE) {
+        throw std::invalid_argument("Invalid raster image size");
+    }
+    if (opts.tileSize == 0 or opts.tileSize % RASTER_BLOCK != 0) {
+        throw std::invalid_argument("Tile size must be a multiple of 8");
+    }
+    const auto& faces = mesh.faces();
+    const auto nf = faces.size();
+    const auto nv = mesh.numVertices();
+    if (nf >= RasterImages::NONE) {
+        throw std::overflow_error("Too many faces for 32-bit face IDs");
+    }
+
+    // Transform to clip space
+    std::vector<std::array<float, 4>> clip(nv);
+    parallel_for(0, nv, [&](auto v) {
+        const auto& p = mesh.vertex(v);
+        for (std::size_t r{0}; r < 4; r++) {
+            auto sum = static_cast<double>(camera(r, 3));
+            for (std::size_t d{0}; d < 3; d++) {
+                sum += static_cast<double>(camera(r, d)) * p[d];
+            }
+            clip[v][r] = static_cast<float>(sum);
+        }
+    });
+
+    // Clip the fan triangles of a face
+    const auto guard =
+        double(1 << 16) / static_cast<double>(std::max(width, height)) - 1;
+    auto clipFace = [&](std::size_t f, auto func) {
+        const auto& face = faces[f];
+        for (std::size_t k{1}; k + 1 < face.size(); k++) {
+            const std::array<std::size_t, 3> idx{face[0], face[k], face[k + 1]};
+            std::array<detail::ClipVertex, 3> tri{};
+            for (std::size_t i{0}; i < 3; i++) {
+                if (idx[i] >= nv) {
+                    throw std::out_of_range("Face references invalid vertex");
+                }
+                const auto& c = clip[idx[i]];
+                tri[i] = {c[0], c[1], c[2], c[3]};
+            }
+            detail::raster_clip_triangle(
+                tri, guard, [&](const auto& a, const auto& b, const auto& c) {
+                    func(k, a, b, c);
+                });
+        }
+    };
+
+    // Count, then set up the triangles in face order
+    std::vector<std::size_t> offsets(nf + 1, 0);
+    parallel_for(0, nf, [&](auto f) {
+        std::size_t n{0};
+        clipFace(f, [&n](auto, const auto&, const auto&, const auto&) {
+            n++;
+        });
+        offsets[f + 1] = n;
+    });
+    for (std::size_t f{0}; f < nf; f++) {
+        offsets[f + 1] += offsets[f];
+    }
+    const auto nt = offsets.back();
+    if (nt >= RasterImages::NONE) {
+        throw std::overflow_error("Too many triangles to rasterize");
+    }
+    std::vector<detail::RasterTriangle> tris(nt);
+    parallel_for(0, nf, [&](auto f) {
+        auto t = offsets[f];
+        clipFace(f, [&](auto k, const auto& a, const auto& b, const auto& c) {
+            auto& tri = tris[t++];
+            tri.face = static_cast<std::uint32_t>(f);
+            tri.corner = static_cast<std::uint32_t>(k);
+            detail::raster_setup(
+                tri, {&a, &b, &c}, width, height, opts.cullBackFaces);
+        });
+    });
+
+    // Bin the triangles into tiles. Each chunk of triangles is binned in
+    // parallel, and the chunks are concatenated in order per tile.
+    const auto ts = opts.tileSize;
+    const auto tilesX = (width + ts - 1) / ts;
+    const auto tilesY = (height + ts - 1) / ts;
+    const auto numTiles = tilesX * tilesY;
+    const auto numChunks =
+        std::max<std::size_t>(1, std::min(nt, num_threads() * 4));
+    auto forEachTile = [&](const detail::RasterTriangle& tri, auto func) {
+        if (tri.x0 > tri.x1 or tri.y0 > tri.y1) {
+            return;
+        }
+        const auto tx1 = static_cast<std::size_t>(tri.x1) / ts;
+        const auto ty1 = static_cast<std::size_t>(tri.y1) / ts;
+        for (auto ty = static_cast<std::size_t>(tri.y0) / ts; ty <= ty1; ty++) {
+            for (auto tx = static_cast<std::size_t>(tri.x0) / ts; tx <= tx1;
+                 tx++) {
+                func(ty * tilesX + tx);
+            }
+        }
+    };
+    auto forEachInChunk = [&](std::size_t chunk, auto func) {
+        const auto b = nt * chunk / numChunks;
+        const auto e = nt * (chunk + 1) / numChunks;
+        for (auto t = b; t < e; t++) {
+            forEachTile(tris[t], [&](auto tile) { func(t, tile); });
+        }
+    };
+    std::vector<std::size_t> cursors(numTiles * numChunks, 0);
+    parallel_for(
+        0, numChunks,
+        [&](auto chunk) {
+            forEachInChunk(chunk, [&](auto, auto tile) {
+                cursors[tile * numChunks + chunk]++;
+            });
+        },
+        1);
+    std::vector<std::size_t> binOffsets(numTiles + 1, 0);
+    std::size_t total{0};
+    for (std::size_t i{0}; i < cursors.size(); i++) {
+        if (i % numChunks == 0) {
+            binOffsets[i / numChunks] = total;
+        }
+        auto n = cursors[i];
+        cursors[i] = total;
+        total += n;
+    }
+    binOffsets[numTiles] = total;
+    std::vector<std::uint32_t> bins(total);
+    parallel_for(
+        0, numChunks,
+        [&](auto chunk) {
+            forEachInChunk(chunk, [&](auto t, auto tile) {
+                bins[cursors[tile * numChunks + chunk]++] =
+                    static_cast<std::uint32_t>(t);
+            });
+        },
+        1);
+
+    // Rasterize the tiles
+    RasterImages result;
+    result.depth = Image(height, width, 1, Depth::F32);
+    auto* depth = reinterpret_cast<float*>(result.depth.data());
+    std::vector<std::uint32_t> ids(height * width);
+    constexpr auto inf = std::numeric_limits<float>::infinity();
+    parallel_for(
+        0, numTiles,
+        [&](auto tile) {
+            const auto tx0 = static_cast<std::int64_t>((tile % tilesX) * ts);
+            const auto ty0 = static_cast<std::int64_t>((tile / tilesX) * ts);
+            const auto tx1 = std::min<std::int64_t>(tx0 + ts, width) - 1;
+            const auto ty1 = std::min<std::int64_t>(ty0 + ts, height) - 1;
+            for (auto y = ty0; y <= ty1; y++) {
+                const auto row = static_cast<std::size_t>(y) * width;
+                std::fill_n(depth + row + tx0, tx1 - tx0 + 1, inf);
+                std::fill_n(
+                    ids.begin() + row + tx0, tx1 - tx0 + 1, RasterImages::NONE);
+            }
+            const auto blocksX = (tx1 - tx0) / RASTER_BLOCK + 1;
+            const auto blocksY = (ty1 - ty0) / RASTER_BLOCK + 1;
+            std::vector<float> blockMaxZ(blocksX * blocksY, inf);
+
+            for (auto i = binOffsets[tile]; i < binOffsets[tile + 1]; i++) {
+                const auto& tri = tris[bins[i]];
+                const auto bx0 =
+                    (std::max<std::int64_t>(tri.x0, tx0) - tx0) / RASTER_BLOCK;
+                const auto bx1 =
+                    (std::min<std::int64_t>(tri.x1, tx1) - tx0) / RASTER_BLOCK;
+                const auto by0 =
+                    (std::max<std::int64_t>(tri.y0, ty0) - ty0) / RASTER_BLOCK;
+                const auto by1 =
+                    (std::min<std::int64_t>(tri.y1, ty1) - ty0) / RASTER_BLOCK;
+                for (auto by = by0; by <= by1; by++) {
+                    for (auto bx = bx0; bx <= bx1; bx++) {
+                        const auto x0 = tx0 + bx * RASTER_BLOCK;
+                        const auto y0 = ty0 + by * RASTER_BLOCK;
+                        detail::raster_block(
+                            tri, bins[i],
+                            {x0, std::min(x0 + RASTER_BLOCK - 1, tx1), y0,
+                             std::min(y0 + RASTER_BLOCK - 1, ty1)},
+                            blockMaxZ[by * blocksX + bx], depth, ids.data(),
+                            width);
+                    }
+                }
+            }
+        },
+        1);
+
+    // Resolve face IDs and normals
+    bool vertexNormals{false};
+    if constexpr (traits::has_normal_v<typename MeshType::Vertex>) {
+        const auto& verts = mesh.vertices();
+        auto hasNormal = [](auto& v) { return v.normal.has_value(); };
+        vertexNormals =
+            nv > 0 and std::all_of(verts.begin(), verts.end(), hasNormal);
+    }
+    result.normals = Image(height, width, 3, Depth::F32);
+    result.faceIDs = Image(height, width, 1, Depth::U32);
+    auto* normals = reinterpret_cast<float*>(result.normals.data());
+    auto* faceIDs = reinterpret_cast<std::uint32_t*>(result.faceIDs.data());
+    parallel_for(0, height, [&](auto y) {
+        for (std::size_t x{0}; x < width; x++) {
+            const auto p = y * width + x;
+            const auto id = ids[p];
+            if (id == RasterImages::NONE) {
+                faceIDs[p] = RasterImages::NONE;
+                continue;
+            }
+            const auto& tri = tris[id];
+            faceIDs[p] = tri.face;
+            const auto& face = faces[tri.face];
+            const std::array<std::size_t, 3> idx{
+                face[0], face[tri.corner], face[tri.corner + 1]};
+            std::array<double, 3> n{};
+            if (vertexNormals) {
+                if constexpr (traits::has_normal_v<typename MeshType::Vertex>) {
+                    auto nx = (double(x) + 0.5) / double(width) * 2 - 1;
+                    auto ny = 1 - (double(y) + 0.5) / double(height) * 2;
+                    auto l = detail::raster_barycentric(
+                        {&clip[idx[0]], &clip[idx[1]], &clip[idx[2]]}, nx, ny);
+                    for (std::size_t i{0}; i < 3; i++) {
+                        const auto& vn = *mesh.vertex(idx[i]).normal;
+                        for (std::size_t d{0}; d < 3; d++) {
+                            n[d] += l[i] * vn[d];
+                        }
+                    }
+                }
+            } else {
+                const auto& a = mesh.vertex(idx[0]);
+                const auto& b = mesh.vertex(idx[1]);
+                const auto& c = mesh.vertex(idx[2]);
+                std::array<double, 3> u{};
+                std::array<double, 3> v{};
+                for (std::size_t d{0}; d < 3; d++) {
+                    u[d] = double(b[d]) - double(a[d]);
+                    v[d] = double(c[d]) - double(a[d]);
+                }
+                n = {u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2],
+                     u[0] * v[1] - u[1] * v[0]};
+            }
+            auto len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            for (std::size_t d{0}; d < 3; d++) {
+                normals[3 * p + d] =
+                    len > 0 ? static_cast<float>(n[d] / len) : 0.F;
+            }
+        }
+    });
+
+    return result;
+}
+
+}  // namespace educelab
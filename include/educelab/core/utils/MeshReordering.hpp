@@ -0,0 +1,261 @@
+#pragma once
+
+/** @file */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+#include "educelab/core/utils/Sorting.hpp"
+
+namespace educelab
+{
+
+/** @brief Space-filling curves for spatial ordering */
+enum class SpaceFillingCurve {
+    /** Z-order curve. Cheapest to compute. */
+    Morton,
+    /** Hilbert curve. Better locality: consecutive cells always touch. */
+    Hilbert
+};
+
+/**
+ * @brief Interleave the bits of integer grid coordinates
+ *
+ * Bit `b` of coordinate `d` becomes bit `b * Dims + (Dims - 1 - d)` of the
+ * result. Only the low `64 / Dims` bits of each coordinate are used.
+ */
+template <std::size_t Dims>
+auto morton_encode(const std::array<std::uint32_t, Dims>& coords)
+    -> std::uint64_t
+{
+    static_assert(Dims > 0 and Dims <= 64, "Unsupported dimensions");
+    constexpr std::size_t bits{std::min<std::size_t>(32, 64 / Dims)};
+    std::uint64_t code{0};
+    for (std::size_t b{bits}; b-- > 0;) {
+        for (std::size_t d{0}; d < Dims; d++) {
+            code = (code << 1) | ((coords[d] >> b) & 1U);
+        }
+    }
+    return code;
+}
+
+/**
+ * @brief Compute the Hilbert curve index of integer grid coordinates
+ *
+ * Uses Skilling's transform ("Programming the Hilbert curve", 2004) to
+ * convert the coordinates to the curve's transposed form, which is then
+ * interleaved like morton_encode(). Only the low `64 / Dims` bits of each
+ * coordinate are used.
+ */
+template <std::size_t Dims>
+auto hilbert_encode(std::array<std::uint32_t, Dims> x) -> std::uint64_t
+{
+    static_assert(Dims > 0 and Dims <= 64, "Unsupported dimensions");
+    constexpr std::size_t bits{std::min<std::size_t>(32, 64 / Dims)};
+    if constexpr (bits < 32) {
+        for (auto& v : x) {
+            v &= (std::uint32_t{1} << bits) - 1;
+        }
+    }
+
+    // Inverse undo
+    for (std::uint32_t q = std::uint32_t{1} << (bits - 1); q > 1; q >>= 1) {
+        auto p = q - 1;
+        for (std::size_t i{0}; i < Dims; i++) {
+            if ((x[i] & q) != 0) {
+                x[0] ^= p;
+            } else {
+                auto t = (x[0] ^ x[i]) & p;
+                x[0] ^= t;
+                x[i] ^= t;
+            }
+        }
+    }
+
+    // Gray encode
+    for (std::size_t i{1}; i < Dims; i++) {
+        x[i] ^= x[i - 1];
+    }
+    std::uint32_t t{0};
+    for (std::uint32_t q = std::uint32_t{1} << (bits - 1); q > 1; q >>= 1) {
+        if ((x[Dims - 1] & q) != 0) {
+            t ^= q - 1;
+        }
+    }
+    for (auto& v : x) {
+        v ^= t;
+    }
+    return morton_encode<Dims>(x);
+}
+
+namespace detail
+{
+/**
+ * Compute the space-filling curve index of `n` points. `point(i)` returns the
+ * i-th point as a `std::array<double, Dims>`. Points are quantized to a grid
+ * over their bounds.
+ *
+ * @throws std::invalid_argument If a point is not finite
+ */
+template <std::size_t Dims, typename PointFn>
+auto space_filling_keys(std::size_t n, PointFn point, SpaceFillingCurve curve)
+    -> std::vector<std::uint64_t>
+{
+    using Coords = std::array<std::uint32_t, Dims>;
+    constexpr std::size_t bits{std::min<std::size_t>(32, 64 / Dims)};
+
+    // Bounds
+    auto blocks = std::min(num_threads(), std::max<std::size_t>(n, 1));
+    std::vector<std::array<double, 2 * Dims>> blockBounds(blocks);
+    parallel_for(
+        0, blocks,
+        [&](auto b) {
+            auto& bb = blockBounds[b];
+            for (std::size_t d{0}; d < Dims; d++) {
+                bb[d] = std::numeric_limits<double>::max();
+                bb[Dims + d] = std::numeric_limits<double>::lowest();
+            }
+            auto [begin, end] = block_range(n, blocks, b);
+            for (auto i = begin; i < end; i++) {
+                auto p = point(i);
+                for (std::size_t d{0}; d < Dims; d++) {
+                    if (not std::isfinite(p[d])) {
+                        throw std::invalid_argument("Points must be finite");
+                    }
+                    bb[d] = std::min(bb[d], p[d]);
+                    bb[Dims + d] = std::max(bb[Dims + d], p[d]);
+                }
+            }
+        },
+        1);
+    std::array<double, Dims> lo;
+    std::array<double, Dims> scale;
+    for (std::size_t d{0}; d < Dims; d++) {
+        lo[d] = std::numeric_limits<double>::max();
+        auto hi = std::numeric_limits<double>::lowest();
+        for (const auto& bb : blockBounds) {
+            lo[d] = std::min(lo[d], bb[d]);
+            hi = std::max(hi, bb[Dims + d]);
+        }
+        // Uniform scale keeps the curve's cells cubic
+        scale[d] = hi - lo[d];
+    }
+    const auto extent = *std::max_element(scale.begin(), scale.end());
+    const auto maxCoord = double((std::uint64_t{1} << bits) - 1);
+    const auto factor = extent > 0 ? maxCoord / extent : 0.0;
+
+    std::vector<std::uint64_t> keys(n);
+    parallel_for(0, n, [&](auto i) {
+        auto p = point(i);
+        Coords c;
+        for (std::size_t d{0}; d < Dims; d++) {
+            // Bounds wider than the double range give inf * 0 = NaN, which
+            // must not reach the integer conversion
+            auto q = (p[d] - lo[d]) * factor;
+            c[d] = q > 0 ? static_cast<std::uint32_t>(std::min(q, maxCoord))
+                         : 0;
+        }
+        keys[i] = curve == SpaceFillingCurve::Hilbert ? hilbert_encode(c)
+                                                      : morton_encode(c);
+    });
+    return keys;
+}
+}  // namespace detail
+
+/**
+ * @brief Reorder mesh vertices and faces along a space-filling curve
+ *
+ * Vertex positions are quantized to a grid over the mesh bounds, encoded
+ * along the selected curve, and sorted with a parallel radix sort. Faces
+ * are then sorted by their smallest new vertex index. Vertices which are
+ * close in space end up close in memory, which improves cache locality for
+ * all subsequent traversals of the mesh. Face vertex order (winding) is
+ * preserved, and face UVs are reordered with their faces.
+ *
+ * ```{.cpp}
+ * reorder_spatially(mesh);
+ * compute_vertex_normals(mesh);
+ * ```
+ *
+ * @returns The new index of every original vertex
+ * @throws std::out_of_range If a face references an invalid vertex. The
+ * mesh is unchanged.
+ * @throws std::invalid_argument If a vertex position is not finite. The
+ * mesh is unchanged.
+ */
+template <class MeshType>
+auto reorder_spatially(
+    MeshType& mesh, SpaceFillingCurve curve = SpaceFillingCurve::Hilbert)
+    -> std::vector<std::size_t>
+{
+    constexpr auto Dims = MeshType::dims;
+    using Index = typename MeshType::Face::value_type;
+
+    // Validate faces before modifying the mesh
+    auto& verts = mesh.vertices();
+    const auto nv = verts.size();
+    auto& faces = mesh.faces();
+    parallel_for(0, faces.size(), [&](auto f) {
+        for (const auto& v : faces[f]) {
+            if (static_cast<std::size_t>(v) >= nv) {
+                throw std::out_of_range("Face references invalid vertex");
+            }
+        }
+    });
+
+    // Sort vertices by curve index
+    auto keys = detail::space_filling_keys<Dims>(
+        nv,
+        [&](auto v) {
+            std::array<double, Dims> p;
+            for (std::size_t d{0}; d < Dims; d++) {
+                p[d] = static_cast<double>(verts[v][d]);
+            }
+            return p;
+        },
+        curve);
+    std::vector<std::size_t> order(nv);
+    std::iota(order.begin(), order.end(), 0);
+    radix_sort_pairs(keys, order);
+
+    // Permute vertices
+    std::vector<std::size_t> remap(nv);
+    std::vector<typename MeshType::Vertex> sorted(nv);
+    parallel_for(0, nv, [&](auto i) {
+        remap[order[i]] = i;
+        sorted[i] = std::move(verts[order[i]]);
+    });
+    verts = std::move(sorted);
+
+    // Remap faces, then sort them by their smallest vertex
+    const auto nf = faces.size();
+    std::vector<std::uint64_t> faceKeys(nf);
+    std::vector<std::size_t> faceOrder(nf);
+    parallel_for(0, nf, [&](auto f) {
+        auto minIdx = std::numeric_limits<std::uint64_t>::max();
+        for (auto& v : faces[f]) {
+            v = static_cast<Index>(remap[v]);
+            minIdx = std::min<std::uint64_t>(minIdx, v);
+        }
+        faceKeys[f] = minIdx;
+        faceOrder[f] = f;
+    });
+    radix_sort_pairs(faceKeys, faceOrder);
+    std::vector<typename MeshType::Face> sortedFaces(nf);
+    parallel_for(0, nf, [&](auto i) {
+        sortedFaces[i] = std::move(faces[faceOrder[i]]);
+    });
+    faces = std::move(sortedFaces);
+    detail::permute_face_uvs(mesh, faceOrder);
+    return remap;
+}
+
+}  // namespace educelab
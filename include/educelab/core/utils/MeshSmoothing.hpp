@@ -0,0 +1,271 @@
+#pragma once
+
+/** @file */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "educelab/core/utils/MeshAdjacency.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+
+namespace educelab
+{
+
+/** @brief Neighbor weighting schemes for mesh smoothing */
+enum class SmoothingWeights {
+    /** All one-ring neighbors contribute equally (umbrella operator) */
+    Uniform,
+    /**
+     * Neighbors are weighted by the cotangents of the angles opposite their
+     * shared edge. Approximates the Laplace-Beltrami operator, which reduces
+     * tangential drift on irregular meshes. Requires a triangle mesh.
+     */
+    Cotangent
+};
+
+/** @brief Options for smooth_laplacian() and smooth_taubin() */
+struct SmoothOptions {
+    /** Number of iterations */
+    std::size_t iterations{10};
+    /** Smoothing step size (0, 1] */
+    double lambda{0.5};
+    /**
+     * Taubin inflation step size. Must be negative with |mu| > lambda.
+     * Ignored by smooth_laplacian().
+     */
+    double mu{-0.53};
+    /** Neighbor weighting */
+    SmoothingWeights weights{SmoothingWeights::Uniform};
+    /** Keep boundary vertices in place */
+    bool fixBoundary{false};
+};
+
+namespace detail
+{
+/**
+ * Sparse matrix in compressed sparse row (CSR) layout. Row `r` has the
+ * entries `values[offsets[r]]` to `values[offsets[r + 1]]` in the columns
+ * `cols[offsets[r]]` to `cols[offsets[r + 1]]`.
+ */
+template <typename T, typename Index = std::uint32_t>
+struct SparseMatrix {
+    /** Row offsets */
+    std::vector<Index> offsets;
+    /** Column of each entry */
+    std::vector<Index> cols;
+    /** Value of each entry */
+    std::vector<T> values;
+
+    /** Number of rows */
+    [[nodiscard]] auto rows() const -> std::size_t
+    {
+        return offsets.empty() ? 0 : offsets.size() - 1;
+    }
+
+    /** Compute y = A * x in parallel */
+    void multiply(const T* x, T* y) const
+    {
+        parallel_for(0, rows(), [&](auto r) {
+            T sum{0};
+            for (auto i = offsets[r]; i < offsets[r + 1]; i++) {
+                sum += values[i] * x[cols[i]];
+            }
+            y[r] = sum;
+        });
+    }
+};
+
+/**
+ * Row-normalized one-ring weight matrix for a mesh. The columns of each row
+ * are the vertex's neighbors. Rows of isolated vertices are empty.
+ */
+template <typename T, class MeshType, typename Index>
+auto smoothing_weights(
+    const MeshType& mesh,
+    const MeshAdjacency<Index>& adj,
+    SmoothingWeights weighting) -> SparseMatrix<T, Index>
+{
+    const auto nv = adj.numVertices();
+    SparseMatrix<T, Index> m;
+    m.offsets.resize(nv + 1);
+    m.offsets[0] = 0;
+    for (std::size_t v{0}; v < nv; v++) {
+        m.offsets[v + 1] = static_cast<Index>(
+            m.offsets[v] + adj.vertexNeighbors(v).size());
+    }
+    m.cols.resize(m.offsets.back());
+    m.values.resize(m.offsets.back());
+
+    // Cotangent weight of each edge: (cot(alpha) + cot(beta)) / 2
+    std::vector<T> edgeW;
+    if (weighting == SmoothingWeights::Cotangent) {
+        edgeW.resize(adj.numEdges());
+        parallel_for(0, adj.numEdges(), [&](auto e) {
+            const auto& [a, b] = adj.edge(e);
+            double w{0};
+            for (auto f : adj.edgeFaces(e)) {
+                const auto& face = mesh.face(f);
+                if (face.size() != 3) {
+                    throw std::invalid_argument(
+                        "Cotangent weights require a triangle mesh");
+                }
+                auto o = face[0] + face[1] + face[2] - a - b;
+                const auto& po = mesh.vertex(o);
+                auto ea = mesh.vertex(a) - po;
+                auto eb = mesh.vertex(b) - po;
+                auto d = static_cast<double>(ea.dot(eb));
+                auto la = static_cast<double>(ea.magnitude2());
+                auto lb = static_cast<double>(eb.magnitude2());
+                auto sin = std::sqrt(std::max(la * lb - d * d, 0.0));
+                if (sin > 0) {
+                    w += d / sin / 2;
+                }
+            }
+            // Obtuse triangles produce negative weights, which are unstable
+            edgeW[e] = static_cast<T>(std::max(w, 0.0));
+        });
+    }
+
+    parallel_for(0, nv, [&](auto v) {
+        auto nbrs = adj.vertexNeighbors(v);
+        auto edges = adj.vertexEdges(v);
+        auto begin = m.offsets[v];
+        T sum{0};
+        for (std::size_t i{0}; i < nbrs.size(); i++) {
+            auto w = edgeW.empty() ? T(1) : edgeW[edges[i]];
+            m.cols[begin + i] = nbrs[i];
+            m.values[begin + i] = w;
+            sum += w;
+        }
+        // Fall back to uniform weights if every weight is degenerate
+        for (std::size_t i{0}; i < nbrs.size(); i++) {
+            auto& w = m.values[begin + i];
+            w = sum > 0 ? w / sum : T(1) / T(nbrs.size());
+        }
+    });
+    return m;
+}
+
+/** Shared implementation of smooth_laplacian() and smooth_taubin() */
+template <class MeshType>
+void smooth_impl(MeshType& mesh, const SmoothOptions& opts, bool taubin)
+{
+    using T = typename MeshType::value_type;
+    static_assert(
+        std::is_floating_point_v<T>, "Smoothing requires floating-point");
+    constexpr auto Dims = MeshType::dims;
+    if (mesh.empty() or opts.iterations == 0) {
+        return;
+    }
+
+    MeshAdjacency<std::uint32_t> adj(mesh);
+    auto weights = smoothing_weights<T>(mesh, adj, opts.weights);
+    const auto nv = mesh.numVertices();
+
+    // 0 for vertices which don't move, 1 otherwise
+    std::vector<T> mask(nv);
+    parallel_for(0, nv, [&](auto v) {
+        auto isolated = weights.offsets[v] == weights.offsets[v + 1];
+        auto fixed = opts.fixBoundary and adj.isBoundaryVertex(v);
+        mask[v] = isolated or fixed ? T(0) : T(1);
+    });
+
+    // SoA position buffers, double-buffered
+    std::array<std::vector<T>, Dims> cur;
+    std::array<std::vector<T>, Dims> next;
+    for (std::size_t d{0}; d < Dims; d++) {
+        cur[d].resize(nv);
+        next[d].resize(nv);
+    }
+    auto& verts = mesh.vertices();
+    parallel_for(0, nv, [&](auto v) {
+        for (std::size_t d{0}; d < Dims; d++) {
+            cur[d][v] = verts[v][d];
+        }
+    });
+
+    // p' = p + step * (W * p - p). The update is a branch-free loop over
+    // contiguous arrays, which the compiler can vectorize.
+    auto step = [&](T factor) {
+        for (std::size_t d{0}; d < Dims; d++) {
+            const auto* src = cur[d].data();
+            auto* dst = next[d].data();
+            weights.multiply(src, dst);
+            parallel_for_blocks(0, nv, [&](auto b, auto e) {
+                const auto* m = mask.data();
+                for (auto v = b; v < e; v++) {
+                    dst[v] = src[v] + factor * m[v] * (dst[v] - src[v]);
+                }
+            });
+        }
+        std::swap(cur, next);
+    };
+
+    for (std::size_t it{0}; it < opts.iterations; it++) {
+        step(static_cast<T>(opts.lambda));
+        if (taubin) {
+            step(static_cast<T>(opts.mu));
+        }
+    }
+
+    parallel_for(0, nv, [&](auto v) {
+        for (std::size_t d{0}; d < Dims; d++) {
+            verts[v][d] = cur[d][v];
+        }
+    });
+}
+}  // namespace detail
+
+/**
+ * @brief Smooth a mesh with iterative Laplacian smoothing
+ *
+ * Each iteration moves every vertex toward the weighted average of its
+ * one-ring neighbors by a factor of `opts.lambda`. Laplacian smoothing
+ * shrinks the mesh. See smooth_taubin() for a volume-preserving variant.
+ *
+ * The neighbor weights are precomputed once into a CSR matrix, and vertex
+ * positions are copied to per-axis (structure-of-arrays) buffers, which are
+ * double-buffered between iterations and updated in parallel.
+ *
+ * @throws std::invalid_argument If cotangent weights are requested for a
+ * non-triangle mesh
+ */
+template <class MeshType>
+void smooth_laplacian(MeshType& mesh, const SmoothOptions& opts = {})
+{
+    detail::smooth_impl(mesh, opts, false);
+}
+
+/**
+ * @brief Smooth a mesh with Taubin's \f$\lambda|\mu\f$ algorithm
+ *
+ * Each iteration applies a Laplacian smoothing step with `opts.lambda`
+ * followed by an inflation step with `opts.mu`, which removes high
+ * frequency noise without the shrinkage of plain Laplacian smoothing.
+ *
+ * ```{.cpp}
+ * SmoothOptions opts;
+ * opts.iterations = 20;
+ * opts.weights = SmoothingWeights::Cotangent;
+ * smooth_taubin(mesh, opts);
+ * ```
+ *
+ * @throws std::invalid_argument If `opts.mu` is not negative or cotangent
+ * weights are requested for a non-triangle mesh
+ */
+template <class MeshType>
+void smooth_taubin(MeshType& mesh, const SmoothOptions& opts = {})
+{
+    if (not(opts.mu < 0)) {
+        throw std::invalid_argument("Taubin mu must be negative");
+    }
+    detail::smooth_impl(mesh, opts, true);
+}
+
+}  // namespace educelab
@@ -0,0 +1,313 @@
+#pragma once
+
+/** @file */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "educelab/core/utils/Parallel.hpp"
+
+namespace educelab
+{
+
+/**
+ * @brief Compensated (Neumaier) floating-point accumulator
+ *
+ * Tracks the low-order bits lost by each addition in a separate compensation
+ * term, so the error of a sum of `n` values does not grow with `n`. Partial
+ * sums computed in parallel can be combined with merge().
+ */
+template <typename T = double>
+class CompensatedSum
+{
+public:
+    /** @brief Add a value */
+    void add(T v)
+    {
+        auto t = sum_ + v;
+        if (std::abs(sum_) >= std::abs(v)) {
+            comp_ += (sum_ - t) + v;
+        } else {
+            comp_ += (v - t) + sum_;
+        }
+        sum_ = t;
+    }
+
+    /** @brief Add a value */
+    auto operator+=(T v) -> CompensatedSum&
+    {
+        add(v);
+        return *this;
+    }
+
+    /** @brief Add another partial sum */
+    void merge(const CompensatedSum& other)
+    {
+        add(other.sum_);
+        comp_ += other.comp_;
+    }
+
+    /** @brief Get the compensated sum */
+    [[nodiscard]] auto value() const -> T { return sum_ + comp_; }
+
+private:
+    /** Running sum */
+    T sum_{0};
+    /** Running compensation */
+    T comp_{0};
+};
+
+/** @brief Result of compute_mesh_statistics() */
+struct MeshStatistics {
+    /** Number of faces */
+    std::size_t numFaces{0};
+    /** Total surface area */
+    double area{0};
+    /**
+     * Signed enclosed volume. Only meaningful for closed, consistently
+     * oriented 3D meshes. Positive if face normals point outward.
+     */
+    double volume{0};
+    /** Smallest face area */
+    double minFaceArea{0};
+    /** Largest face area */
+    double maxFaceArea{0};
+    /**
+     * Number of face edges. Edges shared by two faces are counted once per
+     * face.
+     */
+    std::size_t numEdges{0};
+    /** Shortest edge length */
+    double minEdgeLength{0};
+    /** Longest edge length */
+    double maxEdgeLength{0};
+    /** Mean edge length */
+    double meanEdgeLength{0};
+    /** Standard deviation of the edge lengths */
+    double stdDevEdgeLength{0};
+    /**
+     * Number of faces with fewer than 3 vertices, repeated vertices, or an
+     * area of at most the degenerate area threshold
+     */
+    std::size_t numDegenerateFaces{0};
+};
+
+namespace detail
+{
+/** Number of faces reduced by a single task */
+constexpr std::size_t STATS_BLOCK_SIZE{1 << 14};
+
+/** Partial mesh statistics for a block of faces */
+struct MeshStatsAccumulator {
+    CompensatedSum<double> area;
+    CompensatedSum<double> volume;
+    double minArea{std::numeric_limits<double>::max()};
+    double maxArea{0};
+    std::size_t faces{0};
+    std::size_t degenerate{0};
+    // Edge lengths (Welford's online mean and variance)
+    std::size_t edges{0};
+    double edgeMean{0};
+    double edgeM2{0};
+    double minEdge{std::numeric_limits<double>::max()};
+    double maxEdge{0};
+
+    void addEdge(double len)
+    {
+        edges++;
+        auto delta = len - edgeMean;
+        edgeMean += delta / double(edges);
+        edgeM2 += delta * (len - edgeMean);
+        minEdge = std::min(minEdge, len);
+        maxEdge = std::max(maxEdge, len);
+    }
+
+    /** Merge another block (Chan et al.'s parallel variance) */
+    void merge(const MeshStatsAccumulator& o)
+    {
+        area.merge(o.area);
+        volume.merge(o.volume);
+        minArea = std::min(minArea, o.minArea);
+        maxArea = std::max(maxArea, o.maxArea);
+        faces += o.faces;
+        degenerate += o.degenerate;
+        if (o.edges > 0) {
+            auto n = double(edges + o.edges);
+            auto delta = o.edgeMean - edgeMean;
+            edgeMean += delta * double(o.edges) / n;
+            edgeM2 += o.edgeM2 + delta * delta * double(edges) *
+                                     double(o.edges) / n;
+            edges += o.edges;
+            minEdge = std::min(minEdge, o.minEdge);
+            maxEdge = std::max(maxEdge, o.maxEdge);
+        }
+    }
+};
+}  // namespace detail
+
+/**
+ * @brief Compute surface area, volume, edge length, and degeneracy
+ * statistics for a mesh
+ *
+ * All statistics are gathered in a single parallel pass over the faces.
+ * Polygon areas are computed with Newell's method (3D) or the shoelace
+ * formula (2D), and the volume is the sum of the signed volumes of the
+ * tetrahedra formed by each fan triangle and the first vertex of the mesh.
+ * Positions are converted to double and taken relative to that vertex, which
+ * avoids catastrophic cancellation for meshes far from the origin. Area and
+ * volume are accumulated with compensated summation in fixed-size blocks, so
+ * results are stable for very large meshes and identical for any number of
+ * threads.
+ *
+ * ```{.cpp}
+ * auto stats = compute_mesh_statistics(mesh);
+ * std::cout << stats.area << " " << stats.volume << "\n";
+ * ```
+ *
+ * Faces with fewer than 3 vertices are counted as degenerate and are
+ * otherwise excluded from the area, volume, and edge statistics.
+ *
+ * @param mesh 2D or 3D mesh
+ * @param degenerateArea Faces with an area less than or equal to this value
+ * are counted as degenerate
+ * @throws std::out_of_range If a face references an invalid vertex
+ */
+template <class MeshType>
+auto compute_mesh_statistics(const MeshType& mesh, double degenerateArea = 0)
+    -> MeshStatistics
+{
+    constexpr auto Dims = MeshType::dims;
+    static_assert(Dims == 2 or Dims == 3, "Mesh must be 2D or 3D");
+    using P = std::array<double, 3>;
+    const auto& verts = mesh.vertices();
+    const auto& faces = mesh.faces();
+    const auto nv = verts.size();
+    const auto nf = faces.size();
+
+    P origin{};
+    if (nv > 0) {
+        for (std::size_t d{0}; d < Dims; d++) {
+            origin[d] = static_cast<double>(verts[0][d]);
+        }
+    }
+    auto point = [&](std::size_t v) {
+        if (v >= nv) {
+            throw std::out_of_range("Face references invalid vertex");
+        }
+        P p{};
+        for (std::size_t d{0}; d < Dims; d++) {
+            p[d] = static_cast<double>(verts[v][d]) - origin[d];
+        }
+        return p;
+    };
+
+    const auto numBlocks = (nf + detail::STATS_BLOCK_SIZE - 1) /
+                           detail::STATS_BLOCK_SIZE;
+    std::vector<detail::MeshStatsAccumulator> blocks(numBlocks);
+    parallel_for(
+        0, numBlocks,
+        [&](auto b) {
+            auto& acc = blocks[b];
+            auto begin = b * detail::STATS_BLOCK_SIZE;
+            auto end = std::min(nf, begin + detail::STATS_BLOCK_SIZE);
+            std::vector<P> pts;
+            for (auto f = begin; f < end; f++) {
+                const auto& face = faces[f];
+                const auto n = face.size();
+                pts.resize(n);
+                for (std::size_t i{0}; i < n; i++) {
+                    pts[i] = point(face[i]);
+                }
+                if (n < 3) {
+                    acc.degenerate++;
+                    continue;
+                }
+
+                // Edges, and the vector area: sum of cross(p_i, p_i+1) / 2
+                P vecArea{};
+                for (std::size_t i{0}; i < n; i++) {
+                    const auto& a = pts[i];
+                    const auto& c = pts[(i + 1) % n];
+                    auto dx = c[0] - a[0];
+                    auto dy = c[1] - a[1];
+                    auto dz = c[2] - a[2];
+                    acc.addEdge(std::sqrt(dx * dx + dy * dy + dz * dz));
+                    vecArea[0] += a[1] * c[2] - a[2] * c[1];
+                    vecArea[1] += a[2] * c[0] - a[0] * c[2];
+                    vecArea[2] += a[0] * c[1] - a[1] * c[0];
+                }
+                double area{0};
+                if constexpr (Dims == 3) {
+                    area = 0.5 * std::sqrt(
+                                     vecArea[0] * vecArea[0] +
+                                     vecArea[1] * vecArea[1] +
+                                     vecArea[2] * vecArea[2]);
+                } else {
+                    area = 0.5 * std::abs(vecArea[2]);
+                }
+                acc.area += area;
+                acc.minArea = std::min(acc.minArea, area);
+                acc.maxArea = std::max(acc.maxArea, area);
+                acc.faces++;
+
+                // Signed volume of the fan tetrahedra: p0 . (pi x pi+1) / 6
+                if constexpr (Dims == 3) {
+                    double vol{0};
+                    const auto& p0 = pts[0];
+                    for (std::size_t i{1}; i + 1 < n; i++) {
+                        const auto& a = pts[i];
+                        const auto& c = pts[i + 1];
+                        vol += p0[0] * (a[1] * c[2] - a[2] * c[1]) +
+                               p0[1] * (a[2] * c[0] - a[0] * c[2]) +
+                               p0[2] * (a[0] * c[1] - a[1] * c[0]);
+                    }
+                    acc.volume += vol / 6;
+                }
+
+                // Degeneracy
+                bool repeated{false};
+                for (std::size_t i{0}; i < n and not repeated; i++) {
+                    for (std::size_t j{i + 1}; j < n; j++) {
+                        if (face[i] == face[j]) {
+                            repeated = true;
+                            break;
+                        }
+                    }
+                }
+                if (repeated or area <= degenerateArea) {
+                    acc.degenerate++;
+                }
+            }
+        },
+        1);
+
+    detail::MeshStatsAccumulator total;
+    for (const auto& b : blocks) {
+        total.merge(b);
+    }
+    MeshStatistics stats;
+    stats.numFaces = nf;
+    stats.area = total.area.value();
+    stats.volume = total.volume.value();
+    stats.numDegenerateFaces = total.degenerate;
+    if (total.faces > 0) {
+        stats.minFaceArea = total.minArea;
+        stats.maxFaceArea = total.maxArea;
+    }
+    stats.numEdges = total.edges;
+    if (total.edges > 0) {
+        stats.minEdgeLength = total.minEdge;
+        stats.maxEdgeLength = total.maxEdge;
+        stats.meanEdgeLength = total.edgeMean;
+        stats.stdDevEdgeLength =
+            std::sqrt(std::max(total.edgeM2 / double(total.edges), 0.0));
+    }
+    return stats;
+}
+
+}  // namespace educelab
@@ -0,0 +1,423 @@
+#pragma once
+
+/** @file */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "educelab/core/utils/MeshAdjacency.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+
+namespace educelab
+{
+
+/** @brief Mesh subdivision schemes */
+enum class SubdivisionScheme {
+    /**
+     * Loop subdivision. Splits every triangle into four. Requires a triangle
+     * mesh.
+     */
+    Loop,
+    /**
+     * Catmull-Clark subdivision. Splits every n-gon into n quads. Supports
+     * arbitrary polygonal meshes.
+     */
+    CatmullClark
+};
+
+/** @brief Options for subdivide() and subdivide_stream() */
+struct SubdivideOptions {
+    /** Subdivision scheme */
+    SubdivisionScheme scheme{SubdivisionScheme::Loop};
+    /** Number of subdivision levels */
+    std::size_t levels{1};
+    /**
+     * Number of vertices, and of input faces, in each chunk passed to the
+     * writer by subdivide_stream()
+     */
+    std::size_t chunkSize{1 << 16};
+};
+
+namespace detail
+{
+/**
+ * One level of subdivision. The edge table of the coarse mesh is built once,
+ * after which any range of fine vertices or faces can be computed
+ * independently and written directly into preallocated output.
+ *
+ * Fine vertices are ordered: coarse vertices, then one vertex per coarse
+ * edge, then (Catmull-Clark only) one vertex per coarse face. The fine faces
+ * of coarse face `f` start at faceOffset(f).
+ */
+template <class MeshType>
+class SubdivisionLevel
+{
+public:
+    using T = typename MeshType::value_type;
+    using Vertex = typename MeshType::Vertex;
+    using Face = typename MeshType::Face;
+    using Index = typename MeshType::index_type;
+    using AdjIndex = std::
+        conditional_t<(sizeof(Index) > 4), std::uint64_t, std::uint32_t>;
+    static constexpr auto Dims = MeshType::dims;
+    using Point = std::array<double, Dims>;
+
+    SubdivisionLevel(const MeshType& mesh, SubdivisionScheme scheme)
+        : mesh_{mesh}, scheme_{scheme}, adj_(mesh)
+    {
+        const auto& faces = mesh.faces();
+        const auto nf = faces.size();
+        if (scheme_ == SubdivisionScheme::Loop) {
+            parallel_for(0, nf, [&](auto f) {
+                if (faces[f].size() != 3) {
+                    throw std::invalid_argument(
+                        "Loop subdivision requires a triangle mesh");
+                }
+            });
+        }
+
+        // Output face offsets: four triangles per triangle, or one quad per
+        // polygon corner
+        fOffsets_.resize(nf + 1, 0);
+        for (std::size_t f{0}; f < nf; f++) {
+            auto n = scheme_ == SubdivisionScheme::Loop ? 4 : faces[f].size();
+            fOffsets_[f + 1] = fOffsets_[f] + n;
+        }
+
+        // Face points are shared by many edge and vertex points
+        if (scheme_ == SubdivisionScheme::CatmullClark) {
+            facePoints_.resize(nf);
+            parallel_for(0, nf, [&](auto f) {
+                Point p{};
+                for (auto v : faces[f]) {
+                    add_(p, mesh_.vertex(v), 1);
+                }
+                scale_(p, 1. / static_cast<double>(faces[f].size()));
+                facePoints_[f] = p;
+            });
+        }
+
+        numVertices_ = mesh.numVertices() + adj_.numEdges();
+        if (scheme_ == SubdivisionScheme::CatmullClark) {
+            numVertices_ += nf;
+        }
+        MeshType::checkCapacity(numVertices_);
+    }
+
+    /** Number of fine vertices */
+    [[nodiscard]] auto numVertices() const -> std::size_t
+    {
+        return numVertices_;
+    }
+
+    /** Number of fine faces */
+    [[nodiscard]] auto numFaces() const -> std::size_t
+    {
+        return fOffsets_.back();
+    }
+
+    /** Index of the first fine face of a coarse face */
+    [[nodiscard]] auto faceOffset(std::size_t f) const -> std::size_t
+    {
+        return fOffsets_[f];
+    }
+
+    /**
+     * Compute the fine vertex positions [b, e) in parallel. Vertex traits in
+     * `out` are not modified.
+     */
+    void vertices(std::size_t b, std::size_t e, Vertex* out) const
+    {
+        const auto nv = mesh_.numVertices();
+        const auto ne = adj_.numEdges();
+        parallel_for(b, e, [&](auto i) {
+            Point p;
+            if (i < nv) {
+                p = vertexPoint_(i);
+            } else if (i < nv + ne) {
+                p = edgePoint_(i - nv);
+            } else {
+                p = facePoints_[i - nv - ne];
+            }
+            auto& v = out[i - b];
+            for (std::size_t d{0}; d < Dims; d++) {
+                v[d] = static_cast<T>(p[d]);
+            }
+        });
+    }
+
+    /**
+     * Compute the fine faces of the coarse faces [b, e) in parallel. Face
+     * storage in `out` is reused.
+     */
+    void faces(std::size_t b, std::size_t e, Face* out) const
+    {
+        const auto nv = mesh_.numVertices();
+        const auto ne = adj_.numEdges();
+        const auto first = fOffsets_[b];
+        parallel_for(b, e, [&](auto f) {
+            const auto& face = mesh_.face(f);
+            const auto edges = adj_.faceEdges(f);
+            auto* dst = out + (fOffsets_[f] - first);
+            auto edge = [&](std::size_t c) {
+                return static_cast<Index>(nv + edges[c % face.size()]);
+            };
+            if (scheme_ == SubdivisionScheme::Loop) {
+                assign_(dst[0], {face[0], edge(0), edge(2)});
+                assign_(dst[1], {face[1], edge(1), edge(0)});
+                assign_(dst[2], {face[2], edge(2), edge(1)});
+                assign_(dst[3], {edge(0), edge(1), edge(2)});
+                return;
+            }
+            const auto center = static_cast<Index>(nv + ne + f);
+            const auto n = face.size();
+            for (std::size_t c{0}; c < n; c++) {
+                assign_(dst[c], {face[c], edge(c), center, edge(c + n - 1)});
+            }
+        });
+    }
+
+private:
+    const MeshType& mesh_;
+    SubdivisionScheme scheme_;
+    MeshAdjacency<AdjIndex> adj_;
+    std::vector<std::size_t> fOffsets_;
+    std::vector<Point> facePoints_;
+    std::size_t numVertices_{0};
+
+    template <class Vector>
+    static void add_(Point& p, const Vector& v, double w)
+    {
+        for (std::size_t d{0}; d < Dims; d++) {
+            p[d] += w * static_cast<double>(v[d]);
+        }
+    }
+
+    static void scale_(Point& p, double s)
+    {
+        for (auto& x : p) {
+            x *= s;
+        }
+    }
+
+    /** Assign a small face without reallocating reused storage */
+    static void assign_(Face& face, std::initializer_list<Index> idxs)
+    {
+        face.assign(idxs.begin(), idxs.end());
+    }
+
+    /** Position of the coarse vertex `v` in the fine mesh */
+    auto vertexPoint_(std::size_t v) const -> Point
+    {
+        const auto& pos = mesh_.vertex(v);
+        Point p{};
+        add_(p, pos, 1);
+
+        // Classify the one-ring
+        const auto edges = adj_.vertexEdges(v);
+        const auto neighbors = adj_.vertexNeighbors(v);
+        std::array<std::size_t, 2> boundary{};
+        std::size_t numBoundary{0};
+        for (std::size_t i{0}; i < edges.size(); i++) {
+            const auto numFaces = adj_.edgeFaces(edges[i]).size();
+            if (numFaces > 2) {
+                return p;
+            }
+            if (numFaces == 1) {
+                if (numBoundary == 2) {
+                    return p;
+                }
+                boundary[numBoundary++] = neighbors[i];
+            }
+        }
+
+        // Boundary and corner vertices follow the boundary curve
+        if (numBoundary == 2) {
+            scale_(p, 0.75);
+            add_(p, mesh_.vertex(boundary[0]), 0.125);
+            add_(p, mesh_.vertex(boundary[1]), 0.125);
+            return p;
+        }
+        if (numBoundary != 0 or edges.empty()) {
+            return p;
+        }
+        const auto n = static_cast<double>(edges.size());
+
+        if (scheme_ == SubdivisionScheme::Loop) {
+            constexpr auto pi = 3.14159265358979323846;
+            auto c = 0.375 + 0.25 * std::cos(2 * pi / n);
+            auto beta = (0.625 - c * c) / n;
+            scale_(p, 1 - n * beta);
+            for (auto u : neighbors) {
+                add_(p, mesh_.vertex(u), beta);
+            }
+            return p;
+        }
+
+        // Catmull-Clark: (Q + 2R + (n - 3)S) / n, with Q the mean of the
+        // adjacent face points and R the mean of the edge midpoints
+        const auto faces = adj_.vertexFaces(v);
+        if (faces.size() != edges.size()) {
+            return p;
+        }
+        scale_(p, (n - 2) / n);
+        for (auto f : faces) {
+            add_(p, facePoints_[f], 1 / (n * n));
+        }
+        for (auto u : neighbors) {
+            add_(p, mesh_.vertex(u), 1 / (n * n));
+        }
+        return p;
+    }
+
+    /** Position of the new vertex on edge `e` */
+    auto edgePoint_(std::size_t e) const -> Point
+    {
+        const auto& [a, b] = adj_.edge(e);
+        const auto faces = adj_.edgeFaces(e);
+        Point p{};
+        if (faces.size() != 2) {
+            add_(p, mesh_.vertex(a), 0.5);
+            add_(p, mesh_.vertex(b), 0.5);
+            return p;
+        }
+        if (scheme_ == SubdivisionScheme::Loop) {
+            add_(p, mesh_.vertex(a), 0.375);
+            add_(p, mesh_.vertex(b), 0.375);
+            for (auto f : faces) {
+                for (auto v : mesh_.face(f)) {
+                    if (v != a and v != b) {
+                        add_(p, mesh_.vertex(v), 0.125);
+                        break;
+                    }
+                }
+            }
+            return p;
+        }
+        add_(p, mesh_.vertex(a), 0.25);
+        add_(p, mesh_.vertex(b), 0.25);
+        add_(p, facePoints_[faces[0]], 0.25);
+        add_(p, facePoints_[faces[1]], 0.25);
+        return p;
+    }
+};
+
+/** Apply all but the last subdivision level in memory */
+template <class MeshType>
+auto subdivide_levels(
+    const MeshType& mesh, SubdivisionScheme scheme, std::size_t levels)
+    -> MeshType
+{
+    MeshType result = mesh;
+    for (std::size_t l{0}; l < levels; l++) {
+        MeshType fine;
+        {
+            SubdivisionLevel level(result, scheme);
+            fine.vertices().resize(level.numVertices());
+            fine.faces().resize(level.numFaces());
+            level.vertices(0, level.numVertices(), fine.vertices().data());
+            level.faces(0, result.numFaces(), fine.faces().data());
+        }
+        result = std::move(fine);
+    }
+    return result;
+}
+}  // namespace detail
+
+/**
+ * @brief Subdivide a mesh
+ *
+ * Applies `opts.levels` levels of Loop or Catmull-Clark subdivision. The
+ * edge table of each level is built with a parallel sort (see
+ * MeshAdjacency), after which every output vertex and face is computed
+ * independently in parallel and written directly into the preallocated
+ * output arrays.
+ *
+ * The first `numVertices()` vertices of each level are the input vertices,
+ * moved to their smoothed positions. Boundary edges are treated as creases
+ * which are subdivided as cubic B-spline curves. Vertices on non-manifold
+ * edges keep their positions.
+ *
+ * Only vertex positions are subdivided: Normals, colors, and texture
+ * coordinates are not carried over.
+ *
+ * ```{.cpp}
+ * SubdivideOptions opts;
+ * opts.scheme = SubdivisionScheme::CatmullClark;
+ * opts.levels = 2;
+ * auto fine = subdivide(mesh, opts);
+ * ```
+ *
+ * @throws std::invalid_argument If the scheme is Loop and the mesh has
+ * non-triangular faces
+ * @throws std::out_of_range If a face references an invalid vertex
+ * @throws std::overflow_error If the result has more vertices than can be
+ * indexed by the mesh's index type
+ */
+template <class MeshType>
+auto subdivide(const MeshType& mesh, const SubdivideOptions& opts = {})
+    -> MeshType
+{
+    return detail::subdivide_levels(mesh, opts.scheme, opts.levels);
+}
+
+/**
+ * @brief Subdivide a mesh, streaming the last level to a writer
+ *
+ * Like subdivide(), but the final and largest level is never held in memory:
+ * Its vertices and faces are computed in chunks of `opts.chunkSize` and
+ * passed to `writer.writeVertices(const std::vector<Vertex>&)` and
+ * `writer.writeFaces(const std::vector<Face>&)`. The chunk buffers are
+ * reused, so the faces of the final level are generated without
+ * per-face allocations. `writer` is typically a MeshStreamWriter, which
+ * must be closed by the caller.
+ *
+ * ```{.cpp}
+ * MeshStreamWriter<Mesh3f> writer("fine.elmesh");
+ * opts.levels = 5;
+ * subdivide_stream(mesh, writer, opts);
+ * writer.close();
+ * ```
+ *
+ * @copydetails subdivide()
+ * @throws std::invalid_argument If `opts.chunkSize` is 0
+ */
+template <class MeshType, class Writer>
+void subdivide_stream(
+    const MeshType& mesh, Writer& writer, const SubdivideOptions& opts = {})
+{
+    if (opts.chunkSize == 0) {
+        throw std::invalid_argument("Chunk size must be greater than 0");
+    }
+    if (opts.levels == 0) {
+        writer.writeVertices(mesh.vertices());
+        writer.writeFaces(mesh.faces());
+        return;
+    }
+    auto coarse = detail::subdivide_levels(mesh, opts.scheme, opts.levels - 1);
+    detail::SubdivisionLevel level(coarse, opts.scheme);
+
+    std::vector<typename MeshType::Vertex> vertices;
+    for (std::size_t b{0}; b < level.numVertices(); b += opts.chunkSize) {
+        auto e = std::min(b + opts.chunkSize, level.numVertices());
+        vertices.resize(e - b);
+        level.vertices(b, e, vertices.data());
+        writer.writeVertices(vertices);
+    }
+
+    std::vector<typename MeshType::Face> faces;
+    for (std::size_t b{0}; b < coarse.numFaces(); b += opts.chunkSize) {
+        auto e = std::min(b + opts.chunkSize, coarse.numFaces());
+        faces.resize(level.faceOffset(e) - level.faceOffset(b));
+        level.faces(b, e, faces.data());
+        writer.writeFaces(faces);
+    }
+}
+
+}  // namespace educelab
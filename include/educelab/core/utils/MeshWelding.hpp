@@ -0,0 +1,225 @@
+#pragma once
+
+/** @file */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/utils/Hashing.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+#include "educelab/core/utils/Sorting.hpp"
+
+namespace educelab
+{
+
+/**
+ * @brief Merge mesh vertices which are within `epsilon` of one another
+ *
+ * Each vertex is merged into the lowest-indexed vertex within `epsilon`
+ * (Euclidean distance), and merged vertices keep the traits (normal, color,
+ * etc.) of that vertex. Merging follows these links transitively. If
+ * `epsilon` is zero, only vertices with identical positions are merged.
+ * Surviving vertices keep their relative order, and face indices are
+ * remapped. Faces which collapse to fewer than three distinct consecutive
+ * vertices are removed. Face UVs drop the same corners as their faces and
+ * are removed with them. The UV list is unchanged.
+ *
+ * Positions are quantized to a grid with a cell size of `epsilon`, so
+ * vertices within `epsilon` of each other are always in the same or adjacent
+ * cells. The cells are hashed and radix sorted in parallel, which groups
+ * each cell's vertices contiguously. Every vertex then searches its
+ * neighboring cells independently. No hash table or locks are required.
+ * Cells beyond 2^62 in any dimension are clamped, so a tiny `epsilon` stays
+ * correct but may be slow for vertices far from the origin.
+ *
+ * ```{.cpp}
+ * auto mesh = read_mesh<Mesh3f>("tiles.obj");
+ * auto removed = weld_vertices(mesh, 1e-5F);
+ * ```
+ *
+ * @returns The number of vertices removed
+ * @throws std::invalid_argument If `epsilon` is negative or not finite, or
+ * if a vertex position is not finite. The mesh is unchanged.
+ * @throws std::out_of_range If a face references an invalid vertex. The
+ * mesh is unchanged.
+ */
+template <class MeshType>
+auto weld_vertices(
+    MeshType& mesh, typename MeshType::value_type epsilon = 0) -> std::size_t
+{
+    using T = typename MeshType::value_type;
+    using Index = typename MeshType::Face::value_type;
+    constexpr auto Dims = MeshType::dims;
+    using Cell = std::array<std::int64_t, Dims>;
+
+    if (not(epsilon >= T(0)) or not std::isfinite(double(epsilon))) {
+        throw std::invalid_argument("Weld epsilon must be finite and >= 0");
+    }
+
+    // Validate positions and faces before modifying the mesh
+    auto& verts = mesh.vertices();
+    const auto nv = verts.size();
+    parallel_for(0, nv, [&](auto i) {
+        for (std::size_t d{0}; d < Dims; d++) {
+            if (not std::isfinite(static_cast<double>(verts[i][d]))) {
+                throw std::invalid_argument("Vertex positions must be finite");
+            }
+        }
+    });
+    auto& faces = mesh.faces();
+    parallel_for(0, faces.size(), [&](auto f) {
+        for (const auto& idx : faces[f]) {
+            if (static_cast<std::size_t>(idx) >= nv) {
+                throw std::out_of_range("Face references invalid vertex");
+            }
+        }
+    });
+    if (nv < 2) {
+        return 0;
+    }
+    const bool exact = epsilon == T(0);
+    const auto eps = static_cast<double>(epsilon);
+    const auto eps2 = eps * eps;
+
+    // Grid cell of each vertex. For exact welding, the cell is the bit
+    // pattern of the position (with -0 folded into +0).
+    auto cell_of = [&](const auto& v) {
+        Cell c{};
+        for (std::size_t d{0}; d < Dims; d++) {
+            if (exact) {
+                auto val = static_cast<double>(v[d]) + 0.0;
+                std::memcpy(&c[d], &val, sizeof(val));
+            } else {
+                c[d] = detail::grid_coord(static_cast<double>(v[d]), eps);
+            }
+        }
+        return c;
+    };
+
+    // Hash cells. Only enough hash bits to keep collisions rare are kept,
+    // which reduces the number of radix sort passes.
+    std::size_t bits{8};
+    while (bits < 64 and (std::size_t{1} << (bits - 8)) < nv) {
+        bits++;
+    }
+    const auto shift = static_cast<unsigned>(64 - bits);
+    auto key_of = [shift](const Cell& c) {
+        return detail::hash_cell(c) >> shift;
+    };
+    std::vector<Cell> cells(nv);
+    std::vector<std::uint64_t> keys(nv);
+    std::vector<std::size_t> order(nv);
+    parallel_for(0, nv, [&](auto i) {
+        cells[i] = cell_of(verts[i]);
+        keys[i] = key_of(cells[i]);
+        order[i] = i;
+    });
+    radix_sort_pairs(keys, order);
+
+    // Find the lowest-indexed vertex within epsilon of each vertex
+    const std::size_t numOffsets = exact ? 1 : std::pow(3, Dims);
+    std::vector<std::size_t> target(nv);
+    parallel_for(0, nv, [&](auto i) {
+        const auto& v = verts[i];
+        auto best = i;
+        for (std::size_t o{0}; o < numOffsets; o++) {
+            // Neighbor cell offset: o as base-3 digits in [-1, 1]
+            auto nbr = cells[i];
+            if (not exact) {
+                auto digits = o;
+                for (std::size_t d{0}; d < Dims; d++) {
+                    nbr[d] += static_cast<std::int64_t>(digits % 3) - 1;
+                    digits /= 3;
+                }
+            }
+            auto [first, last] =
+                std::equal_range(keys.begin(), keys.end(), key_of(nbr));
+            for (auto it = first; it != last; it++) {
+                auto j = order[it - keys.begin()];
+                if (j >= best or cells[j] != nbr) {
+                    continue;
+                }
+                double dist2{0};
+                for (std::size_t d{0}; d < Dims; d++) {
+                    auto diff = static_cast<double>(verts[j][d]) -
+                                static_cast<double>(v[d]);
+                    dist2 += diff * diff;
+                }
+                if (dist2 <= eps2) {
+                    best = j;
+                }
+            }
+        }
+        target[i] = best;
+    });
+
+    // Resolve links to representatives. target[i] <= i, so one ascending
+    // pass is sufficient.
+    std::vector<std::size_t> remap(nv);
+    std::size_t numKept{0};
+    for (std::size_t i{0}; i < nv; i++) {
+        remap[i] = target[i] == i ? numKept++ : remap[target[i]];
+    }
+    const auto removed = nv - numKept;
+    if (removed == 0) {
+        return 0;
+    }
+
+    // Compact vertices
+    for (std::size_t i{0}; i < nv; i++) {
+        if (target[i] == i and remap[i] != i) {
+            verts[remap[i]] = std::move(verts[i]);
+        }
+    }
+    verts.resize(numKept);
+
+    // Remap faces and collapse repeated vertices. Face UVs lose the same
+    // corners as their faces.
+    auto& faceUVs = mesh.faceUVs();
+    std::vector<char> keep(faces.size());
+    parallel_for(0, faces.size(), [&](auto f) {
+        auto& face = faces[f];
+        auto* uvs = f < faceUVs.size() and faceUVs[f].size() == face.size()
+                        ? &faceUVs[f]
+                        : nullptr;
+        std::size_t n{0};
+        for (std::size_t c{0}; c < face.size(); c++) {
+            auto r = static_cast<Index>(remap[face[c]]);
+            if (n == 0 or face[n - 1] != r) {
+                if (uvs != nullptr) {
+                    (*uvs)[n] = (*uvs)[c];
+                }
+                face[n++] = r;
+            }
+        }
+        while (n > 1 and face[n - 1] == face[0]) {
+            n--;
+        }
+        face.resize(n);
+        if (uvs != nullptr) {
+            uvs->resize(n);
+        }
+        keep[f] = n >= 3 ? 1 : 0;
+    });
+    std::vector<std::size_t> kept;
+    for (std::size_t f{0}; f < faces.size(); f++) {
+        if (keep[f] != 0) {
+            if (kept.size() != f) {
+                faces[kept.size()] = std::move(faces[f]);
+            }
+            kept.push_back(f);
+        }
+    }
+    faces.resize(kept.size());
+    detail::permute_face_uvs(mesh, kept);
+    return removed;
+}
+
+}  // namespace educelab
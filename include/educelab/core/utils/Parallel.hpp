@@ -0,0 +1,174 @@
+#pragma once
+
+/** @file */
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace educelab
+{
+
+namespace detail
+{
+/** Requested number of worker threads. 0 selects the hardware default. */
+inline std::atomic<std::size_t> NUM_THREADS{0};
+
+/** Whether the current thread is executing a parallel region */
+inline thread_local bool IN_PARALLEL_REGION{false};
+
+/** RAII guard which marks the current thread as inside a parallel region */
+struct ParallelRegionGuard {
+    /** Mark the region */
+    ParallelRegionGuard() : prev{IN_PARALLEL_REGION}
+    {
+        IN_PARALLEL_REGION = true;
+    }
+    /** Restore the previous state */
+    ~ParallelRegionGuard() { IN_PARALLEL_REGION = prev; }
+    /** Deleted copy constructor */
+    ParallelRegionGuard(const ParallelRegionGuard&) = delete;
+    /** Deleted copy assignment */
+    auto operator=(const ParallelRegionGuard&) -> ParallelRegionGuard& = delete;
+    /** Previous region state */
+    bool prev;
+};
+}  // namespace detail
+
+/**
+ * @brief Get the number of threads used by the library's parallel algorithms
+ *
+ * Defaults to `std::thread::hardware_concurrency()`. Always returns at least 1.
+ */
+inline auto num_threads() -> std::size_t
+{
+    auto n = detail::NUM_THREADS.load();
+    if (n == 0) {
+        n = std::thread::hardware_concurrency();
+    }
+    return std::max<std::size_t>(n, 1);
+}
+
+/**
+ * @brief Set the number of threads used by the library's parallel algorithms
+ *
+ * Setting this value to 0 restores the hardware default.
+ */
+inline void set_num_threads(std::size_t n) { detail::NUM_THREADS = n; }
+
+/**
+ * @brief Get the [begin, end) bounds of a block when splitting `n` elements
+ * into `blocks` contiguous, nearly equal-sized blocks
+ */
+inline auto block_range(std::size_t n, std::size_t blocks, std::size_t idx)
+    -> std::pair<std::size_t, std::size_t>
+{
+    auto base = n / blocks;
+    auto rem = n % blocks;
+    auto begin = idx * base + std::min(idx, rem);
+    auto end = begin + base + (idx < rem ? 1 : 0);
+    return {begin, end};
+}
+
+/**
+ * @brief Call `func(begin, end)` for contiguous blocks of the range
+ * [begin, end) in parallel
+ *
+ * Blocks contain at least `grain` elements and are scheduled dynamically
+ * across num_threads() threads, one of which is the calling thread. If
+ * called from inside another parallel region, the range is processed
+ * serially on the calling thread. The first exception thrown by `func` is
+ * rethrown on the calling thread after all workers have joined.
+ *
+ * ```{.cpp}
+ * std::vector<float> v(1'000'000, 1.F);
+ * parallel_for_blocks(0, v.size(), [&](auto b, auto e) {
+ *     for (auto i = b; i < e; i++) {
+ *         v[i] *= 2.F;
+ *     }
+ * });
+ * ```
+ */
+template <typename Func>
+void parallel_for_blocks(
+    std::size_t begin, std::size_t end, Func&& func, std::size_t grain = 1024)
+{
+    if (end <= begin) {
+        return;
+    }
+    auto n = end - begin;
+    grain = std::max<std::size_t>(grain, 1);
+
+    // Run serially for small or nested ranges
+    auto threads = num_threads();
+    if (threads == 1 or n <= grain or detail::IN_PARALLEL_REGION) {
+        func(begin, end);
+        return;
+    }
+
+    // Over-decompose so fast threads can steal extra blocks
+    auto blockSize = std::max(grain, n / (threads * 8) + 1);
+    auto numBlocks = (n + blockSize - 1) / blockSize;
+    threads = std::min(threads, numBlocks);
+
+    std::atomic<std::size_t> next{0};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    auto worker = [&]() {
+        const detail::ParallelRegionGuard guard;
+        try {
+            for (auto b = next++; b < numBlocks; b = next++) {
+                auto bb = begin + b * blockSize;
+                auto be = std::min(bb + blockSize, end);
+                func(bb, be);
+            }
+        } catch (...) {
+            // Stop handing out work and keep the first error
+            next = numBlocks;
+            const std::lock_guard<std::mutex> lock(errorMutex);
+            if (not error) {
+                error = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (std::size_t t{1}; t < threads; t++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : pool) {
+        t.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+/**
+ * @brief Call `func(i)` for every index in the range [begin, end) in parallel
+ *
+ * @see parallel_for_blocks
+ */
+template <typename Func>
+void parallel_for(
+    std::size_t begin, std::size_t end, Func&& func, std::size_t grain = 1024)
+{
+    parallel_for_blocks(
+        begin, end,
+        [&func](std::size_t b, std::size_t e) {
+            for (auto i = b; i < e; i++) {
+                func(i);
+            }
+        },
+        grain);
+}
+
+}  // namespace educelab
@@ -0,0 +1,600 @@
+#pragma once
+
+/** @file */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "educelab/core/types/PointCloud.hpp"
+#include "educelab/core/types/Vec.hpp"
+#include "educelab/core/utils/Hashing.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+#include "educelab/core/utils/Sorting.hpp"
+
+namespace educelab
+{
+
+/** @brief Options for remove_statistical_outliers() */
+struct OutlierRemovalOptions {
+    /** Number of nearest neighbors used to measure each point's density */
+    std::size_t neighbors{16};
+    /**
+     * Points whose mean neighbor distance is more than this many standard
+     * deviations above the mean over the whole cloud are removed
+     */
+    double stdRatio{2};
+};
+
+/** @brief Options for estimate_normals() */
+struct NormalEstimationOptions {
+    /** Number of nearest neighbors (including the point itself) to fit */
+    std::size_t neighbors{16};
+    /**
+     * Normals are flipped to face this point. Only the first `Dims`
+     * components are used.
+     */
+    std::array<double, 3> viewpoint{0, 0, 0};
+};
+
+namespace detail
+{
+/**
+ * K-d tree over a list of points for nearest neighbor queries. Nodes are
+ * stored implicitly: the node for the range `[b, e)` of the permuted point
+ * list splits at its median position `(b + e) / 2`. The list must outlive
+ * the tree and not be modified.
+ */
+template <typename T, std::size_t Dims>
+class PointKdTree
+{
+public:
+    /** Neighbor: squared distance and point index */
+    using Neighbor = std::pair<double, std::size_t>;
+    /** Ranges with at most this many points are searched linearly */
+    static constexpr std::size_t LEAF_SIZE{8};
+    /** Marker for no excluded point */
+    static constexpr std::size_t NONE{std::numeric_limits<std::size_t>::max()};
+
+    /** Build the tree. Each level is partitioned in parallel. */
+    explicit PointKdTree(const std::vector<Vec<T, Dims>>& points)
+        : points_{&points}, order_(points.size()), axis_(points.size())
+    {
+        std::iota(order_.begin(), order_.end(), std::size_t{0});
+        using Range = std::array<std::size_t, 2>;
+        std::vector<Range> level;
+        if (points.size() > LEAF_SIZE) {
+            level.push_back({0, points.size()});
+        }
+        while (not level.empty()) {
+            std::vector<Range> next(2 * level.size());
+            parallel_for(
+                0, level.size(),
+                [&](auto i) {
+                    auto [b, e] = level[i];
+                    auto axis = widestAxis(b, e);
+                    auto mid = (b + e) / 2;
+                    std::nth_element(
+                        order_.begin() + b, order_.begin() + mid,
+                        order_.begin() + e, [&](auto x, auto y) {
+                            return points[x][axis] < points[y][axis];
+                        });
+                    axis_[mid] = static_cast<std::uint8_t>(axis);
+                    next[2 * i] = {b, mid};
+                    next[2 * i + 1] = {mid + 1, e};
+                },
+                1);
+            level.clear();
+            for (const auto& r : next) {
+                if (r[1] - r[0] > LEAF_SIZE) {
+                    level.push_back(r);
+                }
+            }
+        }
+    }
+
+    /**
+     * Find the `k` points nearest to `q`, sorted by increasing distance
+     * (then index). The point `exclude` is skipped.
+     */
+    void nearest(
+        const Vec<T, Dims>& q,
+        std::size_t k,
+        std::vector<Neighbor>& result,
+        std::size_t exclude = NONE) const
+    {
+        result.clear();
+        if (k > 0) {
+            search(0, order_.size(), q, k, exclude, result);
+        }
+        std::sort_heap(result.begin(), result.end());
+    }
+
+private:
+    /** Axis with the largest extent over a range */
+    auto widestAxis(std::size_t b, std::size_t e) const -> std::size_t
+    {
+        const auto& pts = *points_;
+        auto lo = pts[order_[b]];
+        auto hi = lo;
+        for (auto i = b + 1; i < e; i++) {
+            const auto& p = pts[order_[i]];
+            for (std::size_t d{0}; d < Dims; d++) {
+                lo[d] = std::min(lo[d], p[d]);
+                hi[d] = std::max(hi[d], p[d]);
+            }
+        }
+        std::size_t axis{0};
+        for (std::size_t d{1}; d < Dims; d++) {
+            if (hi[d] - lo[d] > hi[axis] - lo[axis]) {
+                axis = d;
+            }
+        }
+        return axis;
+    }
+
+    /** Offer a point to the max-heap of the k best neighbors */
+    void consider(
+        const Vec<T, Dims>& q,
+        std::size_t idx,
+        std::size_t k,
+        std::vector<Neighbor>& heap) const
+    {
+        const auto& p = (*points_)[idx];
+        double dist2{0};
+        for (std::size_t d{0}; d < Dims; d++) {
+            auto diff = static_cast<double>(p[d]) - static_cast<double>(q[d]);
+            dist2 += diff * diff;
+        }
+        Neighbor n{dist2, idx};
+        if (heap.size() < k) {
+            heap.push_back(n);
+            std::push_heap(heap.begin(), heap.end());
+        } else if (n < heap.front()) {
+            std::pop_heap(heap.begin(), heap.end());
+            heap.back() = n;
+            std::push_heap(heap.begin(), heap.end());
+        }
+    }
+
+    /** Search the node for the range [b, e) */
+    void search(
+        std::size_t b,
+        std::size_t e,
+        const Vec<T, Dims>& q,
+        std::size_t k,
+        std::size_t exclude,
+        std::vector<Neighbor>& heap) const
+    {
+        if (e - b <= LEAF_SIZE) {
+            for (auto i = b; i < e; i++) {
+                if (order_[i] != exclude) {
+                    consider(q, order_[i], k, heap);
+                }
+            }
+            return;
+        }
+        auto mid = (b + e) / 2;
+        auto axis = axis_[mid];
+        if (order_[mid] != exclude) {
+            consider(q, order_[mid], k, heap);
+        }
+        auto diff = static_cast<double>(q[axis]) -
+                    static_cast<double>((*points_)[order_[mid]][axis]);
+        if (diff < 0) {
+            search(b, mid, q, k, exclude, heap);
+        } else {
+            search(mid + 1, e, q, k, exclude, heap);
+        }
+        // Ties are searched so that equidistant results are deterministic
+        if (heap.size() < k or diff * diff <= heap.front().first) {
+            if (diff < 0) {
+                search(mid + 1, e, q, k, exclude, heap);
+            } else {
+                search(b, mid, q, k, exclude, heap);
+            }
+        }
+    }
+
+    /** Points */
+    const std::vector<Vec<T, Dims>>* points_;
+    /** Permutation of the point indices */
+    std::vector<std::size_t> order_;
+    /** Split axis of the node whose median is at each position */
+    std::vector<std::uint8_t> axis_;
+};
+
+/**
+ * Eigenvector of the smallest eigenvalue of a symmetric matrix, computed
+ * with cyclic Jacobi rotations
+ */
+template <std::size_t Dims>
+auto smallest_eigenvector(std::array<std::array<double, Dims>, Dims> a)
+    -> std::array<double, Dims>
+{
+    std::array<std::array<double, Dims>, Dims> v{};
+    for (std::size_t i{0}; i < Dims; i++) {
+        v[i][i] = 1;
+    }
+    for (std::size_t sweep{0}; sweep < 32; sweep++) {
+        double off{0};
+        double diag{0};
+        for (std::size_t p{0}; p < Dims; p++) {
+            diag += a[p][p] * a[p][p];
+            for (auto q = p + 1; q < Dims; q++) {
+                off += a[p][q] * a[p][q];
+            }
+        }
+        if (off <= 1e-30 * diag or off == 0) {
+            break;
+        }
+        for (std::size_t p{0}; p < Dims; p++) {
+            for (auto q = p + 1; q < Dims; q++) {
+                if (a[p][q] == 0) {
+                    continue;
+                }
+                auto theta = (a[q][q] - a[p][p]) / (2 * a[p][q]);
+                auto t = std::copysign(1., theta) /
+                         (std::abs(theta) + std::sqrt(theta * theta + 1));
+                auto c = 1 / std::sqrt(t * t + 1);
+                auto s = t * c;
+                for (std::size_t k{0}; k < Dims; k++) {
+                    auto kp = a[k][p];
+                    auto kq = a[k][q];
+                    a[k][p] = c * kp - s * kq;
+                    a[k][q] = s * kp + c * kq;
+                }
+                for (std::size_t k{0}; k < Dims; k++) {
+                    auto pk = a[p][k];
+                    auto qk = a[q][k];
+                    a[p][k] = c * pk - s * qk;
+                    a[q][k] = s * pk + c * qk;
+                }
+                for (std::size_t k{0}; k < Dims; k++) {
+                    auto kp = v[k][p];
+                    auto kq = v[k][q];
+                    v[k][p] = c * kp - s * kq;
+                    v[k][q] = s * kp + c * kq;
+                }
+            }
+        }
+    }
+    std::size_t min{0};
+    for (std::size_t i{1}; i < Dims; i++) {
+        if (a[i][i] < a[min][min]) {
+            min = i;
+        }
+    }
+    std::array<double, Dims> result{};
+    for (std::size_t i{0}; i < Dims; i++) {
+        result[i] = v[i][min];
+    }
+    return result;
+}
+}  // namespace detail
+
+/**
+ * @brief Downsample a point cloud to one point per voxel
+ *
+ * Space is divided into cubic voxels with edge length `voxelSize`, and the
+ * points in each occupied voxel are replaced by their centroid. Normals and
+ * colors are averaged, and averaged normals are renormalized. The output
+ * points are ordered by the lowest input index in their voxel, so the
+ * result does not depend on the number of threads.
+ *
+ * Voxel coordinates are hashed and radix sorted in parallel, which groups
+ * each voxel's points contiguously without a hash table or locks.
+ *
+ * ```{.cpp}
+ * auto cloud = read_point_cloud<PointCloud3f>("scan.ply");
+ * auto sparse = voxel_downsample(cloud, 0.01F);
+ * ```
+ *
+ * @throws std::invalid_argument If `voxelSize` is not positive and finite,
+ * or if a point is not finite
+ * @throws std::overflow_error If a voxel coordinate exceeds 2^62, i.e.
+ * `voxelSize` is too small for the extent of the cloud
+ */
+template <class PointCloudType>
+auto voxel_downsample(
+    const PointCloudType& cloud, typename PointCloudType::value_type voxelSize)
+    -> PointCloudType
+{
+    using T = typename PointCloudType::value_type;
+    constexpr auto Dims = PointCloudType::dims;
+    using Cell = std::array<std::int64_t, Dims>;
+
+    const auto size = static_cast<double>(voxelSize);
+    if (not(size > 0) or not std::isfinite(size)) {
+        throw std::invalid_argument("Voxel size must be finite and > 0");
+    }
+    const auto& points = cloud.points();
+    const auto n = points.size();
+    if (n == 0) {
+        return {};
+    }
+
+    // Validate points so that voxel coordinates fit in an int64
+    parallel_for(0, n, [&](auto i) {
+        for (std::size_t d{0}; d < Dims; d++) {
+            auto p = static_cast<double>(points[i][d]);
+            if (not std::isfinite(p)) {
+                throw std::invalid_argument("Points must be finite");
+            }
+            if (std::abs(std::floor(p / size)) >= detail::GRID_COORD_LIMIT) {
+                throw std::overflow_error(
+                    "Voxel size is too small for the point coordinates");
+            }
+        }
+    });
+
+    // Hash voxels with only enough bits to keep collisions rare, which
+    // reduces the number of radix sort passes
+    std::size_t bits{8};
+    while (bits < 64 and (std::size_t{1} << (bits - 8)) < n) {
+        bits++;
+    }
+    const auto shift = static_cast<unsigned>(64 - bits);
+    std::vector<Cell> cells(n);
+    std::vector<std::uint64_t> keys(n);
+    std::vector<std::size_t> order(n);
+    parallel_for(0, n, [&](auto i) {
+        for (std::size_t d{0}; d < Dims; d++) {
+            cells[i][d] =
+                detail::grid_coord(static_cast<double>(points[i][d]), size);
+        }
+        keys[i] = detail::hash_cell(cells[i]) >> shift;
+        order[i] = i;
+    });
+    radix_sort_pairs(keys, order);
+
+    // Separate colliding voxels within each run of equal keys. The sorts
+    // are stable, so each voxel's points stay in increasing index order.
+    std::vector<std::size_t> runs;
+    for (std::size_t i{0}; i < n; i++) {
+        if (i == 0 or keys[i] != keys[i - 1]) {
+            runs.push_back(i);
+        }
+    }
+    runs.push_back(n);
+    parallel_for(0, runs.size() - 1, [&](auto r) {
+        auto first = order.begin() + runs[r];
+        auto last = order.begin() + runs[r + 1];
+        if (last - first > 1) {
+            std::stable_sort(first, last, [&](auto a, auto b) {
+                return cells[a] < cells[b];
+            });
+        }
+    });
+
+    // Voxels, ordered by their first point
+    std::vector<std::size_t> voxelStarts;
+    for (std::size_t i{0}; i < n; i++) {
+        if (i == 0 or cells[order[i]] != cells[order[i - 1]]) {
+            voxelStarts.push_back(i);
+        }
+    }
+    const auto numVoxels = voxelStarts.size();
+    voxelStarts.push_back(n);
+    std::vector<std::size_t> firstPoint(numVoxels);
+    std::vector<std::size_t> voxels(numVoxels);
+    parallel_for(0, numVoxels, [&](auto v) {
+        firstPoint[v] = order[voxelStarts[v]];
+        voxels[v] = v;
+    });
+    radix_sort_pairs(firstPoint, voxels);
+
+    // Average the attributes of each voxel
+    PointCloudType result;
+    result.resize(numVoxels);
+    const auto normals = cloud.hasNormals();
+    const auto colors = cloud.hasColors();
+    if (normals) {
+        result.enableNormals();
+    }
+    if (colors) {
+        result.enableColors();
+    }
+    parallel_for(0, numVoxels, [&](auto out) {
+        auto v = voxels[out];
+        auto b = voxelStarts[v];
+        auto e = voxelStarts[v + 1];
+        auto count = static_cast<double>(e - b);
+        std::array<double, Dims> pos{};
+        std::array<double, Dims> nrm{};
+        std::array<double, 3> col{};
+        for (auto i = b; i < e; i++) {
+            auto idx = order[i];
+            for (std::size_t d{0}; d < Dims; d++) {
+                pos[d] += static_cast<double>(points[idx][d]);
+                if (normals) {
+                    nrm[d] += static_cast<double>(cloud.normals()[idx][d]);
+                }
+            }
+            if (colors) {
+                for (std::size_t c{0}; c < 3; c++) {
+                    col[c] += static_cast<double>(cloud.colors()[idx][c]);
+                }
+            }
+        }
+        double len{0};
+        for (std::size_t d{0}; d < Dims; d++) {
+            result.points()[out][d] = static_cast<T>(pos[d] / count);
+            len += nrm[d] * nrm[d];
+        }
+        len = std::sqrt(len);
+        if (normals and len > 0) {
+            for (std::size_t d{0}; d < Dims; d++) {
+                result.normals()[out][d] = static_cast<T>(nrm[d] / len);
+            }
+        }
+        if (colors) {
+            for (std::size_t c{0}; c < 3; c++) {
+                result.colors()[out][c] = static_cast<float>(col[c] / count);
+            }
+        }
+    });
+    return result;
+}
+
+/**
+ * @brief Remove points which are far from their neighbors
+ *
+ * Computes the mean distance from each point to its `opts.neighbors`
+ * nearest neighbors. Points whose mean distance is more than
+ * `opts.stdRatio` standard deviations above the mean over all points are
+ * removed. The remaining points keep their relative order. Neighbor
+ * queries use a k-d tree and run in parallel.
+ *
+ * ```{.cpp}
+ * auto removed = remove_statistical_outliers(cloud);
+ * ```
+ *
+ * @returns The number of points removed
+ * @throws std::invalid_argument If `opts.neighbors` is zero or
+ * `opts.stdRatio` is not finite
+ */
+template <class PointCloudType>
+auto remove_statistical_outliers(
+    PointCloudType& cloud, const OutlierRemovalOptions& opts = {})
+    -> std::size_t
+{
+    using T = typename PointCloudType::value_type;
+    constexpr auto Dims = PointCloudType::dims;
+    using Tree = detail::PointKdTree<T, Dims>;
+
+    if (opts.neighbors == 0) {
+        throw std::invalid_argument("Number of neighbors must be > 0");
+    }
+    if (not std::isfinite(opts.stdRatio)) {
+        throw std::invalid_argument("Standard deviation ratio must be finite");
+    }
+    const auto n = cloud.size();
+    if (n < 2) {
+        return 0;
+    }
+
+    const auto& points = cloud.points();
+    Tree tree(points);
+    std::vector<double> meanDist(n);
+    parallel_for_blocks(
+        0, n,
+        [&](auto begin, auto end) {
+            std::vector<typename Tree::Neighbor> nbrs;
+            for (auto i = begin; i < end; i++) {
+                tree.nearest(points[i], opts.neighbors, nbrs, i);
+                double sum{0};
+                for (const auto& [dist2, idx] : nbrs) {
+                    sum += std::sqrt(dist2);
+                }
+                meanDist[i] = sum / static_cast<double>(nbrs.size());
+            }
+        },
+        64);
+
+    auto mean = std::accumulate(meanDist.begin(), meanDist.end(), 0.) /
+                static_cast<double>(n);
+    double var{0};
+    for (const auto& d : meanDist) {
+        var += (d - mean) * (d - mean);
+    }
+    auto stddev = std::sqrt(var / static_cast<double>(n - 1));
+    auto threshold = mean + opts.stdRatio * stddev;
+
+    std::vector<std::size_t> keep;
+    keep.reserve(n);
+    for (std::size_t i{0}; i < n; i++) {
+        if (meanDist[i] <= threshold) {
+            keep.push_back(i);
+        }
+    }
+    const auto removed = n - keep.size();
+    if (removed > 0) {
+        cloud.select(keep);
+    }
+    return removed;
+}
+
+/**
+ * @brief Estimate point normals from their nearest neighbors
+ *
+ * Each point's normal is the direction of least variance (the eigenvector
+ * of the smallest eigenvalue of the covariance matrix) of its
+ * `opts.neighbors` nearest neighbors, including the point itself. Normals
+ * are flipped to face `opts.viewpoint`. Existing normals are replaced.
+ * Neighbor queries use a k-d tree and run in parallel.
+ *
+ * ```{.cpp}
+ * NormalEstimationOptions opts;
+ * opts.viewpoint = {0, 0, 10};
+ * estimate_normals(cloud, opts);
+ * ```
+ *
+ * @throws std::invalid_argument If `opts.neighbors` is less than Dims
+ */
+template <class PointCloudType>
+void estimate_normals(
+    PointCloudType& cloud, const NormalEstimationOptions& opts = {})
+{
+    using T = typename PointCloudType::value_type;
+    constexpr auto Dims = PointCloudType::dims;
+    static_assert(Dims == 2 or Dims == 3, "Only 2D and 3D are supported");
+    using Tree = detail::PointKdTree<T, Dims>;
+
+    if (opts.neighbors < Dims) {
+        throw std::invalid_argument("Number of neighbors must be >= Dims");
+    }
+    cloud.enableNormals();
+    const auto& points = cloud.points();
+    auto& normals = cloud.normals();
+    Tree tree(points);
+    parallel_for_blocks(
+        0, cloud.size(),
+        [&](auto begin, auto end) {
+            std::vector<typename Tree::Neighbor> nbrs;
+            for (auto i = begin; i < end; i++) {
+                tree.nearest(points[i], opts.neighbors, nbrs);
+                std::array<double, Dims> mean{};
+                for (const auto& nbr : nbrs) {
+                    for (std::size_t d{0}; d < Dims; d++) {
+                        mean[d] += static_cast<double>(points[nbr.second][d]);
+                    }
+                }
+                for (auto& m : mean) {
+                    m /= static_cast<double>(nbrs.size());
+                }
+                std::array<std::array<double, Dims>, Dims> cov{};
+                for (const auto& nbr : nbrs) {
+                    const auto& p = points[nbr.second];
+                    std::array<double, Dims> x{};
+                    for (std::size_t d{0}; d < Dims; d++) {
+                        x[d] = static_cast<double>(p[d]) - mean[d];
+                    }
+                    for (std::size_t r{0}; r < Dims; r++) {
+                        for (std::size_t c{0}; c < Dims; c++) {
+                            cov[r][c] += x[r] * x[c];
+                        }
+                    }
+                }
+                auto normal = detail::smallest_eigenvector(cov);
+                double facing{0};
+                for (std::size_t d{0}; d < Dims; d++) {
+                    facing += normal[d] * (opts.viewpoint[d] -
+                                           static_cast<double>(points[i][d]));
+                }
+                auto sign = facing < 0 ? -1. : 1.;
+                for (std::size_t d{0}; d < Dims; d++) {
+                    normals[i][d] = static_cast<T>(sign * normal[d]);
+                }
+            }
+        },
+        64);
+}
+
+}  // namespace educelab
@@ -0,0 +1,110 @@
+#pragma once
+
+/** @file */
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "educelab/core/utils/Parallel.hpp"
+
+namespace educelab
+{
+
+/**
+ * @brief Stable, parallel LSD radix sort of key-value pairs by key
+ *
+ * Sorts `keys` in ascending order and applies the same permutation to
+ * `values`. Keys are sorted 8 bits at a time, and only the digits needed to
+ * represent the largest key are processed, so sorting small keys (e.g.
+ * vertex indices) is cheaper than sorting the full key width. Each pass builds
+ * per-thread digit histograms and scatters without atomics.
+ *
+ * ```{.cpp}
+ * std::vector<std::uint32_t> keys{3, 1, 2};
+ * std::vector<std::uint32_t> values{0, 1, 2};
+ * radix_sort_pairs(keys, values);  // keys: {1, 2, 3}, values: {1, 2, 0}
+ * ```
+ *
+ * @throws std::invalid_argument If `keys` and `values` differ in size
+ * @tparam Key Unsigned integral key type
+ * @tparam Value Value type
+ */
+template <typename Key, typename Value>
+void radix_sort_pairs(std::vector<Key>& keys, std::vector<Value>& values)
+{
+    static_assert(std::is_unsigned_v<Key>, "Unsigned key type required");
+    if (keys.size() != values.size()) {
+        throw std::invalid_argument("Keys and values have mismatched sizes");
+    }
+    const auto n = keys.size();
+    if (n < 2) {
+        return;
+    }
+
+    // Number of 8-bit digits in the largest key
+    auto maxKey = *std::max_element(keys.begin(), keys.end());
+    std::size_t passes{0};
+    while (maxKey > 0) {
+        passes++;
+        maxKey = static_cast<Key>(maxKey >> 8);
+    }
+
+    constexpr std::size_t radix{256};
+    auto blocks = std::min(num_threads(), std::max<std::size_t>(n / 4096, 1));
+    std::vector<std::array<std::size_t, radix>> offsets(blocks);
+    std::vector<Key> tmpKeys(n);
+    std::vector<Value> tmpValues(n);
+
+    for (std::size_t pass{0}; pass < passes; pass++) {
+        const auto shift = 8 * pass;
+        auto digit = [shift](Key k) {
+            return static_cast<std::size_t>((k >> shift) & 0xFF);
+        };
+
+        // Per-block histograms
+        parallel_for(
+            0, blocks,
+            [&](auto b) {
+                auto& hist = offsets[b];
+                hist.fill(0);
+                auto [begin, end] = block_range(n, blocks, b);
+                for (auto i = begin; i < end; i++) {
+                    hist[digit(keys[i])]++;
+                }
+            },
+            1);
+
+        // Exclusive scan in (digit, block) order keeps the sort stable
+        std::size_t sum{0};
+        for (std::size_t d{0}; d < radix; d++) {
+            for (auto& hist : offsets) {
+                auto count = hist[d];
+                hist[d] = sum;
+                sum += count;
+            }
+        }
+
+        // Scatter
+        parallel_for(
+            0, blocks,
+            [&](auto b) {
+                auto& pos = offsets[b];
+                auto [begin, end] = block_range(n, blocks, b);
+                for (auto i = begin; i < end; i++) {
+                    auto dst = pos[digit(keys[i])]++;
+                    tmpKeys[dst] = keys[i];
+                    tmpValues[dst] = std::move(values[i]);
+                }
+            },
+            1);
+        keys.swap(tmpKeys);
+        values.swap(tmpValues);
+    }
+}
+
+}  // namespace educelab
@@ -3,8 +3,14 @@
 /** @file */
 
 #include <algorithm>
+#include <array>
 #include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
 #include <exception>
+#include <iterator>
+#include <limits>
 #include <locale>
 #include <string>
 #include <string_view>
@@ -147,47 +153,202 @@ static inline auto trim_copy(std::string_view s) -> std::string
     return std::string{trim(s)};
 }
 
-/** @brief Split a string by a delimiter */
-template <typename... Ds>
-static inline auto split(std::string_view s, const Ds&... ds)
-    -> std::vector<std::string_view>
+namespace detail
 {
-    // Build delimiters list
-    std::vector<char> delimiters;
-    if (sizeof...(ds) > 0) {
-        delimiters = {ds...};
-    } else {
-        delimiters.emplace_back(' ');
+/** Set of characters stored as a 256-bit bitmap */
+class CharBitmap
+{
+public:
+    /** Add a character to the set */
+    void insert(char c)
+    {
+        auto u = static_cast<unsigned char>(c);
+        bits_[u >> 6] |= std::uint64_t{1} << (u & 63);
     }
 
-    // Get a list of all delimiter start positions
-    std::vector<std::string_view::size_type> delimPos;
-    for (const auto& delim : delimiters) {
-        auto b = s.find(delim, 0);
-        while (b != std::string_view::npos) {
-            delimPos.emplace_back(b);
-            b = s.find(delim, b + 1);
-        }
+    /** Whether the set contains a character */
+    [[nodiscard]] auto contains(char c) const -> bool
+    {
+        auto u = static_cast<unsigned char>(c);
+        return ((bits_[u >> 6] >> (u & 63)) & 1) != 0;
     }
 
-    // Sort the delimiter start positions
-    std::sort(delimPos.begin(), delimPos.end());
+private:
+    /** One bit per character value */
+    std::array<std::uint64_t, 4> bits_{};
+};
+}  // namespace detail
 
-    // Split string
-    std::vector<std::string_view> tokens;
-    std::string_view::size_type begin{0};
-    for (auto end : delimPos) {
-        auto t = s.substr(begin, end - begin);
-        if (not t.empty()) {
-            tokens.emplace_back(t);
+/**
+ * @brief Lazy range over the tokens of a delimited string
+ *
+ * Yields the non-empty substrings of a string which are separated by any of
+ * a set of delimiter characters. Tokens are found one at a time as the range
+ * is iterated and refer to the original string, so iteration performs no
+ * allocations. The string must outlive the range and its iterators.
+ *
+ * @see split_view()
+ */
+class SplitIterable
+{
+public:
+    /** @brief Iterator over the tokens of a delimited string */
+    class SplitIterator
+    {
+    public:
+        /** @{ Iterator type traits */
+        /** Iterator difference */
+        using difference_type = std::ptrdiff_t;
+        /** Iterator value */
+        using value_type = std::string_view;
+        /** Iterator value pointer */
+        using pointer = const value_type*;
+        /** Iterator value reference */
+        using reference = const value_type&;
+        /** Iterator type */
+        using iterator_category = std::forward_iterator_tag;
+        /** @} */
+
+        /** Construct the end iterator */
+        SplitIterator() = default;
+
+        /** Construct an iterator at the first token of `s` */
+        SplitIterator(std::string_view s, const detail::CharBitmap& delims)
+            : rest_{s}, delims_{delims}
+        {
+            next_();
+        }
+
+        /** Get the current token */
+        auto operator*() const -> reference { return token_; }
+
+        /** Access the current token */
+        auto operator->() const -> pointer { return &token_; }
+
+        /** Equality comparison */
+        auto operator==(const SplitIterator& other) const -> bool
+        {
+            return token_.data() == other.token_.data();
+        }
+
+        /** Inequality comparison */
+        auto operator!=(const SplitIterator& other) const -> bool
+        {
+            return !(*this == other);
+        }
+
+        /** Increment operator */
+        auto operator++() -> SplitIterator&
+        {
+            next_();
+            return *this;
+        }
+
+        /** Post-increment operator */
+        auto operator++(int) -> SplitIterator
+        {
+            auto tmp = *this;
+            next_();
+            return tmp;
         }
-        begin = end + 1;
+
+    private:
+        /** Advance to the next token, or to the end */
+        void next_()
+        {
+            std::size_t b{0};
+            while (b < rest_.size() and delims_.contains(rest_[b])) {
+                b++;
+            }
+            if (b == rest_.size()) {
+                token_ = {};
+                rest_ = {};
+                return;
+            }
+            auto e = b + 1;
+            while (e < rest_.size() and not delims_.contains(rest_[e])) {
+                e++;
+            }
+            token_ = rest_.substr(b, e - b);
+            rest_.remove_prefix(e);
+        }
+
+        /** Current token. Has a null data pointer at the end. */
+        std::string_view token_;
+        /** Unsearched remainder of the string */
+        std::string_view rest_;
+        /** Delimiter characters */
+        detail::CharBitmap delims_;
+    };
+
+    /** Iterator type */
+    using iterator = SplitIterator;
+    /** Const iterator type */
+    using const_iterator = SplitIterator;
+
+    /** Construct a range over the tokens of `s` */
+    SplitIterable(std::string_view s, const detail::CharBitmap& delims)
+        : str_{s}, delims_{delims}
+    {
     }
-    auto t = s.substr(begin);
-    if (not t.empty()) {
-        tokens.emplace_back(t);
+
+    /** Return the start of the range */
+    auto begin() const -> iterator { return iterator{str_, delims_}; }
+    /** Return the end of the range */
+    auto end() const -> iterator { return iterator{}; }
+    /** Return the const start of the range */
+    auto cbegin() const -> const_iterator { return begin(); }
+    /** Return the const end of the range */
+    auto cend() const -> const_iterator { return end(); }
+
+private:
+    /** Split string */
+    std::string_view str_;
+    /** Delimiter characters */
+    detail::CharBitmap delims_;
+};
+
+/**
+ * @brief Lazily split a string by one or more delimiter characters
+ *
+ * Returns a range of the non-empty tokens of `s`. If no delimiters are
+ * provided, splits on spaces. Unlike split(), no memory is allocated.
+ *
+ * ```{.cpp}
+ * for (auto token : split_view("a,b;c", ',', ';')) {
+ *     std::cout << token << "\n";
+ * }
+ * ```
+ */
+template <typename... Ds>
+static inline auto split_view(std::string_view s, const Ds&... ds)
+    -> SplitIterable
+{
+    detail::CharBitmap delims;
+    if constexpr (sizeof...(ds) > 0) {
+        (delims.insert(ds), ...);
+    } else {
+        delims.insert(' ');
     }
+    return SplitIterable{s, delims};
+}
 
+/**
+ * @brief Split a string by one or more delimiter characters
+ *
+ * Returns the non-empty tokens of `s`. If no delimiters are provided, splits
+ * on spaces.
+ *
+ * @see split_view()
+ */
+template <typename... Ds>
+static inline auto split(std::string_view s, const Ds&... ds)
+    -> std::vector<std::string_view>
+{
+    std::vector<std::string_view> tokens;
+    for (const auto& t : split_view(s, ds...)) {
+        tokens.emplace_back(t);
+    }
     return tokens;
 }
 
@@ -225,6 +386,59 @@ auto to_numeric(std::string_view str, Args... args) -> T
     return val;
 }
 
+/**
+ * @brief Convert the leading characters of a string to a numeric type.
+ *
+ * Like to_numeric(std::string_view, Args...), but additionally stores the
+ * number of characters processed in `pos`, matching the `pos` parameter of the
+ * `std::sto` family of functions. Useful when parsing multiple values from a
+ * single buffer.
+ *
+ * @throws std::invalid_argument If string cannot be converted to the result
+ * type.
+ * @throws std::result_out_of_range If converted value is out of range for the
+ * result type.
+ * @tparam T Requested numeric type
+ * @tparam Args Parameter pack type
+ * @param str Value to convert
+ * @param pos Output location for the number of characters processed. Ignored
+ * if `nullptr`.
+ * @param args Extra parameters passed directly to `std::from_chars`
+ * @return Converted value
+ */
+template <typename T, typename... Args>
+auto to_numeric(std::string_view str, std::size_t* pos, Args... args) -> T
+{
+#ifdef EDUCELAB_NEED_TO_NUMERIC_FP
+    if constexpr (std::is_floating_point_v<T>) {
+        std::string tmp(str);
+        if constexpr (std::is_same_v<T, float>) {
+            return std::stof(tmp, pos);
+        } else if constexpr (std::is_same_v<T, double>) {
+            return std::stod(tmp, pos);
+        } else {
+            return std::stold(tmp, pos);
+        }
+    } else
+#endif
+    {
+        T val;
+        const auto* first = std::data(str);
+        const auto* last = std::data(str) + std::size(str);
+        auto [ptr, ec] = std::from_chars(first, last, val, args...);
+        if (ec == std::errc::invalid_argument) {
+            throw std::invalid_argument("Conversion could not be performed");
+        }
+        if (ec == std::errc::result_out_of_range) {
+            throw std::out_of_range("Value out of range for the result type");
+        }
+        if (pos != nullptr) {
+            *pos = static_cast<std::size_t>(ptr - first);
+        }
+        return val;
+    }
+}
+
 #ifdef EDUCELAB_NEED_TO_NUMERIC_FP
 /**
  * @copybrief to_numeric
@@ -254,4 +468,37 @@ inline auto to_numeric<long double>(std::string_view str) -> long double
 }
 #endif
 
+/**
+ * @brief Append the string representation of a numeric value to a string.
+ *
+ * Uses `std::to_chars` for conversion, which produces the shortest
+ * representation that round-trips through to_numeric() and does not depend on
+ * the current locale.
+ *
+ * @tparam T Numeric type
+ * @param str String to which the value is appended
+ * @param val Value to convert
+ */
+template <typename T>
+void append_numeric(std::string& str, T val)
+{
+    static_assert(std::is_arithmetic_v<T>, "Numeric type required");
+    // Large enough for the longest double or 64-bit integer
+    std::array<char, 32> buf{};
+#ifdef EDUCELAB_NEED_TO_CHARS_FP
+    if constexpr (std::is_floating_point_v<T>) {
+        constexpr auto digits = std::numeric_limits<T>::max_digits10;
+        auto len = std::snprintf(
+            buf.data(), buf.size(), "%.*g", digits,
+            static_cast<double>(val));
+        str.append(buf.data(), static_cast<std::size_t>(len));
+    } else
+#endif
+    {
+        auto* last = buf.data() + buf.size();
+        auto [ptr, ec] = std::to_chars(buf.data(), last, val);
+        str.append(buf.data(), ptr);
+    }
+}
+
 }  // namespace educelab
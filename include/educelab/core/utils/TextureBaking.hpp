@@ -0,0 +1,362 @@
+#pragma once
+
+/** @file */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "educelab/core/types/Image.hpp"
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/types/Vec.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+
+namespace educelab
+{
+
+/** @brief A texel covered by a mesh triangle, passed to bake samplers */
+struct TexelSample {
+    /** Texel row */
+    std::size_t y{0};
+    /** Texel column */
+    std::size_t x{0};
+    /** Index of the covering face */
+    std::size_t face{0};
+    /**
+     * Vertices of the covering triangle. For faces with more than 3 vertices,
+     * this is a triangle of the face's fan triangulation.
+     */
+    std::array<std::size_t, 3> vertices{};
+    /** Texture coordinate indices of the covering triangle */
+    std::array<std::size_t, 3> uvs{};
+    /** Barycentric weight of each triangle vertex at the texel center */
+    Vec<double, 3> barycentric;
+};
+
+/** @brief Options for bake_texture() */
+struct TextureBakeOptions {
+    /**
+     * Width and height of the texel tiles which are rasterized in parallel
+     */
+    std::size_t tileSize{64};
+};
+
+namespace detail
+{
+/** A face triangle in texel space, with its clipped texel bounds */
+struct BakeTriangle {
+    std::size_t face{0};
+    std::array<std::size_t, 3> vertices{};
+    std::array<std::size_t, 3> uvs{};
+    /** Texel-space x and y of each corner */
+    std::array<double, 6> pts{};
+    /** Inclusive texel bounds. Empty if x0 > x1. */
+    std::int64_t x0{1}, x1{0}, y0{1}, y1{0};
+};
+}  // namespace detail
+
+/**
+ * @brief Bake a texture by sampling every texel covered by a mesh
+ *
+ * Every face with texture coordinates is fan-triangulated and rasterized
+ * into a single-precision image of the given size. Texture coordinates map
+ * to texel space as `x = u * width` and `y = (1 - v) * height`, so `v = 1`
+ * is the top row of the image. For every texel whose center is covered by a
+ * triangle, `sampler(const TexelSample&, float* texel)` is called to write
+ * the texel's `channels` values. Texels which aren't covered are left at 0.
+ * Where triangles overlap in texture space, the last face wins. Triangles
+ * with non-finite texture coordinates are skipped.
+ *
+ * Triangles are binned into square tiles of texels, and the tiles are
+ * rasterized in parallel. Within a tile, triangles are processed in face
+ * order, so the result does not depend on the number of threads. The
+ * sampler may be called concurrently from several threads.
+ *
+ * ```{.cpp}
+ * // Bake the interpolated vertex positions into a position map
+ * auto map = bake_texture(mesh, 1024, 1024, 3, [&](auto& s, auto* texel) {
+ *     for (std::size_t i{0}; i < 3; i++) {
+ *         const auto& v = mesh.vertex(s.vertices[i]);
+ *         for (std::size_t d{0}; d < 3; d++) {
+ *             texel[d] += float(s.barycentric[i] * v[d]);
+ *         }
+ *     }
+ * });
+ * ```
+ *
+ * @throws std::invalid_argument If any dimension, the number of channels,
+ * or the tile size is 0
+ * @throws std::out_of_range If a face references an invalid vertex or
+ * texture coordinate
+ */
+template <class MeshType, typename Sampler>
+auto bake_texture(
+    const MeshType& mesh,
+    std::size_t height,
+    std::size_t width,
+    std::size_t channels,
+    Sampler sampler,
+    const TextureBakeOptions& opts = {}) -> Image
+{
+    if (height == 0 or width == 0 or channels == 0 or opts.tileSize == 0) {
+        throw std::invalid_argument("Invalid texture bake parameters");
+    }
+    const auto& faces = mesh.faces();
+    const auto& faceUVs = mesh.faceUVs();
+    const auto nf = std::min(faces.size(), faceUVs.size());
+    const auto nv = mesh.numVertices();
+    const auto nt = mesh.numUVs();
+
+    // Fan-triangulate the textured faces
+    std::vector<std::size_t> offsets(nf + 1, 0);
+    for (std::size_t f{0}; f < nf; f++) {
+        auto n = faces[f].size();
+        auto textured = n >= 3 and faceUVs[f].size() == n;
+        offsets[f + 1] = offsets[f] + (textured ? n - 2 : 0);
+    }
+    std::vector<detail::BakeTriangle> tris(offsets.back());
+    const auto w = static_cast<double>(width);
+    const auto h = static_cast<double>(height);
+    parallel_for(0, nf, [&](auto f) {
+        const auto& face = faces[f];
+        const auto& faceUV = faceUVs[f];
+        for (auto t = offsets[f]; t < offsets[f + 1]; t++) {
+            auto& tri = tris[t];
+            const auto k = t - offsets[f];
+            const std::array<std::size_t, 3> corners{0, k + 1, k + 2};
+            tri.face = f;
+            double minX{w};
+            double maxX{0};
+            double minY{h};
+            double maxY{0};
+            bool finite{true};
+            for (std::size_t i{0}; i < 3; i++) {
+                tri.vertices[i] = face[corners[i]];
+                tri.uvs[i] = faceUV[corners[i]];
+                if (tri.vertices[i] >= nv) {
+                    throw std::out_of_range("Face references invalid vertex");
+                }
+                if (tri.uvs[i] >= nt) {
+                    throw std::out_of_range("Face references invalid UV");
+                }
+                const auto& uv = mesh.uv(tri.uvs[i]);
+                auto x = static_cast<double>(uv[0]) * w;
+                auto y = (1 - static_cast<double>(uv[1])) * h;
+                tri.pts[2 * i] = x;
+                tri.pts[2 * i + 1] = y;
+                finite = finite and std::isfinite(x) and std::isfinite(y);
+                minX = std::min(minX, x);
+                maxX = std::max(maxX, x);
+                minY = std::min(minY, y);
+                maxY = std::max(maxY, y);
+            }
+            // Texels whose centers are inside the bounding box. Bounds are
+            // clamped to the texture before conversion. Triangles with
+            // non-finite UVs keep their empty bounds.
+            if (not finite) {
+                continue;
+            }
+            auto texel = [](double v, double lo, double hi) {
+                return static_cast<std::int64_t>(std::clamp(v, lo, hi));
+            };
+            tri.x0 = texel(std::ceil(minX - 0.5), 0, w);
+            tri.x1 = texel(std::floor(maxX - 0.5), -1, w - 1);
+            tri.y0 = texel(std::ceil(minY - 0.5), 0, h);
+            tri.y1 = texel(std::floor(maxY - 0.5), -1, h - 1);
+        }
+    });
+
+    // Bin the triangles into tiles in face order
+    const auto ts = opts.tileSize;
+    const auto tilesX = (width + ts - 1) / ts;
+    const auto tilesY = (height + ts - 1) / ts;
+    std::vector<std::size_t> binOffsets(tilesX * tilesY + 1, 0);
+    auto forEachTile = [&](const detail::BakeTriangle& tri, auto func) {
+        if (tri.x0 > tri.x1 or tri.y0 > tri.y1) {
+            return;
+        }
+        for (auto ty = std::size_t(tri.y0) / ts; ty <= std::size_t(tri.y1) / ts;
+             ty++) {
+            for (auto tx = std::size_t(tri.x0) / ts;
+                 tx <= std::size_t(tri.x1) / ts; tx++) {
+                func(ty * tilesX + tx);
+            }
+        }
+    };
+    for (const auto& tri : tris) {
+        forEachTile(tri, [&](auto tile) { binOffsets[tile + 1]++; });
+    }
+    for (std::size_t i{1}; i < binOffsets.size(); i++) {
+        binOffsets[i] += binOffsets[i - 1];
+    }
+    std::vector<std::size_t> bins(binOffsets.back());
+    auto cursor = binOffsets;
+    for (std::size_t t{0}; t < tris.size(); t++) {
+        forEachTile(tris[t], [&](auto tile) { bins[cursor[tile]++] = t; });
+    }
+
+    // Rasterize the tiles
+    Image image(height, width, channels, Depth::F32);
+    auto* pixels = reinterpret_cast<float*>(image.data());
+    parallel_for(
+        0, tilesX * tilesY,
+        [&](auto tile) {
+            const auto tx0 = static_cast<std::int64_t>((tile % tilesX) * ts);
+            const auto ty0 = static_cast<std::int64_t>((tile / tilesX) * ts);
+            const auto tx1 = std::min<std::int64_t>(tx0 + ts, width) - 1;
+            const auto ty1 = std::min<std::int64_t>(ty0 + ts, height) - 1;
+            TexelSample sample;
+            std::vector<float> texel(channels);
+            for (auto b = binOffsets[tile]; b < binOffsets[tile + 1]; b++) {
+                const auto& tri = tris[bins[b]];
+                const auto& p = tri.pts;
+                // Twice the signed area
+                auto area = (p[2] - p[0]) * (p[5] - p[1]) -
+                            (p[4] - p[0]) * (p[3] - p[1]);
+                if (area == 0) {
+                    continue;
+                }
+                sample.face = tri.face;
+                sample.vertices = tri.vertices;
+                sample.uvs = tri.uvs;
+                // Edge function of the edge opposite corner i at (x, y)
+                auto edge = [&](std::size_t i, double x, double y) {
+                    auto a = (i + 1) % 3;
+                    auto c = (i + 2) % 3;
+                    return ((p[2 * c] - p[2 * a]) * (y - p[2 * a + 1]) -
+                            (p[2 * c + 1] - p[2 * a + 1]) * (x - p[2 * a])) /
+                           area;
+                };
+                for (auto y = std::max(ty0, tri.y0); y <= std::min(ty1, tri.y1);
+                     y++) {
+                    for (auto x = std::max(tx0, tri.x0);
+                         x <= std::min(tx1, tri.x1); x++) {
+                        auto cx = double(x) + 0.5;
+                        auto cy = double(y) + 0.5;
+                        auto b0 = edge(0, cx, cy);
+                        auto b1 = edge(1, cx, cy);
+                        auto b2 = 1 - b0 - b1;
+                        if (b0 < 0 or b1 < 0 or b2 < 0) {
+                            continue;
+                        }
+                        sample.y = static_cast<std::size_t>(y);
+                        sample.x = static_cast<std::size_t>(x);
+                        sample.barycentric = Vec<double, 3>{b0, b1, b2};
+                        std::fill(texel.begin(), texel.end(), 0.F);
+                        sampler(sample, texel.data());
+                        auto* dst = pixels + (sample.y * width + sample.x) *
+                                                 channels;
+                        std::copy(texel.begin(), texel.end(), dst);
+                    }
+                }
+            }
+        },
+        1);
+    return image;
+}
+
+/**
+ * @brief Bilinearly sample an image at a continuous texel position
+ *
+ * The center of texel (y, x) is at (y + 0.5, x + 0.5), and positions outside
+ * the image are clamped to the edge texels. Integer images are scaled to
+ * [0, 1]. Writes one value per image channel to `out`.
+ *
+ * @throws std::invalid_argument If the image is empty
+ */
+inline void sample_image(const Image& image, double y, double x, float* out)
+{
+    if (image.empty()) {
+        throw std::invalid_argument("Cannot sample an empty image");
+    }
+    const auto cns = image.channels();
+    auto clampTo = [](double v, std::size_t n) {
+        return std::clamp(v - 0.5, 0.0, double(n - 1));
+    };
+    auto fy = clampTo(y, image.height());
+    auto fx = clampTo(x, image.width());
+    auto y0 = static_cast<std::size_t>(fy);
+    auto x0 = static_cast<std::size_t>(fx);
+    auto y1 = std::min(y0 + 1, image.height() - 1);
+    auto x1 = std::min(x0 + 1, image.width() - 1);
+    auto wy = fy - double(y0);
+    auto wx = fx - double(x0);
+
+    auto value = [&](std::size_t py, std::size_t px, std::size_t c) -> double {
+        auto idx = (py * image.width() + px) * cns + c;
+        switch (image.type()) {
+            case Depth::U8:
+                return double(std::to_integer<std::uint8_t>(
+                           image.data()[idx])) /
+                       255;
+            case Depth::U16: {
+                std::uint16_t v;
+                std::memcpy(&v, image.data() + 2 * idx, sizeof(v));
+                return double(v) / 65535;
+            }
+            case Depth::F32: {
+                float v;
+                std::memcpy(&v, image.data() + 4 * idx, sizeof(v));
+                return v;
+            }
+            case Depth::U32: {
+                std::uint32_t v;
+                std::memcpy(&v, image.data() + 4 * idx, sizeof(v));
+                return double(v) / 4294967295.;
+            }
+            case Depth::None:
+                break;
+        }
+        return 0;
+    };
+    for (std::size_t c{0}; c < cns; c++) {
+        auto top = (1 - wx) * value(y0, x0, c) + wx * value(y0, x1, c);
+        auto bottom = (1 - wx) * value(y1, x0, c) + wx * value(y1, x1, c);
+        out[c] = static_cast<float>((1 - wy) * top + wy * bottom);
+    }
+}
+
+/**
+ * @brief Bake interpolated vertex normals into a 3-channel normal map
+ *
+ * Normals are interpolated with the barycentric weights of each texel and
+ * normalized. Vertices without a normal contribute nothing.
+ *
+ * @see bake_texture
+ */
+template <class MeshType>
+auto bake_normals(
+    const MeshType& mesh,
+    std::size_t height,
+    std::size_t width,
+    const TextureBakeOptions& opts = {}) -> Image
+{
+    static_assert(
+        traits::has_normal_v<typename MeshType::Vertex>,
+        "Mesh vertices must have normals");
+    static_assert(MeshType::dims == 3, "Mesh must be 3D");
+    return bake_texture(
+        mesh, height, width, 3,
+        [&](const TexelSample& s, float* texel) {
+            Vec<double, 3> n;
+            for (std::size_t i{0}; i < 3; i++) {
+                const auto& vn = mesh.vertex(s.vertices[i]).normal;
+                if (vn) {
+                    for (std::size_t d{0}; d < 3; d++) {
+                        n[d] += s.barycentric[i] * double((*vn)[d]);
+                    }
+                }
+            }
+            auto len = n.magnitude();
+            for (std::size_t d{0}; d < 3; d++) {
+                texel[d] = len > 0 ? float(n[d] / len) : 0.F;
+            }
+        },
+        opts);
+}
+
+}  // namespace educelab
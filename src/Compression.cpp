@@ -0,0 +1,170 @@
+#include "educelab/core/utils/Compression.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using namespace educelab;
+
+// Codec parameters
+static constexpr std::size_t MIN_MATCH{4};
+static constexpr std::size_t MAX_OFFSET{0xFFFF};
+static constexpr unsigned HASH_BITS{16};
+static constexpr std::uint32_t EMPTY_SLOT{0xFFFFFFFF};
+
+static inline auto read32(const std::byte* p) -> std::uint32_t
+{
+    std::uint32_t v{0};
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline auto hash32(std::uint32_t v) -> std::uint32_t
+{
+    return (v * 2654435761U) >> (32 - HASH_BITS);
+}
+
+// Write a nibble-overflow length extension
+static void write_length(std::vector<std::byte>& out, std::size_t len)
+{
+    while (len >= 255) {
+        out.emplace_back(std::byte{255});
+        len -= 255;
+    }
+    out.emplace_back(static_cast<std::byte>(len));
+}
+
+// Emit a literal run optionally followed by a match
+static void write_sequence(
+    std::vector<std::byte>& out,
+    const std::byte* literals,
+    std::size_t numLiterals,
+    std::size_t offset,
+    std::size_t matchLen)
+{
+    auto litNibble = std::min<std::size_t>(numLiterals, 15);
+    auto matchNibble =
+        matchLen == 0 ? 0 : std::min<std::size_t>(matchLen - MIN_MATCH, 15);
+    out.emplace_back(static_cast<std::byte>((litNibble << 4) | matchNibble));
+    if (litNibble == 15) {
+        write_length(out, numLiterals - 15);
+    }
+    out.insert(out.end(), literals, literals + numLiterals);
+    if (matchLen == 0) {
+        return;
+    }
+    out.emplace_back(static_cast<std::byte>(offset & 0xFF));
+    out.emplace_back(static_cast<std::byte>(offset >> 8));
+    if (matchNibble == 15) {
+        write_length(out, matchLen - MIN_MATCH - 15);
+    }
+}
+
+auto educelab::lz_compress(const std::byte* data, std::size_t size)
+    -> std::vector<std::byte>
+{
+    std::vector<std::byte> out;
+    out.reserve(size / 2 + 16);
+    std::vector<std::uint32_t> table(std::size_t{1} << HASH_BITS, EMPTY_SLOT);
+
+    std::size_t anchor{0};
+    std::size_t pos{0};
+    while (pos + MIN_MATCH <= size) {
+        auto seq = read32(data + pos);
+        auto& slot = table[hash32(seq)];
+        auto cand = slot;
+        slot = static_cast<std::uint32_t>(pos);
+
+        if (cand == EMPTY_SLOT or pos - cand > MAX_OFFSET or
+            read32(data + cand) != seq) {
+            pos++;
+            continue;
+        }
+
+        // Extend the match
+        auto len = MIN_MATCH;
+        while (pos + len < size and data[cand + len] == data[pos + len]) {
+            len++;
+        }
+        write_sequence(out, data + anchor, pos - anchor, pos - cand, len);
+        pos += len;
+        anchor = pos;
+    }
+
+    // Trailing literals
+    write_sequence(out, data + anchor, size - anchor, 0, 0);
+    return out;
+}
+
+// Read a nibble-overflow length extension
+static auto read_length(const std::byte*& in, const std::byte* end)
+    -> std::size_t
+{
+    std::size_t len{0};
+    std::uint8_t b{255};
+    while (b == 255) {
+        if (in == end) {
+            throw std::runtime_error("Malformed LZ data: truncated length");
+        }
+        b = static_cast<std::uint8_t>(*in++);
+        len += b;
+    }
+    return len;
+}
+
+void educelab::lz_decompress(
+    const std::byte* data,
+    std::size_t size,
+    std::byte* out,
+    std::size_t outSize)
+{
+    const auto* in = data;
+    const auto* inEnd = data + size;
+    std::size_t op{0};
+    while (in < inEnd) {
+        auto token = static_cast<std::uint8_t>(*in++);
+
+        // Literals
+        std::size_t numLiterals = token >> 4;
+        if (numLiterals == 15) {
+            numLiterals += read_length(in, inEnd);
+        }
+        if (numLiterals > static_cast<std::size_t>(inEnd - in) or
+            numLiterals > outSize - op) {
+            throw std::runtime_error("Malformed LZ data: literal overrun");
+        }
+        std::memcpy(out + op, in, numLiterals);
+        in += numLiterals;
+        op += numLiterals;
+
+        // Final sequence has no match
+        if (in == inEnd) {
+            break;
+        }
+
+        // Match
+        if (inEnd - in < 2) {
+            throw std::runtime_error("Malformed LZ data: truncated offset");
+        }
+        std::size_t offset = static_cast<std::uint8_t>(in[0]) |
+                             (static_cast<std::uint8_t>(in[1]) << 8);
+        in += 2;
+        std::size_t matchLen = (token & 0x0F) + MIN_MATCH;
+        if ((token & 0x0F) == 15) {
+            matchLen += read_length(in, inEnd);
+        }
+        if (offset == 0 or offset > op or matchLen > outSize - op) {
+            throw std::runtime_error("Malformed LZ data: match overrun");
+        }
+        // Byte-wise copy handles overlapping (run-length) matches
+        const auto* src = out + op - offset;
+        for (std::size_t i{0}; i < matchLen; i++) {
+            out[op + i] = src[i];
+        }
+        op += matchLen;
+    }
+
+    if (op != outSize) {
+        throw std::runtime_error("Malformed LZ data: size mismatch");
+    }
+}
@@ -26,6 +26,7 @@ static inline auto size_of(Depth d) -> std::size_t
         case Depth::U16:
             return 2;
         case Depth::F32:
+        case Depth::U32:
             return 4;
     }
     return 0;
@@ -176,6 +177,11 @@ auto Image::empty() const -> bool { return data_.empty(); }
 
 auto Image::size() const -> std::size_t { return data_.size(); }
 
+auto Image::memoryUsage() const -> std::size_t
+{
+    return sizeof(Image) + data_.capacity();
+}
+
 Image::operator bool() const noexcept { return not empty(); }
 
 void Image::clear()
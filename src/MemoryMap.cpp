@@ -0,0 +1,108 @@
+#include "educelab/core/utils/MemoryMap.hpp"
+
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define EDUCELAB_HAVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace educelab;
+namespace fs = std::filesystem;
+
+MemoryMap::MemoryMap(const fs::path& path)
+{
+#ifdef EDUCELAB_HAVE_MMAP
+    auto fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open file: " + path.string());
+    }
+
+    struct stat st {
+    };
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot stat file: " + path.string());
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+
+    // mmap fails for empty files, which are valid but map to nothing
+    if (size_ > 0) {
+        auto* ptr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Cannot map file: " + path.string());
+        }
+        // Hint that the file will be read front-to-back
+        ::madvise(ptr, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const std::byte*>(ptr);
+        mapped_ = true;
+    }
+    ::close(fd);
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (not file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + path.string());
+    }
+    size_ = static_cast<std::size_t>(file.tellg());
+    file.seekg(0);
+    buffer_.resize(size_);
+    file.read(reinterpret_cast<char*>(buffer_.data()), size_);
+    if (not file) {
+        throw std::runtime_error("Cannot read file: " + path.string());
+    }
+    data_ = buffer_.data();
+#endif
+}
+
+MemoryMap::~MemoryMap() { reset(); }
+
+MemoryMap::MemoryMap(MemoryMap&& other) noexcept
+    : data_{std::exchange(other.data_, nullptr)}
+    , size_{std::exchange(other.size_, 0)}
+    , mapped_{std::exchange(other.mapped_, false)}
+    , buffer_{std::move(other.buffer_)}
+{
+}
+
+auto MemoryMap::operator=(MemoryMap&& other) noexcept -> MemoryMap&
+{
+    if (this != &other) {
+        reset();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        mapped_ = std::exchange(other.mapped_, false);
+        buffer_ = std::move(other.buffer_);
+    }
+    return *this;
+}
+
+auto MemoryMap::data() const noexcept -> const std::byte* { return data_; }
+
+auto MemoryMap::size() const noexcept -> std::size_t { return size_; }
+
+auto MemoryMap::empty() const noexcept -> bool { return size_ == 0; }
+
+auto MemoryMap::view() const noexcept -> std::string_view
+{
+    return {reinterpret_cast<const char*>(data_), size_};
+}
+
+void MemoryMap::reset()
+{
+#ifdef EDUCELAB_HAVE_MMAP
+    if (mapped_) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+        ::munmap(const_cast<std::byte*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+    buffer_.clear();
+}
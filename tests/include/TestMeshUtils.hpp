@@ -0,0 +1,77 @@
+#pragma once
+
+/** @file */
+
+#include <cstddef>
+
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/types/Vec.hpp"
+#include "educelab/core/utils/Iteration.hpp"
+
+namespace educelab::test
+{
+
+/** @brief Face layout of make_grid() */
+enum class GridFaces {
+    /** Two triangles per cell */
+    Triangles,
+    /** One quad per cell */
+    Quads
+};
+
+/** @brief make_grid() position function which places vertex (x, y) at z = 0 */
+struct FlatGrid {
+    auto operator()(std::size_t x, std::size_t y) const -> Vec3d
+    {
+        return Vec3d{double(x), double(y), 0};
+    }
+};
+
+/**
+ * @brief Regular grid mesh with `rows` x `cols` vertices
+ *
+ * Vertex (x, y) has index `v = y * cols + x` and is placed at
+ * `position(x, y)`. Each cell is split into the triangles
+ * (v, v + 1, v + cols + 1) and (v, v + cols + 1, v + cols), or is the quad
+ * (v, v + 1, v + cols + 1, v + cols).
+ */
+template <class MeshType = Mesh3f, class PositionFn = FlatGrid>
+auto make_grid(
+    std::size_t rows,
+    std::size_t cols,
+    PositionFn position = {},
+    GridFaces faces = GridFaces::Triangles) -> MeshType
+{
+    using T = typename MeshType::value_type;
+    MeshType mesh;
+    for (const auto [y, x] : range2D(rows, cols)) {
+        const auto p = position(x, y);
+        mesh.insertVertex(
+            static_cast<T>(p[0]), static_cast<T>(p[1]), static_cast<T>(p[2]));
+    }
+    for (const auto [y, x] : range2D(rows - 1, cols - 1)) {
+        auto v = y * cols + x;
+        if (faces == GridFaces::Quads) {
+            mesh.insertFace(v, v + 1, v + cols + 1, v + cols);
+        } else {
+            mesh.insertFace(v, v + 1, v + cols + 1);
+            mesh.insertFace(v, v + cols + 1, v + cols);
+        }
+    }
+    return mesh;
+}
+
+/** @brief Give every vertex of a mesh the same normal and color */
+template <class MeshType, class ColorType>
+void set_vertex_attributes(
+    MeshType& mesh,
+    const Vec<typename MeshType::value_type, MeshType::dims>& normal,
+    const ColorType& color)
+{
+    for (auto& v : mesh.vertices()) {
+        v.normal = normal;
+        v.color = color;
+    }
+}
+
+}  // namespace educelab::test
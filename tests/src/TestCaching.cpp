@@ -424,4 +424,27 @@ TEST(Caching, Threading)
             EXPECT_EQ(val.value(), expected);
         }
     }
-}
\ No newline at end of file
+}
+
+TEST(Caching, MemoryUsage)
+{
+    Cache cache;
+    cache.set_capacity(1'000'000);
+    auto empty = cache.memoryUsage();
+    EXPECT_GE(empty, sizeof(Cache));
+
+    // Heap memory is included in automatic sizes
+    std::vector<int> list(1000);
+    cache.insert(list);
+    auto expected = sizeof(list) + 1000 * sizeof(int);
+    EXPECT_EQ(cache.size(), expected);
+    Image img(200, 100, 3, Depth::U8);
+    cache.insert(img);
+    expected += memory_usage(img);
+    EXPECT_EQ(cache.size(), expected);
+    EXPECT_GT(expected, img.size());
+
+    // Bookkeeping is counted on top of the objects
+    EXPECT_GT(cache.memoryUsage(), empty + cache.size());
+    EXPECT_EQ(memory_usage(cache), cache.memoryUsage());
+}
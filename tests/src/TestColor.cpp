@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <limits>
+#include <tuple>
+
 #include "educelab/core/types/Color.hpp"
 
 using namespace educelab;
@@ -63,14 +66,131 @@ TEST(Color, Assignment)
     EXPECT_EQ(color.type(), Color::Type::F32C4);
     EXPECT_EQ(color.value<Color::F32C4>(), rgba32);
 
-    for (const auto& hex : {"#f0a", "#ff00aa"}) {
+    // Hex codes are stored as U8C3
+    for (const auto& hex : {"#f0a", "#ff00aa", "#FF00aA"}) {
         color = hex;
         EXPECT_TRUE(color.has_value());
-        EXPECT_EQ(color.type(), Color::Type::HexCode);
-        EXPECT_EQ(color.value<Color::HexCode>(), hex);
+        EXPECT_EQ(color.type(), Color::Type::U8C3);
+        EXPECT_EQ(color.value<Color::U8C3>(), (Color::U8C3{255, 0, 170}));
+        EXPECT_EQ(color.value<Color::HexCode>(), "#ff00aa");
     }
     EXPECT_THROW(color = "#badhex", std::invalid_argument);
 
     color.clear();
     EXPECT_FALSE(color.has_value());
 }
+
+TEST(Color, ConvertDepth)
+{
+    Color color{Color::U8C3{255, 128, 0}};
+    EXPECT_EQ(color.value<Color::U16C3>(), (Color::U16C3{65535, 32896, 0}));
+    auto f = color.value<Color::F32C3>();
+    EXPECT_FLOAT_EQ(f[0], 1.F);
+    EXPECT_FLOAT_EQ(f[1], 128.F / 255.F);
+    EXPECT_FLOAT_EQ(f[2], 0.F);
+
+    // Integer depths round to the nearest value
+    color = Color::U16C1{32896};
+    EXPECT_EQ(color.value<Color::U8C1>(), 128);
+    color = Color::U16C1{32767};
+    EXPECT_EQ(color.value<Color::U8C1>(), 127);
+
+    // Floats are clamped and rounded
+    color = Color::F32C3{-0.5F, 0.5F, 2.F};
+    EXPECT_EQ(color.value<Color::U8C3>(), (Color::U8C3{0, 128, 255}));
+    color = Color::F32C1{std::numeric_limits<float>::quiet_NaN()};
+    EXPECT_EQ(color.value<Color::U16C1>(), 0);
+
+    // Every 8-bit value round trips through each depth
+    for (int v{0}; v < 256; v++) {
+        color = static_cast<Color::U8C1>(v);
+        EXPECT_EQ(Color(color.value<Color::U16C1>()).value<Color::U8C1>(), v);
+        EXPECT_EQ(Color(color.value<Color::F32C1>()).value<Color::U8C1>(), v);
+    }
+}
+
+TEST(Color, ConvertChannels)
+{
+    // Gray to RGB(A)
+    Color color{Color::U8C1{100}};
+    EXPECT_EQ(color.value<Color::U8C3>(), (Color::U8C3{100, 100, 100}));
+    EXPECT_EQ(color.value<Color::U8C4>(), (Color::U8C4{100, 100, 100, 255}));
+    EXPECT_EQ(
+        color.value<Color::U16C4>(),
+        (Color::U16C4{25700, 25700, 25700, 65535}));
+    EXPECT_EQ(color.value<Color::F32C4>()[3], 1.F);
+
+    // RGB to gray uses luma
+    color = Color::U8C3{255, 0, 0};
+    EXPECT_EQ(color.value<Color::U8C1>(), 76);
+    color = Color::F32C3{0, 1, 0};
+    EXPECT_NEAR(color.value<Color::F32C1>(), 0.587F, 1e-6);
+    color = Color::U8C3{50, 50, 50};
+    EXPECT_EQ(color.value<Color::U8C1>(), 50);
+
+    // RGBA to RGB drops alpha
+    color = Color::U8C4{1, 2, 3, 4};
+    EXPECT_EQ(color.value<Color::U8C3>(), (Color::U8C3{1, 2, 3}));
+    EXPECT_EQ(color.value<Color::U8C1>(), 2);
+}
+
+TEST(Color, ConvertHexCode)
+{
+    Color color{"#f0a"};
+    EXPECT_EQ(color.value<Color::U8C3>(), (Color::U8C3{255, 0, 170}));
+    color = "#00Aa33";
+    EXPECT_EQ(color.value<Color::U8C4>(), (Color::U8C4{0, 170, 51, 255}));
+    EXPECT_FLOAT_EQ(color.value<Color::F32C3>()[2], 0.2F);
+
+    color = Color::U8C3{255, 0, 170};
+    EXPECT_EQ(color.value<Color::HexCode>(), "#ff00aa");
+    color = Color::F32C1{1};
+    EXPECT_EQ(color.value<Color::HexCode>(), "#ffffff");
+}
+
+TEST(Color, ParseHexCode)
+{
+    Color::U8C3 rgb;
+    EXPECT_TRUE(detail::parse_hex_color("#09afAF", rgb));
+    EXPECT_EQ(rgb, (Color::U8C3{9, 175, 175}));
+    EXPECT_TRUE(detail::parse_hex_color("#1Fa", rgb));
+    EXPECT_EQ(rgb, (Color::U8C3{17, 255, 170}));
+
+    for (const auto* bad :
+         {"", "#", "#12", "#1234", "#12345", "#1234567", "123456", "#12345g",
+          "#gff", "#12 456", "##12345", "#ff00aa\n"}) {
+        EXPECT_FALSE(detail::parse_hex_color(bad, rgb)) << bad;
+        EXPECT_THROW(Color{bad}, std::invalid_argument) << bad;
+    }
+
+    // Every value round trips through the formatter
+    for (int v{0}; v < 256; v++) {
+        auto u = static_cast<std::uint8_t>(v);
+        Color::U8C3 in{u, static_cast<std::uint8_t>(255 - v), u};
+        auto hex = detail::rgb_to_hex(in);
+        ASSERT_EQ(hex.size(), 7);
+        EXPECT_TRUE(detail::parse_hex_color(hex, rgb));
+        EXPECT_EQ(rgb, in);
+    }
+}
+
+TEST(Color, Convert)
+{
+    Color color{Color::U8C3{255, 0, 0}};
+    auto c = color.convert(Color::Type::F32C4);
+    EXPECT_EQ(c.type(), Color::Type::F32C4);
+    EXPECT_EQ(c.value<Color::F32C4>(), (Color::F32C4{1, 0, 0, 1}));
+    c = color.convert(Color::Type::HexCode);
+    EXPECT_EQ(c.type(), Color::Type::HexCode);
+    EXPECT_EQ(c.value<Color::HexCode>(), "#ff0000");
+    EXPECT_FALSE(color.convert(Color::Type::None).has_value());
+    EXPECT_EQ(color.convert(Color::Type::U8C3), color);
+
+    // Empty colors can't be converted
+    color.clear();
+    EXPECT_THROW(
+        std::ignore = color.value<Color::U8C3>(), std::bad_variant_access);
+    EXPECT_THROW(
+        std::ignore = color.convert(Color::Type::U8C3),
+        std::bad_variant_access);
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <tuple>
+#include <vector>
+
+#include "educelab/core/types/ColorArray.hpp"
+#include "educelab/core/utils/MemoryUsage.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+
+using namespace educelab;
+
+TEST(ColorArray, Construct)
+{
+    ColorArray empty;
+    EXPECT_EQ(empty.type(), Color::Type::None);
+    EXPECT_EQ(empty.size(), 0);
+    EXPECT_TRUE(empty.empty());
+
+    ColorArray colors(Color::Type::U8C3, 4);
+    EXPECT_EQ(colors.type(), Color::Type::U8C3);
+    EXPECT_EQ(colors.size(), 4);
+    for (const auto& c : colors.values<Color::U8C3>()) {
+        EXPECT_EQ(c, (Color::U8C3{0, 0, 0}));
+    }
+    EXPECT_THROW(
+        std::ignore = colors.values<Color::F32C3>(), std::bad_variant_access);
+
+    ColorArray values(std::vector<Color::F32C1>{0.F, 1.F});
+    EXPECT_EQ(values.type(), Color::Type::F32C1);
+    EXPECT_EQ(values.size(), 2);
+
+    EXPECT_THROW(ColorArray(Color::Type::None), std::invalid_argument);
+    EXPECT_THROW(ColorArray(Color::Type::HexCode), std::invalid_argument);
+}
+
+TEST(ColorArray, Access)
+{
+    ColorArray colors(Color::Type::U8C3, 2);
+    colors.set(0, Color("#ff0000"));
+    colors.set(1, Color(Color::F32C1{1}));
+    EXPECT_EQ(colors.get(0).type(), Color::Type::U8C3);
+    EXPECT_EQ(colors.get(0).value<Color::U8C3>(), (Color::U8C3{255, 0, 0}));
+    EXPECT_EQ(colors.get(1).value<Color::U8C3>(), (Color::U8C3{255, 255, 255}));
+    EXPECT_THROW(std::ignore = colors.get(2), std::out_of_range);
+    EXPECT_THROW(colors.set(2, Color("#000")), std::out_of_range);
+    EXPECT_THROW(colors.set(0, Color()), std::bad_variant_access);
+    EXPECT_THROW(std::ignore = ColorArray().get(0), std::out_of_range);
+
+    colors.resize(3);
+    EXPECT_EQ(colors.size(), 3);
+    EXPECT_EQ(colors.get(2).value<Color::U8C3>(), (Color::U8C3{0, 0, 0}));
+    colors.clear();
+    EXPECT_TRUE(colors.empty());
+    EXPECT_EQ(colors.type(), Color::Type::U8C3);
+}
+
+TEST(ColorArray, Convert)
+{
+    std::vector<Color::U8C3> rgb;
+    for (std::size_t i{0}; i < 50000; i++) {
+        auto v = static_cast<std::uint8_t>(i % 256);
+        rgb.push_back(Color::U8C3{v, static_cast<std::uint8_t>(255 - v), 7});
+    }
+    ColorArray colors(rgb);
+
+    // Bulk conversion matches per-color conversion for every type
+    set_num_threads(4);
+    for (const auto type :
+         {Color::Type::U8C1, Color::Type::U8C4, Color::Type::U16C1,
+          Color::Type::U16C3, Color::Type::U16C4, Color::Type::F32C1,
+          Color::Type::F32C3, Color::Type::F32C4}) {
+        auto converted = colors.convert(type);
+        ASSERT_EQ(converted.type(), type);
+        ASSERT_EQ(converted.size(), colors.size());
+        for (std::size_t i{0}; i < colors.size(); i += 97) {
+            EXPECT_EQ(converted.get(i), colors.get(i).convert(type));
+        }
+        auto back = converted.convert(Color::Type::U8C3);
+        if (type != Color::Type::U8C1 and type != Color::Type::F32C1 and
+            type != Color::Type::U16C1) {
+            EXPECT_EQ(back.values<Color::U8C3>(), rgb);
+        }
+    }
+    set_num_threads(0);
+
+    auto rgba = convert_colors<Color::F32C4>(rgb);
+    ASSERT_EQ(rgba.size(), rgb.size());
+    EXPECT_EQ(rgba[255], (Color::F32C4{1, 0, 7.F / 255.F, 1}));
+
+    // Converting an empty array keeps it empty
+    auto none = ColorArray().convert(Color::Type::F32C3);
+    EXPECT_EQ(none.type(), Color::Type::F32C3);
+    EXPECT_TRUE(none.empty());
+    EXPECT_THROW(
+        std::ignore = colors.convert(Color::Type::HexCode),
+        std::invalid_argument);
+}
+
+TEST(ColorArray, MemoryUsage)
+{
+    ColorArray colors(Color::Type::U8C3, 1000);
+    EXPECT_GE(memory_usage(colors), sizeof(ColorArray) + 3000);
+    EXPECT_LT(memory_usage(colors), sizeof(Color) * 1000);
+}
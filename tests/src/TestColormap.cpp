@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "educelab/core/types/Image.hpp"
+#include "educelab/core/utils/Colormap.hpp"
+#include "educelab/core/utils/Iteration.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+
+using namespace educelab;
+
+namespace
+{
+void expect_near(const Color::U8C3& a, const std::array<int, 3>& b, int tol)
+{
+    for (std::size_t c{0}; c < 3; c++) {
+        EXPECT_NEAR(a[c], b[c], tol) << "channel " << c;
+    }
+}
+
+auto pixel(const Image& img, std::size_t y, std::size_t x) -> Color::U8C3
+{
+    const auto* p = &img.at<std::uint8_t>(y, x);
+    return Color::U8C3{p[0], p[1], p[2]};
+}
+}  // namespace
+
+TEST(Colormap, LUT)
+{
+    // Endpoints of the matplotlib colormaps
+    auto lut = colormap_lut(Colormap::Viridis);
+    ASSERT_EQ(lut.size(), 256);
+    expect_near(lut.front(), {68, 1, 84}, 4);
+    expect_near(lut.back(), {253, 231, 37}, 4);
+    lut = colormap_lut(Colormap::Magma, 4096);
+    ASSERT_EQ(lut.size(), 4096);
+    expect_near(lut.front(), {0, 0, 4}, 4);
+    expect_near(lut.back(), {252, 253, 191}, 6);
+    lut = colormap_lut(Colormap::Inferno);
+    expect_near(lut.back(), {252, 255, 164}, 6);
+    lut = colormap_lut(Colormap::Plasma);
+    expect_near(lut.front(), {13, 8, 135}, 4);
+    expect_near(lut.back(), {240, 249, 33}, 6);
+    lut = colormap_lut(Colormap::Turbo);
+    EXPECT_GT(lut[128][1], 200);
+
+    lut = colormap_lut(Colormap::Gray);
+    for (std::size_t i{0}; i < lut.size(); i++) {
+        EXPECT_EQ(lut[i], (Color::U8C3{i, i, i}));
+    }
+    EXPECT_THROW(colormap_lut(Colormap::Gray, 1), std::invalid_argument);
+
+    auto c = colormap_color(Colormap::Viridis, 2);
+    EXPECT_EQ(c, colormap_color(Colormap::Viridis, 1));
+}
+
+TEST(Colormap, Apply)
+{
+    constexpr std::size_t h{64};
+    constexpr std::size_t w{300};
+    Image img(h, w, 1, Depth::F32);
+    for (const auto [y, x] : range2D(h, w)) {
+        img.at<float>(y, x) = static_cast<float>(x) - 10.F + y;
+    }
+    img.at<float>(0, 0) = std::numeric_limits<float>::quiet_NaN();
+    img.at<float>(0, 1) = std::numeric_limits<float>::infinity();
+
+    auto lut = colormap_lut(Colormap::Viridis, 4096);
+    set_num_threads(4);
+    auto out = apply_colormap(img, lut, 0, 255);
+    set_num_threads(0);
+    ASSERT_EQ(out.height(), h);
+    ASSERT_EQ(out.width(), w);
+    ASSERT_EQ(out.channels(), 3);
+    ASSERT_EQ(out.type(), Depth::U8);
+    for (const auto [y, x] : range2D(h, w)) {
+        if (y == 0 and x < 2) {
+            continue;
+        }
+        auto v = std::clamp(img.at<float>(y, x), 0.F, 255.F);
+        auto idx = static_cast<std::size_t>(std::round(v / 255.F * 4095.F));
+        ASSERT_EQ(pixel(out, y, x), lut[idx]) << y << " " << x;
+    }
+    EXPECT_EQ(pixel(out, 0, 0), lut.front());
+    EXPECT_EQ(pixel(out, 0, 1), lut.back());
+
+    // Built-in colormap with alpha
+    ColormapOptions opts;
+    opts.alpha = true;
+    auto rgba = apply_colormap(img, Colormap::Gray, 0, 255, opts);
+    ASSERT_EQ(rgba.channels(), 4);
+    EXPECT_EQ(rgba.at<std::uint8_t>(0, 0), 0);
+    EXPECT_EQ((&rgba.at<std::uint8_t>(0, 0))[3], 0);
+    EXPECT_EQ((&rgba.at<std::uint8_t>(0, 1))[3], 0);
+    EXPECT_EQ(pixel(rgba, 0, 100), (Color::U8C3{90, 90, 90}));
+    EXPECT_EQ((&rgba.at<std::uint8_t>(0, 100))[3], 255);
+}
+
+TEST(Colormap, IntegerImages)
+{
+    Image u16(1, 3, 1, Depth::U16);
+    u16.at<std::uint16_t>(0, 0) = 0;
+    u16.at<std::uint16_t>(0, 1) = 32768;
+    u16.at<std::uint16_t>(0, 2) = 65535;
+    auto out = apply_colormap(u16, Colormap::Gray, 0, 65535);
+    EXPECT_EQ(pixel(out, 0, 0), (Color::U8C3{0, 0, 0}));
+    EXPECT_EQ(pixel(out, 0, 1), (Color::U8C3{128, 128, 128}));
+    EXPECT_EQ(pixel(out, 0, 2), (Color::U8C3{255, 255, 255}));
+
+    Image u8(1, 2, 1, Depth::U8);
+    u8.at<std::uint8_t>(0, 1) = 200;
+    out = apply_colormap(u8, Colormap::Gray, 100, 200);
+    EXPECT_EQ(pixel(out, 0, 0), (Color::U8C3{0, 0, 0}));
+    EXPECT_EQ(pixel(out, 0, 1), (Color::U8C3{255, 255, 255}));
+}
+
+TEST(Colormap, WideRange)
+{
+    // max - min overflows a float
+    constexpr auto big = std::numeric_limits<float>::max();
+    const std::vector<std::pair<float, std::uint8_t>> expected{
+        {-big, 0},      {-big / 2, 64}, {0, 128},   {1e32F, 128},
+        {big / 4, 159}, {big / 2, 191}, {big, 255}};
+    Image img(1, expected.size(), 1, Depth::F32);
+    for (std::size_t x{0}; x < expected.size(); x++) {
+        img.at<float>(0, x) = expected[x].first;
+    }
+    auto out = apply_colormap(img, Colormap::Gray, -big, big);
+    for (std::size_t x{0}; x < expected.size(); x++) {
+        const auto v = expected[x].second;
+        EXPECT_EQ(pixel(out, 0, x), (Color::U8C3{v, v, v})) << x;
+    }
+}
+
+TEST(Colormap, Errors)
+{
+    Image img(2, 2, 1, Depth::F32);
+    auto gray = Colormap::Gray;
+    EXPECT_THROW(apply_colormap(img, gray, 1, 1), std::invalid_argument);
+    EXPECT_THROW(apply_colormap(img, gray, 1, 0), std::invalid_argument);
+    constexpr auto inf = std::numeric_limits<float>::infinity();
+    EXPECT_THROW(apply_colormap(img, gray, 0, inf), std::invalid_argument);
+    EXPECT_THROW(apply_colormap(img, gray, -inf, 0), std::invalid_argument);
+    EXPECT_THROW(apply_colormap(Image{}, gray, 0, 1), std::invalid_argument);
+    Image rgb(2, 2, 3, Depth::F32);
+    EXPECT_THROW(apply_colormap(rgb, gray, 0, 1), std::invalid_argument);
+    Image labels(2, 2, 1, Depth::U32);
+    EXPECT_THROW(apply_colormap(labels, gray, 0, 1), std::invalid_argument);
+    std::vector<Color::U8C3> lut(1);
+    EXPECT_THROW(apply_colormap(img, lut, 0, 1), std::invalid_argument);
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "educelab/core/utils/Compression.hpp"
+
+using namespace educelab;
+
+TEST(Compression, LZRoundTrip)
+{
+    // Repetitive data with a random tail
+    std::vector<std::byte> input;
+    for (int i = 0; i < 10'000; i++) {
+        input.emplace_back(static_cast<std::byte>(i % 7));
+    }
+    std::mt19937 gen(0);
+    for (int i = 0; i < 1'000; i++) {
+        input.emplace_back(static_cast<std::byte>(gen() & 0xFF));
+    }
+
+    auto compressed = lz_compress(input.data(), input.size());
+    EXPECT_LT(compressed.size(), input.size() / 4);
+
+    std::vector<std::byte> output(input.size());
+    lz_decompress(
+        compressed.data(), compressed.size(), output.data(), output.size());
+    EXPECT_EQ(output, input);
+}
+
+TEST(Compression, LZEmpty)
+{
+    auto compressed = lz_compress(nullptr, 0);
+    EXPECT_NO_THROW(
+        lz_decompress(compressed.data(), compressed.size(), nullptr, 0));
+}
+
+TEST(Compression, LZMalformed)
+{
+    std::vector<std::byte> input(100, std::byte{1});
+    auto compressed = lz_compress(input.data(), input.size());
+    std::vector<std::byte> output(input.size() - 1);
+    EXPECT_THROW(
+        lz_decompress(
+            compressed.data(), compressed.size(), output.data(), output.size()),
+        std::runtime_error);
+}
+
+TEST(Compression, DeltaRoundTrip)
+{
+    std::vector<std::uint32_t> input{0, 1, 2, 1, 0, 4'000'000'000, 5, 5};
+    std::vector<std::byte> encoded;
+    delta_encode(input.data(), input.size(), encoded);
+
+    std::vector<std::uint32_t> output(input.size());
+    delta_decode(encoded.data(), encoded.size(), output.data(), output.size());
+    EXPECT_EQ(output, input);
+
+    // Truncated
+    EXPECT_THROW(
+        delta_decode(encoded.data(), 3, output.data(), output.size()),
+        std::runtime_error);
+}
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <tuple>
+
 #include "educelab/core/types/Image.hpp"
 #include "educelab/core/utils/Iteration.hpp"
 
@@ -63,6 +65,25 @@ TEST(Image, PropertiesConstructorF32)
     }
 }
 
+TEST(Image, PropertiesConstructorU32)
+{
+    // Construct image
+    Image img(5, 10, 1, Depth::U32);
+    EXPECT_EQ(img.height(), 5);
+    EXPECT_EQ(img.width(), 10);
+    EXPECT_EQ(img.channels(), 1);
+    EXPECT_EQ(img.type(), Depth::U32);
+    EXPECT_EQ(img.size(), 5 * 10 * 4);
+
+    // Check zero initialization
+    for (const auto [y, x] : range2D(img.height(), img.width())) {
+        EXPECT_EQ(img.at<std::uint32_t>(y, x), std::uint32_t{0});
+    }
+
+    // Labels are not convertible
+    EXPECT_THROW(std::ignore = img.convert(Depth::F32), std::runtime_error);
+}
+
 TEST(Image, ConvertFromU8)
 {
     // Construct image
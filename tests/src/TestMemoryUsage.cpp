@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "educelab/core/types/Color.hpp"
+#include "educelab/core/types/Image.hpp"
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/types/PointCloud.hpp"
+#include "educelab/core/utils/MemoryUsage.hpp"
+
+using namespace educelab;
+
+namespace
+{
+struct Buffer {
+    std::size_t n{0};
+};
+}  // namespace
+
+template <>
+struct educelab::MemoryUsage<Buffer> {
+    static constexpr bool flat{false};
+    static auto bytes(const Buffer& b) -> std::size_t
+    {
+        return sizeof(Buffer) + b.n;
+    }
+};
+
+TEST(MemoryUsage, Standard)
+{
+    EXPECT_EQ(memory_usage(1.), sizeof(double));
+    EXPECT_EQ(memory_usage(Vec3f{}), sizeof(Vec3f));
+
+    std::vector<float> v(10);
+    v.reserve(20);
+    EXPECT_EQ(memory_usage(v), sizeof(v) + 20 * sizeof(float));
+
+    // Nested containers count each element's heap memory
+    std::vector<std::vector<int>> nested(3, std::vector<int>(4));
+    auto inner = memory_usage(nested[0]);
+    EXPECT_EQ(inner, sizeof(std::vector<int>) + 4 * sizeof(int));
+    EXPECT_EQ(
+        memory_usage(nested),
+        sizeof(nested) + nested.capacity() * sizeof(nested[0]) +
+            3 * (inner - sizeof(nested[0])));
+
+    // Short strings may be stored inline
+    std::string s(1000, 'a');
+    EXPECT_GE(memory_usage(s), sizeof(s) + 1000);
+    EXPECT_LE(memory_usage(std::string{"a"}), sizeof(s) + 16);
+
+    std::optional<std::vector<int>> opt;
+    EXPECT_EQ(memory_usage(opt), sizeof(opt));
+    opt = std::vector<int>(5);
+    EXPECT_EQ(memory_usage(opt), sizeof(opt) + 5 * sizeof(int));
+
+    auto ptr = std::make_shared<std::vector<int>>(5);
+    EXPECT_EQ(memory_usage(ptr), sizeof(ptr) + memory_usage(*ptr));
+    EXPECT_EQ(memory_usage(std::shared_ptr<int>{}), sizeof(ptr));
+
+    std::array<Buffer, 2> bufs{Buffer{10}, Buffer{20}};
+    EXPECT_EQ(memory_usage(bufs), sizeof(bufs) + 30);
+    std::vector<Buffer> bufList(2, Buffer{5});
+    EXPECT_EQ(memory_usage(bufList), memory_usage(std::vector<int>(0)) +
+                                         bufList.capacity() * sizeof(Buffer) +
+                                         10);
+}
+
+TEST(MemoryUsage, Image)
+{
+    EXPECT_EQ(memory_usage(Image{}), sizeof(Image));
+    Image img(10, 20, 3, Depth::U16);
+    EXPECT_EQ(memory_usage(img), sizeof(Image) + img.size());
+    EXPECT_EQ(img.memoryUsage(), memory_usage(img));
+}
+
+TEST(MemoryUsage, Color)
+{
+    EXPECT_EQ(memory_usage(Color{}), sizeof(Color));
+    EXPECT_EQ(memory_usage(Color{Color::F32C3{1, 0, 0}}), sizeof(Color));
+    // Hex codes are stored as U8C3
+    EXPECT_EQ(memory_usage(Color{"#ff0000"}), sizeof(Color));
+}
+
+TEST(MemoryUsage, Mesh)
+{
+    Mesh3f mesh;
+    auto empty = memory_usage(mesh);
+    EXPECT_EQ(empty, sizeof(Mesh3f));
+
+    mesh.insertVertex(0, 0, 0);
+    mesh.insertVertex(1, 0, 0);
+    mesh.insertVertex(1, 1, 0);
+    mesh.insertFace(0, 1, 2);
+    mesh.vertices().shrink_to_fit();
+    auto bytes = memory_usage(mesh);
+    // Vertices and face list
+    auto expected = empty + 3 * sizeof(Mesh3f::Vertex) +
+                    mesh.faces().capacity() * sizeof(Mesh3f::Face) +
+                    mesh.face(0).capacity() * sizeof(Mesh3f::index_type);
+    EXPECT_EQ(bytes, expected);
+
+    // Texture coordinates and per-face UV indices
+    mesh.insertUV(0, 0);
+    mesh.faceUVs().push_back({0, 0, 0});
+    mesh.uvs().shrink_to_fit();
+    mesh.faceUVs().shrink_to_fit();
+    expected += sizeof(Mesh3f::UV) + sizeof(Mesh3f::Face) +
+                mesh.faceUV(0).capacity() * sizeof(Mesh3f::index_type);
+    EXPECT_EQ(memory_usage(mesh), expected);
+
+    // Vertex colors
+    mesh.vertex(0).color = "#00ff00";
+    EXPECT_GE(memory_usage(mesh), expected);
+
+    // Shared pointers include the mesh
+    auto ptr = Mesh3f::New();
+    EXPECT_EQ(memory_usage(ptr), sizeof(ptr) + sizeof(Mesh3f));
+}
+
+TEST(MemoryUsage, PointCloud)
+{
+    PointCloud3f cloud({Vec3f{0, 0, 0}, Vec3f{1, 0, 0}});
+    cloud.points().shrink_to_fit();
+    EXPECT_EQ(memory_usage(cloud), sizeof(cloud) + 2 * sizeof(Vec3f));
+    cloud.enableColors();
+    cloud.colors().shrink_to_fit();
+    EXPECT_EQ(
+        memory_usage(cloud),
+        sizeof(cloud) + 2 * sizeof(Vec3f) + 2 * sizeof(Color::F32C3));
+}
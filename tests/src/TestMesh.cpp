@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+
 #include "educelab/core/types/Color.hpp"
 #include "educelab/core/types/Mesh.hpp"
 #include "educelab/core/utils/Iteration.hpp"
@@ -91,3 +95,89 @@ TEST(Mesh, AddVerticesAndFace)
     // Check face
     EXPECT_EQ(mesh.face(faceIdx), expectedFace);
 }
+
+TEST(Mesh, TextureCoordinates)
+{
+    Mesh3f mesh;
+    for (const auto& i : {0.F, 1.F, 2.F, 3.F}) {
+        mesh.insertVertex(i, i, i);
+    }
+    EXPECT_FALSE(mesh.hasUVs());
+    mesh.insertFace(0, 1, 2);
+    EXPECT_TRUE(mesh.faceUV(0).empty());
+
+    // Per-wedge
+    mesh.insertUV(0, 0);
+    mesh.insertUV(Mesh3f::UV{1, 0});
+    mesh.insertUV(1, 1);
+    auto f = mesh.insertFace({0, 2, 3}, {0, 1, 2});
+    EXPECT_TRUE(mesh.hasUVs());
+    EXPECT_EQ(mesh.numUVs(), 3);
+    EXPECT_EQ(mesh.uv(1), Mesh3f::UV(1, 0));
+    EXPECT_TRUE(mesh.faceUV(0).empty());
+    EXPECT_EQ(mesh.faceUV(f), Mesh3f::Face({0, 1, 2}));
+    EXPECT_EQ(mesh.faceUVs().size(), 2);
+    EXPECT_THROW(mesh.insertFace({0, 1, 2}, {0, 1}), std::invalid_argument);
+    EXPECT_THROW(std::ignore = mesh.faceUV(5), std::out_of_range);
+
+    // Per-vertex
+    mesh.setVertexUVs(
+        {Mesh3f::UV{0, 0}, Mesh3f::UV{1, 0}, Mesh3f::UV{1, 1},
+         Mesh3f::UV{0, 1}});
+    EXPECT_EQ(mesh.numUVs(), 4);
+    EXPECT_EQ(mesh.faceUV(1), mesh.face(1));
+    EXPECT_THROW(
+        mesh.setVertexUVs({Mesh3f::UV{0, 0}, Mesh3f::UV{1, 0}}),
+        std::invalid_argument);
+    EXPECT_EQ(mesh.numUVs(), 4);
+
+    mesh.clear();
+    EXPECT_FALSE(mesh.hasUVs());
+    EXPECT_TRUE(mesh.faceUVs().empty());
+}
+
+TEST(Mesh, IndexType)
+{
+    static_assert(std::is_same_v<Mesh3f::index_type, std::uint32_t>);
+    static_assert(
+        std::is_same_v<LargeMesh<float, 3>::index_type, std::uint64_t>);
+    EXPECT_EQ(sizeof(Mesh3f::Face::value_type), 4);
+
+    // Overflow on insert
+    using TinyMesh =
+        Mesh<float, 3, traits::DefaultVertexTraits<float, 3>, std::uint8_t>;
+    TinyMesh tiny;
+    for (std::size_t i{0}; i < 256; i++) {
+        EXPECT_EQ(tiny.insertVertex(0, 0, 0), i);
+    }
+    EXPECT_THROW(tiny.insertVertex(0, 0, 0), std::overflow_error);
+    EXPECT_EQ(tiny.numVertices(), 256);
+    EXPECT_THROW(tiny.insertFace(0, 1, 256), std::overflow_error);
+    EXPECT_THROW(tiny.insertFace(0, 1, -1), std::overflow_error);
+    EXPECT_EQ(tiny.numFaces(), 0);
+    EXPECT_THROW(TinyMesh::checkCapacity(257), std::overflow_error);
+    EXPECT_NO_THROW(TinyMesh::checkCapacity(256));
+
+    // Widen and narrow
+    Mesh3f mesh;
+    mesh.insertVertex(0, 0, 0);
+    mesh.insertVertex(1, 0, 0);
+    mesh.insertVertex(1, 1, 0);
+    mesh.insertUV(0, 0);
+    mesh.insertFace({0, 1, 2}, {0, 0, 0});
+    using Large = LargeMesh<float, 3>;
+    Large large(mesh);
+    EXPECT_EQ(large.numVertices(), 3);
+    EXPECT_EQ(large.vertex(2), mesh.vertex(2));
+    EXPECT_EQ(large.face(0), Large::Face({0, 1, 2}));
+    EXPECT_EQ(large.faceUV(0), Large::Face({0, 0, 0}));
+    Mesh3f narrow(large);
+    EXPECT_EQ(narrow.faces(), mesh.faces());
+    EXPECT_EQ(narrow.faceUVs(), mesh.faceUVs());
+
+    large.insertFace(0, 1, std::uint64_t{1} << 32);
+    EXPECT_THROW(Mesh3f{large}, std::overflow_error);
+    Mesh3f big;
+    big.vertices().resize(300);
+    EXPECT_THROW(TinyMesh{big}, std::overflow_error);
+}
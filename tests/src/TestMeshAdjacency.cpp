@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include <tuple>
+#include <vector>
+
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/utils/MeshAdjacency.hpp"
+
+#include "TestMeshUtils.hpp"
+
+using namespace educelab;
+
+namespace
+{
+template <class Range>
+auto to_vector(const Range& r) -> std::vector<std::uint32_t>
+{
+    return {r.begin(), r.end()};
+}
+}  // namespace
+
+TEST(MeshAdjacency, Counts)
+{
+    MeshAdjacency adj(test::make_grid(3, 3));
+    EXPECT_EQ(adj.numVertices(), 9);
+    EXPECT_EQ(adj.numFaces(), 8);
+    EXPECT_EQ(adj.numHalfEdges(), 24);
+    // Euler: V - E + F = 1 for a disk
+    EXPECT_EQ(adj.numEdges(), 16);
+    EXPECT_TRUE(adj.isManifold());
+}
+
+TEST(MeshAdjacency, OneRing)
+{
+    MeshAdjacency adj(test::make_grid(3, 3));
+    using V = std::vector<std::uint32_t>;
+    EXPECT_EQ(to_vector(adj.vertexNeighbors(4)), V({0, 1, 3, 5, 7, 8}));
+    EXPECT_EQ(to_vector(adj.vertexNeighbors(0)), V({1, 3, 4}));
+    EXPECT_EQ(to_vector(adj.vertexFaces(4)), V({0, 1, 3, 4, 6, 7}));
+    EXPECT_EQ(to_vector(adj.vertexFaces(2)), V({2}));
+
+    // Edges match neighbors
+    auto nbrs = adj.vertexNeighbors(4);
+    auto edges = adj.vertexEdges(4);
+    ASSERT_EQ(edges.size(), nbrs.size());
+    for (std::size_t i{0}; i < edges.size(); i++) {
+        auto e = adj.edge(edges[i]);
+        EXPECT_EQ(e[0] == 4 ? e[1] : e[0], nbrs[i]);
+    }
+    EXPECT_THROW(std::ignore = adj.vertexNeighbors(9), std::out_of_range);
+}
+
+TEST(MeshAdjacency, RepeatedVertices)
+{
+    // A quad which repeats vertex 1 has a self-edge (1, 1)
+    Mesh3f mesh;
+    mesh.insertVertex(0, 0, 0);
+    mesh.insertVertex(1, 0, 0);
+    mesh.insertVertex(0, 1, 0);
+    mesh.insertFace(0, 1, 1, 2);
+    MeshAdjacency adj(mesh);
+    using V = std::vector<std::uint32_t>;
+    EXPECT_EQ(adj.numEdges(), 4);
+    EXPECT_EQ(adj.faceEdges(0).size(), 4);
+    EXPECT_EQ(to_vector(adj.vertexNeighbors(1)), V({0, 2}));
+    EXPECT_EQ(to_vector(adj.vertexNeighbors(0)), V({1, 2}));
+    for (auto e : adj.vertexEdges(1)) {
+        EXPECT_NE(adj.edge(e)[0], adj.edge(e)[1]);
+    }
+    EXPECT_EQ(to_vector(adj.vertexFaces(1)), V({0}));
+
+    // Non-consecutive repeats are also listed once
+    mesh.insertFace(1, 0, 1, 2);
+    adj = MeshAdjacency(mesh);
+    EXPECT_EQ(to_vector(adj.vertexFaces(1)), V({0, 1}));
+    EXPECT_EQ(to_vector(adj.vertexFaces(0)), V({0, 1}));
+    EXPECT_EQ(to_vector(adj.vertexFaces(2)), V({0, 1}));
+}
+
+TEST(MeshAdjacency, FaceNeighbors)
+{
+    auto grid = test::make_grid(3, 3);
+    MeshAdjacency adj(grid);
+    using V = std::vector<std::uint32_t>;
+    EXPECT_EQ(adj.faceNeighbors(0), V({1, 3}));
+    EXPECT_EQ(adj.faceNeighbors(3), V({0, 2, 6}));
+
+    // Face edges are ordered by corner
+    const auto& f = grid.face(3);
+    auto edges = adj.faceEdges(3);
+    ASSERT_EQ(edges.size(), 3);
+    for (std::size_t c{0}; c < 3; c++) {
+        auto e = adj.edge(edges[c]);
+        auto a = std::min(f[c], f[(c + 1) % 3]);
+        auto b = std::max(f[c], f[(c + 1) % 3]);
+        EXPECT_EQ(e[0], a);
+        EXPECT_EQ(e[1], b);
+    }
+}
+
+TEST(MeshAdjacency, Boundary)
+{
+    MeshAdjacency adj(test::make_grid(3, 3));
+    EXPECT_EQ(adj.boundaryEdges().size(), 8);
+    for (auto e : adj.boundaryEdges()) {
+        EXPECT_EQ(adj.edgeFaces(e).size(), 1);
+    }
+    EXPECT_FALSE(adj.isBoundaryVertex(4));
+    EXPECT_TRUE(adj.isBoundaryVertex(0));
+}
+
+TEST(MeshAdjacency, NonManifold)
+{
+    // Three triangles which share edge (0, 1)
+    Mesh3f fin;
+    fin.insertVertex(0, 0, 0);
+    fin.insertVertex(1, 0, 0);
+    fin.insertVertex(0, 1, 0);
+    fin.insertVertex(0, -1, 0);
+    fin.insertVertex(0, 0, 1);
+    fin.insertFace(0, 1, 2);
+    fin.insertFace(1, 0, 3);
+    fin.insertFace(0, 1, 4);
+    MeshAdjacency adj(fin);
+    ASSERT_EQ(adj.nonManifoldEdges().size(), 1);
+    auto e = adj.edge(adj.nonManifoldEdges()[0]);
+    EXPECT_EQ(e, (MeshAdjacency<>::Edge{0, 1}));
+    EXPECT_FALSE(adj.isManifold());
+
+    // Two triangles which touch at a single vertex
+    Mesh3f bowtie;
+    bowtie.insertVertex(0, 0, 0);
+    bowtie.insertVertex(1, 1, 0);
+    bowtie.insertVertex(1, -1, 0);
+    bowtie.insertVertex(-1, 1, 0);
+    bowtie.insertVertex(-1, -1, 0);
+    bowtie.insertFace(0, 1, 2);
+    bowtie.insertFace(0, 3, 4);
+    MeshAdjacency bowAdj(bowtie);
+    EXPECT_TRUE(bowAdj.nonManifoldEdges().empty());
+    EXPECT_EQ(bowAdj.nonManifoldVertices(), std::vector<std::uint32_t>{0});
+}
+
+TEST(MeshAdjacency, Errors)
+{
+    Mesh3f mesh;
+    mesh.insertVertex(0, 0, 0);
+    mesh.insertFace(0, 1, 2);
+    EXPECT_THROW(MeshAdjacency{mesh}, std::out_of_range);
+
+    // Too many vertices for 8-bit indices
+    Mesh3f large;
+    for (int i = 0; i < 300; i++) {
+        large.insertVertex(0, 0, 0);
+    }
+    EXPECT_THROW(MeshAdjacency<std::uint8_t>{large}, std::overflow_error);
+}
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <tuple>
+
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/utils/MeshCacheOptimization.hpp"
+
+#include "TestMeshUtils.hpp"
+
+using namespace educelab;
+
+namespace
+{
+// Sorted list of faces, each rotated so its smallest index is first
+auto canonical_faces(const Mesh3f& mesh) -> std::vector<Mesh3f::Face>
+{
+    auto faces = mesh.faces();
+    for (auto& f : faces) {
+        std::rotate(f.begin(), std::min_element(f.begin(), f.end()), f.end());
+    }
+    std::sort(faces.begin(), faces.end());
+    return faces;
+}
+}  // namespace
+
+TEST(MeshCacheOptimization, ACMR)
+{
+    Mesh3f mesh;
+    for (int i = 0; i < 4; i++) {
+        mesh.insertVertex(0, 0, 0);
+    }
+    mesh.insertFace(0, 1, 2);
+    mesh.insertFace(2, 1, 3);
+    EXPECT_DOUBLE_EQ(compute_acmr(mesh), 2.0);
+    // FIFO eviction: Vertex 0 is evicted by the time it's used again
+    mesh.insertFace(3, 2, 0);
+    EXPECT_DOUBLE_EQ(compute_acmr(mesh, 3), 5.0 / 3.0);
+    EXPECT_DOUBLE_EQ(compute_acmr(mesh, 5), 4.0 / 3.0);
+}
+
+TEST(MeshCacheOptimization, VertexCache)
+{
+    auto mesh = test::make_grid(100, 100);
+    // Shuffle the faces to simulate an arbitrary order
+    std::mt19937 gen(7);
+    std::shuffle(mesh.faces().begin(), mesh.faces().end(), gen);
+    auto expected = canonical_faces(mesh);
+
+    auto stats = optimize_vertex_cache(mesh);
+    EXPECT_GT(stats.acmrBefore, 2.5);
+    EXPECT_LT(stats.acmrAfter, 0.8);
+    EXPECT_DOUBLE_EQ(stats.acmrAfter, compute_acmr(mesh));
+    // Faces and winding are preserved
+    EXPECT_EQ(canonical_faces(mesh), expected);
+}
+
+TEST(MeshCacheOptimization, VertexCacheLargeMesh)
+{
+    auto mesh = test::make_grid(20, 20);
+    LargeMesh<float, 3> large;
+    for (const auto& v : mesh.vertices()) {
+        large.insertVertex(v[0], v[1], v[2]);
+    }
+    for (const auto& f : mesh.faces()) {
+        large.insertFace(f[0], f[1], f[2]);
+    }
+
+    auto stats = optimize_vertex_cache(mesh);
+    auto largeStats = optimize_vertex_cache(large);
+    EXPECT_DOUBLE_EQ(largeStats.acmrAfter, stats.acmrAfter);
+    ASSERT_EQ(large.numFaces(), mesh.numFaces());
+    for (std::size_t f{0}; f < mesh.numFaces(); f++) {
+        EXPECT_TRUE(std::equal(
+            mesh.face(f).begin(), mesh.face(f).end(), large.face(f).begin()));
+    }
+}
+
+TEST(MeshCacheOptimization, VertexFetch)
+{
+    auto mesh = test::make_grid(20, 20);
+    std::mt19937 gen(7);
+    std::shuffle(mesh.faces().begin(), mesh.faces().end(), gen);
+    auto unused = mesh.insertVertex(-1.F, -1.F, -1.F);
+    auto orig = mesh;
+
+    auto remap = optimize_vertex_fetch(mesh);
+    ASSERT_EQ(remap.size(), orig.numVertices());
+    EXPECT_EQ(remap[unused], mesh.numVertices() - 1);
+
+    // Indices increase by at most one over the first use
+    std::size_t next{0};
+    for (std::size_t f{0}; f < mesh.numFaces(); f++) {
+        for (std::size_t c{0}; c < 3; c++) {
+            std::size_t v = mesh.face(f)[c];
+            EXPECT_LE(v, next);
+            next = std::max(next, v + 1);
+            EXPECT_EQ(mesh.vertex(v), orig.vertex(orig.face(f)[c]));
+        }
+    }
+}
+
+TEST(MeshCacheOptimization, FaceUVs)
+{
+    // Each corner's UV is its vertex's position
+    auto mesh = test::make_grid(20, 20);
+    std::mt19937 gen(7);
+    std::shuffle(mesh.faces().begin(), mesh.faces().end(), gen);
+    std::vector<Mesh3f::UV> uvs;
+    for (const auto& v : mesh.vertices()) {
+        uvs.emplace_back(v[0], v[1]);
+    }
+    mesh.setVertexUVs(uvs);
+
+    std::ignore = optimize_vertex_cache(mesh);
+    std::ignore = optimize_vertex_fetch(mesh);
+    ASSERT_EQ(mesh.faceUVs().size(), mesh.numFaces());
+    for (std::size_t f{0}; f < mesh.numFaces(); f++) {
+        for (std::size_t c{0}; c < 3; c++) {
+            const auto& uv = mesh.uv(mesh.faceUV(f)[c]);
+            const auto& v = mesh.vertex(mesh.face(f)[c]);
+            EXPECT_EQ(uv[0], v[0]);
+            EXPECT_EQ(uv[1], v[1]);
+        }
+    }
+}
+
+TEST(MeshCacheOptimization, Errors)
+{
+    Mesh3f mesh;
+    mesh.insertVertex(0, 0, 0);
+    mesh.insertFace(0, 0, 0, 0);
+    EXPECT_THROW(optimize_vertex_cache(mesh), std::invalid_argument);
+    auto tri = test::make_grid(2, 2);
+    EXPECT_THROW(optimize_vertex_cache(tri, 3), std::invalid_argument);
+
+    tri.insertFace(1, 2, 4);
+    auto orig = tri;
+    EXPECT_THROW(std::ignore = optimize_vertex_fetch(tri), std::out_of_range);
+    // The mesh is unchanged
+    EXPECT_EQ(tri.vertices(), orig.vertices());
+    EXPECT_EQ(tri.faces(), orig.faces());
+}
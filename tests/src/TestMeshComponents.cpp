@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/utils/Iteration.hpp"
+#include "educelab/core/utils/MeshComponents.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+
+using namespace educelab;
+
+namespace
+{
+// Add a triangulated grid patch to a mesh, offset along x
+void add_patch(Mesh3f& mesh, std::size_t n, float offset)
+{
+    auto base = mesh.numVertices();
+    for (const auto [y, x] : range2D(n, n)) {
+        mesh.insertVertex(float(x) + offset, float(y), 0.F);
+    }
+    for (const auto [y, x] : range2D(n - 1, n - 1)) {
+        auto v = base + y * n + x;
+        mesh.insertFace(v, v + 1, v + n + 1);
+        mesh.insertFace(v, v + n + 1, v + n);
+    }
+}
+}  // namespace
+
+TEST(MeshComponents, UnionFind)
+{
+    ConcurrentUnionFind uf(10);
+    uf.unite(3, 7);
+    uf.unite(7, 9);
+    uf.unite(1, 2);
+    EXPECT_EQ(uf.find(9), 3);
+    EXPECT_EQ(uf.find(2), 1);
+    EXPECT_EQ(uf.find(5), 5);
+    uf.unite(9, 2);
+    EXPECT_EQ(uf.find(7), 1);
+}
+
+TEST(MeshComponents, UnionFindConcurrent)
+{
+    // Concurrently link random pairs within each residue class mod 8
+    constexpr std::size_t n{200'000};
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs(n);
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<std::uint32_t> dist(0, n / 8 - 1);
+    for (std::size_t i{0}; i < n; i++) {
+        auto r = static_cast<std::uint32_t>(i % 8);
+        pairs[i] = {dist(gen) * 8 + r, dist(gen) * 8 + r};
+    }
+    for (std::uint32_t i{0}; i < 8; i++) {
+        pairs.emplace_back(i, i + 8);
+    }
+    set_num_threads(4);
+    ConcurrentUnionFind uf(n);
+    parallel_for(0, pairs.size(), [&](auto i) {
+        uf.unite(pairs[i].first, pairs[i].second);
+    });
+    set_num_threads(0);
+    for (std::uint32_t i{0}; i < n; i++) {
+        EXPECT_LE(uf.find(i), i);
+        EXPECT_EQ(uf.find(i) % 8, i % 8);
+    }
+}
+
+TEST(MeshComponents, ConnectedComponents)
+{
+    Mesh3f mesh;
+    add_patch(mesh, 4, 0);
+    mesh.insertVertex(-1, -1, -1);
+    add_patch(mesh, 2, 10);
+
+    auto comps = connected_components(mesh);
+    ASSERT_EQ(comps.numComponents, 3);
+    EXPECT_EQ(comps.vertexLabels[0], 0);
+    EXPECT_EQ(comps.vertexLabels[15], 0);
+    EXPECT_EQ(comps.vertexLabels[16], 1);
+    EXPECT_EQ(comps.vertexLabels[17], 2);
+    EXPECT_EQ(comps.faceLabels.front(), 0);
+    EXPECT_EQ(comps.faceLabels.back(), 2);
+    EXPECT_EQ(comps.vertexCounts, std::vector<std::size_t>({16, 1, 4}));
+    EXPECT_EQ(comps.faceCounts, std::vector<std::size_t>({18, 0, 2}));
+}
+
+TEST(MeshComponents, SplitComponents)
+{
+    Mesh3f mesh;
+    add_patch(mesh, 30, 0);
+    mesh.insertVertex(-1, -1, -1);
+    add_patch(mesh, 2, 100);
+    add_patch(mesh, 5, 200);
+
+    auto parts = split_components(mesh);
+    ASSERT_EQ(parts.size(), 3);
+    EXPECT_EQ(parts[0].numVertices(), 900);
+    EXPECT_EQ(parts[0].numFaces(), 29 * 29 * 2);
+    EXPECT_EQ(parts[1].numVertices(), 4);
+    EXPECT_EQ(parts[2].numFaces(), 32);
+    EXPECT_EQ(parts[1].vertex(3), Vec3f(101, 1, 0));
+    EXPECT_EQ(parts[2].face(0), Mesh3f::Face({0, 1, 6}));
+    EXPECT_EQ(parts[2].vertex(6), mesh.vertex(905 + 6));
+
+    // Discard small islands
+    parts = split_components(mesh, 10);
+    ASSERT_EQ(parts.size(), 2);
+    EXPECT_EQ(parts[1].numFaces(), 32);
+}
+
+TEST(MeshComponents, SplitComponentsUVs)
+{
+    // Each corner's UV is its vertex's position
+    Mesh3f mesh;
+    add_patch(mesh, 3, 0);
+    add_patch(mesh, 4, 100);
+    std::vector<Mesh3f::UV> uvs;
+    for (const auto& v : mesh.vertices()) {
+        uvs.emplace_back(v[0], v[1]);
+    }
+    mesh.setVertexUVs(uvs);
+    // The last face has no UVs
+    mesh.faceUVs().pop_back();
+
+    auto parts = split_components(mesh);
+    ASSERT_EQ(parts.size(), 2);
+    EXPECT_EQ(parts[0].numUVs(), 9);
+    EXPECT_EQ(parts[1].numUVs(), 16);
+    EXPECT_TRUE(parts[1].faceUV(parts[1].numFaces() - 1).empty());
+    for (const auto& part : parts) {
+        ASSERT_EQ(part.faceUVs().size(), part.numFaces());
+        for (std::size_t f{0}; f < part.numFaces(); f++) {
+            const auto& faceUV = part.faceUV(f);
+            for (std::size_t c{0}; c < faceUV.size(); c++) {
+                const auto& uv = part.uv(faceUV[c]);
+                const auto& v = part.vertex(part.face(f)[c]);
+                EXPECT_EQ(uv[0], v[0]);
+                EXPECT_EQ(uv[1], v[1]);
+            }
+        }
+    }
+}
@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/utils/Iteration.hpp"
+#include "educelab/core/utils/Math.hpp"
+#include "educelab/core/utils/MeshAdjacency.hpp"
+#include "educelab/core/utils/MeshDecimation.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+
+using namespace educelab;
+
+namespace
+{
+// Triangulated grid over [0, 1]^2 with height function z(x, y)
+template <class Func>
+auto make_surface(std::size_t res, Func z) -> Mesh3d
+{
+    Mesh3d mesh;
+    for (const auto [y, x] : range2D(res, res)) {
+        auto u = double(x) / double(res - 1);
+        auto v = double(y) / double(res - 1);
+        mesh.insertVertex(u, v, z(u, v));
+    }
+    for (const auto [y, x] : range2D(res - 1, res - 1)) {
+        auto i = y * res + x;
+        mesh.insertFace(i, i + 1, i + res + 1);
+        mesh.insertFace(i, i + res + 1, i + res);
+    }
+    return mesh;
+}
+
+void expect_valid(const Mesh3d& mesh)
+{
+    for (const auto& f : mesh.faces()) {
+        ASSERT_EQ(f.size(), 3);
+        for (auto idx : f) {
+            ASSERT_LT(idx, mesh.numVertices());
+        }
+        EXPECT_NE(f[0], f[1]);
+        EXPECT_NE(f[1], f[2]);
+        EXPECT_NE(f[0], f[2]);
+    }
+    MeshAdjacency adj(mesh);
+    EXPECT_TRUE(adj.isManifold());
+}
+}  // namespace
+
+TEST(MeshDecimation, Plane)
+{
+    // A plane has zero error everywhere, so it can be reduced to very few
+    // faces while keeping its boundary square
+    auto mesh = make_surface(20, [](auto, auto) { return 0.5; });
+    DecimateOptions opts;
+    opts.targetFaces = 8;
+    decimate(mesh, opts);
+    EXPECT_LE(mesh.numFaces(), 50);
+    expect_valid(mesh);
+    for (const auto& v : mesh.vertices()) {
+        EXPECT_NEAR(v[2], 0.5, 1e-9);
+        EXPECT_GE(v[0], -1e-9);
+        EXPECT_LE(v[0], 1 + 1e-9);
+    }
+}
+
+TEST(MeshDecimation, TargetFaces)
+{
+    auto mesh = make_surface(50, [](auto u, auto v) {
+        return 0.1 * std::sin(6 * u) * std::cos(4 * v);
+    });
+    DecimateOptions opts;
+    opts.targetFaces = 1000;
+    decimate(mesh, opts);
+    EXPECT_LE(mesh.numFaces(), 1000);
+    EXPECT_GE(mesh.numFaces(), 990);
+    expect_valid(mesh);
+
+    // Vertices stay close to the surface
+    for (const auto& v : mesh.vertices()) {
+        auto z = 0.1 * std::sin(6 * v[0]) * std::cos(4 * v[1]);
+        EXPECT_NEAR(v[2], z, 0.01);
+    }
+}
+
+TEST(MeshDecimation, MaxError)
+{
+    // Flat for u < 0.5, curved otherwise
+    auto mesh = make_surface(30, [](auto u, auto v) {
+        return u < 0.5 ? 0.0 : std::pow(u - 0.5, 2) + 0.1 * std::sin(5 * v);
+    });
+    auto before = mesh.numFaces();
+    DecimateOptions opts;
+    opts.maxError = 1e-12;
+    decimate(mesh, opts);
+    // Only the flat region can be collapsed without error
+    EXPECT_GT(mesh.numFaces(), before / 3);
+    EXPECT_LT(mesh.numFaces(), before);
+    expect_valid(mesh);
+}
+
+TEST(MeshDecimation, MaxErrorScale)
+{
+    // The error is in squared mesh units, so scaling the mesh by s and the
+    // threshold by s^2 gives the same result. Powers of 2 keep the
+    // arithmetic exact.
+    auto surface = [](auto u, auto v) {
+        return 0.1 * std::sin(6 * u) * std::cos(4 * v);
+    };
+    auto mesh = make_surface(40, surface);
+    auto scaled = mesh;
+    for (auto& v : scaled.vertices()) {
+        v *= 8.0;
+    }
+    DecimateOptions opts;
+    opts.maxError = 1e-5;
+    decimate(mesh, opts);
+    opts.maxError *= 64;
+    decimate(scaled, opts);
+    EXPECT_LT(mesh.numFaces(), 40 * 40);
+    EXPECT_GT(mesh.numFaces(), 100);
+    ASSERT_EQ(scaled.numFaces(), mesh.numFaces());
+    EXPECT_EQ(scaled.faces(), mesh.faces());
+
+    // A finer tessellation of the same surface stays within about the same
+    // distance of it
+    auto fine = make_surface(80, surface);
+    opts.maxError = 1e-5;
+    decimate(fine, opts);
+    for (const auto& v : fine.vertices()) {
+        EXPECT_NEAR(v[2], surface(v[0], v[1]), 0.01);
+    }
+}
+
+TEST(MeshDecimation, Parallel)
+{
+    auto mesh = make_surface(120, [](auto u, auto v) {
+        return 0.1 * std::sin(6 * u) * std::cos(4 * v);
+    });
+    DecimateOptions opts;
+    opts.targetFaces = mesh.numFaces() / 20;
+    // Force concurrent clusters regardless of the machine
+    set_num_threads(4);
+    decimate_parallel(mesh, opts, 27);
+    set_num_threads(0);
+    EXPECT_LE(mesh.numFaces(), opts.targetFaces);
+    EXPECT_GE(mesh.numFaces(), opts.targetFaces - 10);
+    expect_valid(mesh);
+    for (const auto& v : mesh.vertices()) {
+        auto z = 0.1 * std::sin(6 * v[0]) * std::cos(4 * v[1]);
+        EXPECT_NEAR(v[2], z, 0.02);
+    }
+
+    // More clusters than vertices
+    auto small = make_surface(10, [](auto, auto) { return 0.0; });
+    opts.targetFaces = 20;
+    decimate_parallel(small, opts, std::size_t{1} << 40);
+    EXPECT_LE(small.numFaces(), 20);
+    expect_valid(small);
+}
+
+TEST(MeshDecimation, FaceUVs)
+{
+    // Every face has its own UVs, numbered by face and corner
+    auto mesh = make_surface(30, [](auto u, auto v) {
+        return 0.1 * std::sin(6 * u) * std::cos(4 * v);
+    });
+    for (std::size_t f{0}; f < mesh.numFaces(); f++) {
+        Mesh3d::Face uvs;
+        for (std::size_t c{0}; c < 3; c++) {
+            uvs.push_back(mesh.insertUV(double(f), double(c)));
+        }
+        mesh.faceUVs().push_back(uvs);
+    }
+    DecimateOptions opts;
+    opts.targetFaces = mesh.numFaces() / 10;
+
+    for (const auto parallel : {false, true}) {
+        auto result = mesh;
+        if (parallel) {
+            set_num_threads(4);
+            decimate_parallel(result, opts, 8);
+            set_num_threads(0);
+        } else {
+            decimate(result, opts);
+        }
+        ASSERT_EQ(result.faceUVs().size(), result.numFaces());
+        EXPECT_EQ(result.numUVs(), mesh.numUVs());
+
+        // Surviving faces keep their own UVs in order
+        double prev{-1};
+        for (std::size_t f{0}; f < result.numFaces(); f++) {
+            const auto& uvs = result.faceUV(f);
+            ASSERT_EQ(uvs.size(), 3);
+            auto face = result.uv(uvs[0])[0];
+            EXPECT_GT(face, prev);
+            prev = face;
+            for (std::size_t c{0}; c < 3; c++) {
+                EXPECT_EQ(result.uv(uvs[c]), Mesh3d::UV(face, double(c)));
+            }
+        }
+    }
+}
+
+TEST(MeshDecimation, Errors)
+{
+    Mesh3d mesh;
+    mesh.insertVertex(0, 0, 0);
+    mesh.insertVertex(1, 0, 0);
+    mesh.insertVertex(1, 1, 0);
+    mesh.insertVertex(0, 1, 0);
+    mesh.insertFace(0, 1, 2, 3);
+    EXPECT_THROW(decimate(mesh, {}), std::invalid_argument);
+}
@@ -0,0 +1,415 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "educelab/core/io/MeshIO.hpp"
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/utils/Iteration.hpp"
+
+#include "TestMeshUtils.hpp"
+
+using namespace educelab;
+namespace fs = std::filesystem;
+
+namespace
+{
+auto write_text(const fs::path& path, const std::string& text) -> fs::path
+{
+    std::ofstream file(path, std::ios::binary);
+    file << text;
+    return path;
+}
+
+auto temp_path(const std::string& name) -> fs::path
+{
+    return fs::temp_directory_path() / ("educelab_core_TestMeshIO_" + name);
+}
+}  // namespace
+
+TEST(MeshIO, ReadOBJ)
+{
+    auto path = write_text(
+        temp_path("read.obj"),
+        "# Comment\n"
+        "o quad\n"
+        "v 0 0 0\n"
+        "v 1 0 0 1 0 0\n"
+        "v +1 1 0\r\n"
+        "v 0 1 0\n"
+        "vt 0 0\n"
+        "vn 0 0 1\n"
+        "s off\n"
+        "f 1/1 2/1 3/1\n"
+        "f 1//1 -2//-1 -1//-1\n"
+        "f 2 3 4 1\n");
+    auto mesh = read_mesh<Mesh3f>(path);
+    fs::remove(path);
+
+    ASSERT_EQ(mesh.numVertices(), 4);
+    ASSERT_EQ(mesh.numFaces(), 3);
+    EXPECT_EQ(mesh.vertex(2), Vec3f(1, 1, 0));
+    EXPECT_EQ(mesh.face(0), Mesh3f::Face({0, 1, 2}));
+    EXPECT_EQ(mesh.face(1), Mesh3f::Face({0, 2, 3}));
+    EXPECT_EQ(mesh.face(2), Mesh3f::Face({1, 2, 3, 0}));
+
+    // Colors
+    EXPECT_FALSE(mesh.vertex(0).color.has_value());
+    EXPECT_EQ(mesh.vertex(1).color, Color(Color::F32C3{1, 0, 0}));
+
+    // Normals
+    EXPECT_EQ(mesh.vertex(0).normal, Vec3f(0, 0, 1));
+    EXPECT_FALSE(mesh.vertex(1).normal.has_value());
+
+    // Texture coordinates
+    ASSERT_EQ(mesh.numUVs(), 1);
+    EXPECT_EQ(mesh.uv(0), Mesh3f::UV(0, 0));
+    EXPECT_EQ(mesh.faceUV(0), Mesh3f::Face({0, 0, 0}));
+    EXPECT_TRUE(mesh.faceUV(1).empty());
+    EXPECT_TRUE(mesh.faceUV(2).empty());
+}
+
+TEST(MeshIO, ReadOBJLarge)
+{
+    // Large enough to be split into several parallel chunks
+    constexpr std::size_t rows{200};
+    constexpr std::size_t cols{200};
+    std::string text;
+    for (const auto [y, x] : range2D(rows, cols)) {
+        text += "v " + std::to_string(x) + ' ' + std::to_string(y) + " 0.5\n";
+        // Interleave faces which use relative indices
+        if (x > 0 and y > 0) {
+            text += "f -1 -2 -" + std::to_string(cols + 2) + " -" +
+                    std::to_string(cols + 1) + '\n';
+        }
+    }
+    auto path = write_text(temp_path("large.obj"), text);
+    auto mesh = read_mesh<Mesh3d>(path);
+    fs::remove(path);
+
+    ASSERT_EQ(mesh.numVertices(), rows * cols);
+    ASSERT_EQ(mesh.numFaces(), (rows - 1) * (cols - 1));
+    for (const auto [y, x] : range2D(rows, cols)) {
+        EXPECT_EQ(mesh.vertex(y * cols + x), Vec3d(x, y, 0.5));
+    }
+    std::size_t fIdx{0};
+    for (const auto [y, x] : range2D(std::size_t{1}, rows, 1, cols)) {
+        auto v = y * cols + x;
+        Mesh3d::Face expected(
+            {Mesh3d::toIndex(v), Mesh3d::toIndex(v - 1),
+             Mesh3d::toIndex(v - cols - 1), Mesh3d::toIndex(v - cols)});
+        EXPECT_EQ(mesh.face(fIdx++), expected);
+    }
+}
+
+TEST(MeshIO, ReadOBJErrors)
+{
+    auto path = write_text(temp_path("bad_index.obj"), "v 0 0 0\nf 1 2 3\n");
+    EXPECT_THROW(read_mesh<Mesh3f>(path), std::runtime_error);
+    write_text(path, "v 0 0\n");
+    EXPECT_THROW(read_mesh<Mesh3f>(path), std::runtime_error);
+    write_text(path, "v 0 0 0\nv 0 a 0\n");
+    EXPECT_THROW(read_mesh<Mesh3f>(path), std::runtime_error);
+    // Extra values aren't dropped
+    for (const auto* text :
+         {"v 0 0 0 1 0 0 1\n", "v 0 0 0 1 0\n", "vn 0 0 1 0\n",
+          "vt 0 0 0 0\n"}) {
+        write_text(path, text);
+        EXPECT_THROW(read_mesh<Mesh3f>(path), std::runtime_error) << text;
+    }
+    // The smallest int64 index isn't mistaken for a missing reference
+    for (const auto* corner :
+         {"-9223372036854775808", "1/-9223372036854775808",
+          "1//-9223372036854775808"}) {
+        write_text(
+            path, std::string("v 0 0 0\nvt 0 0\nvn 0 0 1\nf 1/1/1 1/1/1 ") +
+                      corner + "\n");
+        EXPECT_THROW(read_mesh<Mesh3f>(path), std::runtime_error) << corner;
+    }
+    fs::remove(path);
+
+    EXPECT_THROW(read_mesh<Mesh3f>("missing.obj"), std::runtime_error);
+    EXPECT_THROW(read_mesh<Mesh3f>("mesh.xyz"), std::invalid_argument);
+}
+
+TEST(MeshIO, WriteReadOBJ)
+{
+    auto mesh = test::make_grid<Mesh3f>(
+        10, 10,
+        [](std::size_t x, std::size_t y) {
+            return Vec3d{0.1F * x, 0.25F * y, 1.F / 3.F};
+        },
+        test::GridFaces::Quads);
+    test::set_vertex_attributes(
+        mesh, Vec3f{0, 0, 1}, Color::F32C3{0.5F, 0.F, 1.F});
+    std::vector<Mesh3f::UV> uvs;
+    for (const auto [y, x] : range2D(10, 10)) {
+        uvs.emplace_back(x / 9.F, 1.F - y / 9.F);
+    }
+    mesh.setVertexUVs(uvs);
+    // A face without texture coordinates
+    mesh.insertFace(0, 1, 10);
+
+    auto path = temp_path("roundtrip.obj");
+    write_mesh(path, mesh);
+    auto result = read_mesh<Mesh3f>(path);
+    fs::remove(path);
+
+    ASSERT_EQ(result.numVertices(), mesh.numVertices());
+    ASSERT_EQ(result.numFaces(), mesh.numFaces());
+    for (std::size_t i{0}; i < mesh.numVertices(); i++) {
+        EXPECT_EQ(result.vertex(i), mesh.vertex(i));
+        EXPECT_EQ(result.vertex(i).normal, mesh.vertex(i).normal);
+        EXPECT_EQ(result.vertex(i).color, mesh.vertex(i).color);
+    }
+    for (std::size_t i{0}; i < mesh.numFaces(); i++) {
+        EXPECT_EQ(result.face(i), mesh.face(i));
+        EXPECT_EQ(result.faceUV(i), mesh.faceUV(i));
+    }
+    EXPECT_EQ(result.uvs(), mesh.uvs());
+}
+
+namespace
+{
+auto make_grid(std::size_t rows, std::size_t cols) -> Mesh3f
+{
+    auto mesh = test::make_grid<Mesh3f>(
+        rows, cols, [](std::size_t x, std::size_t y) {
+            return Vec3d{0.5F * x, 0.25F * y, 0.1F * (x + y)};
+        });
+    test::set_vertex_attributes(
+        mesh, Vec3f{0, 0, 1}, Color::F32C3{0.5F, 0.F, 1.F});
+    return mesh;
+}
+}  // namespace
+
+TEST(MeshIO, WriteReadNative)
+{
+    auto mesh = make_grid(50, 40);
+    // Mixed face sizes
+    mesh.insertFace(0, 1, 41, 40);
+
+    auto path = temp_path("roundtrip.elmesh");
+    write_mesh(path, mesh);
+    auto result = read_mesh<Mesh3f>(path);
+
+    ASSERT_EQ(result.numVertices(), mesh.numVertices());
+    ASSERT_EQ(result.numFaces(), mesh.numFaces());
+    for (std::size_t i{0}; i < mesh.numVertices(); i++) {
+        EXPECT_EQ(result.vertex(i), mesh.vertex(i));
+        EXPECT_EQ(result.vertex(i).normal, mesh.vertex(i).normal);
+        EXPECT_EQ(result.vertex(i).color, mesh.vertex(i).color);
+    }
+    EXPECT_EQ(result.faces(), mesh.faces());
+
+    // Read into a different precision
+    auto resultD = read_mesh<Mesh3d>(path);
+    fs::remove(path);
+    EXPECT_EQ(resultD.vertex(41), Vec3d(0.5F, 0.25F, 0.2F));
+}
+
+TEST(MeshIO, WriteReadNativeEncoded)
+{
+    auto mesh = make_grid(300, 300);
+    MeshWriteOptions opts;
+    opts.quantizePositions = true;
+    opts.compressIndices = true;
+
+    auto path = temp_path("encoded.elmesh");
+    auto rawPath = temp_path("raw.elmesh");
+    write_mesh(path, mesh, opts);
+    write_mesh(rawPath, mesh);
+    EXPECT_LT(fs::file_size(path), fs::file_size(rawPath));
+    auto result = read_mesh<Mesh3f>(path);
+    fs::remove(path);
+    fs::remove(rawPath);
+
+    ASSERT_EQ(result.numVertices(), mesh.numVertices());
+    EXPECT_EQ(result.faces(), mesh.faces());
+    for (std::size_t i{0}; i < mesh.numVertices(); i++) {
+        // Max error is half a step: (150 / 65535) / 2 on the widest axis
+        for (std::size_t d{0}; d < 3; d++) {
+            EXPECT_NEAR(result.vertex(i)[d], mesh.vertex(i)[d], 1.2e-3);
+        }
+    }
+}
+
+TEST(MeshIO, WriteNativeMixedFaceSizes)
+{
+    // Face sizes which sum to 3 * numFaces must not be mistaken for a
+    // triangle mesh. Faces with fewer than 3 vertices can't be read back, so
+    // the writer rejects them instead of producing a corrupt file.
+    Mesh3f mesh;
+    mesh.insertVertex(0, 0, 0);
+    mesh.insertVertex(1, 0, 0);
+    mesh.insertVertex(1, 1, 0);
+    mesh.insertVertex(0, 1, 0);
+    mesh.insertFace({0, 1});
+    mesh.insertFace(0, 1, 2, 3);
+    auto path = temp_path("mixed.elmesh");
+    EXPECT_THROW(write_mesh(path, mesh), std::invalid_argument);
+
+    // Quads and triangles round-trip with their face sizes
+    mesh.faces().clear();
+    mesh.insertFace(0, 1, 2, 3);
+    mesh.insertFace(0, 1, 2);
+    mesh.insertFace(3, 2, 1, 0);
+    write_mesh(path, mesh);
+    auto result = read_mesh<Mesh3f>(path);
+    fs::remove(path);
+    EXPECT_EQ(result.faces(), mesh.faces());
+}
+
+TEST(MeshIO, ReadNativeErrors)
+{
+    auto path = write_text(temp_path("bad.elmesh"), "not a mesh file");
+    EXPECT_THROW(read_mesh<Mesh3f>(path), std::runtime_error);
+
+    // Truncated file
+    write_mesh(path, make_grid(10, 10));
+    fs::resize_file(path, fs::file_size(path) - 16);
+    EXPECT_THROW(read_mesh<Mesh3f>(path), std::runtime_error);
+
+    // Vertex and face counts which don't match the file are rejected before
+    // anything is allocated
+    for (const auto offset : {16, 24}) {
+        for (const auto count : {std::uint64_t{1} << 40, ~std::uint64_t{0}}) {
+            write_mesh(path, make_grid(10, 10));
+            std::fstream file(
+                path, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(offset);
+            file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            file.close();
+            EXPECT_THROW(read_mesh<Mesh3f>(path), std::runtime_error);
+        }
+    }
+    fs::remove(path);
+}
+
+TEST(MeshIO, ReadPLYASCII)
+{
+    auto path = write_text(
+        temp_path("read.ply"),
+        "ply\n"
+        "format ascii 1.0\n"
+        "comment Extra elements and properties are skipped\n"
+        "element material 1\n"
+        "property list uchar float coefficients\n"
+        "element vertex 4\n"
+        "property float x\n"
+        "property float y\n"
+        "property float z\n"
+        "property float confidence\n"
+        "property uchar red\n"
+        "property uchar green\n"
+        "property uchar blue\n"
+        "element face 2\n"
+        "property list uchar int vertex_indices\n"
+        "property int flags\n"
+        "end_header\n"
+        "3 0.1 0.2 0.3\n"
+        "0 0 0 1 255 0 0\n"
+        "1 0 0 1 0 255 0\n"
+        "1 1 0 1 0 0 255\n"
+        "0 1 0 1 1 2 3\n"
+        "3 0 1 2 7\n"
+        "4 0 1 2 3 7\n");
+    auto mesh = read_mesh<Mesh3f>(path);
+    fs::remove(path);
+
+    ASSERT_EQ(mesh.numVertices(), 4);
+    ASSERT_EQ(mesh.numFaces(), 2);
+    EXPECT_EQ(mesh.vertex(2), Vec3f(1, 1, 0));
+    EXPECT_EQ(mesh.vertex(1).color, Color(Color::U8C3{0, 255, 0}));
+    EXPECT_FALSE(mesh.vertex(0).normal.has_value());
+    EXPECT_EQ(mesh.face(0), Mesh3f::Face({0, 1, 2}));
+    EXPECT_EQ(mesh.face(1), Mesh3f::Face({0, 1, 2, 3}));
+}
+
+TEST(MeshIO, ReadPLYBigEndian)
+{
+    using Mesh2f = Mesh<float, 2>;
+    using Vec2f = Vec<float, 2>;
+    std::string body;
+    auto appendBE = [&](auto val) {
+        std::array<char, sizeof(val)> b;
+        std::memcpy(b.data(), &val, sizeof(val));
+        body.append(b.rbegin(), b.rend());
+    };
+    for (const auto [y, x] : range2D(2, 2)) {
+        appendBE(float(x));
+        appendBE(float(y));
+    }
+    body += char(3);
+    for (std::int32_t v : {0, 1, 3}) {
+        appendBE(v);
+    }
+    auto path = write_text(
+        temp_path("be.ply"),
+        "ply\n"
+        "format binary_big_endian 1.0\n"
+        "element vertex 4\n"
+        "property float x\n"
+        "property float y\n"
+        "element face 1\n"
+        "property list uchar int vertex_index\n"
+        "end_header\n" +
+            body);
+    auto mesh = read_mesh<Mesh2f>(path);
+    fs::remove(path);
+
+    ASSERT_EQ(mesh.numVertices(), 4);
+    EXPECT_EQ(mesh.vertex(3), Vec2f(1, 1));
+    ASSERT_EQ(mesh.numFaces(), 1);
+    EXPECT_EQ(mesh.face(0), Mesh2f::Face({0, 1, 3}));
+}
+
+TEST(MeshIO, WriteReadPLY)
+{
+    auto mesh = make_grid(30, 20);
+    mesh.insertFace(0, 1, 21, 20);
+
+    auto path = temp_path("roundtrip.ply");
+    write_mesh(path, mesh);
+    auto result = read_mesh<Mesh3f>(path);
+    fs::remove(path);
+
+    ASSERT_EQ(result.numVertices(), mesh.numVertices());
+    for (std::size_t i{0}; i < mesh.numVertices(); i++) {
+        EXPECT_EQ(result.vertex(i), mesh.vertex(i));
+        EXPECT_EQ(result.vertex(i).normal, mesh.vertex(i).normal);
+        // Colors are stored as 8-bit
+        EXPECT_EQ(result.vertex(i).color, Color(Color::U8C3{128, 0, 255}));
+    }
+    EXPECT_EQ(result.faces(), mesh.faces());
+}
+
+TEST(MeshIO, ReadPLYErrors)
+{
+    auto path = write_text(temp_path("bad.ply"), "ply\nformat ascii 1.0\n");
+    EXPECT_THROW(read_mesh<Mesh3f>(path), std::runtime_error);
+
+    write_text(
+        path,
+        "ply\nformat ascii 1.0\nelement vertex 1\nproperty float x\n"
+        "property float y\nproperty float z\nelement face 1\n"
+        "property list uchar int vertex_indices\nend_header\n"
+        "0 0 0\n3 0 1 2\n");
+    EXPECT_THROW(read_mesh<Mesh3f>(path), std::runtime_error);
+
+    // Truncated
+    write_mesh(path, make_grid(10, 10));
+    fs::resize_file(path, fs::file_size(path) - 16);
+    EXPECT_THROW(read_mesh<Mesh3f>(path), std::runtime_error);
+
+    // Element count larger than the file
+    write_text(
+        path,
+        "ply\nformat binary_little_endian 1.0\n"
+        "element vertex 1000000000000\nproperty float x\nproperty float y\n"
+        "property float z\nend_header\n");
+    EXPECT_THROW(read_mesh<Mesh3f>(path), std::runtime_error);
+    fs::remove(path);
+}
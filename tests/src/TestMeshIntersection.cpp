@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/utils/Iteration.hpp"
+#include "educelab/core/utils/MeshIntersection.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+
+#include "TestMeshUtils.hpp"
+
+using namespace educelab;
+
+namespace
+{
+// Grid position with bumpy heights
+struct BumpyGrid {
+    auto operator()(std::size_t x, std::size_t y) const -> Vec3d
+    {
+        auto z = std::sin(0.7 * x) * std::cos(0.3 * y);
+        return Vec3d{double(x), double(y), z};
+    }
+};
+}  // namespace
+
+TEST(MeshIntersection, Triangle)
+{
+    Mesh3d mesh;
+    mesh.insertVertex(0, 0, 0);
+    mesh.insertVertex(2, 0, 0);
+    mesh.insertVertex(0, 2, 0);
+    mesh.insertFace(0, 1, 2);
+    MeshBVH bvh(mesh);
+    EXPECT_EQ(bvh.numTriangles(), 1);
+
+    Ray<double> ray{Vec3d{0.5, 0.25, 2}, Vec3d{0, 0, -0.5}};
+    auto hit = bvh.intersect(ray);
+    ASSERT_TRUE(hit);
+    EXPECT_EQ(hit.face, 0);
+    EXPECT_DOUBLE_EQ(hit.distance, 4);
+    EXPECT_DOUBLE_EQ(hit.barycentric[0], 0.625);
+    EXPECT_DOUBLE_EQ(hit.barycentric[1], 0.25);
+    EXPECT_DOUBLE_EQ(hit.barycentric[2], 0.125);
+
+    // Back faces hit too
+    ray = {Vec3d{0.5, 0.25, -1}, Vec3d{0, 0, 1}};
+    hit = bvh.intersect(ray);
+    ASSERT_TRUE(hit);
+    EXPECT_DOUBLE_EQ(hit.distance, 1);
+    EXPECT_DOUBLE_EQ(hit.barycentric[1], 0.25);
+
+    // Misses
+    EXPECT_FALSE(bvh.intersect({Vec3d{2, 2, 1}, Vec3d{0, 0, -1}}));
+    EXPECT_FALSE(bvh.intersect({Vec3d{0.5, 0.5, 1}, Vec3d{0, 0, 1}}));
+    EXPECT_FALSE(bvh.intersect({Vec3d{0.5, 0.5, 1}, Vec3d{0, 0, -1}, 0, 0.5}));
+    EXPECT_FALSE(bvh.intersect({Vec3d{0.5, 0.5, 1}, Vec3d{0, 0, -1}, 2}));
+    EXPECT_FALSE(bvh.intersect({Vec3d{0.5, 0.5, 1}, Vec3d{1, 0, 0}}));
+}
+
+TEST(MeshIntersection, Polygon)
+{
+    Mesh3f mesh;
+    mesh.insertVertex(0, 0, 0);
+    mesh.insertVertex(1, 0, 0);
+    mesh.insertVertex(1, 1, 0);
+    mesh.insertVertex(0, 1, 0);
+    mesh.insertFace(0, 1, 2, 3);
+    MeshBVH bvh(mesh);
+    EXPECT_EQ(bvh.numTriangles(), 2);
+
+    auto hit = bvh.intersect({Vec3f{0.25F, 0.75F, 1}, Vec3f{0, 0, -1}});
+    ASSERT_TRUE(hit);
+    EXPECT_EQ(hit.face, 0);
+    std::array<std::size_t, 3> tri{0, 2, 3};
+    EXPECT_EQ(hit.vertices, tri);
+
+    // Interpolating the vertices gives the hit point
+    Vec3f p;
+    for (std::size_t i{0}; i < 3; i++) {
+        for (std::size_t d{0}; d < 3; d++) {
+            p[d] += hit.barycentric[i] * mesh.vertex(hit.vertices[i])[d];
+        }
+    }
+    EXPECT_FLOAT_EQ(p[0], 0.25F);
+    EXPECT_FLOAT_EQ(p[1], 0.75F);
+}
+
+TEST(MeshIntersection, NegativeTMin)
+{
+    // A stack of triangles at z = 0, -1, ..., -9, all behind the origin
+    Mesh3d mesh;
+    for (std::size_t i{0}; i < 10; i++) {
+        auto z = -double(i);
+        auto v = mesh.insertVertex(0, 0, z);
+        mesh.insertVertex(2, 0, z);
+        mesh.insertVertex(0, 2, z);
+        mesh.insertFace(v, v + 1, v + 2);
+    }
+    // One leaf, so every triangle is tested in order
+    MeshBVH bvh(mesh, 16);
+    Ray<double> ray{Vec3d{0.5, 0.5, 5}, Vec3d{0, 0, 1}, -100};
+    auto hit = bvh.intersect(ray);
+    ASSERT_TRUE(hit);
+    EXPECT_EQ(hit.face, 9);
+    EXPECT_DOUBLE_EQ(hit.distance, -14);
+    EXPECT_TRUE(bvh.occluded(ray));
+    ray.tMin = -5;
+    EXPECT_FALSE(bvh.occluded(ray));
+}
+
+TEST(MeshIntersection, Watertight)
+{
+    // Rays through shared vertices and edges never slip through
+    auto mesh = test::make_grid<Mesh3f>(20, 20);
+    MeshBVH bvh(mesh);
+    std::vector<Ray<float>> rays;
+    for (const auto [y, x] : range2D(0.5F, 18.6F, 0.5F, 18.6F, 0.5F)) {
+        rays.push_back({Vec3f{x, y, 3}, Vec3f{0, 0, -1}});
+        rays.push_back({Vec3f{x - 1, y - 2, 3}, Vec3f{1, 2, -3}});
+        rays.push_back({Vec3f{x + 3, y + 1, -1}, Vec3f{-3, -1, 1}});
+    }
+    auto hits = bvh.intersect(rays);
+    for (std::size_t i{0}; i < rays.size(); i++) {
+        ASSERT_TRUE(hits[i]) << "Ray " << i << " missed";
+        EXPECT_NEAR(hits[i].distance, i % 3 == 0 ? 3 : 1, 1e-5);
+    }
+
+    // Also when the mesh is behind the origin
+    rays.clear();
+    for (const auto [y, x] : range2D(0.5F, 18.6F, 0.5F, 18.6F, 0.5F)) {
+        rays.push_back({Vec3f{x, y, -3}, Vec3f{0, 0, -1}, -10});
+        rays.push_back({Vec3f{x - 1, y - 2, -3}, Vec3f{-1, -2, -3}, -10});
+        rays.push_back({Vec3f{x + 3, y + 1, -1}, Vec3f{3, 1, -1}, -10});
+    }
+    hits = bvh.intersect(rays);
+    for (std::size_t i{0}; i < rays.size(); i++) {
+        ASSERT_TRUE(hits[i]) << "Ray " << i << " missed";
+        EXPECT_NEAR(hits[i].distance, i % 3 == 0 ? -3 : -1, 1e-5);
+    }
+}
+
+TEST(MeshIntersection, MatchesBruteForce)
+{
+    auto mesh = test::make_grid<Mesh3d>(40, 40, BumpyGrid{});
+    MeshBVH bvh(mesh);
+    EXPECT_GT(bvh.numNodes(), 1);
+    // A single leaf tests every triangle
+    MeshBVH brute(mesh, 2 * mesh.numFaces());
+    EXPECT_EQ(brute.numNodes(), 1);
+
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<double> pos(-5, 45);
+    std::uniform_real_distribution<double> dir(-1, 1);
+    std::vector<Ray<double>> rays(5000);
+    for (auto& r : rays) {
+        r.origin = Vec3d{pos(gen), pos(gen), 3};
+        r.direction = Vec3d{dir(gen), dir(gen), -1};
+    }
+    set_num_threads(4);
+    auto hits = bvh.intersect(rays);
+    set_num_threads(0);
+    std::size_t numHits{0};
+    for (std::size_t i{0}; i < rays.size(); i++) {
+        auto expected = brute.intersect(rays[i]);
+        ASSERT_EQ(bool(hits[i]), bool(expected));
+        if (expected) {
+            numHits++;
+            EXPECT_EQ(hits[i].face, expected.face);
+            EXPECT_DOUBLE_EQ(hits[i].distance, expected.distance);
+        }
+        EXPECT_EQ(bvh.occluded(rays[i]), bool(expected));
+    }
+    EXPECT_GT(numHits, 1000);
+
+    // Convenience function
+    auto direct = intersect(mesh, rays);
+    for (std::size_t i{0}; i < rays.size(); i++) {
+        EXPECT_EQ(direct[i].face, hits[i].face);
+    }
+}
+
+TEST(MeshIntersection, Errors)
+{
+    auto mesh = test::make_grid<Mesh3f>(3, 3);
+    EXPECT_THROW(MeshBVH(mesh, 0), std::invalid_argument);
+    mesh.insertFace(0, 1, 9);
+    EXPECT_THROW(MeshBVH{mesh}, std::out_of_range);
+
+    // Empty mesh
+    MeshBVH empty(Mesh3f{});
+    EXPECT_FALSE(empty.intersect({Vec3f{0, 0, 1}, Vec3f{0, 0, -1}}));
+    EXPECT_FALSE(empty.occluded({Vec3f{0, 0, 1}, Vec3f{0, 0, -1}}));
+}
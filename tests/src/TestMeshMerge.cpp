@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/utils/MeshMerge.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+
+#include "TestMeshUtils.hpp"
+
+using namespace educelab;
+
+namespace
+{
+auto make_grid(std::size_t res, double offset) -> Mesh3d
+{
+    auto mesh = test::make_grid<Mesh3d>(
+        res, res,
+        [offset](std::size_t x, std::size_t y) {
+            return Vec3d{x + offset, double(y), offset};
+        },
+        test::GridFaces::Quads);
+    test::set_vertex_attributes(mesh, Vec3d{0, 0, 1}, Color::U8C3{1, 2, 3});
+    return mesh;
+}
+
+void expect_appended(
+    const Mesh3d& result,
+    const Mesh3d& src,
+    std::size_t vOffset,
+    std::size_t fOffset)
+{
+    for (std::size_t v{0}; v < src.numVertices(); v++) {
+        EXPECT_EQ(result.vertex(vOffset + v), src.vertex(v));
+        EXPECT_EQ(result.vertex(vOffset + v).color, src.vertex(v).color);
+    }
+    for (std::size_t f{0}; f < src.numFaces(); f++) {
+        auto expected = src.face(f);
+        for (auto& v : expected) {
+            v += vOffset;
+        }
+        EXPECT_EQ(result.face(fOffset + f), expected);
+    }
+}
+}  // namespace
+
+TEST(MeshMerge, Append)
+{
+    auto dst = make_grid(4, 0);
+    auto src = make_grid(5, 10);
+    append(dst, src);
+    ASSERT_EQ(dst.numVertices(), 16 + 25);
+    ASSERT_EQ(dst.numFaces(), 9 + 16);
+    expect_appended(dst, make_grid(4, 0), 0, 0);
+    expect_appended(dst, src, 16, 9);
+    EXPECT_EQ(dst.vertex(20).normal, Vec3d(0, 0, 1));
+
+    // Append to empty
+    Mesh3d empty;
+    append(empty, src);
+    expect_appended(empty, src, 0, 0);
+}
+
+TEST(MeshMerge, AppendConvert)
+{
+    Mesh3f dst;
+    dst.insertVertex(0, 0, 0);
+    dst.vertex(0).normal = Vec3f{1, 0, 0};
+    auto src = make_grid(3, 0.5);
+    append(dst, src);
+    ASSERT_EQ(dst.numVertices(), 10);
+    EXPECT_EQ(dst.vertex(2), Vec3f(1.5F, 0, 0.5F));
+    EXPECT_EQ(dst.vertex(2).normal, Vec3f(0, 0, 1));
+    EXPECT_EQ(dst.vertex(2).color, Color(Color::U8C3{1, 2, 3}));
+    EXPECT_EQ(dst.face(0), Mesh3f::Face({1, 2, 5, 4}));
+}
+
+TEST(MeshMerge, UnifyNormals)
+{
+    auto dst = make_grid(3, 0);
+    Mesh3d src;
+    src.insertVertex(0, 0, 0);
+    append(dst, src);
+    for (const auto& v : dst.vertices()) {
+        EXPECT_FALSE(v.normal.has_value());
+    }
+}
+
+TEST(MeshMerge, Merge)
+{
+    std::vector<Mesh3d> meshes;
+    for (std::size_t i{0}; i < 50; i++) {
+        meshes.push_back(make_grid(2 + i % 7, double(i)));
+    }
+    // Empty and large inputs
+    meshes.insert(meshes.begin() + 3, Mesh3d{});
+    meshes.push_back(make_grid(80, 100));
+
+    set_num_threads(4);
+    auto merged = merge(meshes);
+    set_num_threads(0);
+
+    std::size_t vOffset{0};
+    std::size_t fOffset{0};
+    for (const auto& m : meshes) {
+        expect_appended(merged, m, vOffset, fOffset);
+        vOffset += m.numVertices();
+        fOffset += m.numFaces();
+    }
+    EXPECT_EQ(merged.numVertices(), vOffset);
+    EXPECT_EQ(merged.numFaces(), fOffset);
+
+    // Same as appending one at a time
+    Mesh3d appended;
+    for (const auto& m : meshes) {
+        append(appended, m);
+    }
+    EXPECT_EQ(appended.faces(), merged.faces());
+    EXPECT_TRUE(merge(std::vector<Mesh3d>{}).empty());
+}
+
+TEST(MeshMerge, TextureCoordinates)
+{
+    auto a = make_grid(3, 0);
+    Mesh3d b;
+    b.insertVertex(0, 0, 0);
+    b.insertVertex(1, 0, 0);
+    b.insertVertex(1, 1, 0);
+    b.insertUV(0, 0);
+    b.insertUV(0.5, 0.5);
+    b.insertFace({0, 1, 2}, {1, 0, 1});
+
+    auto merged = merge(std::vector<Mesh3d>{a, b, b});
+    ASSERT_EQ(merged.numUVs(), 4);
+    EXPECT_EQ(merged.uv(3), Mesh3d::UV(0.5, 0.5));
+    ASSERT_EQ(merged.faceUVs().size(), merged.numFaces());
+    for (std::size_t f{0}; f < a.numFaces(); f++) {
+        EXPECT_TRUE(merged.faceUV(f).empty());
+    }
+    EXPECT_EQ(merged.face(5), Mesh3d::Face({12, 13, 14}));
+    EXPECT_EQ(merged.faceUV(4), Mesh3d::Face({1, 0, 1}));
+    EXPECT_EQ(merged.faceUV(5), Mesh3d::Face({3, 2, 3}));
+
+    // Converted
+    Mesh3f dst;
+    append(dst, b);
+    EXPECT_EQ(dst.uv(1), Mesh3f::UV(0.5F, 0.5F));
+    EXPECT_EQ(dst.faceUV(0), Mesh3f::Face({1, 0, 1}));
+
+    b.faceUVs()[0][2] = 5;
+    EXPECT_THROW(append(dst, b), std::out_of_range);
+}
+
+TEST(MeshMerge, Errors)
+{
+    auto dst = make_grid(3, 0);
+    auto src = make_grid(3, 0);
+    src.insertFace(0, 1, 9);
+    EXPECT_THROW(append(dst, src), std::out_of_range);
+    EXPECT_EQ(dst.numVertices(), 9);
+    EXPECT_EQ(dst.numFaces(), 4);
+}
+
+TEST(MeshMerge, IndexType)
+{
+    // Widen
+    auto src = make_grid(3, 0);
+    using Large = LargeMesh<double, 3>;
+    Large large;
+    append(large, src);
+    EXPECT_EQ(large.face(3), Large::Face({4, 5, 8, 7}));
+
+    // Overflow leaves dst unchanged
+    using TinyMesh =
+        Mesh<double, 3, traits::DefaultVertexTraits<double, 3>, std::uint8_t>;
+    TinyMesh tiny;
+    append(tiny, make_grid(15, 0));
+    EXPECT_THROW(append(tiny, make_grid(6, 0)), std::overflow_error);
+    EXPECT_EQ(tiny.numVertices(), 225);
+    append(tiny, make_grid(5, 0));
+    EXPECT_EQ(tiny.numVertices(), 250);
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <tuple>
+
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/utils/Iteration.hpp"
+#include "educelab/core/utils/MeshNormals.hpp"
+
+using namespace educelab;
+
+namespace
+{
+// Unit cube with outward-facing quads
+auto make_cube() -> Mesh3d
+{
+    Mesh3d mesh;
+    for (const auto z : {0, 1}) {
+        for (const auto [y, x] : range2D(2, 2)) {
+            mesh.insertVertex(x, y, z);
+        }
+    }
+    mesh.insertFace(0, 2, 3, 1);
+    mesh.insertFace(4, 5, 7, 6);
+    mesh.insertFace(0, 1, 5, 4);
+    mesh.insertFace(2, 6, 7, 3);
+    mesh.insertFace(0, 4, 6, 2);
+    mesh.insertFace(1, 3, 7, 5);
+    return mesh;
+}
+}  // namespace
+
+TEST(MeshNormals, FaceNormals)
+{
+    auto normals = compute_face_normals(make_cube());
+    ASSERT_EQ(normals.size(), 6);
+    EXPECT_EQ(normals[0], Vec3d(0, 0, -1));
+    EXPECT_EQ(normals[1], Vec3d(0, 0, 1));
+    EXPECT_EQ(normals[4], Vec3d(-1, 0, 0));
+}
+
+TEST(MeshNormals, VertexNormalsCube)
+{
+    auto mesh = make_cube();
+    auto center = Vec3d{0.5, 0.5, 0.5};
+    for (auto w : {NormalWeighting::Uniform, NormalWeighting::Area,
+                   NormalWeighting::Angle}) {
+        compute_vertex_normals(mesh, w);
+        for (std::size_t v{0}; v < mesh.numVertices(); v++) {
+            ASSERT_TRUE(mesh.vertex(v).normal.has_value());
+            auto expected = (mesh.vertex(v) - center).unit();
+            for (std::size_t d{0}; d < 3; d++) {
+                auto n = mesh.vertex(v).normal.value();
+                EXPECT_NEAR(n[d], expected[d], 1e-9);
+            }
+        }
+    }
+}
+
+TEST(MeshNormals, VertexNormalsWeighting)
+{
+    // A large face in the XY plane and a small face in the XZ plane
+    Mesh3d mesh;
+    mesh.insertVertex(0, 0, 0);
+    mesh.insertVertex(10, 0, 0);
+    mesh.insertVertex(0, 10, 0);
+    mesh.insertVertex(0, 0, -1);
+    mesh.insertFace(0, 1, 2);
+    mesh.insertFace(0, 3, 1);
+    // Unreferenced vertex
+    mesh.insertVertex(5, 5, 5);
+
+    compute_vertex_normals(mesh, NormalWeighting::Uniform);
+    auto uniform = mesh.vertex(0).normal.value();
+    EXPECT_NEAR(uniform[1], -uniform[2], 1e-12);
+    EXPECT_FALSE(mesh.vertex(4).normal.has_value());
+
+    // Area weighting: The large face has 10x the area
+    compute_vertex_normals(mesh, NormalWeighting::Area);
+    auto area = mesh.vertex(0).normal.value();
+    EXPECT_NEAR(area[2], 10 * -area[1], 1e-12);
+
+    // Both corners at vertex 0 are right angles
+    compute_vertex_normals(mesh, NormalWeighting::Angle);
+    auto angle = mesh.vertex(0).normal.value();
+    EXPECT_NEAR(angle[1], uniform[1], 1e-12);
+    EXPECT_NEAR(angle[2], uniform[2], 1e-12);
+}
+
+TEST(MeshNormals, VertexNormalsLarge)
+{
+    // Large enough for parallel CSR construction
+    constexpr std::size_t rows{300};
+    constexpr std::size_t cols{300};
+    Mesh3f mesh;
+    for (const auto [y, x] : range2D(rows, cols)) {
+        mesh.insertVertex(x, y, 0);
+    }
+    for (const auto [y, x] : range2D(rows - 1, cols - 1)) {
+        auto v = y * cols + x;
+        mesh.insertFace(v, v + 1, v + cols + 1);
+        mesh.insertFace(v, v + cols + 1, v + cols);
+    }
+    compute_vertex_normals(mesh);
+    for (std::size_t v{0}; v < mesh.numVertices(); v++) {
+        EXPECT_EQ(mesh.vertex(v).normal, Vec3f(0, 0, 1));
+    }
+}
+
+TEST(MeshNormals, InvalidFaces)
+{
+    auto mesh = make_cube();
+    mesh.faces().push_back({0, 1, 8});
+    EXPECT_THROW(std::ignore = compute_face_normals(mesh), std::out_of_range);
+    EXPECT_THROW(compute_vertex_normals(mesh), std::out_of_range);
+    for (std::size_t v{0}; v < mesh.numVertices(); v++) {
+        EXPECT_FALSE(mesh.vertex(v).normal.has_value());
+    }
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <map>
+
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/utils/MeshPartitioning.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+
+#include "TestMeshUtils.hpp"
+
+using namespace educelab;
+
+namespace
+{
+void check_partition(
+    const Mesh3f& mesh,
+    const std::vector<MeshChunk<Mesh3f>>& chunks,
+    std::size_t target)
+{
+    // Every face is in exactly one chunk
+    std::vector<int> faceSeen(mesh.numFaces(), 0);
+    std::map<std::size_t, int> vertexChunks;
+    for (std::size_t c{0}; c < chunks.size(); c++) {
+        const auto& chunk = chunks[c];
+        if (c + 1 < chunks.size()) {
+            EXPECT_EQ(chunk.faces.size(), target);
+        }
+        ASSERT_EQ(chunk.mesh.numFaces(), chunk.faces.size());
+        ASSERT_EQ(chunk.mesh.numVertices(), chunk.vertices.size());
+        for (std::size_t f{0}; f < chunk.faces.size(); f++) {
+            faceSeen[chunk.faces[f]]++;
+            const auto& local = chunk.mesh.face(f);
+            const auto& global = mesh.face(chunk.faces[f]);
+            ASSERT_EQ(local.size(), global.size());
+            for (std::size_t i{0}; i < local.size(); i++) {
+                EXPECT_EQ(chunk.vertices[local[i]], global[i]);
+            }
+        }
+        for (std::size_t v{0}; v < chunk.vertices.size(); v++) {
+            EXPECT_EQ(chunk.mesh.vertex(v), mesh.vertex(chunk.vertices[v]));
+            vertexChunks[chunk.vertices[v]]++;
+        }
+    }
+    for (const auto& s : faceSeen) {
+        EXPECT_EQ(s, 1);
+    }
+
+    // Boundary vertices are exactly those used by more than one chunk
+    for (const auto& chunk : chunks) {
+        std::vector<std::size_t> expected;
+        for (std::size_t v{0}; v < chunk.vertices.size(); v++) {
+            if (vertexChunks[chunk.vertices[v]] > 1) {
+                expected.push_back(v);
+            }
+        }
+        EXPECT_EQ(chunk.boundary, expected);
+    }
+}
+}  // namespace
+
+TEST(MeshPartitioning, Partition)
+{
+    auto mesh = test::make_grid(64, 64);
+    constexpr std::size_t target{128};
+    for (auto curve : {SpaceFillingCurve::Hilbert, SpaceFillingCurve::Morton}) {
+        auto chunks = partition_mesh(mesh, target, curve);
+        ASSERT_EQ(chunks.size(), (mesh.numFaces() + target - 1) / target);
+        check_partition(mesh, chunks, target);
+
+        // Chunks are compact: 128 triangles cover about 8x8 grid cells
+        std::size_t totalVerts{0};
+        for (const auto& chunk : chunks) {
+            totalVerts += chunk.vertices.size();
+        }
+        EXPECT_LT(totalVerts / chunks.size(), 110);
+    }
+}
+
+TEST(MeshPartitioning, Parallel)
+{
+    auto mesh = test::make_grid(50, 50);
+    auto serial = partition_mesh(mesh, 100);
+    set_num_threads(4);
+    auto parallel = partition_mesh(mesh, 100);
+    set_num_threads(0);
+    check_partition(mesh, parallel, 100);
+    ASSERT_EQ(serial.size(), parallel.size());
+    for (std::size_t c{0}; c < serial.size(); c++) {
+        EXPECT_EQ(serial[c].faces, parallel[c].faces);
+        EXPECT_EQ(serial[c].boundary, parallel[c].boundary);
+    }
+}
+
+TEST(MeshPartitioning, SingleChunk)
+{
+    auto mesh = test::make_grid(5, 5);
+    auto chunks = partition_mesh(mesh, 1000);
+    ASSERT_EQ(chunks.size(), 1);
+    EXPECT_TRUE(chunks[0].boundary.empty());
+    EXPECT_EQ(chunks[0].mesh.numVertices(), mesh.numVertices());
+    check_partition(mesh, chunks, 1000);
+
+    EXPECT_TRUE(partition_mesh(Mesh3f{}, 10).empty());
+}
+
+TEST(MeshPartitioning, FaceUVs)
+{
+    // Each corner's UV is its vertex's position
+    auto mesh = test::make_grid(20, 20);
+    std::vector<Mesh3f::UV> uvs;
+    for (const auto& v : mesh.vertices()) {
+        uvs.emplace_back(v[0], v[1]);
+    }
+    mesh.setVertexUVs(uvs);
+
+    auto chunks = partition_mesh(mesh, 50);
+    check_partition(mesh, chunks, 50);
+    for (const auto& chunk : chunks) {
+        const auto& m = chunk.mesh;
+        EXPECT_EQ(m.numUVs(), m.numVertices());
+        ASSERT_EQ(m.faceUVs().size(), m.numFaces());
+        for (std::size_t f{0}; f < m.numFaces(); f++) {
+            for (std::size_t c{0}; c < 3; c++) {
+                const auto& uv = m.uv(m.faceUV(f)[c]);
+                const auto& v = m.vertex(m.face(f)[c]);
+                EXPECT_EQ(uv[0], v[0]);
+                EXPECT_EQ(uv[1], v[1]);
+            }
+        }
+    }
+}
+
+TEST(MeshPartitioning, Errors)
+{
+    auto mesh = test::make_grid(3, 3);
+    EXPECT_THROW(partition_mesh(mesh, 0), std::invalid_argument);
+    mesh.insertFace(0, 1, 9);
+    EXPECT_THROW(partition_mesh(mesh, 2), std::out_of_range);
+}
@@ -0,0 +1,251 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+#include "educelab/core/types/Image.hpp"
+#include "educelab/core/types/Mat.hpp"
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/utils/Iteration.hpp"
+#include "educelab/core/utils/MeshIntersection.hpp"
+#include "educelab/core/utils/MeshRasterization.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+
+using namespace educelab;
+
+namespace
+{
+using Mat4f = Mat<4, 4, float>;
+
+// Perspective projection looking down -z
+auto perspective(float fovY, float aspect, float near, float far) -> Mat4f
+{
+    auto f = 1.F / std::tan(fovY / 2);
+    Mat4f m;
+    m(0, 0) = f / aspect;
+    m(1, 1) = f;
+    m(2, 2) = (far + near) / (near - far);
+    m(2, 3) = 2 * far * near / (near - far);
+    m(3, 2) = -1;
+    return m;
+}
+
+auto face_id(const RasterImages& r, std::size_t y, std::size_t x)
+{
+    return r.faceIDs.at<std::uint32_t>(y, x);
+}
+}  // namespace
+
+TEST(MeshRasterization, Coverage)
+{
+    // Two triangles which exactly cover the screen. Pixel centers on the
+    // shared diagonal are covered by exactly one of them.
+    Mesh3f mesh;
+    mesh.insertVertex(-1, -1, 0);
+    mesh.insertVertex(1, -1, 0);
+    mesh.insertVertex(1, 1, 0);
+    mesh.insertVertex(-1, 1, 0);
+    mesh.insertFace(0, 1, 2);
+    mesh.insertFace(0, 2, 3);
+    auto r = rasterize(mesh, Mat4f::Eye(), 40, 40);
+    ASSERT_EQ(r.depth.height(), 40);
+    ASSERT_EQ(r.depth.width(), 40);
+    EXPECT_EQ(r.depth.type(), Depth::F32);
+    EXPECT_EQ(r.normals.channels(), 3);
+    EXPECT_EQ(r.faceIDs.type(), Depth::U32);
+    for (const auto [y, x] : range2D(40, 40)) {
+        EXPECT_FLOAT_EQ(r.depth.at<float>(y, x), 0.5F);
+        if (x + y < 39) {
+            EXPECT_EQ(face_id(r, y, x), 1);
+        } else if (x + y > 39) {
+            EXPECT_EQ(face_id(r, y, x), 0);
+        } else {
+            EXPECT_NE(face_id(r, y, x), RasterImages::NONE);
+        }
+        const auto* n = &r.normals.at<float>(y, x);
+        EXPECT_FLOAT_EQ(n[2], 1.F);
+    }
+
+    // Pixels outside a smaller triangle
+    mesh.faces().resize(1);
+    mesh.vertex(1)[0] = 0;
+    mesh.vertex(2)[0] = 0;
+    mesh.vertex(2)[1] = 0;
+    r = rasterize(mesh, Mat4f::Eye(), 8, 8);
+    EXPECT_EQ(face_id(r, 7, 1), 0);
+    EXPECT_EQ(face_id(r, 7, 4), RasterImages::NONE);
+    EXPECT_EQ(face_id(r, 0, 0), RasterImages::NONE);
+    EXPECT_TRUE(std::isinf(r.depth.at<float>(0, 0)));
+    EXPECT_FLOAT_EQ(r.normals.at<float>(0, 0), 0.F);
+}
+
+TEST(MeshRasterization, DepthTest)
+{
+    Mesh3f mesh;
+    // Far quad over the whole screen, drawn second
+    mesh.insertVertex(-0.5F, -0.5F, -0.5F);
+    mesh.insertVertex(0.5F, -0.5F, -0.5F);
+    mesh.insertVertex(0.5F, 0.5F, -0.5F);
+    mesh.insertVertex(-0.5F, 0.5F, -0.5F);
+    mesh.insertVertex(-1, -1, 0.5F);
+    mesh.insertVertex(1, -1, 0.5F);
+    mesh.insertVertex(1, 1, 0.5F);
+    mesh.insertVertex(-1, 1, 0.5F);
+    mesh.insertFace(0, 1, 2, 3);
+    mesh.insertFace(4, 5, 6, 7);
+    auto r = rasterize(mesh, Mat4f::Eye(), 64, 64);
+    EXPECT_EQ(face_id(r, 32, 32), 0);
+    EXPECT_FLOAT_EQ(r.depth.at<float>(32, 32), 0.25F);
+    EXPECT_EQ(face_id(r, 2, 2), 1);
+    EXPECT_FLOAT_EQ(r.depth.at<float>(2, 2), 0.75F);
+
+    // Same result in reverse order
+    std::swap(mesh.faces()[0], mesh.faces()[1]);
+    auto swapped = rasterize(mesh, Mat4f::Eye(), 64, 64);
+    EXPECT_EQ(face_id(swapped, 32, 32), 1);
+    EXPECT_EQ(face_id(swapped, 2, 2), 0);
+}
+
+TEST(MeshRasterization, Perspective)
+{
+    auto camera = perspective(1.5F, 1.F, 0.5F, 10.F);
+
+    // Plane at z = -2 fills the view
+    Mesh3f mesh;
+    mesh.insertVertex(-10, -10, -2);
+    mesh.insertVertex(10, -10, -2);
+    mesh.insertVertex(10, 10, -2);
+    mesh.insertVertex(-10, 10, -2);
+    mesh.insertFace(0, 1, 2, 3);
+    auto r = rasterize(mesh, camera, 32, 32);
+    auto zNdc = (camera(2, 2) * -2 + camera(2, 3)) / 2;
+    for (const auto [y, x] : range2D(32, 32)) {
+        ASSERT_EQ(face_id(r, y, x), 0);
+        EXPECT_NEAR(r.depth.at<float>(y, x), (zNdc + 1) / 2, 1e-6);
+    }
+
+    // A floor which crosses the near plane and the camera is clipped
+    Mesh3f floor;
+    floor.insertVertex(-5, -1, 5);
+    floor.insertVertex(5, -1, 5);
+    floor.insertVertex(5, -1, -5);
+    floor.insertVertex(-5, -1, -5);
+    floor.insertFace(0, 1, 2, 3);
+    r = rasterize(floor, camera, 32, 32);
+    EXPECT_EQ(face_id(r, 31, 16), 0);
+    EXPECT_EQ(face_id(r, 0, 16), RasterImages::NONE);
+    // Farther rows are deeper
+    EXPECT_LT(r.depth.at<float>(31, 16), r.depth.at<float>(20, 16));
+    const auto* n = &r.normals.at<float>(31, 16);
+    EXPECT_FLOAT_EQ(std::abs(n[1]), 1.F);
+
+    // Behind the camera
+    for (auto& v : floor.vertices()) {
+        v[2] = 5;
+    }
+    r = rasterize(floor, camera, 32, 32);
+    EXPECT_EQ(face_id(r, 31, 16), RasterImages::NONE);
+}
+
+TEST(MeshRasterization, Normals)
+{
+    // Vertex normals are interpolated and normalized
+    Mesh3f mesh;
+    mesh.insertVertex(-1, -1, 0);
+    mesh.insertVertex(1, -1, 0);
+    mesh.insertVertex(1, 1, 0);
+    mesh.insertVertex(-1, 1, 0);
+    mesh.insertFace(0, 1, 2, 3);
+    for (std::size_t v{0}; v < 4; v++) {
+        auto x = mesh.vertex(v)[0];
+        mesh.vertex(v).normal = Vec3f{x, 0, 1};
+    }
+    auto r = rasterize(mesh, Mat4f::Eye(), 16, 16);
+    for (const auto [y, x] : range2D(16, 16)) {
+        const auto* n = &r.normals.at<float>(y, x);
+        EXPECT_NEAR(n[0] * n[0] + n[1] * n[1] + n[2] * n[2], 1, 1e-6);
+        auto ndcX = (x + 0.5F) / 8 - 1;
+        EXPECT_NEAR(n[0] / n[2], ndcX, 1e-5);
+    }
+
+    // Back faces are culled on request
+    std::swap(mesh.faces()[0][1], mesh.faces()[0][3]);
+    RasterOptions opts;
+    r = rasterize(mesh, Mat4f::Eye(), 16, 16, opts);
+    EXPECT_EQ(face_id(r, 8, 8), 0);
+    opts.cullBackFaces = true;
+    r = rasterize(mesh, Mat4f::Eye(), 16, 16, opts);
+    EXPECT_EQ(face_id(r, 8, 8), RasterImages::NONE);
+}
+
+TEST(MeshRasterization, MatchesRayCasting)
+{
+    // Random overlapping triangles
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<float> pos(-1.2F, 1.2F);
+    std::uniform_real_distribution<float> depth(-0.9F, 0.9F);
+    Mesh3f mesh;
+    for (std::size_t f{0}; f < 300; f++) {
+        auto cx = pos(gen);
+        auto cy = pos(gen);
+        for (std::size_t i{0}; i < 3; i++) {
+            mesh.insertVertex(
+                cx + pos(gen) / 4, cy + pos(gen) / 4, depth(gen));
+        }
+        mesh.insertFace(3 * f, 3 * f + 1, 3 * f + 2);
+    }
+    constexpr std::size_t h{96};
+    constexpr std::size_t w{128};
+    auto r = rasterize(mesh, Mat4f::Eye(), h, w);
+
+    // Orthographic rays through the pixel centers
+    MeshBVH bvh(mesh);
+    std::size_t mismatches{0};
+    std::size_t covered{0};
+    for (const auto [y, x] : range2D(h, w)) {
+        auto nx = (float(x) + 0.5F) / w * 2 - 1;
+        auto ny = 1 - (float(y) + 0.5F) / h * 2;
+        auto hit = bvh.intersect({Vec3f{nx, ny, -2}, Vec3f{0, 0, 1}});
+        auto expected = hit ? hit.face : RasterImages::NONE;
+        mismatches += face_id(r, y, x) != expected ? 1 : 0;
+        covered += hit ? 1 : 0;
+        if (hit and face_id(r, y, x) == expected) {
+            EXPECT_NEAR(
+                r.depth.at<float>(y, x), (hit.distance - 2 + 1) / 2, 1e-4);
+        }
+    }
+    EXPECT_GT(covered, h * w / 2);
+    EXPECT_LT(mismatches, h * w / 100);
+
+    // Tiles and threads don't change the result
+    RasterOptions opts;
+    opts.tileSize = 8;
+    set_num_threads(4);
+    auto tiled = rasterize(mesh, Mat4f::Eye(), h, w, opts);
+    set_num_threads(0);
+    for (const auto [y, x] : range2D(h, w)) {
+        EXPECT_EQ(face_id(tiled, y, x), face_id(r, y, x));
+        EXPECT_EQ(tiled.depth.at<float>(y, x), r.depth.at<float>(y, x));
+    }
+}
+
+TEST(MeshRasterization, Errors)
+{
+    Mesh3f mesh;
+    mesh.insertVertex(0, 0, 0);
+    mesh.insertVertex(1, 0, 0);
+    mesh.insertVertex(1, 1, 0);
+    mesh.insertFace(0, 1, 2);
+    auto eye = Mat4f::Eye();
+    EXPECT_THROW(rasterize(mesh, eye, 0, 8), std::invalid_argument);
+    EXPECT_THROW(rasterize(mesh, eye, 8, 20000), std::invalid_argument);
+    RasterOptions opts;
+    opts.tileSize = 12;
+    EXPECT_THROW(rasterize(mesh, eye, 8, 8, opts), std::invalid_argument);
+    mesh.insertFace(0, 1, 5);
+    EXPECT_THROW(rasterize(mesh, eye, 8, 8), std::out_of_range);
+
+    // Empty mesh
+    auto r = rasterize(Mesh3f{}, eye, 4, 4);
+    EXPECT_EQ(face_id(r, 0, 0), RasterImages::NONE);
+}
@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/utils/Iteration.hpp"
+#include "educelab/core/utils/MeshReordering.hpp"
+
+using namespace educelab;
+
+TEST(MeshReordering, MortonEncode)
+{
+    using C2 = std::array<std::uint32_t, 2>;
+    using C3 = std::array<std::uint32_t, 3>;
+    EXPECT_EQ(morton_encode(C2{0, 0}), 0);
+    EXPECT_EQ(morton_encode(C2{1, 0}), 2);
+    EXPECT_EQ(morton_encode(C2{0, 1}), 1);
+    EXPECT_EQ(morton_encode(C2{3, 3}), 15);
+    EXPECT_EQ(morton_encode(C3{1, 1, 1}), 7);
+    EXPECT_EQ(morton_encode(C3{2, 0, 0}), 32);
+}
+
+TEST(MeshReordering, HilbertEncode)
+{
+    // The first 8^3 curve indices fill an 8x8x8 cube, and each step moves
+    // to an adjacent cell
+    constexpr std::uint32_t n{8};
+    std::vector<std::array<std::uint32_t, 3>> cells(n * n * n);
+    for (std::uint32_t z{0}; z < n; z++) {
+        for (const auto [y, x] : range2D(n, n)) {
+            std::array<std::uint32_t, 3> c{x, y, z};
+            auto code = hilbert_encode(c);
+            ASSERT_LT(code, cells.size());
+            cells[code] = c;
+        }
+    }
+    for (std::size_t i{1}; i < cells.size(); i++) {
+        std::uint32_t dist{0};
+        for (std::size_t d{0}; d < 3; d++) {
+            dist += std::max(cells[i][d], cells[i - 1][d]) -
+                    std::min(cells[i][d], cells[i - 1][d]);
+        }
+        EXPECT_EQ(dist, 1) << "Step " << i;
+    }
+}
+
+TEST(MeshReordering, ReorderSpatially)
+{
+    // Grid with shuffled vertex and face order
+    constexpr std::size_t n{64};
+    Mesh3f mesh;
+    std::vector<std::size_t> perm(n * n);
+    std::iota(perm.begin(), perm.end(), 0);
+    std::mt19937 gen(3);
+    std::shuffle(perm.begin(), perm.end(), gen);
+    std::vector<std::size_t> inv(perm.size());
+    for (std::size_t i{0}; i < perm.size(); i++) {
+        inv[perm[i]] = i;
+        mesh.insertVertex(float(perm[i] % n), float(perm[i] / n), 0.F);
+    }
+    for (const auto [y, x] : range2D(n - 1, n - 1)) {
+        auto v = y * n + x;
+        mesh.insertFace(inv[v], inv[v + 1], inv[v + n + 1], inv[v + n]);
+    }
+    std::shuffle(mesh.faces().begin(), mesh.faces().end(), gen);
+    auto orig = mesh;
+
+    // Average index distance between the corners of a face
+    auto spread = [](const Mesh3f& m) {
+        double sum{0};
+        for (const auto& f : m.faces()) {
+            auto [lo, hi] = std::minmax_element(f.begin(), f.end());
+            sum += double(*hi - *lo);
+        }
+        return sum / double(m.numFaces());
+    };
+    auto before = spread(mesh);
+
+    for (auto curve : {SpaceFillingCurve::Morton, SpaceFillingCurve::Hilbert}) {
+        mesh = orig;
+        auto remap = reorder_spatially(mesh, curve);
+        EXPECT_LT(spread(mesh), before / 10);
+
+        // Geometry and topology are preserved
+        for (std::size_t v{0}; v < orig.numVertices(); v++) {
+            EXPECT_EQ(mesh.vertex(remap[v]), orig.vertex(v));
+        }
+        std::vector<Mesh3f::Face> expected;
+        for (auto f : orig.faces()) {
+            for (auto& v : f) {
+                v = remap[v];
+            }
+            expected.push_back(f);
+        }
+        auto result = mesh.faces();
+        std::sort(expected.begin(), expected.end());
+        std::sort(result.begin(), result.end());
+        EXPECT_EQ(result, expected);
+
+        // Faces are sorted by their smallest vertex
+        std::size_t prev{0};
+        for (const auto& f : mesh.faces()) {
+            auto lo = *std::min_element(f.begin(), f.end());
+            EXPECT_GE(lo, prev);
+            prev = lo;
+        }
+    }
+}
+
+TEST(MeshReordering, FaceUVs)
+{
+    // Each corner's UV is its vertex's position
+    constexpr std::size_t n{32};
+    Mesh3f mesh;
+    for (const auto [y, x] : range2D(n, n)) {
+        mesh.insertVertex(float(x), float(y), 0.F);
+    }
+    for (const auto [y, x] : range2D(n - 1, n - 1)) {
+        auto v = y * n + x;
+        mesh.insertFace(v, v + 1, v + n + 1, v + n);
+    }
+    std::mt19937 gen(3);
+    std::shuffle(mesh.faces().begin(), mesh.faces().end(), gen);
+    std::vector<Mesh3f::UV> uvs;
+    for (const auto& v : mesh.vertices()) {
+        uvs.emplace_back(v[0], v[1]);
+    }
+    mesh.setVertexUVs(uvs);
+
+    std::ignore = reorder_spatially(mesh);
+    ASSERT_EQ(mesh.faceUVs().size(), mesh.numFaces());
+    for (std::size_t f{0}; f < mesh.numFaces(); f++) {
+        for (std::size_t c{0}; c < 4; c++) {
+            const auto& uv = mesh.uv(mesh.faceUV(f)[c]);
+            const auto& v = mesh.vertex(mesh.face(f)[c]);
+            EXPECT_EQ(uv[0], v[0]);
+            EXPECT_EQ(uv[1], v[1]);
+        }
+    }
+}
+
+TEST(MeshReordering, Errors)
+{
+    Mesh3f mesh;
+    mesh.insertVertex(1, 1, 1);
+    mesh.insertVertex(0, 0, 0);
+    mesh.insertVertex(1, 0, 0);
+    mesh.insertFace(0, 1, 3);
+    auto orig = mesh;
+    EXPECT_THROW(std::ignore = reorder_spatially(mesh), std::out_of_range);
+    // The mesh is unchanged
+    EXPECT_EQ(mesh.vertices(), orig.vertices());
+    EXPECT_EQ(mesh.faces(), orig.faces());
+
+    // Non-finite positions
+    mesh.face(0) = {0, 1, 2};
+    for (const auto val : {std::numeric_limits<float>::quiet_NaN(),
+                           std::numeric_limits<float>::infinity()}) {
+        mesh.vertex(2)[1] = val;
+        EXPECT_THROW(
+            std::ignore = reorder_spatially(mesh), std::invalid_argument);
+    }
+    EXPECT_EQ(mesh.vertex(0), orig.vertex(0));
+
+    // Bounds wider than the double range
+    Mesh3d wide;
+    wide.insertVertex(-1e308, 0, 0);
+    wide.insertVertex(1e308, 0, 0);
+    wide.insertVertex(0, 0, 0);
+    wide.insertFace(0, 1, 2);
+    auto remap = reorder_spatially(wide);
+    EXPECT_EQ(remap.size(), 3);
+}
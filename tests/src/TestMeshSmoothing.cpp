@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/utils/Iteration.hpp"
+#include "educelab/core/utils/Math.hpp"
+#include "educelab/core/utils/MeshSmoothing.hpp"
+
+using namespace educelab;
+
+namespace
+{
+// Triangulated UV sphere with optional noise along the radius
+auto make_sphere(std::size_t res, double noise) -> Mesh3d
+{
+    Mesh3d mesh;
+    mesh.insertVertex(0, 0, 1);
+    for (const auto [i, j] : range2D(std::size_t{1}, res, 0, 2 * res)) {
+        auto theta = PI<double> * double(i) / double(res);
+        auto phi = PI<double> * double(j) / double(res);
+        auto r = 1 + noise * ((i * 7 + j * 13) % 5 - 2.0) / 2.0;
+        mesh.insertVertex(
+            r * std::sin(theta) * std::cos(phi),
+            r * std::sin(theta) * std::sin(phi), r * std::cos(theta));
+    }
+    auto south = mesh.insertVertex(0, 0, -1);
+    const auto cols = 2 * res;
+    auto ring = [&](std::size_t i, std::size_t j) {
+        return 1 + (i - 1) * cols + (j % cols);
+    };
+    for (std::size_t j{0}; j < cols; j++) {
+        mesh.insertFace(0, ring(1, j), ring(1, j + 1));
+        mesh.insertFace(south, ring(res - 1, j + 1), ring(res - 1, j));
+    }
+    for (const auto [i, j] : range2D(std::size_t{1}, res - 1, 0, cols)) {
+        mesh.insertFace(ring(i, j), ring(i + 1, j), ring(i + 1, j + 1));
+        mesh.insertFace(ring(i, j), ring(i + 1, j + 1), ring(i, j + 1));
+    }
+    return mesh;
+}
+
+// Mean and max deviation of vertex radii from 1
+auto radius_stats(const Mesh3d& mesh) -> std::pair<double, double>
+{
+    double mean{0};
+    double maxDev{0};
+    for (const auto& v : mesh.vertices()) {
+        auto r = v.magnitude();
+        mean += r;
+        maxDev = std::max(maxDev, std::abs(r - 1));
+    }
+    return {mean / double(mesh.numVertices()), maxDev};
+}
+}  // namespace
+
+TEST(MeshSmoothing, Laplacian)
+{
+    auto mesh = make_sphere(20, 0.05);
+    SmoothOptions opts;
+    opts.iterations = 20;
+    smooth_laplacian(mesh, opts);
+    auto [mean, dev] = radius_stats(mesh);
+    // Laplacian smoothing shrinks the surface
+    EXPECT_LT(mean, 0.99);
+}
+
+TEST(MeshSmoothing, Taubin)
+{
+    auto noisy = make_sphere(20, 0.05);
+    auto before = radius_stats(noisy).second;
+    for (auto w : {SmoothingWeights::Uniform, SmoothingWeights::Cotangent}) {
+        auto mesh = noisy;
+        SmoothOptions opts;
+        opts.iterations = 20;
+        opts.weights = w;
+        smooth_taubin(mesh, opts);
+        auto [mean, dev] = radius_stats(mesh);
+        // Noise is removed without significant shrinkage
+        EXPECT_LT(dev, before / 2);
+        EXPECT_NEAR(mean, 1, 0.03);
+    }
+}
+
+TEST(MeshSmoothing, FixBoundary)
+{
+    Mesh3f mesh;
+    for (const auto [y, x] : range2D(5, 5)) {
+        auto z = (x + y) % 2 == 0 ? 0.1F : -0.1F;
+        mesh.insertVertex(float(x), float(y), z);
+    }
+    for (const auto [y, x] : range2D(4, 4)) {
+        auto v = y * 5 + x;
+        mesh.insertFace(v, v + 1, v + 6);
+        mesh.insertFace(v, v + 6, v + 5);
+    }
+    auto orig = mesh;
+    SmoothOptions opts;
+    opts.fixBoundary = true;
+    smooth_laplacian(mesh, opts);
+    EXPECT_EQ(mesh.vertex(0), orig.vertex(0));
+    EXPECT_EQ(mesh.vertex(14), orig.vertex(14));
+    EXPECT_NE(mesh.vertex(12), orig.vertex(12));
+    EXPECT_LT(std::abs(mesh.vertex(12)[2]), 0.1F);
+}
+
+TEST(MeshSmoothing, Errors)
+{
+    Mesh3f mesh;
+    mesh.insertVertex(0, 0, 0);
+    mesh.insertVertex(1, 0, 0);
+    mesh.insertVertex(1, 1, 0);
+    mesh.insertVertex(0, 1, 0);
+    mesh.insertFace(0, 1, 2, 3);
+    SmoothOptions opts;
+    EXPECT_NO_THROW(smooth_laplacian(mesh, opts));
+    opts.weights = SmoothingWeights::Cotangent;
+    EXPECT_THROW(smooth_laplacian(mesh, opts), std::invalid_argument);
+    opts.mu = 0.5;
+    EXPECT_THROW(smooth_taubin(mesh, opts), std::invalid_argument);
+}
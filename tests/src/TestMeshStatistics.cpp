@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/utils/Iteration.hpp"
+#include "educelab/core/utils/MeshStatistics.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+
+using namespace educelab;
+
+namespace
+{
+// Unit cube with outward-facing quads
+auto make_cube(double offset = 0) -> Mesh3d
+{
+    Mesh3d mesh;
+    for (const auto z : range(2)) {
+        for (const auto [y, x] : range2D(2, 2)) {
+            mesh.insertVertex(x + offset, y + offset, z + offset);
+        }
+    }
+    mesh.insertFace(0, 2, 3, 1);
+    mesh.insertFace(4, 5, 7, 6);
+    mesh.insertFace(0, 1, 5, 4);
+    mesh.insertFace(2, 6, 7, 3);
+    mesh.insertFace(0, 4, 6, 2);
+    mesh.insertFace(1, 3, 7, 5);
+    return mesh;
+}
+
+auto triangulate(const Mesh3d& mesh) -> Mesh3d
+{
+    Mesh3d result;
+    result.vertices() = mesh.vertices();
+    for (const auto& f : mesh.faces()) {
+        result.insertFace(f[0], f[1], f[2]);
+        result.insertFace(f[0], f[2], f[3]);
+    }
+    return result;
+}
+}  // namespace
+
+TEST(MeshStatistics, CompensatedSum)
+{
+    CompensatedSum<double> sum;
+    double naive{0};
+    sum += 1;
+    naive += 1;
+    for (int i = 0; i < 1000000; i++) {
+        sum += 1e-16;
+        naive += 1e-16;
+    }
+    EXPECT_DOUBLE_EQ(sum.value(), 1 + 1e-10);
+    EXPECT_EQ(naive, 1);
+
+    CompensatedSum<double> a;
+    CompensatedSum<double> b;
+    a += 1e16;
+    b += 1;
+    b += -1e16;
+    a.merge(b);
+    EXPECT_EQ(a.value(), 1);
+}
+
+TEST(MeshStatistics, Cube)
+{
+    for (const auto& mesh : {make_cube(), triangulate(make_cube())}) {
+        auto stats = compute_mesh_statistics(mesh);
+        EXPECT_EQ(stats.numFaces, mesh.numFaces());
+        EXPECT_DOUBLE_EQ(stats.area, 6);
+        EXPECT_DOUBLE_EQ(stats.volume, 1);
+        EXPECT_EQ(stats.numDegenerateFaces, 0);
+    }
+
+    // Quad edges are all unit length
+    auto stats = compute_mesh_statistics(make_cube());
+    EXPECT_EQ(stats.numEdges, 24);
+    EXPECT_DOUBLE_EQ(stats.minEdgeLength, 1);
+    EXPECT_DOUBLE_EQ(stats.maxEdgeLength, 1);
+    EXPECT_DOUBLE_EQ(stats.meanEdgeLength, 1);
+    EXPECT_DOUBLE_EQ(stats.stdDevEdgeLength, 0);
+    EXPECT_DOUBLE_EQ(stats.minFaceArea, 1);
+    EXPECT_DOUBLE_EQ(stats.maxFaceArea, 1);
+
+    // Triangle edges: two unit edges and one diagonal
+    stats = compute_mesh_statistics(triangulate(make_cube()));
+    EXPECT_EQ(stats.numEdges, 36);
+    EXPECT_DOUBLE_EQ(stats.maxEdgeLength, std::sqrt(2.0));
+    auto mean = (2 + std::sqrt(2.0)) / 3;
+    EXPECT_DOUBLE_EQ(stats.meanEdgeLength, mean);
+    auto var = (2 * (1 - mean) * (1 - mean) +
+                (std::sqrt(2.0) - mean) * (std::sqrt(2.0) - mean)) /
+               3;
+    EXPECT_NEAR(stats.stdDevEdgeLength, std::sqrt(var), 1e-12);
+    EXPECT_DOUBLE_EQ(stats.minFaceArea, 0.5);
+
+    // Inward-facing faces give a negative volume
+    auto inverted = make_cube();
+    for (auto& f : inverted.faces()) {
+        std::reverse(f.begin(), f.end());
+    }
+    EXPECT_DOUBLE_EQ(compute_mesh_statistics(inverted).volume, -1);
+}
+
+TEST(MeshStatistics, FarFromOrigin)
+{
+    auto stats = compute_mesh_statistics(triangulate(make_cube(1e7)));
+    EXPECT_DOUBLE_EQ(stats.area, 6);
+    EXPECT_DOUBLE_EQ(stats.volume, 1);
+}
+
+TEST(MeshStatistics, Degenerate)
+{
+    auto mesh = make_cube();
+    mesh.insertFace(0, 1, 1);
+    mesh.insertFace(0, 1, 3, 2, 0);
+    mesh.faces().push_back({0, 1});
+    mesh.insertFace(0, 1, 3);
+    auto stats = compute_mesh_statistics(mesh);
+    EXPECT_EQ(stats.numFaces, 10);
+    EXPECT_EQ(stats.numDegenerateFaces, 3);
+    EXPECT_EQ(stats.minFaceArea, 0);
+    // The two-vertex face has no edges
+    EXPECT_EQ(stats.numEdges, 35);
+
+    // Faces with fewer than 3 vertices are only counted as degenerate
+    Mesh3d lines;
+    lines.insertVertex(0, 0, 0);
+    lines.insertVertex(1, 0, 0);
+    lines.faces().push_back({0, 1});
+    lines.faces().emplace_back();
+    stats = compute_mesh_statistics(lines);
+    EXPECT_EQ(stats.numFaces, 2);
+    EXPECT_EQ(stats.numDegenerateFaces, 2);
+    EXPECT_EQ(stats.area, 0);
+    EXPECT_EQ(stats.minFaceArea, 0);
+    EXPECT_EQ(stats.numEdges, 0);
+
+    // Area threshold
+    mesh = triangulate(make_cube());
+    mesh.vertex(7) = Vec3d{1, 1, 1e-9};
+    stats = compute_mesh_statistics(mesh, 1e-6);
+    EXPECT_EQ(stats.numDegenerateFaces, 2);
+
+    mesh.insertFace(0, 1, 8);
+    EXPECT_THROW(compute_mesh_statistics(mesh), std::out_of_range);
+}
+
+TEST(MeshStatistics, Mesh2D)
+{
+    Mesh<float, 2> mesh;
+    mesh.insertVertex(0, 0);
+    mesh.insertVertex(3, 0);
+    mesh.insertVertex(3, 4);
+    mesh.insertVertex(0, 4);
+    mesh.insertFace(0, 1, 2);
+    mesh.insertFace(0, 2, 3);
+    auto stats = compute_mesh_statistics(mesh);
+    EXPECT_DOUBLE_EQ(stats.area, 12);
+    EXPECT_EQ(stats.volume, 0);
+    EXPECT_DOUBLE_EQ(stats.maxEdgeLength, 5);
+    EXPECT_DOUBLE_EQ(stats.minEdgeLength, 3);
+}
+
+TEST(MeshStatistics, Deterministic)
+{
+    // Closed surface: a grid of disjoint unit cubes
+    Mesh3d mesh;
+    constexpr std::size_t res{40};
+    auto cube = triangulate(make_cube());
+    for (const auto z : range(res)) {
+        for (const auto [y, x] : range2D(res, res)) {
+            auto base = mesh.numVertices();
+            for (const auto& v : cube.vertices()) {
+                mesh.insertVertex(
+                    v[0] + 2. * x, v[1] + 2. * y, v[2] + 2. * z);
+            }
+            for (const auto& f : cube.faces()) {
+                mesh.insertFace(f[0] + base, f[1] + base, f[2] + base);
+            }
+        }
+    }
+    auto serial = compute_mesh_statistics(mesh);
+    set_num_threads(4);
+    auto parallel = compute_mesh_statistics(mesh);
+    set_num_threads(0);
+    EXPECT_EQ(serial.area, parallel.area);
+    EXPECT_EQ(serial.volume, parallel.volume);
+    EXPECT_EQ(serial.meanEdgeLength, parallel.meanEdgeLength);
+    EXPECT_EQ(serial.stdDevEdgeLength, parallel.stdDevEdgeLength);
+    EXPECT_DOUBLE_EQ(parallel.area, 6. * res * res * res);
+    EXPECT_NEAR(parallel.volume, double(res * res * res), 1e-6);
+}
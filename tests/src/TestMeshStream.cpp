@@ -0,0 +1,309 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+
+#include "educelab/core/io/MeshIO.hpp"
+#include "educelab/core/io/MeshStream.hpp"
+#include "educelab/core/types/Mat.hpp"
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+
+#include "TestMeshUtils.hpp"
+
+using namespace educelab;
+namespace fs = std::filesystem;
+
+namespace
+{
+auto temp_path(const std::string& name) -> fs::path
+{
+    auto prefix = "educelab_core_TestMeshStream_";
+    return fs::temp_directory_path() / (prefix + name);
+}
+
+auto make_grid(std::size_t rows, std::size_t cols) -> Mesh3d
+{
+    auto mesh = test::make_grid<Mesh3d>(
+        rows, cols, [](std::size_t x, std::size_t y) {
+            return Vec3d{0.5 * x, 0.25 * y, 0.1 * (x + y)};
+        });
+    test::set_vertex_attributes(
+        mesh, Vec3d{0, 0, 1}, Color::U8C3{10, 20, 30});
+    // Mixed face sizes
+    mesh.insertFace(0, 1, cols + 1, cols);
+    return mesh;
+}
+
+// Read a whole mesh through the chunked reader, faces first
+auto read_chunked(const fs::path& path, std::size_t chunkSize) -> Mesh3d
+{
+    MeshStreamReader<Mesh3d> reader(path, chunkSize);
+    Mesh3d mesh;
+    std::vector<Mesh3d::Face> faces;
+    while (reader.readFaces(faces)) {
+        EXPECT_LE(faces.size(), chunkSize);
+        mesh.faces().insert(mesh.faces().end(), faces.begin(), faces.end());
+    }
+    std::vector<Mesh3d::Vertex> vertices;
+    while (reader.readVertices(vertices)) {
+        EXPECT_LE(vertices.size(), chunkSize);
+        mesh.vertices().insert(
+            mesh.vertices().end(), vertices.begin(), vertices.end());
+    }
+    EXPECT_EQ(mesh.numVertices(), reader.numVertices());
+    EXPECT_EQ(mesh.numFaces(), reader.numFaces());
+    return mesh;
+}
+
+void expect_equal(const Mesh3d& result, const Mesh3d& expected)
+{
+    ASSERT_EQ(result.numVertices(), expected.numVertices());
+    for (std::size_t i{0}; i < expected.numVertices(); i++) {
+        EXPECT_EQ(result.vertex(i), expected.vertex(i));
+        EXPECT_EQ(result.vertex(i).normal, expected.vertex(i).normal);
+    }
+    EXPECT_EQ(result.faces(), expected.faces());
+}
+}  // namespace
+
+TEST(MeshStream, ReadChunks)
+{
+    auto mesh = make_grid(20, 30);
+    MeshWriteOptions compressed;
+    compressed.compressIndices = true;
+    for (const auto& name : {"read.ply", "read.elmesh", "read_lz.elmesh"}) {
+        auto path = temp_path(name);
+        auto lz = name[5] == 'l';
+        write_mesh(path, mesh, lz ? compressed : MeshWriteOptions{});
+        auto result = read_chunked(path, 7);
+        fs::remove(path);
+        expect_equal(result, mesh);
+    }
+}
+
+TEST(MeshStream, ReadCompressedSegments)
+{
+    // More than one compressed index segment
+    auto mesh = test::make_grid<Mesh3d>(420, 420);
+    ASSERT_GT(3 * mesh.numFaces(), std::size_t{1} << 20);
+    MeshWriteOptions opts;
+    opts.compressIndices = true;
+    auto path = temp_path("segments.elmesh");
+    write_mesh(path, mesh, opts);
+    auto result = read_chunked(path, 100000);
+    fs::remove(path);
+    EXPECT_EQ(result.faces(), mesh.faces());
+}
+
+TEST(MeshStream, WriteChunks)
+{
+    auto mesh = make_grid(25, 16);
+    MeshWriteOptions compressed;
+    compressed.compressIndices = true;
+    for (const auto& name : {"write.ply", "write.elmesh", "write_lz.elmesh"}) {
+        auto path = temp_path(name);
+        auto lz = name[6] == 'l';
+        MeshStreamWriter<Mesh3d> writer(
+            path, {true, true}, lz ? compressed : MeshWriteOptions{});
+        const auto& verts = mesh.vertices();
+        const auto& faces = mesh.faces();
+        for (std::size_t i{0}; i < verts.size(); i += 50) {
+            auto end = verts.begin() + std::min(i + 50, verts.size());
+            writer.writeVertices({verts.begin() + i, end});
+        }
+        for (std::size_t i{0}; i < faces.size(); i += 64) {
+            auto end = faces.begin() + std::min(i + 64, faces.size());
+            writer.writeFaces({faces.begin() + i, end});
+        }
+        writer.close();
+        EXPECT_EQ(writer.numVertices(), mesh.numVertices());
+        EXPECT_EQ(writer.numFaces(), mesh.numFaces());
+
+        auto result = read_mesh<Mesh3d>(path);
+        fs::remove(path);
+        expect_equal(result, mesh);
+        // The native format stores F32C3 colors
+        Color color(Color::F32C3{10 / 255.F, 20 / 255.F, 30 / 255.F});
+        if (is_file_type(path, "ply")) {
+            color = Color::U8C3{10, 20, 30};
+        }
+        EXPECT_EQ(result.vertex(3).color, color);
+        EXPECT_FALSE(fs::exists(fs::path(path) += ".spill0"));
+    }
+}
+
+TEST(MeshStream, Transform)
+{
+    auto mesh = make_grid(10, 10);
+    auto in = temp_path("transform_in.ply");
+    auto out = temp_path("transform_out.elmesh");
+    write_mesh(in, mesh);
+
+    // Swap x and z, scale y, and translate
+    Mat<4, 4, double> m{0., 0., 1., 1., 0., 2., 0., 2.,
+                        1., 0., 0., 3., 0., 0., 0., 1.};
+    MeshStreamOptions opts;
+    opts.chunkSize = 13;
+    set_num_threads(4);
+    stream_transform<Mesh3d>(in, out, m, opts);
+    set_num_threads(0);
+    auto result = read_mesh<Mesh3d>(out);
+    ASSERT_EQ(result.numVertices(), mesh.numVertices());
+    for (std::size_t i{0}; i < mesh.numVertices(); i++) {
+        const auto& v = mesh.vertex(i);
+        EXPECT_EQ(result.vertex(i), Vec3d(v[2] + 1, 2 * v[1] + 2, v[0] + 3));
+        EXPECT_EQ(result.vertex(i).normal, Vec3d(1, 0, 0));
+    }
+    EXPECT_EQ(result.faces(), mesh.faces());
+
+    // Function
+    stream_transform<Mesh3d>(in, out, [](auto& v) { v[1] = -v[1]; });
+    result = read_mesh<Mesh3d>(out);
+    EXPECT_EQ(result.vertex(12)[1], -mesh.vertex(12)[1]);
+    fs::remove(in);
+    fs::remove(out);
+}
+
+TEST(MeshStream, Bounds)
+{
+    auto mesh = make_grid(40, 30);
+    auto path = temp_path("bounds.elmesh");
+    write_mesh(path, mesh);
+    MeshStreamOptions opts;
+    opts.chunkSize = 100;
+    auto [lo, hi] = stream_bounds<Mesh3d>(path, opts);
+    fs::remove(path);
+    EXPECT_EQ(lo, Vec3d(0, 0, 0));
+    EXPECT_EQ(hi, Vec3d(14.5, 9.75, 0.1 * 68));
+}
+
+TEST(MeshStream, Convert)
+{
+    auto mesh = make_grid(12, 9);
+    auto in = temp_path("convert_in.ply");
+    auto out = temp_path("convert_out.elmesh");
+    write_mesh(in, mesh);
+
+    // Double to float, drop normals, compress indices
+    MeshStreamOptions opts;
+    opts.chunkSize = 10;
+    opts.write.compressIndices = true;
+    stream_convert<Mesh3d, Mesh3f>(in, out, {false, true}, opts);
+    auto result = read_mesh<Mesh3f>(out);
+    fs::remove(in);
+    fs::remove(out);
+
+    ASSERT_EQ(result.numVertices(), mesh.numVertices());
+    for (std::size_t i{0}; i < mesh.numVertices(); i++) {
+        const auto& v = mesh.vertex(i);
+        EXPECT_EQ(
+            result.vertex(i), Vec3f(float(v[0]), float(v[1]), float(v[2])));
+        EXPECT_FALSE(result.vertex(i).normal.has_value());
+        EXPECT_EQ(
+            result.vertex(i).color,
+            Color(Color::F32C3{10 / 255.F, 20 / 255.F, 30 / 255.F}));
+    }
+    ASSERT_EQ(result.numFaces(), mesh.numFaces());
+    for (std::size_t f{0}; f < mesh.numFaces(); f++) {
+        EXPECT_TRUE(std::equal(
+            result.face(f).begin(), result.face(f).end(),
+            mesh.face(f).begin(), mesh.face(f).end()));
+    }
+}
+
+TEST(MeshStream, FilterFaces)
+{
+    auto mesh = make_grid(15, 15);
+    auto in = temp_path("filter_in.elmesh");
+    auto out = temp_path("filter_out.ply");
+    write_mesh(in, mesh);
+
+    MeshStreamOptions opts;
+    opts.chunkSize = 32;
+    auto kept = stream_filter_faces<Mesh3d>(
+        in, out, [](const auto& f) { return f[0] % 2 == 0; }, opts);
+    auto result = read_mesh<Mesh3d>(out);
+    fs::remove(in);
+    fs::remove(out);
+
+    std::vector<Mesh3d::Face> expected;
+    for (const auto& f : mesh.faces()) {
+        if (f[0] % 2 == 0) {
+            expected.push_back(f);
+        }
+    }
+    EXPECT_EQ(kept, expected.size());
+    EXPECT_EQ(result.numVertices(), mesh.numVertices());
+    EXPECT_EQ(result.faces(), expected);
+}
+
+TEST(MeshStream, Errors)
+{
+    EXPECT_THROW(MeshStreamReader<Mesh3d>("mesh.obj"), std::invalid_argument);
+    EXPECT_THROW(MeshStreamWriter<Mesh3d>("mesh.obj"), std::invalid_argument);
+
+    // Unsupported options don't truncate an existing file
+    auto path = temp_path("errors.elmesh");
+    auto mesh = make_grid(3, 3);
+    write_mesh(path, mesh);
+    const auto size = fs::file_size(path);
+    MeshWriteOptions quantized;
+    quantized.quantizePositions = true;
+    EXPECT_THROW(
+        MeshStreamWriter<Mesh3d>(path, {}, quantized), std::invalid_argument);
+    EXPECT_EQ(fs::file_size(path), size);
+
+    // Spill files are removed if one can't be created
+    auto blocked = path;
+    blocked += ".spill2";
+    fs::create_directory(blocked);
+    EXPECT_THROW(MeshStreamWriter<Mesh3d>{path}, std::runtime_error);
+    fs::remove(blocked);
+    for (const auto* ext : {".spill0", ".spill1"}) {
+        auto spill = path;
+        spill += ext;
+        EXPECT_FALSE(fs::exists(spill)) << spill;
+    }
+
+    MeshStreamWriter<Mesh3d> writer(path);
+    writer.writeVertices(mesh.vertices());
+    EXPECT_THROW(
+        writer.writeFaces({Mesh3d::Face{0, 1, 9}}), std::out_of_range);
+    writer.writeFaces(mesh.faces());
+    EXPECT_THROW(writer.writeVertices(mesh.vertices()), std::runtime_error);
+    writer.close();
+    EXPECT_EQ(read_mesh<Mesh3d>(path).faces(), mesh.faces());
+
+    // Face count which overflows the block size computations
+    {
+        std::fstream file(
+            path, std::ios::binary | std::ios::in | std::ios::out);
+        const auto count = ~std::uint64_t{0} / 3 + 1;
+        file.seekp(24);
+        file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    }
+    EXPECT_THROW(MeshStreamReader<Mesh3d>{path}, std::runtime_error);
+
+    // Missing normals
+    MeshStreamWriter<Mesh3d> normals(path, {true, false});
+    Mesh3d::Vertex v;
+    EXPECT_THROW(normals.writeVertices({v}), std::runtime_error);
+    fs::remove(path);
+
+    // Missing colors report the same error for every format
+    for (const auto& name : {"colors.ply", "colors.elmesh"}) {
+        auto colorPath = temp_path(name);
+        {
+            MeshStreamWriter<Mesh3d> colors(colorPath, {false, true});
+            try {
+                colors.writeVertices({v});
+                ADD_FAILURE() << "Expected std::runtime_error";
+            } catch (const std::runtime_error& e) {
+                EXPECT_STREQ(e.what(), "Vertex is missing a color");
+            }
+        }
+        fs::remove(colorPath);
+    }
+}
@@ -0,0 +1,231 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/utils/MeshAdjacency.hpp"
+#include "educelab/core/utils/MeshSubdivision.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+
+using namespace educelab;
+
+namespace
+{
+auto make_octahedron() -> Mesh3d
+{
+    Mesh3d mesh;
+    mesh.insertVertex(1, 0, 0);
+    mesh.insertVertex(-1, 0, 0);
+    mesh.insertVertex(0, 1, 0);
+    mesh.insertVertex(0, -1, 0);
+    mesh.insertVertex(0, 0, 1);
+    mesh.insertVertex(0, 0, -1);
+    mesh.insertFace(0, 2, 4);
+    mesh.insertFace(2, 1, 4);
+    mesh.insertFace(1, 3, 4);
+    mesh.insertFace(3, 0, 4);
+    mesh.insertFace(2, 0, 5);
+    mesh.insertFace(1, 2, 5);
+    mesh.insertFace(3, 1, 5);
+    mesh.insertFace(0, 3, 5);
+    return mesh;
+}
+
+auto make_cube() -> Mesh3d
+{
+    Mesh3d mesh;
+    for (std::size_t i{0}; i < 8; i++) {
+        mesh.insertVertex(
+            i & 1U ? 1. : -1., i & 2U ? 1. : -1., i & 4U ? 1. : -1.);
+    }
+    mesh.insertFace(0, 2, 3, 1);
+    mesh.insertFace(4, 5, 7, 6);
+    mesh.insertFace(0, 1, 5, 4);
+    mesh.insertFace(2, 6, 7, 3);
+    mesh.insertFace(0, 4, 6, 2);
+    mesh.insertFace(1, 3, 7, 5);
+    return mesh;
+}
+
+// Collects the chunks written by subdivide_stream()
+struct MeshCollector {
+    Mesh3d mesh;
+    std::size_t numChunks{0};
+    void writeVertices(const std::vector<Mesh3d::Vertex>& vertices)
+    {
+        auto& dst = mesh.vertices();
+        dst.insert(dst.end(), vertices.begin(), vertices.end());
+        numChunks++;
+    }
+    void writeFaces(const std::vector<Mesh3d::Face>& faces)
+    {
+        auto& dst = mesh.faces();
+        dst.insert(dst.end(), faces.begin(), faces.end());
+        numChunks++;
+    }
+};
+
+void expect_closed_manifold(const Mesh3d& mesh)
+{
+    MeshAdjacency adj(mesh);
+    EXPECT_TRUE(adj.isManifold());
+    EXPECT_TRUE(adj.boundaryEdges().empty());
+    auto euler = mesh.numVertices() + mesh.numFaces() - adj.numEdges();
+    EXPECT_EQ(euler, 2);
+}
+}  // namespace
+
+TEST(MeshSubdivision, LoopTriangle)
+{
+    Mesh3d mesh;
+    mesh.insertVertex(0, 0, 0);
+    mesh.insertVertex(4, 0, 0);
+    mesh.insertVertex(0, 4, 0);
+    mesh.insertFace(0, 1, 2);
+    auto fine = subdivide(mesh);
+    ASSERT_EQ(fine.numVertices(), 6);
+    ASSERT_EQ(fine.numFaces(), 4);
+
+    // Boundary vertices: 3/4 v + 1/8 (neighbors)
+    EXPECT_EQ(fine.vertex(0), Vec3d(0.5, 0.5, 0));
+    EXPECT_EQ(fine.vertex(1), Vec3d(3, 0.5, 0));
+    // Boundary edges: midpoints
+    for (std::size_t v{3}; v < 6; v++) {
+        const auto& p = fine.vertex(v);
+        EXPECT_TRUE(
+            p == Vec3d(2, 0, 0) or p == Vec3d(2, 2, 0) or p == Vec3d(0, 2, 0));
+    }
+
+    // Corner triangles keep the input orientation
+    const auto& f = fine.face(0);
+    EXPECT_EQ(f[0], 0);
+    EXPECT_EQ(fine.vertex(f[1]), Vec3d(2, 0, 0));
+    EXPECT_EQ(fine.vertex(f[2]), Vec3d(0, 2, 0));
+}
+
+TEST(MeshSubdivision, LoopClosed)
+{
+    auto mesh = make_octahedron();
+    auto fine = subdivide(mesh);
+    ASSERT_EQ(fine.numVertices(), 6 + 12);
+    ASSERT_EQ(fine.numFaces(), 32);
+    expect_closed_manifold(fine);
+
+    // Valence 4: beta = (5/8 - (3/8 + cos(pi/2)/4)^2) / 4
+    constexpr auto beta = (0.625 - 0.375 * 0.375) / 4;
+    EXPECT_NEAR(fine.vertex(0)[0], 1 - 4 * beta, 1e-12);
+    EXPECT_NEAR(fine.vertex(0)[1], 0, 1e-12);
+
+    // Odd vertices: 3/8 (a + b) + 1/8 (c + d). Edge (0, 2) is opposite 4
+    // and 5, which cancel.
+    for (std::size_t v{6}; v < fine.numVertices(); v++) {
+        const auto& p = fine.vertex(v);
+        auto r = p[0] * p[0] + p[1] * p[1] + p[2] * p[2];
+        EXPECT_NEAR(r, 2 * 0.375 * 0.375, 1e-12);
+    }
+
+    SubdivideOptions opts;
+    opts.levels = 3;
+    set_num_threads(4);
+    fine = subdivide(mesh, opts);
+    set_num_threads(0);
+    EXPECT_EQ(fine.numFaces(), 8 * 64);
+    expect_closed_manifold(fine);
+}
+
+TEST(MeshSubdivision, CatmullClark)
+{
+    auto mesh = make_cube();
+    SubdivideOptions opts;
+    opts.scheme = SubdivisionScheme::CatmullClark;
+    auto fine = subdivide(mesh, opts);
+    ASSERT_EQ(fine.numVertices(), 8 + 12 + 6);
+    ASSERT_EQ(fine.numFaces(), 24);
+    expect_closed_manifold(fine);
+
+    // Vertex point: (Q + 2R + (n - 3)S) / n
+    for (std::size_t d{0}; d < 3; d++) {
+        EXPECT_NEAR(fine.vertex(7)[d], 5. / 9., 1e-12);
+    }
+    // Face point of face 0 (z = -1)
+    EXPECT_EQ(fine.vertex(8 + 12), Vec3d(0, 0, -1));
+    // Quads: corner, edge, face, edge
+    const auto& f = fine.face(0);
+    ASSERT_EQ(f.size(), 4);
+    EXPECT_EQ(f[0], 0);
+    EXPECT_EQ(f[2], 20);
+    // Edge point: (a + b + F1 + F2) / 4
+    const auto& e = fine.vertex(f[1]);
+    EXPECT_DOUBLE_EQ(e[0], -0.75);
+    EXPECT_DOUBLE_EQ(e[1], 0);
+    EXPECT_DOUBLE_EQ(e[2], -0.75);
+
+    // Mixed polygons
+    Mesh3d mixed;
+    mixed.insertVertex(0, 0, 0);
+    mixed.insertVertex(1, 0, 0);
+    mixed.insertVertex(1, 1, 0);
+    mixed.insertVertex(0, 1, 0);
+    mixed.insertVertex(2, 0, 0);
+    mixed.insertFace(0, 1, 2, 3);
+    mixed.insertFace(1, 4, 2);
+    fine = subdivide(mixed, opts);
+    EXPECT_EQ(fine.numVertices(), 5 + 6 + 2);
+    EXPECT_EQ(fine.numFaces(), 7);
+    EXPECT_EQ(fine.vertex(11), Vec3d(0.5, 0.5, 0));
+
+    opts.levels = 2;
+    fine = subdivide(mesh, opts);
+    EXPECT_EQ(fine.numFaces(), 96);
+    expect_closed_manifold(fine);
+}
+
+TEST(MeshSubdivision, Stream)
+{
+    for (auto scheme :
+         {SubdivisionScheme::Loop, SubdivisionScheme::CatmullClark}) {
+        auto mesh = make_octahedron();
+        SubdivideOptions opts;
+        opts.scheme = scheme;
+        opts.levels = 2;
+        opts.chunkSize = 7;
+        auto expected = subdivide(mesh, opts);
+
+        MeshCollector writer;
+        subdivide_stream(mesh, writer, opts);
+        EXPECT_GT(writer.numChunks, 2);
+        ASSERT_EQ(writer.mesh.numVertices(), expected.numVertices());
+        for (std::size_t v{0}; v < expected.numVertices(); v++) {
+            EXPECT_EQ(writer.mesh.vertex(v), expected.vertex(v));
+        }
+        EXPECT_EQ(writer.mesh.faces(), expected.faces());
+    }
+}
+
+TEST(MeshSubdivision, Errors)
+{
+    auto cube = make_cube();
+    EXPECT_THROW(subdivide(cube), std::invalid_argument);
+
+    auto mesh = make_octahedron();
+    MeshCollector writer;
+    SubdivideOptions opts;
+    opts.chunkSize = 0;
+    EXPECT_THROW(subdivide_stream(mesh, writer, opts), std::invalid_argument);
+
+    mesh.insertFace(0, 1, 9);
+    EXPECT_THROW(subdivide(mesh), std::out_of_range);
+
+    // Too many vertices for 8-bit indices
+    using TinyMesh =
+        Mesh<double, 3, traits::DefaultVertexTraits<double, 3>, std::uint8_t>;
+    TinyMesh tiny;
+    tiny.insertVertex(1, 0, 0);
+    tiny.insertVertex(0, 1, 0);
+    tiny.insertVertex(0, 0, 1);
+    tiny.insertFace(0, 1, 2);
+    opts.levels = 3;
+    EXPECT_EQ(subdivide(tiny, opts).numVertices(), 45);
+    opts.levels = 5;
+    EXPECT_THROW(subdivide(tiny, opts), std::overflow_error);
+}
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+
+#include <limits>
+
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/utils/Iteration.hpp"
+#include "educelab/core/utils/MeshWelding.hpp"
+
+using namespace educelab;
+
+namespace
+{
+// Two grid tiles which share a duplicated seam at x == cols - 1
+auto make_tiles(std::size_t rows, std::size_t cols, float jitter) -> Mesh3f
+{
+    Mesh3f mesh;
+    for (const auto tile : {0, 1}) {
+        auto base = mesh.numVertices();
+        for (const auto [y, x] : range2D(rows, cols)) {
+            auto px = static_cast<float>(x + tile * (cols - 1));
+            // Offset the second tile's seam vertices slightly
+            auto dx = tile == 1 and x == 0 ? jitter : 0.F;
+            mesh.insertVertex(px + dx, static_cast<float>(y), 0.F);
+        }
+        for (const auto [y, x] : range2D(rows - 1, cols - 1)) {
+            auto v = base + y * cols + x;
+            mesh.insertFace(v, v + 1, v + cols + 1, v + cols);
+        }
+    }
+    return mesh;
+}
+}  // namespace
+
+TEST(MeshWelding, ExactDuplicates)
+{
+    auto mesh = make_tiles(4, 3, 0.F);
+    auto removed = weld_vertices(mesh);
+    EXPECT_EQ(removed, 4);
+    EXPECT_EQ(mesh.numVertices(), 20);
+    EXPECT_EQ(mesh.numFaces(), 12);
+
+    // Second tile's first face now uses the first tile's seam vertices
+    EXPECT_EQ(mesh.face(6), Mesh3f::Face({2, 12, 14, 5}));
+    for (const auto& f : mesh.faces()) {
+        for (auto idx : f) {
+            EXPECT_LT(idx, mesh.numVertices());
+        }
+    }
+}
+
+TEST(MeshWelding, Epsilon)
+{
+    // Seam vertices differ by less than epsilon
+    auto mesh = make_tiles(4, 3, 1e-4F);
+    EXPECT_EQ(weld_vertices(mesh), 0);
+    EXPECT_EQ(weld_vertices(mesh, 1e-5F), 0);
+    EXPECT_EQ(weld_vertices(mesh, 1e-3F), 4);
+    EXPECT_EQ(mesh.numVertices(), 20);
+    // Representatives keep their positions
+    EXPECT_EQ(mesh.vertex(2), Vec3f(2, 0, 0));
+}
+
+TEST(MeshWelding, AdjacentCells)
+{
+    // Vertices within epsilon which fall in neighboring grid cells
+    Mesh3d mesh;
+    mesh.insertVertex(0.999, 0.0, 0.0);
+    mesh.insertVertex(1.001, 0.0, 0.0);
+    mesh.insertVertex(-0.0001, -0.0001, -0.0001);
+    mesh.insertVertex(0.0001, 0.0001, 0.0001);
+    mesh.insertVertex(0.5, 0.5, 0.5);
+    EXPECT_EQ(weld_vertices(mesh, 0.01), 2);
+    ASSERT_EQ(mesh.numVertices(), 3);
+    EXPECT_EQ(mesh.vertex(1), Vec3d(-0.0001, -0.0001, -0.0001));
+}
+
+TEST(MeshWelding, TinyEpsilon)
+{
+    // Grid coordinates far beyond the int64 range are clamped
+    Mesh3d mesh;
+    mesh.insertVertex(1.0, 2.0, 3.0);
+    mesh.insertVertex(-1.0, 2.0, 3.0);
+    mesh.insertVertex(1.0, 2.0, 3.0);
+    mesh.insertVertex(1e-300, 0.0, 0.0);
+    mesh.insertVertex(1.5e-300, 0.0, 0.0);
+    mesh.insertVertex(1e300, -1e300, 0.0);
+    EXPECT_EQ(weld_vertices(mesh, 1e-300), 2);
+    ASSERT_EQ(mesh.numVertices(), 4);
+    EXPECT_EQ(mesh.vertex(0), Vec3d(1, 2, 3));
+    EXPECT_EQ(mesh.vertex(1), Vec3d(-1, 2, 3));
+    EXPECT_EQ(mesh.vertex(2), Vec3d(1e-300, 0, 0));
+    EXPECT_EQ(mesh.vertex(3), Vec3d(1e300, -1e300, 0));
+}
+
+TEST(MeshWelding, DegenerateFaces)
+{
+    Mesh3f mesh;
+    mesh.insertVertex(0, 0, 0);
+    mesh.insertVertex(1, 0, 0);
+    mesh.insertVertex(1, 0, 0);
+    mesh.insertVertex(0, 1, 0);
+    mesh.insertVertex(1, 1, 0);
+    mesh.insertFace(0, 1, 2);
+    mesh.insertFace(0, 2, 4, 3);
+    EXPECT_EQ(weld_vertices(mesh), 1);
+    ASSERT_EQ(mesh.numFaces(), 1);
+    EXPECT_EQ(mesh.face(0), Mesh3f::Face({0, 1, 3, 2}));
+}
+
+TEST(MeshWelding, FaceUVs)
+{
+    // Each corner's UV is its vertex's position
+    auto mesh = make_tiles(4, 3, 0.F);
+    // Collapses to an edge and is removed
+    mesh.insertFace(2, 12, 15, 5);
+    // Loses its repeated seam corner
+    mesh.insertFace(2, 12, 13, 16);
+    std::vector<Mesh3f::UV> uvs;
+    for (const auto& v : mesh.vertices()) {
+        uvs.emplace_back(v[0], v[1]);
+    }
+    mesh.setVertexUVs(uvs);
+    // No face UVs
+    mesh.insertFace(0, 1, 4);
+
+    EXPECT_EQ(weld_vertices(mesh), 4);
+    ASSERT_EQ(mesh.numFaces(), 14);
+    EXPECT_EQ(mesh.face(12), Mesh3f::Face({2, 12, 14}));
+    EXPECT_EQ(mesh.faceUV(12), Mesh3f::Face({2, 13, 16}));
+    EXPECT_TRUE(mesh.faceUV(13).empty());
+    for (std::size_t f{0}; f < 13; f++) {
+        const auto& face = mesh.face(f);
+        ASSERT_EQ(mesh.faceUV(f).size(), face.size());
+        for (std::size_t c{0}; c < face.size(); c++) {
+            const auto& uv = mesh.uv(mesh.faceUV(f)[c]);
+            const auto& v = mesh.vertex(face[c]);
+            EXPECT_EQ(uv[0], v[0]);
+            EXPECT_EQ(uv[1], v[1]);
+        }
+    }
+}
+
+TEST(MeshWelding, Large)
+{
+    // Large enough for parallel hashing and sorting
+    auto mesh = make_tiles(300, 300, 1e-6F);
+    auto removed = weld_vertices(mesh, 1e-5F);
+    EXPECT_EQ(removed, 300);
+    EXPECT_EQ(mesh.numVertices(), 2 * 300 * 300 - 300);
+}
+
+TEST(MeshWelding, Errors)
+{
+    auto mesh = make_tiles(2, 2, 0.F);
+    EXPECT_THROW(weld_vertices(mesh, -1.F), std::invalid_argument);
+    auto nonFinite = mesh;
+    nonFinite.vertex(0)[1] = std::numeric_limits<float>::quiet_NaN();
+    EXPECT_THROW(weld_vertices(nonFinite), std::invalid_argument);
+    nonFinite.vertex(0)[1] = std::numeric_limits<float>::infinity();
+    EXPECT_THROW(weld_vertices(nonFinite, 1.F), std::invalid_argument);
+    mesh.insertFace(0, 1, 100);
+    auto orig = mesh;
+    EXPECT_THROW(weld_vertices(mesh), std::out_of_range);
+    // The mesh is unchanged
+    EXPECT_EQ(mesh.vertices(), orig.vertices());
+    EXPECT_EQ(mesh.faces(), orig.faces());
+}
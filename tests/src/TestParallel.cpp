@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "educelab/core/utils/Parallel.hpp"
+
+using namespace educelab;
+
+TEST(Parallel, BlockRange)
+{
+    // Blocks cover the range without gaps
+    std::size_t expected{0};
+    for (std::size_t b{0}; b < 3; b++) {
+        auto [begin, end] = block_range(10, 3, b);
+        EXPECT_EQ(begin, expected);
+        expected = end;
+    }
+    EXPECT_EQ(expected, 10);
+
+    // Remainder is distributed to the first blocks
+    using Range = std::pair<std::size_t, std::size_t>;
+    EXPECT_EQ(block_range(10, 3, 0), Range(0, 4));
+    EXPECT_EQ(block_range(10, 3, 2), Range(7, 10));
+}
+
+TEST(Parallel, ParallelFor)
+{
+    std::vector<int> v(100'000, 0);
+    parallel_for(0, v.size(), [&](auto i) { v[i] += 1; });
+    EXPECT_EQ(std::accumulate(v.begin(), v.end(), 0), 100'000);
+}
+
+TEST(Parallel, ParallelForBlocks)
+{
+    std::vector<int> v(100'000, 0);
+    parallel_for_blocks(
+        10, v.size(),
+        [&](auto b, auto e) {
+            for (auto i = b; i < e; i++) {
+                v[i] = 1;
+            }
+        },
+        16);
+    EXPECT_EQ(std::accumulate(v.begin(), v.begin() + 10, 0), 0);
+    EXPECT_EQ(std::accumulate(v.begin(), v.end(), 0), 100'000 - 10);
+}
+
+TEST(Parallel, Nested)
+{
+    std::vector<int> v(64 * 64, 0);
+    parallel_for(
+        0, 64,
+        [&](auto y) {
+            parallel_for(0, 64, [&](auto x) { v[y * 64 + x] = 1; }, 1);
+        },
+        1);
+    EXPECT_EQ(std::accumulate(v.begin(), v.end(), 0), 64 * 64);
+}
+
+TEST(Parallel, NumThreads)
+{
+    set_num_threads(3);
+    EXPECT_EQ(num_threads(), 3);
+    set_num_threads(0);
+    EXPECT_GE(num_threads(), 1);
+}
+
+TEST(Parallel, Exceptions)
+{
+    auto func = [](auto i) {
+        if (i == 5000) {
+            throw std::runtime_error("error");
+        }
+    };
+    EXPECT_THROW(parallel_for(0, 10'000, func, 1), std::runtime_error);
+}
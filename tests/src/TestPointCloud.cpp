@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include "educelab/core/types/PointCloud.hpp"
+
+using namespace educelab;
+
+TEST(PointCloud, InsertPoint)
+{
+    PointCloud3f cloud;
+    EXPECT_TRUE(cloud.empty());
+    EXPECT_EQ(cloud.insertPoint(0, 1, 2), 0);
+    EXPECT_EQ(cloud.insertPoint(Vec3f{3, 4, 5}), 1);
+    EXPECT_EQ(cloud.size(), 2);
+    EXPECT_EQ(cloud.point(1), Vec3f(3, 4, 5));
+    EXPECT_FALSE(cloud.hasNormals());
+    EXPECT_FALSE(cloud.hasColors());
+    EXPECT_TRUE(cloud.normals().empty());
+    EXPECT_THROW(std::ignore = cloud.normal(0), std::out_of_range);
+    EXPECT_THROW(std::ignore = cloud.point(2), std::out_of_range);
+}
+
+TEST(PointCloud, Attributes)
+{
+    PointCloud3f cloud({Vec3f{0, 0, 0}, Vec3f{1, 0, 0}});
+    cloud.enableNormals();
+    ASSERT_TRUE(cloud.hasNormals());
+    EXPECT_EQ(cloud.normal(1), Vec3f(0, 0, 0));
+    cloud.normal(1) = {0, 0, 1};
+
+    // New points get default attributes
+    cloud.insertPoint(2, 0, 0);
+    ASSERT_EQ(cloud.normals().size(), 3);
+    EXPECT_EQ(cloud.normal(2), Vec3f(0, 0, 0));
+    EXPECT_FALSE(cloud.hasColors());
+
+    cloud.enableColors();
+    cloud.color(0) = {1.F, 0.5F, 0.F};
+    cloud.resize(5);
+    EXPECT_EQ(cloud.normals().size(), 5);
+    EXPECT_EQ(cloud.colors().size(), 5);
+    EXPECT_EQ(cloud.normal(1), Vec3f(0, 0, 1));
+
+    cloud.clearNormals();
+    EXPECT_FALSE(cloud.hasNormals());
+    EXPECT_TRUE(cloud.hasColors());
+    cloud.clear();
+    EXPECT_TRUE(cloud.empty());
+    EXPECT_TRUE(cloud.colors().empty());
+}
+
+TEST(PointCloud, EnableAttributesBeforeInsert)
+{
+    PointCloud3f cloud;
+    cloud.enableNormals();
+    cloud.enableColors();
+    EXPECT_TRUE(cloud.hasNormals());
+    EXPECT_TRUE(cloud.hasColors());
+
+    cloud.insertPoint(0, 0, 0);
+    cloud.insertPoint(1, 0, 0);
+    ASSERT_EQ(cloud.normals().size(), 2);
+    ASSERT_EQ(cloud.colors().size(), 2);
+    cloud.normal(1) = {0, 0, 1};
+
+    cloud.resize(4);
+    EXPECT_EQ(cloud.normals().size(), 4);
+    EXPECT_EQ(cloud.colors().size(), 4);
+    cloud.select({1});
+    ASSERT_EQ(cloud.normals().size(), 1);
+    EXPECT_EQ(cloud.normal(0), Vec3f(0, 0, 1));
+
+    // Attributes stay enabled when the cloud is resized to empty
+    cloud.resize(0);
+    EXPECT_TRUE(cloud.hasNormals());
+    cloud.insertPoint(2, 0, 0);
+    EXPECT_EQ(cloud.normals().size(), 1);
+
+    cloud.clear();
+    EXPECT_FALSE(cloud.hasNormals());
+    EXPECT_FALSE(cloud.hasColors());
+}
+
+TEST(PointCloud, Select)
+{
+    PointCloud3d cloud;
+    for (int i{0}; i < 5; i++) {
+        cloud.insertPoint(i, 0, 0);
+    }
+    cloud.enableColors();
+    for (std::size_t i{0}; i < 5; i++) {
+        cloud.color(i)[0] = static_cast<float>(i);
+    }
+    cloud.select({4, 1, 1});
+    ASSERT_EQ(cloud.size(), 3);
+    EXPECT_EQ(cloud.point(0), Vec3d(4, 0, 0));
+    EXPECT_EQ(cloud.point(2), Vec3d(1, 0, 0));
+    EXPECT_EQ(cloud.color(0)[0], 4.F);
+    EXPECT_EQ(cloud.color(1)[0], 1.F);
+    EXPECT_FALSE(cloud.hasNormals());
+    EXPECT_THROW(cloud.select({3}), std::out_of_range);
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "educelab/core/io/PointCloudIO.hpp"
+#include "educelab/core/types/PointCloud.hpp"
+
+using namespace educelab;
+namespace fs = std::filesystem;
+
+namespace
+{
+auto temp_path(const std::string& name) -> fs::path
+{
+    return fs::temp_directory_path() /
+           ("educelab_core_TestPointCloudIO_" + name);
+}
+}  // namespace
+
+TEST(PointCloudIO, WriteReadPLY)
+{
+    PointCloud3f cloud;
+    for (std::size_t i{0}; i < 1000; i++) {
+        auto x = static_cast<float>(i);
+        cloud.insertPoint(x, x * 0.5F, -x);
+    }
+    cloud.enableNormals();
+    cloud.enableColors();
+    for (std::size_t i{0}; i < cloud.size(); i++) {
+        cloud.normal(i) = {0, 1, 0};
+        cloud.color(i) = {float(i % 256) / 255.F, 0.F, 1.F};
+    }
+    auto path = temp_path("points.ply");
+    write_point_cloud(path, cloud);
+    auto result = read_point_cloud<PointCloud3d>(path);
+    fs::remove(path);
+
+    ASSERT_EQ(result.size(), cloud.size());
+    ASSERT_TRUE(result.hasNormals());
+    ASSERT_TRUE(result.hasColors());
+    for (std::size_t i{0}; i < cloud.size(); i++) {
+        const auto& p = cloud.point(i);
+        EXPECT_EQ(result.point(i), Vec3d(p[0], p[1], p[2]));
+        EXPECT_EQ(result.normal(i), Vec3d(0, 1, 0));
+        EXPECT_FLOAT_EQ(result.color(i)[0], cloud.color(i)[0]);
+        EXPECT_FLOAT_EQ(result.color(i)[2], 1.F);
+    }
+
+    // No attributes
+    cloud.clearNormals();
+    cloud.clearColors();
+    write_point_cloud(path, cloud);
+    result = read_point_cloud<PointCloud3d>(path);
+    fs::remove(path);
+    EXPECT_EQ(result.size(), cloud.size());
+    EXPECT_FALSE(result.hasNormals());
+    EXPECT_FALSE(result.hasColors());
+}
+
+TEST(PointCloudIO, ReadPLYMesh)
+{
+    // Faces are skipped, and 16-bit colors are scaled to [0, 1]
+    auto path = temp_path("mesh.ply");
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "ply\n"
+                "format ascii 1.0\n"
+                "element vertex 3\n"
+                "property double x\n"
+                "property double y\n"
+                "property double z\n"
+                "property ushort red\n"
+                "property ushort green\n"
+                "property ushort blue\n"
+                "element face 1\n"
+                "property list uchar int vertex_indices\n"
+                "end_header\n"
+                "0 0 0 65535 0 0\n"
+                "1 0 0 0 65535 0\n"
+                "0 1 0 0 0 0\n"
+                "3 0 1 2\n";
+    }
+    auto cloud = read_point_cloud<PointCloud3f>(path);
+    fs::remove(path);
+    ASSERT_EQ(cloud.size(), 3);
+    EXPECT_EQ(cloud.point(1), Vec3f(1, 0, 0));
+    EXPECT_FALSE(cloud.hasNormals());
+    ASSERT_TRUE(cloud.hasColors());
+    EXPECT_EQ(cloud.color(0), Color::F32C3(1.F, 0.F, 0.F));
+    EXPECT_EQ(cloud.color(1), Color::F32C3(0.F, 1.F, 0.F));
+}
+
+TEST(PointCloudIO, Errors)
+{
+    PointCloud3f cloud;
+    cloud.insertPoint(0, 0, 0);
+    EXPECT_THROW(
+        write_point_cloud(temp_path("points.xyz"), cloud),
+        std::invalid_argument);
+    EXPECT_THROW(
+        std::ignore = read_point_cloud<PointCloud3f>(temp_path("points.xyz")),
+        std::invalid_argument);
+    EXPECT_THROW(
+        std::ignore = read_point_cloud<PointCloud3f>(temp_path("none.ply")),
+        std::runtime_error);
+
+    // Vertex count larger than the file
+    auto path = temp_path("huge.ply");
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "ply\nformat binary_little_endian 1.0\n"
+                "element vertex 100000000000\nproperty float x\n"
+                "property float y\nproperty float z\nend_header\n";
+    }
+    EXPECT_THROW(
+        std::ignore = read_point_cloud<PointCloud3f>(path),
+        std::runtime_error);
+    fs::remove(path);
+}
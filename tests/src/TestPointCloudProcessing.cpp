@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "educelab/core/types/PointCloud.hpp"
+#include "educelab/core/utils/Iteration.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+#include "educelab/core/utils/PointCloudProcessing.hpp"
+
+using namespace educelab;
+
+namespace
+{
+// Regular grid of points on the z = 0 plane with the given spacing
+auto make_grid(std::size_t res, double spacing) -> PointCloud3d
+{
+    PointCloud3d cloud;
+    for (const auto [y, x] : range2D(res, res)) {
+        cloud.insertPoint(double(x) * spacing, double(y) * spacing, 0.);
+    }
+    return cloud;
+}
+}  // namespace
+
+TEST(PointCloudProcessing, KdTree)
+{
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<float> dist(-1, 1);
+    std::vector<Vec3f> points(2000);
+    for (auto& p : points) {
+        p = {dist(gen), dist(gen), dist(gen)};
+    }
+    // Duplicates and a flat cluster
+    points[10] = points[11];
+    for (std::size_t i{100}; i < 200; i++) {
+        points[i][2] = 0;
+    }
+    set_num_threads(4);
+    detail::PointKdTree<float, 3> tree(points);
+    set_num_threads(0);
+
+    using Neighbor = std::pair<double, std::size_t>;
+    std::vector<Neighbor> result;
+    for (std::size_t q{0}; q < 100; q++) {
+        auto query = q < 50 ? points[q * 3] : Vec3f{dist(gen), dist(gen), 0};
+        std::vector<Neighbor> expected;
+        for (std::size_t i{0}; i < points.size(); i++) {
+            double d2{0};
+            for (std::size_t d{0}; d < 3; d++) {
+                auto diff = double(points[i][d]) - double(query[d]);
+                d2 += diff * diff;
+            }
+            expected.emplace_back(d2, i);
+        }
+        std::sort(expected.begin(), expected.end());
+        expected.resize(12);
+        tree.nearest(query, 12, result);
+        EXPECT_EQ(result, expected);
+    }
+
+    // Excluding the query point
+    tree.nearest(points[10], 1, result, 10);
+    ASSERT_EQ(result.size(), 1);
+    EXPECT_EQ(result[0], Neighbor(0., 11));
+
+    // More neighbors than points
+    std::vector<Vec3f> few{Vec3f{0, 0, 0}, Vec3f{1, 0, 0}};
+    detail::PointKdTree<float, 3> small(few);
+    small.nearest(Vec3f{2, 0, 0}, 5, result);
+    ASSERT_EQ(result.size(), 2);
+    EXPECT_EQ(result[0].second, 1);
+}
+
+TEST(PointCloudProcessing, VoxelDownsample)
+{
+    // 4x4 grid with a spacing of 1 and voxels of size 2: each voxel holds a
+    // 2x2 block of points
+    auto cloud = make_grid(4, 1);
+    cloud.enableColors();
+    cloud.enableNormals();
+    for (std::size_t i{0}; i < cloud.size(); i++) {
+        cloud.color(i) = {float(i) / 15.F, 0.F, 1.F};
+        cloud.normal(i) = {i % 2 == 0 ? 1. : 0., 0., 1.};
+    }
+    auto result = voxel_downsample(cloud, 2.);
+    ASSERT_EQ(result.size(), 4);
+    ASSERT_TRUE(result.hasColors());
+    ASSERT_TRUE(result.hasNormals());
+    // Ordered by the first point in each voxel
+    EXPECT_EQ(result.point(0), Vec3d(0.5, 0.5, 0));
+    EXPECT_EQ(result.point(1), Vec3d(2.5, 0.5, 0));
+    EXPECT_EQ(result.point(2), Vec3d(0.5, 2.5, 0));
+    EXPECT_EQ(result.point(3), Vec3d(2.5, 2.5, 0));
+    // Points 0, 1, 4, 5
+    EXPECT_FLOAT_EQ(result.color(0)[0], 10.F / 4 / 15);
+    EXPECT_FLOAT_EQ(result.color(0)[2], 1.F);
+    auto s = 1 / std::sqrt(1.25);
+    EXPECT_NEAR(result.normal(0)[0], 0.5 * s, 1e-12);
+    EXPECT_NEAR(result.normal(0)[2], s, 1e-12);
+
+    // Negative coordinates and thread independence
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<double> dist(-5, 5);
+    PointCloud3d random;
+    for (std::size_t i{0}; i < 20000; i++) {
+        random.insertPoint(dist(gen), dist(gen), dist(gen));
+    }
+    auto serial = voxel_downsample(random, 1.);
+    EXPECT_EQ(serial.size(), 1000);
+    set_num_threads(4);
+    auto parallel = voxel_downsample(random, 1.);
+    set_num_threads(0);
+    ASSERT_EQ(parallel.size(), serial.size());
+    for (std::size_t i{0}; i < serial.size(); i++) {
+        EXPECT_EQ(parallel.point(i), serial.point(i));
+        EXPECT_FALSE(parallel.hasNormals());
+    }
+
+    EXPECT_TRUE(voxel_downsample(PointCloud3d{}, 1.).empty());
+    EXPECT_THROW(voxel_downsample(cloud, 0.), std::invalid_argument);
+    EXPECT_THROW(voxel_downsample(cloud, NAN), std::invalid_argument);
+    EXPECT_THROW(voxel_downsample(cloud, 1e-300), std::overflow_error);
+    cloud.insertPoint(INFINITY, 0., 0.);
+    EXPECT_THROW(voxel_downsample(cloud, 2.), std::invalid_argument);
+}
+
+TEST(PointCloudProcessing, RemoveOutliers)
+{
+    auto cloud = make_grid(20, 0.1);
+    cloud.insertPoint(5., 5., 5.);
+    cloud.insertPoint(0.5, 0.5, 3.);
+    cloud.enableColors();
+    cloud.color(cloud.size() - 1)[0] = 1.F;
+    cloud.color(10)[0] = 0.5F;
+
+    OutlierRemovalOptions opts;
+    opts.neighbors = 8;
+    set_num_threads(4);
+    auto removed = remove_statistical_outliers(cloud, opts);
+    set_num_threads(0);
+    EXPECT_EQ(removed, 2);
+    ASSERT_EQ(cloud.size(), 400);
+    ASSERT_TRUE(cloud.hasColors());
+    EXPECT_EQ(cloud.color(10)[0], 0.5F);
+    for (const auto& p : cloud.points()) {
+        EXPECT_EQ(p[2], 0.);
+    }
+
+    // Points on the border of the grid are sparser than the interior
+    opts.stdRatio = 10;
+    EXPECT_EQ(remove_statistical_outliers(cloud, opts), 0);
+    opts.stdRatio = 2;
+    EXPECT_GT(remove_statistical_outliers(cloud, opts), 0);
+
+    opts.neighbors = 0;
+    EXPECT_THROW(
+        remove_statistical_outliers(cloud, opts), std::invalid_argument);
+}
+
+TEST(PointCloudProcessing, EstimateNormals)
+{
+    // Plane, viewed from above and below
+    auto cloud = make_grid(10, 0.1);
+    NormalEstimationOptions opts;
+    opts.neighbors = 8;
+    opts.viewpoint = {0, 0, 10};
+    estimate_normals(cloud, opts);
+    ASSERT_TRUE(cloud.hasNormals());
+    for (const auto& n : cloud.normals()) {
+        EXPECT_NEAR(n[0], 0, 1e-9);
+        EXPECT_NEAR(n[1], 0, 1e-9);
+        EXPECT_NEAR(n[2], 1, 1e-9);
+    }
+    opts.viewpoint = {0, 0, -10};
+    estimate_normals(cloud, opts);
+    EXPECT_NEAR(cloud.normal(0)[2], -1, 1e-9);
+
+    // Sphere, oriented towards the center
+    std::mt19937 gen(0);
+    std::normal_distribution<double> dist;
+    PointCloud3d sphere;
+    for (std::size_t i{0}; i < 5000; i++) {
+        Vec3d p{dist(gen), dist(gen), dist(gen)};
+        sphere.insertPoint(p / p.magnitude());
+    }
+    opts.neighbors = 16;
+    opts.viewpoint = {0, 0, 0};
+    set_num_threads(4);
+    estimate_normals(sphere, opts);
+    set_num_threads(0);
+    for (std::size_t i{0}; i < sphere.size(); i++) {
+        const auto& n = sphere.normal(i);
+        EXPECT_NEAR(n.magnitude(), 1, 1e-9);
+        EXPECT_LT(n.dot(sphere.point(i)), -0.99);
+    }
+
+    opts.neighbors = 2;
+    EXPECT_THROW(estimate_normals(sphere, opts), std::invalid_argument);
+}
@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "educelab/core/utils/Sorting.hpp"
+
+using namespace educelab;
+
+TEST(Sorting, RadixSortPairs)
+{
+    std::vector<std::uint32_t> keys{3, 1, 2, 1};
+    std::vector<int> values{0, 1, 2, 3};
+    radix_sort_pairs(keys, values);
+    EXPECT_EQ(keys, std::vector<std::uint32_t>({1, 1, 2, 3}));
+    // Stable: Equal keys keep their input order
+    EXPECT_EQ(values, std::vector<int>({1, 3, 2, 0}));
+}
+
+TEST(Sorting, RadixSortPairsLarge)
+{
+    // Large enough to be sorted in several parallel blocks
+    std::mt19937_64 gen(42);
+    std::uniform_int_distribution<std::uint64_t> dist(0, 1ULL << 40);
+    std::vector<std::uint64_t> keys(100'000);
+    std::vector<std::size_t> values(keys.size());
+    for (std::size_t i{0}; i < keys.size(); i++) {
+        keys[i] = dist(gen);
+        values[i] = i;
+    }
+    auto expected = keys;
+    std::sort(expected.begin(), expected.end());
+
+    auto input = keys;
+    radix_sort_pairs(keys, values);
+    EXPECT_EQ(keys, expected);
+    for (std::size_t i{0}; i < keys.size(); i++) {
+        EXPECT_EQ(input[values[i]], keys[i]);
+    }
+}
+
+TEST(Sorting, RadixSortPairsErrors)
+{
+    std::vector<std::uint8_t> keys{1, 2};
+    std::vector<int> values{1};
+    EXPECT_THROW(radix_sort_pairs(keys, values), std::invalid_argument);
+}
@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <iterator>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "educelab/core/utils/String.hpp"
 
@@ -151,6 +154,37 @@ TEST(String, Split)
     EXPECT_EQ(split("This is only a test."), expected);
 }
 
+TEST(String, SplitView)
+{
+    std::vector<std::string_view> expected{"a", "b", "c"};
+    std::vector<std::string_view> tokens;
+    for (const auto& t : split_view(";a,;b;,c,", ',', ';')) {
+        tokens.push_back(t);
+    }
+    EXPECT_EQ(tokens, expected);
+
+    // Tokens refer to the original string
+    std::string_view str{"x y"};
+    auto range = split_view(str);
+    auto it = range.begin();
+    EXPECT_EQ(it->data(), str.data());
+    EXPECT_EQ((it++)->size(), 1);
+    EXPECT_EQ(*it, "y");
+    EXPECT_EQ(it->data(), str.data() + 2);
+    EXPECT_NE(it, range.end());
+    EXPECT_EQ(++it, range.end());
+
+    // Empty strings and strings of only delimiters have no tokens
+    EXPECT_EQ(split_view("").begin(), split_view("").end());
+    auto delims = split_view("   ");
+    EXPECT_EQ(delims.begin(), delims.end());
+
+    // Every byte value can be a delimiter
+    std::string bytes{"a\xff" "b\x80" "c\x01"};
+    EXPECT_EQ(split(bytes, '\xff', '\x80', '\x01'), expected);
+    EXPECT_EQ(std::distance(range.begin(), range.end()), 2);
+}
+
 TEST(String, ToNumeric)
 {
     std::string test{"100.3456 unparsed"};
@@ -170,3 +204,35 @@ TEST(String, ToNumeric)
     EXPECT_THROW(to_numeric<int>("bad"), std::invalid_argument);
     EXPECT_THROW(to_numeric<uint8_t>("256"), std::out_of_range);
 }
+
+TEST(String, ToNumericPos)
+{
+    std::string test{"100.3456 unparsed"};
+    std::size_t pos{0};
+    EXPECT_EQ(to_numeric<int>(test, &pos), 100);
+    EXPECT_EQ(pos, 3);
+    EXPECT_EQ(to_numeric<float>(test, &pos), 100.3456F);
+    EXPECT_EQ(pos, 8);
+    EXPECT_EQ(to_numeric<int>("ff", &pos, 16), 255);
+    EXPECT_EQ(pos, 2);
+
+    EXPECT_THROW(to_numeric<int>("bad", &pos), std::invalid_argument);
+    EXPECT_THROW(to_numeric<uint8_t>("256", &pos), std::out_of_range);
+}
+
+TEST(String, AppendNumeric)
+{
+    std::string result{"v"};
+    result += ' ';
+    append_numeric(result, 1.5F);
+    result += ' ';
+    append_numeric(result, -2);
+    result += ' ';
+    append_numeric(result, std::size_t{42});
+    EXPECT_EQ(result, "v 1.5 -2 42");
+
+    // Round-trip
+    result.clear();
+    append_numeric(result, 0.1F);
+    EXPECT_EQ(to_numeric<float>(result), 0.1F);
+}
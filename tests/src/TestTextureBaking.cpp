@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+
+#include <limits>
+
+#include "educelab/core/types/Image.hpp"
+#include "educelab/core/types/Mesh.hpp"
+#include "educelab/core/utils/Iteration.hpp"
+#include "educelab/core/utils/Parallel.hpp"
+#include "educelab/core/utils/TextureBaking.hpp"
+
+using namespace educelab;
+
+namespace
+{
+// Unit square in the XY plane, split into a grid of quads. UV = XY.
+auto make_plane(std::size_t res) -> Mesh3f
+{
+    Mesh3f mesh;
+    for (const auto [y, x] : range2D(res + 1, res + 1)) {
+        auto u = float(x) / float(res);
+        auto v = float(y) / float(res);
+        auto idx = mesh.insertVertex(u, v, 0.F);
+        mesh.vertex(idx).normal = Vec3f{0, 0, 1};
+        mesh.insertUV(u, v);
+    }
+    const auto n = static_cast<Mesh3f::index_type>(res + 1);
+    for (const auto [y, x] : range2D(res, res)) {
+        auto v = static_cast<Mesh3f::index_type>(y * n + x);
+        Mesh3f::Face f{v, v + 1, v + n + 1, v + n};
+        mesh.insertFace(f, f);
+    }
+    return mesh;
+}
+
+// Interpolate the vertex positions
+auto position_sampler(const Mesh3f& mesh)
+{
+    return [&mesh](const TexelSample& s, float* texel) {
+        for (std::size_t i{0}; i < 3; i++) {
+            const auto& v = mesh.vertex(s.vertices[i]);
+            for (std::size_t d{0}; d < 3; d++) {
+                texel[d] += float(s.barycentric[i] * v[d]);
+            }
+        }
+    };
+}
+}  // namespace
+
+TEST(TextureBaking, Coverage)
+{
+    auto mesh = make_plane(3);
+    auto image = bake_texture(mesh, 16, 20, 1, [](auto&, float* t) {
+        t[0] = 1;
+    });
+    EXPECT_EQ(image.height(), 16);
+    EXPECT_EQ(image.width(), 20);
+    EXPECT_EQ(image.channels(), 1);
+    EXPECT_EQ(image.type(), Depth::F32);
+    for (const auto [y, x] : range2D(16, 20)) {
+        EXPECT_EQ(image.at<float>(y, x), 1.F);
+    }
+
+    // Half of the texture: texels on or above the diagonal
+    Mesh3f tri;
+    tri.insertVertex(0, 0, 0);
+    tri.insertVertex(1, 0, 0);
+    tri.insertVertex(1, 1, 0);
+    tri.insertUV(0, 1);
+    tri.insertUV(1, 1);
+    tri.insertUV(1, 0);
+    tri.insertFace({0, 1, 2}, {0, 1, 2});
+    image = bake_texture(tri, 8, 8, 1, [](auto&, float* t) { t[0] = 1; });
+    for (const auto [y, x] : range2D(8, 8)) {
+        EXPECT_EQ(image.at<float>(y, x), x >= y ? 1.F : 0.F);
+    }
+}
+
+TEST(TextureBaking, ExtremeUVs)
+{
+    // A huge triangle covers the texture. A triangle with a NaN UV is
+    // skipped.
+    constexpr auto nan = std::numeric_limits<float>::quiet_NaN();
+    Mesh3f mesh;
+    mesh.insertVertex(0, 0, 0);
+    mesh.insertVertex(1, 0, 0);
+    mesh.insertVertex(0, 1, 0);
+    mesh.insertUV(-1e20F, -1e20F);
+    mesh.insertUV(1e20F, -1e20F);
+    mesh.insertUV(-1e20F, 1e20F);
+    mesh.insertUV(0, 0);
+    mesh.insertUV(1, 0);
+    mesh.insertUV(nan, 1);
+    mesh.insertFace({0, 1, 2}, {0, 1, 2});
+    mesh.insertFace({0, 1, 2}, {3, 4, 5});
+    auto image = bake_texture(mesh, 8, 8, 1, [](auto& s, float* t) {
+        t[0] = float(s.face + 1);
+    });
+    for (const auto [y, x] : range2D(8, 8)) {
+        EXPECT_EQ(image.at<float>(y, x), 1.F);
+    }
+}
+
+TEST(TextureBaking, Interpolation)
+{
+    auto mesh = make_plane(4);
+    constexpr std::size_t size{32};
+    auto image = bake_texture(mesh, size, size, 3, position_sampler(mesh));
+    for (const auto [y, x] : range2D(size, size)) {
+        const auto* t = &image.at<float>(y, x);
+        EXPECT_NEAR(t[0], (x + 0.5) / size, 1e-6);
+        EXPECT_NEAR(t[1], 1 - (y + 0.5) / size, 1e-6);
+        EXPECT_EQ(t[2], 0.F);
+    }
+}
+
+TEST(TextureBaking, Tiles)
+{
+    auto mesh = make_plane(7);
+    auto serial = bake_texture(mesh, 50, 41, 3, position_sampler(mesh));
+    TextureBakeOptions opts;
+    opts.tileSize = 5;
+    set_num_threads(4);
+    auto tiled = bake_texture(mesh, 50, 41, 3, position_sampler(mesh), opts);
+    set_num_threads(0);
+    for (const auto [y, x] : range2D(50, 41)) {
+        const auto* a = &tiled.at<float>(y, x);
+        const auto* b = &serial.at<float>(y, x);
+        for (std::size_t c{0}; c < 3; c++) {
+            EXPECT_EQ(a[c], b[c]);
+        }
+    }
+}
+
+TEST(TextureBaking, Normals)
+{
+    auto mesh = make_plane(2);
+    mesh.vertex(0).normal = Vec3f{1, 0, 0};
+    auto image = bake_normals(mesh, 8, 8);
+    EXPECT_EQ(image.channels(), 3);
+    // Far from vertex 0
+    const auto* n = &image.at<float>(0, 7);
+    EXPECT_FLOAT_EQ(n[2], 1.F);
+    // Near vertex 0 (bottom left), the normal tilts towards +x
+    n = &image.at<float>(7, 0);
+    EXPECT_GT(n[0], 0.F);
+    EXPECT_NEAR(n[0] * n[0] + n[1] * n[1] + n[2] * n[2], 1.F, 1e-6);
+}
+
+TEST(TextureBaking, SampleImage)
+{
+    Image image(2, 2, 1, Depth::U8);
+    image.at<std::uint8_t>(0, 0) = 0;
+    image.at<std::uint8_t>(0, 1) = 255;
+    image.at<std::uint8_t>(1, 0) = 255;
+    image.at<std::uint8_t>(1, 1) = 255;
+    float v{0};
+    sample_image(image, 0.5, 0.5, &v);
+    EXPECT_FLOAT_EQ(v, 0.F);
+    sample_image(image, 1, 1, &v);
+    EXPECT_FLOAT_EQ(v, 0.75F);
+    sample_image(image, 0.5, 1, &v);
+    EXPECT_FLOAT_EQ(v, 0.5F);
+    // Clamped to the edge
+    sample_image(image, -3, 5, &v);
+    EXPECT_FLOAT_EQ(v, 1.F);
+
+    Image f32(1, 2, 2, Depth::F32);
+    (&f32.at<float>(0, 0))[1] = 2.F;
+    (&f32.at<float>(0, 1))[1] = 4.F;
+    std::array<float, 2> px{};
+    sample_image(f32, 0.5, 1, px.data());
+    EXPECT_FLOAT_EQ(px[0], 0.F);
+    EXPECT_FLOAT_EQ(px[1], 3.F);
+
+    EXPECT_THROW(sample_image(Image{}, 0, 0, &v), std::invalid_argument);
+}
+
+TEST(TextureBaking, Errors)
+{
+    auto mesh = make_plane(1);
+    auto noop = [](auto&, float*) {};
+    EXPECT_THROW(bake_texture(mesh, 0, 8, 1, noop), std::invalid_argument);
+    EXPECT_THROW(bake_texture(mesh, 8, 8, 0, noop), std::invalid_argument);
+    mesh.insertFace({0, 1, 2}, {0, 1, 9});
+    EXPECT_THROW(bake_texture(mesh, 8, 8, 1, noop), std::out_of_range);
+}